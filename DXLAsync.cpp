@@ -0,0 +1,243 @@
+/*///////////////////////////////////////////////////////////////////////////////
+C++20 coroutine interface for DXLServo operations. See DXLAsync.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLAsync.h"
+
+#include <algorithm>
+#include <chrono>
+
+////////////////////////////////////////////////////   DXLCoExecutor class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct DXLDetached {                                    // Fire and forget wrapper around a spawned task, frees itself at the end
+    struct promise_type {
+        DXLDetached get_return_object() { return DXLDetached(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+    explicit DXLDetached(std::coroutine_handle<promise_type> h) : handle(h) {}
+};
+
+DXLDetached runDetached(DXLCoExecutor *executor, DXLTask<void> task) {
+    co_await task;
+    executor->taskFinished();
+}
+
+}
+
+void DXLCoExecutor::spawn(DXLTask<void> task) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        active++;
+    }
+    post(runDetached(this, std::move(task)).handle);
+}
+
+void DXLCoExecutor::taskFinished() {
+    std::lock_guard<std::mutex> guard(lock);
+    active--;
+}
+
+void DXLCoExecutor::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ready.push_back(handle);
+    }
+    wake.notify_one();
+}
+
+void DXLCoExecutor::postAt(uint64_t dueUs, std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        Timer timer;
+        timer.dueUs = dueUs;
+        timer.handle = handle;
+        timers.push_back(timer);
+        std::push_heap(timers.begin(), timers.end(), std::greater<Timer>());
+    }
+    wake.notify_one();
+}
+
+void DXLCoExecutor::run() {
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+        uint64_t now = DXLBusStats::nowUs();
+        while (!timers.empty() && timers.front().dueUs <= now) {
+            ready.push_back(timers.front().handle);
+            std::pop_heap(timers.begin(), timers.end(), std::greater<Timer>());
+            timers.pop_back();
+        }
+
+        if (!ready.empty()) {
+            std::coroutine_handle<> handle = ready.front();
+            ready.pop_front();
+            guard.unlock();
+            handle.resume();
+            guard.lock();
+            continue;
+        }
+
+        if (active == 0)    return;
+        if (!timers.empty())    wake.wait_for(guard, std::chrono::microseconds(timers.front().dueUs - now));
+        else                    wake.wait(guard);              // Waiting on bus jobs
+    }
+}
+
+////////////////////////////////////////////////////   Servo operations   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLBusAwaitable<DXLExpected<uint32_t> > dxlAsyncRead(DXLCoExecutor &executor, DXLServo &servo, uint16_t address, uint16_t length) {
+    DXLServo *target = &servo;
+    return DXLBusAwaitable<DXLExpected<uint32_t> >(executor, servo.busPriorityFor(INST_READ, address), [target, address, length]() {
+        return target->tryRead(address, length);
+    });
+}
+
+DXLBusAwaitable<DXLExpected<void> > dxlAsyncWrite(DXLCoExecutor &executor, DXLServo &servo, uint16_t address, uint16_t length, uint32_t value) {
+    DXLServo *target = &servo;
+    return DXLBusAwaitable<DXLExpected<void> >(executor, servo.busPriorityFor(INST_WRITE, address), [target, address, length, value]() {
+        return target->tryWrite(address, length, value);
+    });
+}
+
+DXLBusAwaitable<int> dxlAsyncCall(DXLCoExecutor &executor, int priority, std::function<int()> call) {
+    return DXLBusAwaitable<int>(executor, priority, std::move(call));
+}
+
+DXLSleepAwaitable dxlAsyncSleep(DXLCoExecutor &executor, int ms) {
+    return DXLSleepAwaitable(executor, DXLBusStats::nowUs() + uint64_t(ms > 0 ? ms : 0) * 1000);
+}
+
+DXLTask<DXLExpected<void> > dxlAsyncMoveTo(DXLCoExecutor &executor, DXLServo &servo, int position, int timeoutMs, int pollMs) {
+    uint16_t goalAddress = (servo.servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION;
+    uint16_t movingAddress = (servo.servoType == DXL_PRO_M42) ? ADDR_PRO_MOVING : ADDR_MX_MOVING;
+
+    uint16_t presentAddress = (servo.servoType == DXL_PRO_M42) ? ADDR_PRO_PRESENT_POSITION : ADDR_MX_PRESENT_POSITION;
+
+    DXLExpected<uint32_t> from = co_await dxlAsyncRead(executor, servo, presentAddress, 4);
+    DXLExpected<void> written = co_await dxlAsyncWrite(executor, servo, goalAddress, 4, uint32_t(position));
+    if (!written)   co_return written;
+    uint64_t deadline = DXLBusStats::nowUs() + uint64_t(timeoutMs) * 1000;
+
+    if (from) {                                         // Sleep through the predicted move, as DXLServo::waitForMove()
+        DXLServo *target = &servo;
+        int start = int(int32_t(from.value()));
+        int predictedMs = co_await dxlAsyncCall(executor, DXL_PRIO_CONFIG, [target, start, position]() {     // May read profile registers once
+            return int(target->predictMoveTime(start, position) * 1000.0 - DXL_MOVE_WAKE_LEAD_SEC * 1000.0);
+        });
+        if (predictedMs > pollMs)   co_await dxlAsyncSleep(executor, predictedMs - pollMs);
+    }
+    for (;;) {
+        co_await dxlAsyncSleep(executor, pollMs);       // Moving flag may still be clear right after the write
+        DXLExpected<uint32_t> moving = co_await dxlAsyncRead(executor, servo, movingAddress, 1);
+        if (!moving)    co_return DXLExpected<void>(moving.error());
+        if (moving.value() == 0)    co_return DXLExpected<void>();
+        if (DXLBusStats::nowUs() > deadline) {
+            DXL_LOG_WARN(servo.identity, movingAddress, DXL_LOG_NONE, "Move to %d not finished within %d ms", position, timeoutMs);
+            co_return DXLExpected<void>(DXLError(DXL_COMM_MOTION_TIMEOUT, 0, uint8_t(servo.identity), goalAddress, 0));
+        }
+    }
+}
+
+static DXLExpected<void> callResult(DXLServo &servo, int commResult) {      // Outcome of last packet call made by a blocking setter
+    if (commResult != COMM_SUCCESS || (servo.dxl_error & 0x7F) != 0)    return DXLExpected<void>(DXLError(commResult, servo.dxl_error, uint8_t(servo.identity), 0, servo.getLastAttempts()));
+    return DXLExpected<void>();
+}
+
+DXLTask<DXLExpected<void> > dxlAsyncConfigure(DXLCoExecutor &executor, DXLServo &servo, DXLServoConfig config) {
+    DXLServo *target = &servo;
+    int result;
+
+    // Each step is its own bus job, so control traffic of other servos can run in between
+    result = co_await dxlAsyncCall(executor, DXL_PRIO_CONFIG, [target]() { target->disableTorque(); return target->dxl_comm_result; });
+    if (!callResult(servo, result))     co_return callResult(servo, result);
+
+    if (config.operatingMode >= 0) {
+        result = co_await dxlAsyncCall(executor, DXL_PRIO_CONFIG, [target, config]() { target->setOperatingMode(config.operatingMode); return target->dxl_comm_result; });
+        if (!callResult(servo, result))     co_return callResult(servo, result);
+    }
+    if (config.currentLimitAmps >= 0.0) {
+        result = co_await dxlAsyncCall(executor, DXL_PRIO_CONFIG, [target, config]() { target->setCurrentLimit(config.currentLimitAmps); return target->dxl_comm_result; });
+        if (!callResult(servo, result))     co_return callResult(servo, result);
+    }
+    if (config.velocityLimitRpm >= 0.0) {
+        result = co_await dxlAsyncCall(executor, DXL_PRIO_CONFIG, [target, config]() { target->setVelocityLimit(config.velocityLimitRpm); return target->dxl_comm_result; });
+        if (!callResult(servo, result))     co_return callResult(servo, result);
+    }
+    if (config.accelLimit >= 0.0) {
+        result = co_await dxlAsyncCall(executor, DXL_PRIO_CONFIG, [target, config]() { target->setAccelLimit(config.accelLimit); return target->dxl_comm_result; });
+        if (!callResult(servo, result))     co_return callResult(servo, result);
+    }
+    if (config.enableTorque) {
+        result = co_await dxlAsyncCall(executor, DXL_PRIO_CONFIG, [target]() { target->enableTorque(); return target->dxl_comm_result; });
+        if (!callResult(servo, result))     co_return callResult(servo, result);
+    }
+    if (config.positionGain[0] >= 0) {                  // RAM
+        result = co_await dxlAsyncCall(executor, DXL_PRIO_CONFIG, [target, config]() {
+            target->setPositionGain(config.positionGain[0], config.positionGain[1], config.positionGain[2], config.positionGain[3], config.positionGain[4]);
+            return target->dxl_comm_result;
+        });
+        if (!callResult(servo, result))     co_return callResult(servo, result);
+    }
+    if (config.profileAcceleration > 0) {               // RAM, needs torque state set first on MX
+        result = co_await dxlAsyncCall(executor, DXL_PRIO_CONTROL, [target, config]() { target->setProfileAcceleration(config.profileAcceleration); return target->dxl_comm_result; });
+        if (!callResult(servo, result))     co_return callResult(servo, result);
+    }
+    if (config.profileVelocity > 0) {
+        result = co_await dxlAsyncCall(executor, DXL_PRIO_CONTROL, [target, config]() { target->setProfileVelocity(config.profileVelocity); return target->dxl_comm_result; });
+        if (!callResult(servo, result))     co_return callResult(servo, result);
+    }
+    co_return DXLExpected<void>();
+}
+
+/*
+////////////////////////////////////////////////////    Example Code: pan/tilt demo loop with coroutines    ///////////////////////////////////////////////////////////////////////////
+// Same sequence as the example main() in DXLProServo.cpp, both axes run concurrently on one thread.
+DXLTask<void> sweepAxis(DXLCoExecutor &exec, DXLServo &servo, int start, int step, const char *name) {
+    DXLServoConfig config;
+    config.operatingMode = 2;                                                   // Position mode
+    config.velocityLimitRpm = 80.0;
+    config.accelLimit = 6400.0;
+    config.profileAcceleration = 5;
+    config.profileVelocity = 10;
+    DXLExpected<void> configured = co_await dxlAsyncConfigure(exec, servo, config);
+    if (!configured) {
+        printf("%s setup failed: %s\n", name, configured.error().describe().c_str());
+        co_return;
+    }
+
+    for (int i = 0; i < 10; i++) {
+        DXLExpected<void> moved = co_await dxlAsyncMoveTo(exec, servo, start + i * step);
+        if (!moved) {
+            printf("%s move failed: %s\n", name, moved.error().describe().c_str());
+            co_return;
+        }
+        uint16_t address = (servo.servoType == DXL_PRO_M42) ? ADDR_PRO_PRESENT_POSITION : ADDR_MX_PRESENT_POSITION;
+        DXLExpected<uint32_t> position = co_await dxlAsyncRead(exec, servo, address, 4);
+        if (position)   printf("%s Angle = %.2f degrees\n", name, servo.convertValtoPos(int(int32_t(position.value()))));
+        co_await dxlAsyncSleep(exec, 1000);                                     // Was crossSleep(1), now other axis keeps moving
+    }
+    co_await dxlAsyncCall(exec, DXL_PRIO_CONFIG, [&servo]() { servo.disableTorque(); return servo.dxl_comm_result; });
+}
+
+int main() {
+    DXLServo panServo, tiltServo;
+    // ... ID, device name, servo type, port and packet handler setup as in example main() ...
+
+    DXLBusScheduler bus;
+    panServo.setBusScheduler(&bus);
+    tiltServo.setBusScheduler(&bus);
+    DXLCoExecutor exec(bus);
+    exec.spawn(sweepAxis(exec, panServo, 1800, 45, "Pan"));
+    exec.spawn(sweepAxis(exec, tiltServo, 1603, 45, "Tilt"));
+    exec.run();                                                                 // Returns when both sequences are done
+    bus.stop();
+    panServo.closePort();
+    return 0;
+}
+// End of Example Code
+*/
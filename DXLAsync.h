@@ -0,0 +1,190 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+C++20 coroutine interface for DXLServo operations. Requires -std=c++20.
+
+- DXLTask<T>: lazy coroutine returning T, started when co_await'ed (or spawned).
+- DXLCoExecutor: single thread event loop that resumes coroutines. Bus work is queued on a DXLBusScheduler and runs on its
+  worker thread; completion resumes the waiting coroutine back on the executor thread. One executor thread can run dozens
+  of motion sequences concurrently with no thread per servo, and the scheduler still arbitrates priorities.
+- Awaitables: dxlAsyncRead/Write (one register), dxlAsyncCall (any blocking DXLServo call, run as one bus job),
+  dxlAsyncSleep (timer, no bus), and tasks dxlAsyncMoveTo (goal write, wait for completion) and dxlAsyncConfigure.
+
+Coroutine code only touches a DXLServo between co_awaits on the executor thread, bus jobs only on the worker thread,
+so a servo used from coroutines needs no locking. Do not call blocking DXLServo functions directly from a coroutine,
+wrap them in dxlAsyncCall().
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <coroutine>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+class DXLCoExecutor;
+
+////////////////////////////////////////////////////   DXLTask   /////////////////////////////////////////////////////////////////////////////////////////
+
+struct DXLTaskPromiseBase {
+    std::coroutine_handle<> continuation;              // Coroutine awaiting this task, resumed on completion
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> next = handle.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { std::terminate(); }   // Errors travel as DXLExpected, not exceptions
+};
+
+template <typename T>
+class DXLTask {
+public:
+    struct promise_type : DXLTaskPromiseBase {
+        std::optional<T> result;                        // optional: DXLExpected has no default value
+        DXLTask get_return_object() { return DXLTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_value(T value) { result.emplace(std::move(value)); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> coro;
+
+public:
+    explicit DXLTask(std::coroutine_handle<promise_type> handle) : coro(handle) {}
+    DXLTask(DXLTask &&other) noexcept : coro(std::exchange(other.coro, {})) {}
+    DXLTask(const DXLTask &) = delete;
+    DXLTask &operator=(const DXLTask &) = delete;
+    ~DXLTask() { if (coro) coro.destroy(); }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        coro.promise().continuation = awaiting;
+        return coro;                                    // Symmetric transfer, no stack growth on long chains
+    }
+    T await_resume() { return std::move(*coro.promise().result); }
+};
+
+template <>
+class DXLTask<void> {
+public:
+    struct promise_type : DXLTaskPromiseBase {
+        DXLTask get_return_object() { return DXLTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_void() {}
+    };
+
+private:
+    std::coroutine_handle<promise_type> coro;
+
+public:
+    explicit DXLTask(std::coroutine_handle<promise_type> handle) : coro(handle) {}
+    DXLTask(DXLTask &&other) noexcept : coro(std::exchange(other.coro, {})) {}
+    DXLTask(const DXLTask &) = delete;
+    DXLTask &operator=(const DXLTask &) = delete;
+    ~DXLTask() { if (coro) coro.destroy(); }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        coro.promise().continuation = awaiting;
+        return coro;
+    }
+    void await_resume() {}
+};
+
+////////////////////////////////////////////////////   DXLCoExecutor   /////////////////////////////////////////////////////////////////////////////////////////
+
+class DXLCoExecutor {
+private:
+    struct Timer {
+        uint64_t dueUs;
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer &other) const { return dueUs > other.dueUs; }
+    };
+
+    DXLBusScheduler &busScheduler;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<std::coroutine_handle<> > ready;
+    std::vector<Timer> timers;                          // Min heap on dueUs
+    int active;                                         // Spawned tasks not finished
+
+public:
+    explicit DXLCoExecutor(DXLBusScheduler &scheduler) : busScheduler(scheduler), active(0) {}
+
+    DXLBusScheduler &bus() { return busScheduler; }
+    void spawn(DXLTask<void> task);                     // Start task on next run(), executor keeps it until done
+    void run();                                         // Resume coroutines on calling thread until every spawned task has finished
+    void post(std::coroutine_handle<> handle);          // Resume handle on executor thread. Safe from any thread.
+    void postAt(uint64_t dueUs, std::coroutine_handle<> handle);     // Resume at DXLBusStats::nowUs() time
+    void taskFinished();                                // Used by spawn() wrapper
+};
+
+////////////////////////////////////////////////////   Awaitables   /////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class DXLBusAwaitable {                                 // Runs work() as one bus job on the scheduler worker, resumes with its result
+private:
+    DXLCoExecutor &executor;
+    int priority;
+    std::function<T()> work;
+    std::optional<T> result;
+
+public:
+    DXLBusAwaitable(DXLCoExecutor &exec, int prio, std::function<T()> fn) : executor(exec), priority(prio), work(std::move(fn)) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        DXLBusJob job;
+        job.priority = priority;
+        job.run = [this]() { result.emplace(work()); return 0; };
+        job.done = [this, handle](int) { executor.post(handle); };
+        executor.bus().submit(job);
+    }
+    T await_resume() { return std::move(*result); }
+};
+
+class DXLSleepAwaitable {
+private:
+    DXLCoExecutor &executor;
+    uint64_t dueUs;
+
+public:
+    DXLSleepAwaitable(DXLCoExecutor &exec, uint64_t due) : executor(exec), dueUs(due) {}
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) { executor.postAt(dueUs, handle); }
+    void await_resume() const noexcept {}
+};
+
+struct DXLServoConfig {                                 // Fields below 0 are left unchanged
+    int operatingMode;                                  // setOperatingMode()
+    double velocityLimitRpm;                            // setVelocityLimit(double)
+    double accelLimit;                                  // setAccelLimit(double), rev/min2
+    double currentLimitAmps;                            // setCurrentLimit(double)
+    int profileVelocity, profileAcceleration;           // setProfileVelocity(int)/setProfileAcceleration(int), 0 also skipped
+    bool enableTorque;                                  // Enable torque after EEPROM settings
+    int positionGain[5];                                // setPositionGain(): P, I, D, FF1, FF2, e.g. from DXLGainTuner::loadGains(). Skipped if P below 0.
+
+    DXLServoConfig() : operatingMode(-1), velocityLimitRpm(-1.0), accelLimit(-1.0), currentLimitAmps(-1.0), profileVelocity(-1), profileAcceleration(-1), enableTorque(true) {
+        positionGain[0] = -1, positionGain[1] = 0, positionGain[2] = 0, positionGain[3] = 0, positionGain[4] = 0;
+    }
+};
+
+DXLBusAwaitable<DXLExpected<uint32_t> > dxlAsyncRead(DXLCoExecutor &executor, DXLServo &servo, uint16_t address, uint16_t length);
+DXLBusAwaitable<DXLExpected<void> > dxlAsyncWrite(DXLCoExecutor &executor, DXLServo &servo, uint16_t address, uint16_t length, uint32_t value);
+DXLBusAwaitable<int> dxlAsyncCall(DXLCoExecutor &executor, int priority, std::function<int()> call);     // Any blocking servo call as one bus job
+DXLSleepAwaitable dxlAsyncSleep(DXLCoExecutor &executor, int ms);
+
+DXLTask<DXLExpected<void> > dxlAsyncMoveTo(DXLCoExecutor &executor, DXLServo &servo, int position, int timeoutMs = 10000, int pollMs = 20);    // Goal write, sleep through predicted move, then poll Moving until stopped
+DXLTask<DXLExpected<void> > dxlAsyncConfigure(DXLCoExecutor &executor, DXLServo &servo, DXLServoConfig config);    // Torque off, EEPROM/limit settings, torque on
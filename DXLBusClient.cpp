@@ -0,0 +1,343 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Client side of DXLBusDaemon. See DXLBusClient.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+
+#include "DXLBusClient.h"
+
+#include <chrono>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+
+////////////////////////////////////////////////////   DXLBusClient definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLBusClient::DXLBusClient() {
+    table = 0;
+    shmFd = -1, socketFd = -1;
+    nextToken = 1;
+    timeoutMs = DXL_CLIENT_TIMEOUT_MS;
+}
+
+DXLBusClient::~DXLBusClient() {
+    disconnect();
+}
+
+bool DXLBusClient::connect(const std::string &daemonName) {
+    disconnect();
+    std::string shmName = "/" + daemonName;
+    shmFd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    struct stat info;
+    if (shmFd < 0 || fstat(shmFd, &info) != 0 || size_t(info.st_size) < sizeof(DXLSharedTable)) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "No bus daemon table %s", shmName.c_str());
+        disconnect();
+        return false;
+    }
+    void *mapped = mmap(0, sizeof(DXLSharedTable), PROT_READ, MAP_SHARED, shmFd, 0);
+    if (mapped == MAP_FAILED) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot map %s: %s", shmName.c_str(), strerror(errno));
+        disconnect();
+        return false;
+    }
+    table = static_cast<const DXLSharedTable *>(mapped);
+    if (table->magic != DXL_DAEMON_MAGIC || table->version != DXL_DAEMON_VERSION) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Bus daemon table %s not ready or version %u, expected %d", shmName.c_str(), table->version, DXL_DAEMON_VERSION);
+        disconnect();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    std::string path = "/tmp/" + daemonName + ".sock";
+    socketFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (socketFd < 0 || ::connect(socketFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot connect to %s: %s", path.c_str(), strerror(errno));
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+void DXLBusClient::disconnect() {
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+    if (table != 0) {
+        munmap(const_cast<DXLSharedTable *>(table), sizeof(DXLSharedTable));
+        table = 0;
+    }
+    if (shmFd >= 0) {
+        close(shmFd);
+        shmFd = -1;
+    }
+}
+
+bool DXLBusClient::daemonAlive() const {
+    if (table == 0 || table->magic != DXL_DAEMON_MAGIC)     return false;
+    return kill(table->daemonPid, 0) == 0 || errno != ESRCH;
+}
+
+size_t DXLBusClient::servoCount() const {
+    return (table != 0) ? table->servoCount : 0;
+}
+
+bool DXLBusClient::servoAt(size_t index, DXLSharedServoState &state) const {
+    if (table == 0 || index >= table->servoCount)   return false;
+    uint64_t deadlineUs = 0;
+    for (int spins = 1; ; spins++) {                    // A daemon that died mid write leaves the slot odd for good, do not spin on it
+        if (table->slots[index].tryRead(state))     return true;
+        if (spins % DXL_CLIENT_READ_SPINS != 0) {
+            DXL_SEQLOCK_PAUSE();
+            continue;
+        }
+        if (!daemonAlive()) {
+            DXL_LOG_ERROR(table->ids[index], DXL_LOG_NONE, DXL_LOG_NONE, "Bus daemon gone during a state update");
+            return false;
+        }
+        uint64_t now = DXLBusStats::nowUs();
+        if (deadlineUs == 0)    deadlineUs = now + uint64_t(timeoutMs) * 1000;
+        else if (now > deadlineUs) {
+            DXL_LOG_ERROR(table->ids[index], DXL_LOG_NONE, DXL_LOG_NONE, "Shared state slot stuck mid update for %d ms", timeoutMs);
+            return false;
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool DXLBusClient::getState(uint8_t id, DXLSharedServoState &state) const {
+    for (size_t i = 0; i < servoCount(); i++) {
+        if (table->ids[i] == id)    return servoAt(i, state);
+    }
+    return false;
+}
+
+uint64_t DXLBusClient::heartbeatAgeUs() const {
+    uint64_t beat = (table != 0) ? table->heartbeatUs.load(std::memory_order_acquire) : 0;
+    if (beat == 0)  return UINT64_MAX;                  // Not connected or no poll finished yet
+    uint64_t now = DXLBusStats::nowUs();
+    return (now > beat) ? now - beat : 0;
+}
+
+int DXLBusClient::request(uint8_t op, uint8_t id, uint16_t address, uint16_t length, const uint8_t *writeData, uint8_t *readData, uint8_t *error) {
+    if (error != 0)     *error = 0;
+    if (socketFd < 0)   return COMM_PORT_BUSY;
+    if (length > DXL_DAEMON_MAX_DATA)   return COMM_TX_ERROR;
+
+    std::lock_guard<std::mutex> guard(lock);
+    DXLDaemonRequest message;
+    message.token = nextToken++;
+    message.op = op;
+    message.id = id;
+    message.address = address;
+    message.length = length;
+    size_t size = DXL_DAEMON_REQUEST_HEADER;
+    if (op == DXL_DAEMON_WRITE) {
+        memcpy(message.data, writeData, length);
+        size += length;
+    }
+    if (send(socketFd, &message, size, MSG_NOSIGNAL) < 0)   return COMM_TX_FAIL;
+
+    DXLDaemonReply answer;
+    uint64_t deadline = DXLBusStats::nowUs() + uint64_t(timeoutMs) * 1000;
+    for (;;) {
+        uint64_t now = DXLBusStats::nowUs();
+        if (now >= deadline)    return COMM_RX_TIMEOUT;
+        pollfd fd;
+        fd.fd = socketFd, fd.events = POLLIN, fd.revents = 0;
+        int ready = ::poll(&fd, 1, int((deadline - now + 999) / 1000));
+        if (ready < 0 && errno == EINTR)    continue;
+        if (ready <= 0)     return COMM_RX_TIMEOUT;
+
+        ssize_t received = recv(socketFd, &answer, sizeof(answer), 0);
+        if (received <= 0)  return COMM_RX_FAIL;         // Daemon gone
+        if (size_t(received) < DXL_DAEMON_REPLY_HEADER || answer.token != message.token)    continue;     // Late reply to a request that timed out
+        break;
+    }
+
+    if (error != 0)     *error = answer.error;
+    if (op == DXL_DAEMON_READ && answer.commResult == COMM_SUCCESS && readData != 0)    memcpy(readData, answer.data, answer.length);
+    return answer.commResult;
+}
+
+////////////////////////////////////////////////////   DXLRemoteServo definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLRemoteServo::DXLRemoteServo(DXLBusClient *busClient, int id) : client(busClient) {
+    dxl_error = 0;
+    dxl_comm_result = COMM_NOT_AVAILABLE;
+    identity = id;
+    servoType = DXL_MX_64;
+    present_position = 0, present_temperature = 0;
+    present_current = 0.0;
+
+    DXLSharedServoState published;
+    if (client->getState(uint8_t(id), published))   servoType = published.servoType;
+    else    DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "ID not served by bus daemon");
+}
+
+bool DXLRemoteServo::state(DXLSharedServoState &out) {
+    if (!client->getState(uint8_t(identity), out)) {
+        dxl_comm_result = COMM_NOT_AVAILABLE;
+        return false;
+    }
+    dxl_comm_result = out.commResult;
+    dxl_error = out.error;
+    return out.updates > 0;
+}
+
+int DXLRemoteServo::readBlockTxRx(uint16_t address, uint16_t length, uint8_t *data) {
+    dxl_comm_result = client->request(DXL_DAEMON_READ, uint8_t(identity), address, length, 0, data, &dxl_error);
+    return dxl_comm_result;
+}
+
+int DXLRemoteServo::read1ByteTxRx(uint16_t address, uint8_t *data) {
+    return readBlockTxRx(address, 1, data);
+}
+
+int DXLRemoteServo::read2ByteTxRx(uint16_t address, uint16_t *data) {
+    uint8_t raw[2] = { 0, 0 };
+    readBlockTxRx(address, 2, raw);
+    if (dxl_comm_result == COMM_SUCCESS)    *data = DXL_MAKEWORD(raw[0], raw[1]);
+    return dxl_comm_result;
+}
+
+int DXLRemoteServo::read4ByteTxRx(uint16_t address, uint32_t *data) {
+    uint8_t raw[4] = { 0, 0, 0, 0 };
+    readBlockTxRx(address, 4, raw);
+    if (dxl_comm_result == COMM_SUCCESS)    *data = DXL_MAKEDWORD(DXL_MAKEWORD(raw[0], raw[1]), DXL_MAKEWORD(raw[2], raw[3]));
+    return dxl_comm_result;
+}
+
+int DXLRemoteServo::writeBlockTxRx(uint16_t address, uint16_t length, const uint8_t *data) {
+    dxl_comm_result = client->request(DXL_DAEMON_WRITE, uint8_t(identity), address, length, data, 0, &dxl_error);
+    return dxl_comm_result;
+}
+
+int DXLRemoteServo::write1ByteTxRx(uint16_t address, uint8_t data) {
+    return writeBlockTxRx(address, 1, &data);
+}
+
+int DXLRemoteServo::write2ByteTxRx(uint16_t address, uint16_t data) {
+    uint8_t raw[2] = { DXL_LOBYTE(data), DXL_HIBYTE(data) };
+    return writeBlockTxRx(address, 2, raw);
+}
+
+int DXLRemoteServo::write4ByteTxRx(uint16_t address, uint32_t data) {
+    uint8_t raw[4] = { DXL_LOBYTE(DXL_LOWORD(data)), DXL_HIBYTE(DXL_LOWORD(data)), DXL_LOBYTE(DXL_HIWORD(data)), DXL_HIBYTE(DXL_HIWORD(data)) };
+    return writeBlockTxRx(address, 4, raw);
+}
+
+int DXLRemoteServo::rebootTxRx() {
+    dxl_comm_result = client->request(DXL_DAEMON_REBOOT, uint8_t(identity), 0, 0, 0, 0, &dxl_error);
+    return dxl_comm_result;
+}
+
+int DXLRemoteServo::readCurrentPosition() {
+    DXLSharedServoState published;
+    if (state(published))   present_position = published.position;
+    return present_position;
+}
+
+double DXLRemoteServo::getPresentCurrent() {
+    DXLSharedServoState published;
+    if (state(published))   present_current = published.currentAmps;
+    return present_current;
+}
+
+int DXLRemoteServo::getPresentTemperature() {
+    DXLSharedServoState published;
+    if (state(published))   present_temperature = published.temperature;
+    return present_temperature;
+}
+
+bool DXLRemoteServo::isMoving() {
+    DXLSharedServoState published;
+    return state(published) && published.moving != 0;
+}
+
+DXLSharedServoState DXLRemoteServo::getState() {
+    DXLSharedServoState published;
+    memset(&published, 0, sizeof(published));
+    state(published);
+    return published;
+}
+
+bool DXLRemoteServo::waitForUpdate(uint64_t afterUs, int timeoutMs) {
+    uint64_t deadline = DXLBusStats::nowUs() + uint64_t(timeoutMs) * 1000;
+    DXLSharedServoState published;
+    while (DXLBusStats::nowUs() < deadline) {
+        if (state(published) && published.timeUs > afterUs)     return true;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return false;
+}
+
+void DXLRemoteServo::enableTorque() {
+    write1ByteTxRx((servoType == DXL_PRO_M42) ? ADDR_PRO_TORQUE_ENABLE : ADDR_MX_TORQUE_ENABLE, TORQUE_ENABLE);
+    if (dxl_comm_result != COMM_SUCCESS || (dxl_error & 0x7F) != 0)     DXL_LOG_ERROR(identity, DXL_LOG_NONE, dxl_comm_result, "Remote torque enable failed, error 0x%02X", dxl_error);
+}
+
+void DXLRemoteServo::disableTorque() {
+    write1ByteTxRx((servoType == DXL_PRO_M42) ? ADDR_PRO_TORQUE_ENABLE : ADDR_MX_TORQUE_ENABLE, TORQUE_DISABLE);
+    if (dxl_comm_result != COMM_SUCCESS || (dxl_error & 0x7F) != 0)     DXL_LOG_ERROR(identity, DXL_LOG_NONE, dxl_comm_result, "Remote torque disable failed, error 0x%02X", dxl_error);
+}
+
+DXLExpected<void> DXLRemoteServo::tryWriteGoalPosition(int position) {
+    uint16_t address = (servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION;
+    write4ByteTxRx(address, uint32_t(position));
+    if (dxl_comm_result != COMM_SUCCESS || (dxl_error & 0x7F) != 0)     return DXLExpected<void>(DXLError(dxl_comm_result, dxl_error, uint8_t(identity), address, 1));
+    return DXLExpected<void>();
+}
+
+void DXLRemoteServo::setLED(int color, int light) {
+    if (color < 0 || color > 3 || (color == 0) != (servoType == DXL_MX_64)) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Invalid LED selected for servo type!");
+        return;
+    }
+    if (light < 0) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Negative numbers not allowed!");
+        return;
+    }
+    int limit = (color == 0) ? 1 : 255;
+    uint16_t address = (color == 0) ? ADDR_MX_LED : uint16_t(ADDR_PRO_LED_RED + color - 1);
+    write1ByteTxRx(address, uint8_t((light > limit) ? limit : light));
+}
+
+void DXLRemoteServo::setPositionGain(int gainP, int gainI, int gainD, int gainF1, int gainF2) {
+    if (servoType == DXL_PRO_M42) {
+        write2ByteTxRx(ADDR_PRO_POSITION_P_GAIN, uint16_t(gainP));
+        return;
+    }
+    uint8_t low[6] = { DXL_LOBYTE(gainD), DXL_HIBYTE(gainD), DXL_LOBYTE(gainI), DXL_HIBYTE(gainI), DXL_LOBYTE(gainP), DXL_HIBYTE(gainP) };
+    uint8_t high[4] = { DXL_LOBYTE(gainF2), DXL_HIBYTE(gainF2), DXL_LOBYTE(gainF1), DXL_HIBYTE(gainF1) };
+    if (writeBlockTxRx(ADDR_MX_POSITION_D_GAIN, 6, low) == COMM_SUCCESS)    writeBlockTxRx(ADDR_MX_POSITION_FF2_GAIN, 4, high);
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLBusClient    ///////////////////////////////////////////////////////////////////////////
+    // Perception process: follows the pan servo without touching the serial port
+    DXLBusClient bus;
+    if (!bus.connect())     return 1;                   // dxlbusd not running
+    DXLRemoteServo pan(&bus, 1);
+
+    pan.enableTorque();
+    pan.tryWriteGoalPosition(2048);
+    pan.waitForUpdate(DXLBusStats::nowUs(), 100);      // Moving flag from a poll after the write
+    while (pan.isMoving()) {
+        DXLSharedServoState state = pan.getState();     // Shared memory copy, no request to the daemon
+        printf("pan %.2f deg, %.3f A, %llu us old\n", state.angleDeg, state.currentAmps, (unsigned long long)(DXLBusStats::nowUs() - state.timeUs));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+// End of Example Code
+*/
+
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Client side of DXLBusDaemon.
+
+DXLBusClient maps the daemon's shared table read only and connects to its command socket. State reads copy a servo slot
+out of shared memory: no system call, no serial traffic, consistent thanks to the slot's seqlock. Register
+reads/writes are one request/reply over the socket and run on the daemon's port thread.
+
+DXLRemoteServo mirrors the DXLServo calls other processes need, so code written against DXLServo ports over by swapping
+the type:
+    packet calls     read1/2/4ByteTxRx, readBlockTxRx, write1/2/4ByteTxRx, writeBlockTxRx, rebootTxRx: same return
+                     values, dxl_comm_result and dxl_error set as on DXLServo
+    present values   readCurrentPosition, getPresentCurrent, getPresentTemperature, isMoving: from the shared table,
+                     present_* members set as on DXLServo
+    settings         enableTorque, disableTorque, tryWriteGoalPosition, setLED, setPositionGain
+Linux only.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+
+#include <mutex>
+#include <string>
+#include <stdint.h>
+
+#include "DXLBusDaemon.h"
+
+#define DXL_CLIENT_TIMEOUT_MS           500             // Reply wait per request, covers the daemon's retries
+#define DXL_CLIENT_READ_SPINS           4096            // Failed seqlock reads of a slot before checking the daemon is alive
+
+class DXLBusClient {
+private:
+    const DXLSharedTable *table;
+    int shmFd, socketFd;
+    std::mutex lock;                                    // One request in flight per client
+    uint32_t nextToken;
+    int timeoutMs;
+
+public:
+    DXLBusClient();
+    ~DXLBusClient();
+    DXLBusClient(const DXLBusClient &) = delete;
+    DXLBusClient &operator=(const DXLBusClient &) = delete;
+
+    bool connect(const std::string &daemonName = DXL_DAEMON_DEFAULT_NAME);
+    void disconnect();
+    bool isConnected() const { return table != 0; }
+    bool daemonAlive() const;                           // Table still published by a running daemon
+    void setTimeout(int ms) { timeoutMs = ms; }
+
+    bool getState(uint8_t id, DXLSharedServoState &state) const;      // Latest published state, false if ID not served or daemon died mid update
+    uint64_t heartbeatAgeUs() const;                    // Time since the daemon's last poll
+    size_t servoCount() const;
+    bool servoAt(size_t index, DXLSharedServoState &state) const;
+
+    int request(uint8_t op, uint8_t id, uint16_t address, uint16_t length, const uint8_t *writeData, uint8_t *readData, uint8_t *error);    // COMM_* result
+};
+
+class DXLRemoteServo {
+private:
+    DXLBusClient *client;
+
+    bool state(DXLSharedServoState &out);               // Sets dxl_comm_result from the last poll
+
+public:
+    DXLRemoteServo(DXLBusClient *busClient, int id);    // servoType taken from the daemon's table
+
+    uint8_t dxl_error;
+    int dxl_comm_result, identity, servoType;
+    int present_position, present_temperature;
+    double present_current;
+
+    int read1ByteTxRx(uint16_t address, uint8_t *data);
+    int read2ByteTxRx(uint16_t address, uint16_t *data);
+    int read4ByteTxRx(uint16_t address, uint32_t *data);
+    int readBlockTxRx(uint16_t address, uint16_t length, uint8_t *data);
+    int write1ByteTxRx(uint16_t address, uint8_t data);
+    int write2ByteTxRx(uint16_t address, uint16_t data);
+    int write4ByteTxRx(uint16_t address, uint32_t data);
+    int writeBlockTxRx(uint16_t address, uint16_t length, const uint8_t *data);
+    int rebootTxRx();
+
+    int readCurrentPosition();                          // Raw position, no bus traffic
+    double getPresentCurrent();                         // Amps, no bus traffic
+    int getPresentTemperature();                        // No bus traffic
+    bool isMoving();                                    // No bus traffic
+    DXLSharedServoState getState();                     // Everything the daemon publishes, angle in degrees included
+    bool waitForUpdate(uint64_t afterUs, int timeoutMs);    // Until state read by the daemon after afterUs (DXLBusStats::nowUs()), false on timeout
+
+    void enableTorque();
+    void disableTorque();
+    DXLExpected<void> tryWriteGoalPosition(int position);   // Returns once written. isMoving() reflects the move after waitForUpdate().
+    void setLED(int color, int light);                  // As DXLServo::setLED()
+    void setPositionGain(int gainP, int gainI = 0, int gainD = 0, int gainF1 = 0, int gainF2 = 0);     // MX gains in two writes, as DXLServo
+};
+
+#endif
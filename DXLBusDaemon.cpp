@@ -0,0 +1,457 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Bus daemon. See DXLBusDaemon.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+
+#include "DXLBusDaemon.h"
+
+#include <chrono>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// Present value block per servo type, Moving through Present Temperature
+#define MX_STATE_BLOCK_START            ADDR_MX_REALTIME_TICK      // Tick along for clock sync, 2 bytes more per servo
+#define MX_STATE_BLOCK_LENGTH           (ADDR_MX_PRESENT_TEMPERATURE + 1 - ADDR_MX_REALTIME_TICK)
+#define PRO_STATE_BLOCK_START           ADDR_PRO_MOVING
+#define PRO_STATE_BLOCK_LENGTH          (ADDR_PRO_PRESENT_TEMPERATURE + 1 - ADDR_PRO_MOVING)
+
+static bool removeStaleTable(const std::string &shmName) {      // Table exists but its daemon is gone (crash, kill -9)
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0)     return false;
+    struct stat info;
+    bool stale = false;
+    if (fstat(fd, &info) == 0 && size_t(info.st_size) >= sizeof(DXLSharedTable)) {
+        void *mapped = mmap(0, sizeof(DXLSharedTable), PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED) {
+            const DXLSharedTable *old = static_cast<const DXLSharedTable *>(mapped);
+            stale = old->magic != DXL_DAEMON_MAGIC || (kill(old->daemonPid, 0) != 0 && errno == ESRCH);
+            munmap(mapped, sizeof(DXLSharedTable));
+        }
+    }
+    else {
+        stale = true;                                       // Died before sizing it
+    }
+    close(fd);
+    return stale && shm_unlink(shmName.c_str()) == 0;
+}
+
+////////////////////////////////////////////////////   DXLBusDaemon definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLBusDaemon::DXLBusDaemon(const std::string &daemonName) : name(daemonName) {
+    table = 0;
+    shmFd = -1, listenFd = -1, stopFd = -1;
+    running.store(false);
+    pollRateHz = 100.0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+DXLBusDaemon::~DXLBusDaemon() {
+    stop();
+}
+
+bool DXLBusDaemon::addServo(DXLServo *servo) {
+    if (running.load()) {
+        DXL_LOG_ERROR(servo->identity, DXL_LOG_NONE, DXL_LOG_NONE, "Daemon already running, servo not added");
+        return false;
+    }
+    if (servos.size() >= DXL_DAEMON_MAX_SERVOS) {
+        DXL_LOG_ERROR(servo->identity, DXL_LOG_NONE, DXL_LOG_NONE, "Daemon table full (%d servos)", DXL_DAEMON_MAX_SERVOS);
+        return false;
+    }
+    DXLServo *other;
+    if (portFor(uint8_t(servo->identity), &other) != 0) {
+        DXL_LOG_ERROR(servo->identity, DXL_LOG_NONE, DXL_LOG_NONE, "ID already served by daemon");
+        return false;
+    }
+
+    Port *port = 0;
+    for (size_t i = 0; i < ports.size(); i++) {
+        if (DXLTimeoutPort::underlying(ports[i]->portHandler) == DXLTimeoutPort::underlying(servo->prtHandler))   port = ports[i].get();    // Same bus, wrapped or not
+    }
+    if (port == 0) {
+        ports.push_back(std::unique_ptr<Port>(new Port()));
+        port = ports.back().get();
+        port->portHandler = servo->prtHandler;
+        port->packetHandler = servo->pktHandler;
+        port->bulkRead.reset(new dynamixel::GroupBulkRead(DXLTimeoutPort::underlying(servo->prtHandler), servo->pktHandler));     // Real port, shares its busy flag with wrapped servos
+    }
+    bool pro = (servo->servoType == DXL_PRO_M42);
+    port->bulkRead->addParam(uint8_t(servo->identity), pro ? PRO_STATE_BLOCK_START : MX_STATE_BLOCK_START, pro ? PRO_STATE_BLOCK_LENGTH : MX_STATE_BLOCK_LENGTH);
+    port->slots.push_back(servos.size());
+    servos.push_back(servo);
+    return true;
+}
+
+DXLBusDaemon::Port *DXLBusDaemon::portFor(uint8_t id, DXLServo **servo) {      // IDs are unique across ports, clients address by ID only
+    for (size_t p = 0; p < ports.size(); p++) {
+        for (size_t i = 0; i < ports[p]->slots.size(); i++) {
+            DXLServo *candidate = servos[ports[p]->slots[i]];
+            if (candidate->identity != id)  continue;
+            *servo = candidate;
+            return ports[p].get();
+        }
+    }
+    return 0;
+}
+
+bool DXLBusDaemon::start() {
+    if (running.load())     return true;
+
+    std::string shmName = sharedMemoryName();
+    shmFd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, DXL_DAEMON_ACCESS_MODE);       // Clients map read only
+    if (shmFd < 0 && errno == EEXIST && removeStaleTable(shmName)) {
+        DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Removed shared table %s left by a daemon that exited", shmName.c_str());
+        shmFd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, DXL_DAEMON_ACCESS_MODE);
+    }
+    if (shmFd < 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot create shared table %s: %s", shmName.c_str(), strerror(errno));
+        return false;
+    }
+    if (fchmod(shmFd, DXL_DAEMON_ACCESS_MODE) != 0 || ftruncate(shmFd, sizeof(DXLSharedTable)) != 0) {     // Exact mode whatever the umask
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot set up shared table: %s", strerror(errno));
+        stop();
+        return false;
+    }
+    void *mapped = mmap(0, sizeof(DXLSharedTable), PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    if (mapped == MAP_FAILED) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot map shared table: %s", strerror(errno));
+        stop();
+        return false;
+    }
+    table = static_cast<DXLSharedTable *>(mapped);          // Fresh object is zero filled, atomics start at 0
+    table->version = DXL_DAEMON_VERSION;
+    table->servoCount = uint32_t(servos.size());
+    table->daemonPid = int32_t(getpid());
+    for (size_t p = 0; p < ports.size(); p++) {
+        for (size_t i = 0; i < ports[p]->slots.size(); i++) {
+            size_t slot = ports[p]->slots[i];
+            DXLSharedServoState state;
+            memset(&state, 0, sizeof(state));
+            state.id = uint8_t(servos[slot]->identity);
+            state.port = uint8_t(p);
+            state.servoType = servos[slot]->servoType;
+            state.commResult = COMM_NOT_AVAILABLE;
+            table->ids[slot] = state.id;
+            table->slots[slot].write(state);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    table->magic = DXL_DAEMON_MAGIC;                        // Clients check last, table complete once set
+
+    std::string path = socketPath();
+    unlink(path.c_str());                                   // Shared table is the instance lock, a socket file here is stale
+    listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        chmod(path.c_str(), DXL_DAEMON_ACCESS_MODE) != 0 ||            // Before listen(): nobody can connect while the umask mode holds
+        ::listen(listenFd, DXL_DAEMON_MAX_CLIENTS) != 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot listen on %s: %s", path.c_str(), strerror(errno));
+        stop();
+        return false;
+    }
+    stopFd = eventfd(0, EFD_CLOEXEC);
+
+    running.store(true);
+    for (size_t p = 0; p < ports.size(); p++) {
+        Port *port = ports[p].get();
+        port->worker = std::thread([this, port]() { portLoop(port); });
+    }
+    listener = std::thread([this]() { socketLoop(); });
+    DXL_LOG_INFO(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Bus daemon serving %d servos on %d ports: %s, %s", int(servos.size()), int(ports.size()), shmName.c_str(), path.c_str());
+    return true;
+}
+
+void DXLBusDaemon::stop() {
+    bool wasRunning = running.exchange(false);
+    if (wasRunning) {
+        uint64_t one = 1;
+        if (write(stopFd, &one, sizeof(one)) < 0)   DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot wake socket thread");
+        for (size_t p = 0; p < ports.size(); p++) {
+            {
+                std::lock_guard<std::mutex> guard(ports[p]->lock);
+                ports[p]->commands.clear();
+            }
+            ports[p]->wake.notify_all();
+        }
+    }
+    if (listener.joinable())    listener.join();
+    for (size_t p = 0; p < ports.size(); p++) {
+        if (ports[p]->worker.joinable())    ports[p]->worker.join();
+    }
+
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath().c_str());
+        listenFd = -1;
+    }
+    if (stopFd >= 0) {
+        close(stopFd);
+        stopFd = -1;
+    }
+    if (table != 0) {
+        table->magic = 0;                                   // Clients still mapped see the daemon gone
+        munmap(table, sizeof(DXLSharedTable));
+        table = 0;
+    }
+    if (shmFd >= 0) {
+        close(shmFd);
+        shm_unlink(sharedMemoryName().c_str());
+        shmFd = -1;
+    }
+}
+
+void DXLBusDaemon::socketLoop() {
+    std::vector<std::shared_ptr<Client> > clients;
+    std::vector<pollfd> fds;
+
+    while (running.load()) {
+        fds.resize(2 + clients.size());
+        fds[0].fd = stopFd, fds[0].events = POLLIN, fds[0].revents = 0;
+        fds[1].fd = listenFd, fds[1].events = POLLIN, fds[1].revents = 0;
+        for (size_t i = 0; i < clients.size(); i++) {
+            fds[2 + i].fd = clients[i]->fd, fds[2 + i].events = POLLIN, fds[2 + i].revents = 0;
+        }
+        if (::poll(fds.data(), nfds_t(fds.size()), -1) < 0) {
+            if (errno == EINTR)     continue;
+            DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Daemon socket poll failed: %s", strerror(errno));
+            break;
+        }
+        if (fds[0].revents != 0)    break;
+
+        for (size_t i = clients.size(); i-- > 0;) {         // Back to front, hung up clients erased in place
+            short events = fds[2 + i].revents;
+            if (events & POLLIN)    serve(clients[i]);
+            if ((events & (POLLHUP | POLLERR | POLLNVAL)) || clients[i]->fd < 0) {
+                {
+                    std::lock_guard<std::mutex> guard(clients[i]->lock);
+                    if (clients[i]->fd >= 0)    close(clients[i]->fd);
+                    clients[i]->fd = -1;
+                }
+                clients.erase(clients.begin() + i);         // Queued commands still hold it
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd = accept4(listenFd, 0, 0, SOCK_CLOEXEC);
+            if (fd >= 0 && clients.size() >= DXL_DAEMON_MAX_CLIENTS) {
+                DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Client refused, %d clients connected", int(clients.size()));
+                close(fd);
+            }
+            else if (fd >= 0) {
+                std::shared_ptr<Client> client(new Client());
+                client->fd = fd;
+                clients.push_back(client);
+            }
+        }
+        std::lock_guard<std::mutex> guard(statsLock);
+        stats.clients = uint32_t(clients.size());
+    }
+
+    for (size_t i = 0; i < clients.size(); i++) {
+        std::lock_guard<std::mutex> guard(clients[i]->lock);
+        if (clients[i]->fd >= 0)    close(clients[i]->fd);
+        clients[i]->fd = -1;
+    }
+}
+
+void DXLBusDaemon::serve(const std::shared_ptr<Client> &client) {
+    Command command;
+    command.client = client;
+    ssize_t received = recv(client->fd, &command.request, sizeof(command.request), 0);
+    if (received <= 0) {                                    // Orderly shutdown by client
+        std::lock_guard<std::mutex> guard(client->lock);
+        close(client->fd);
+        client->fd = -1;
+        return;
+    }
+
+    const DXLDaemonRequest &request = command.request;
+    Port *port = 0;
+    bool valid = size_t(received) >= DXL_DAEMON_REQUEST_HEADER && request.length <= DXL_DAEMON_MAX_DATA
+        && (request.op != DXL_DAEMON_WRITE || size_t(received) >= DXL_DAEMON_REQUEST_HEADER + request.length)
+        && (request.op == DXL_DAEMON_READ || request.op == DXL_DAEMON_WRITE || request.op == DXL_DAEMON_REBOOT);
+    if (valid)  port = portFor(request.id, &command.servo);
+
+    if (port == 0) {
+        DXLDaemonReply message;
+        message.token = (size_t(received) >= sizeof(uint32_t)) ? request.token : 0;
+        message.commResult = COMM_NOT_AVAILABLE;
+        message.error = 0;
+        message.length = 0;
+        reply(client, message);
+        std::lock_guard<std::mutex> guard(statsLock);
+        stats.rejected++;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(port->lock);
+        port->commands.push_back(command);
+    }
+    port->wake.notify_one();
+}
+
+void DXLBusDaemon::reply(const std::shared_ptr<Client> &client, const DXLDaemonReply &message) {
+    std::lock_guard<std::mutex> guard(client->lock);
+    if (client->fd < 0)     return;                         // Hung up while command was queued
+    if (send(client->fd, &message, DXL_DAEMON_REPLY_HEADER + message.length, MSG_NOSIGNAL) < 0) {
+        DXL_LOG_DEBUG(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Reply to client dropped: %s", strerror(errno));
+    }
+}
+
+void DXLBusDaemon::portLoop(Port *port) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point nextPoll = Clock::now();
+
+    while (running.load()) {
+        std::unique_lock<std::mutex> guard(port->lock);
+        port->wake.wait_until(guard, nextPoll, [&]() { return !running.load() || !port->commands.empty(); });
+        if (!running.load())    break;
+
+        if (!port->commands.empty()) {                      // Commands first, poll when queue is empty or due
+            Command command = port->commands.front();
+            port->commands.pop_front();
+            guard.unlock();
+            execute(command);
+            if (Clock::now() < nextPoll)    continue;
+        }
+        else {
+            guard.unlock();
+        }
+
+        pollPort(port);
+        if (pollRateHz > 0.0) {
+            nextPoll += std::chrono::microseconds(int64_t(1e6 / pollRateHz));
+            if (nextPoll < Clock::now())    nextPoll = Clock::now();    // Fell behind, do not burst
+        }
+        else {
+            nextPoll = Clock::now();
+        }
+    }
+}
+
+void DXLBusDaemon::execute(Command &command) {
+    const DXLDaemonRequest &request = command.request;
+    DXLServo *servo = command.servo;
+    DXLDaemonReply message;
+    message.token = request.token;
+    message.length = 0;
+
+    int result;
+    if (request.op == DXL_DAEMON_READ) {
+        result = servo->readBlockTxRx(request.address, request.length, message.data);
+        if (result == COMM_SUCCESS)     message.length = request.length;
+    }
+    else if (request.op == DXL_DAEMON_WRITE) {
+        result = servo->writeBlockTxRx(request.address, request.length, request.data);
+    }
+    else {
+        result = servo->rebootTxRx();
+    }
+    message.commResult = result;
+    message.error = servo->dxl_error;
+    reply(command.client, message);
+
+    std::lock_guard<std::mutex> guard(statsLock);
+    stats.commands++;
+    if (result != COMM_SUCCESS || (message.error & 0x7F) != 0)  stats.commandFailures++;
+}
+
+void DXLBusDaemon::pollPort(Port *port) {
+    DXLServo *first = servos[port->slots[0]];
+    int result;
+    uint64_t txUs = 0, rxUs = 0;
+    auto bulkRead = [&]() {                             // Stamped inside the job, queueing time is not bus latency
+        txUs = DXLBusStats::nowUs();
+        int r = port->bulkRead->txRxPacket();
+        rxUs = DXLBusStats::nowUs();
+        return r;
+    };
+    if (first->getBusScheduler() != 0)  result = first->getBusScheduler()->runSync(DXL_PRIO_TELEMETRY, bulkRead);
+    else                                result = bulkRead();
+
+    uint64_t now = DXLBusStats::nowUs();
+    bool failed = false;
+    uint8_t block[MX_STATE_BLOCK_LENGTH > PRO_STATE_BLOCK_LENGTH ? MX_STATE_BLOCK_LENGTH : PRO_STATE_BLOCK_LENGTH];
+    for (size_t i = 0; i < port->slots.size(); i++) {
+        size_t slot = port->slots[i];
+        DXLServo *servo = servos[slot];
+        DXLSharedServoState state = table->slots[slot].read();     // Only this thread writes the slot
+        uint8_t id = uint8_t(servo->identity);
+        bool pro = (servo->servoType == DXL_PRO_M42);
+        uint16_t start = pro ? PRO_STATE_BLOCK_START : MX_STATE_BLOCK_START;
+        uint16_t length = pro ? PRO_STATE_BLOCK_LENGTH : MX_STATE_BLOCK_LENGTH;
+
+        state.commResult = result;
+        if (!port->bulkRead->isAvailable(id, start, length)) {
+            if (state.commResult == COMM_SUCCESS)   state.commResult = COMM_RX_FAIL;
+            state.failures++;
+            failed = true;
+            table->slots[slot].write(state);
+            continue;
+        }
+        for (uint16_t b = 0; b < length; b++)   block[b] = uint8_t(port->bulkRead->getData(id, uint16_t(start + b), 1));     // Local copy, no bus traffic
+        servo->publishState(start, length, block, txUs, rxUs);      // Daemon's own threads see it through getState() too
+        DXLServoState present = servo->getState();
+
+        state.error = 0;                                    // Bulk read does not keep the status error byte
+        state.moving = present.moving;
+        state.movingStatus = pro ? 0 : block[ADDR_MX_MOVING_STATUS - MX_STATE_BLOCK_START];
+        state.position = present.position;
+        state.velocity = present.velocity;
+        state.current = present.current;
+        state.temperature = present.temperature;
+        state.angleDeg = servo->convertValtoPos(state.position);
+        state.currentAmps = servo->convertValtoCurr(state.current);
+        state.timeUs = present.timeUs;
+        state.updates++;
+        table->slots[slot].write(state);
+    }
+    table->heartbeatUs.store(now, std::memory_order_release);
+
+    std::lock_guard<std::mutex> guard(statsLock);
+    stats.polls++;
+    if (failed)     stats.pollFailures++;
+}
+
+DXLDaemonStats DXLBusDaemon::getStats() const {
+    std::lock_guard<std::mutex> guard(statsLock);
+    return stats;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLBusDaemon    ///////////////////////////////////////////////////////////////////////////
+    // dxlbusd: owns both ports, everything else connects with DXLBusClient
+    #include <csignal>
+    static volatile sig_atomic_t quit = 0;
+
+    int main() {
+        DXLServo panServo, tiltServo;
+        // ID, device name, servo type, port and packet handlers, baud rate set up as in DXLProServo.cpp example
+
+        DXLBusDaemon daemon;
+        daemon.addServo(&panServo);
+        daemon.addServo(&tiltServo);
+        daemon.setPollRate(200.0);
+        if (!daemon.start())    return 1;
+
+        signal(SIGINT, [](int) { quit = 1; });
+        signal(SIGTERM, [](int) { quit = 1; });
+        while (!quit)   sleep(1);
+        daemon.stop();
+        return 0;
+    }
+// End of Example Code
+*/
+
+#endif
@@ -0,0 +1,157 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Bus daemon: one process owns the serial ports, any number of local processes share the servos.
+
+State: every poll the daemon reads the present values of all servos on a port with one GroupBulkRead and publishes them
+in a shared memory table (shm_open, "/<name>"). Each servo slot is a DXLSeqlock, so clients copy a consistent state
+without locks or system calls and without any serial traffic. The values also go to the servo's own getState().
+    MX:  Realtime Tick - Present Temperature (120 - 146), the tick keeps the servo clock sync current
+    Pro: Moving - Present Temperature (610 - 625)
+Commands: clients send register reads/writes over a Unix SOCK_SEQPACKET socket ("/tmp/<name>.sock"), one request per
+message. Each port has its own worker thread that runs commands ahead of the next poll, so a goal write waits for at most
+one transaction already on the bus. Commands go through DXLServo packet calls (retries, stats, bus scheduler).
+Access: table and socket are created DXL_DAEMON_ACCESS_MODE (owner and the daemon's group), so only clients running as the
+daemon's user or in its group can see state or move servos. Run the daemon under a dedicated group to share it.
+
+Client side in DXLBusClient.h. Linux only.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+#define DXL_DAEMON_MAGIC                0x444C5844      // "DXLD"
+#define DXL_DAEMON_VERSION              2
+#define DXL_DAEMON_MAX_SERVOS           64
+#define DXL_DAEMON_MAX_DATA             128             // Register bytes per request
+#define DXL_DAEMON_DEFAULT_NAME         "dxlbusd"
+#define DXL_DAEMON_MAX_CLIENTS          32
+#define DXL_DAEMON_ACCESS_MODE          0660            // Shared table and command socket, no access for other users
+
+enum DXLDaemonOp {
+    DXL_DAEMON_READ = 1,
+    DXL_DAEMON_WRITE,
+    DXL_DAEMON_REBOOT
+};
+
+struct DXLSharedServoState {                            // Published per servo, plain data
+    uint8_t id, port;                                   // port: index in order ports were first seen by addServo()
+    uint8_t moving, movingStatus;                       // movingStatus MX only
+    int32_t servoType;
+    int32_t position, velocity, current, temperature;   // Raw register values
+    double angleDeg, currentAmps;                       // convertValtoPos(), convertValtoCurr() of the daemon's DXLServo
+    int32_t commResult;                                 // COMM_* of the last poll
+    uint8_t error;                                      // Reserved, bulk read status error byte not available
+    uint64_t timeUs;                                    // DXLBusStats::nowUs() of the last good read, CLOCK_MONOTONIC so valid across processes
+    uint64_t updates, failures;
+};
+
+struct DXLSharedTable {
+    uint32_t magic, version;
+    uint32_t servoCount;
+    int32_t daemonPid;
+    std::atomic<uint64_t> heartbeatUs;                  // Last finished poll of any port
+    uint8_t ids[DXL_DAEMON_MAX_SERVOS];                 // Servo ID per slot, fixed before magic is set
+    DXLSeqlock<DXLSharedServoState> slots[DXL_DAEMON_MAX_SERVOS];
+};
+
+struct DXLDaemonRequest {
+    uint32_t token;                                     // Echoed in reply
+    uint8_t op;                                         // DXLDaemonOp
+    uint8_t id;
+    uint16_t address, length;
+    uint8_t data[DXL_DAEMON_MAX_DATA];                  // Write data, only length bytes sent
+};
+
+struct DXLDaemonReply {
+    uint32_t token;
+    int32_t commResult;
+    uint8_t error;
+    uint16_t length;
+    uint8_t data[DXL_DAEMON_MAX_DATA];                  // Read data, only length bytes sent
+};
+
+#define DXL_DAEMON_REQUEST_HEADER       offsetof(DXLDaemonRequest, data)       // Bytes sent ahead of data
+#define DXL_DAEMON_REPLY_HEADER         offsetof(DXLDaemonReply, data)
+
+struct DXLDaemonStats {
+    uint64_t polls, pollFailures;
+    uint64_t commands, commandFailures, rejected;       // rejected: unknown ID or malformed request
+    uint32_t clients;
+};
+
+class DXLBusDaemon {
+private:
+    struct Client {
+        std::mutex lock;
+        int fd;                                         // -1 once hung up, queued commands then drop their reply
+    };
+
+    struct Command {
+        std::shared_ptr<Client> client;
+        DXLServo *servo;
+        DXLDaemonRequest request;
+    };
+
+    struct Port {
+        dynamixel::PortHandler *portHandler;
+        dynamixel::PacketHandler *packetHandler;
+        std::vector<size_t> slots;                      // Index into servos/shared table
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<Command> commands;
+        std::unique_ptr<dynamixel::GroupBulkRead> bulkRead;    // Present values of every servo on the port
+        std::thread worker;
+    };
+
+    std::string name;
+    std::vector<DXLServo *> servos;                     // Same index as shared slots
+    std::vector<std::unique_ptr<Port> > ports;
+    DXLSharedTable *table;
+    int shmFd, listenFd, stopFd;                        // stopFd: eventfd that wakes the socket thread
+    std::thread listener;
+    std::atomic<bool> running;
+    double pollRateHz;
+
+    mutable std::mutex statsLock;
+    DXLDaemonStats stats;
+
+    Port *portFor(uint8_t id, DXLServo **servo);
+    void socketLoop();
+    void serve(const std::shared_ptr<Client> &client);  // Read one request, queue it or reject it
+    void reply(const std::shared_ptr<Client> &client, const DXLDaemonReply &message);
+    void portLoop(Port *port);
+    void execute(Command &command);
+    void pollPort(Port *port);
+
+public:
+    explicit DXLBusDaemon(const std::string &daemonName = DXL_DAEMON_DEFAULT_NAME);
+    ~DXLBusDaemon();
+    DXLBusDaemon(const DXLBusDaemon &) = delete;
+    DXLBusDaemon &operator=(const DXLBusDaemon &) = delete;
+
+    bool addServo(DXLServo *servo);                     // Before start(). Port already initialised, Protocol 2.0.
+    void setPollRate(double hz) { pollRateHz = hz; }    // Per port, default 100 Hz. 0: poll back to back.
+
+    bool start();                                       // Create shared table and socket, start threads. false if either exists already or cannot be created.
+    void stop();                                        // Join threads, remove shared table and socket
+    bool isRunning() const { return running.load(); }
+
+    DXLDaemonStats getStats() const;
+    std::string sharedMemoryName() const { return "/" + name; }
+    std::string socketPath() const { return "/tmp/" + name + ".sock"; }
+};
+
+#endif
@@ -0,0 +1,225 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Priority bus scheduler. See DXLBusScheduler.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLBusScheduler.h"
+
+#include <chrono>
+
+#include "DXLBusStats.h"
+
+////////////////////////////////////////////////////   DXLBusScheduler class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLBusScheduler::DXLBusScheduler() {
+    for (int p = 0; p < DXL_PRIO_CLASSES; p++) {
+        stats[p].jobs = 0;
+        stats[p].deadlineMisses = 0;
+        stats[p].heldBack = 0;
+        stats[p].maxWaitUs = 0;
+        stats[p].averageUs = 0.0;
+    }
+    nextSequence = 0;
+    workerId.store(std::thread::id(), std::memory_order_relaxed);
+    running = false;
+    stopping = false;
+}
+
+DXLBusScheduler::~DXLBusScheduler() {
+    stop();
+}
+
+void DXLBusScheduler::start() {
+    std::lock_guard<std::mutex> guard(lock);
+    if (running)    return;
+    stopping = false;
+    running = true;
+    worker = std::thread(&DXLBusScheduler::workerLoop, this);
+}
+
+void DXLBusScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!running)   return;
+        stopping = true;
+        reservations.clear();                           // Nothing left to wait for
+    }
+    wake.notify_all();
+    if (worker.joinable())  worker.join();
+    std::lock_guard<std::mutex> guard(lock);
+    running = false;
+}
+
+void DXLBusScheduler::submit(const DXLBusJob &job) {
+    bool needStart;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        int priority = (job.priority < 0) ? 0 : (job.priority >= DXL_PRIO_CLASSES) ? DXL_PRIO_CLASSES - 1 : job.priority;
+        queues[priority].push_back(job);
+        queues[priority].back().priority = priority;
+        queues[priority].back().sequence = nextSequence++;
+        queues[priority].back().submitUs = DXLBusStats::nowUs();
+        needStart = !running;
+    }
+    if (needStart)  start();
+    wake.notify_one();
+}
+
+int DXLBusScheduler::runSync(int priority, const std::function<int()> &run, uint32_t estimateUs, uint64_t deadlineUs) {
+    if (onWorkerThread())   return run();           // Already own the bus, e.g. nested call from a job
+
+    std::mutex doneLock;
+    std::condition_variable doneWake;
+    bool finished = false;
+    int result = 0;
+
+    DXLBusJob job;
+    job.run = run;
+    job.priority = priority;
+    job.estimateUs = estimateUs;
+    job.deadlineUs = deadlineUs;
+    job.done = [&](int r) {
+        std::lock_guard<std::mutex> guard(doneLock);
+        result = r;
+        finished = true;
+        doneWake.notify_one();
+    };
+    submit(job);
+
+    std::unique_lock<std::mutex> guard(doneLock);
+    doneWake.wait(guard, [&] { return finished; });
+    return result;
+}
+
+void DXLBusScheduler::announce(uint64_t releaseUs, uint32_t durationUs) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        Reservation reservation;
+        reservation.releaseUs = releaseUs;
+        reservation.durationUs = durationUs;
+        reservations.push_back(reservation);
+    }
+    wake.notify_one();
+}
+
+bool DXLBusScheduler::pick(uint64_t nowUs, DXLBusJob &job, uint64_t &waitUntilUs) {
+    waitUntilUs = 0;
+    for (size_t r = 0; r < reservations.size();) {     // Announced setpoint never came
+        if (nowUs > reservations[r].releaseUs + DXL_SCHED_RESERVATION_GRACE_US)     reservations.erase(reservations.begin() + r);
+        else    r++;
+    }
+
+    for (int p = 0; p < DXL_PRIO_CLASSES; p++) {
+        std::deque<DXLBusJob> &queue = queues[p];
+        if (queue.empty())  continue;
+
+        size_t best = 0;                                // Earliest deadline first, no deadline after all deadlines, FIFO otherwise
+        for (size_t i = 1; i < queue.size(); i++) {
+            uint64_t a = queue[i].deadlineUs, b = queue[best].deadlineUs;
+            if (a != 0 && (b == 0 || a < b))    best = i;
+        }
+
+        if (p > DXL_PRIO_CONTROL) {
+            double estimate = queue[best].estimateUs ? double(queue[best].estimateUs) : (stats[p].averageUs > 0.0 ? stats[p].averageUs : 1000.0);
+            uint64_t blockedUntil = 0;
+            for (size_t r = 0; r < reservations.size(); r++) {
+                if (double(nowUs) + estimate > double(reservations[r].releaseUs)) {       // Would still be on the bus when setpoint arrives
+                    uint64_t until = reservations[r].releaseUs + DXL_SCHED_RESERVATION_GRACE_US;
+                    if (blockedUntil == 0 || until < blockedUntil)   blockedUntil = until;
+                }
+            }
+            if (blockedUntil != 0) {
+                stats[p].heldBack++;
+                if (waitUntilUs == 0 || blockedUntil < waitUntilUs)     waitUntilUs = blockedUntil;
+                continue;                               // A shorter job of a lower class may still fit
+            }
+        }
+        else if (!reservations.empty()) {               // Setpoint arrived, release earliest reservation
+            size_t earliest = 0;
+            for (size_t r = 1; r < reservations.size(); r++) {
+                if (reservations[r].releaseUs < reservations[earliest].releaseUs)     earliest = r;
+            }
+            if (p == DXL_PRIO_CONTROL && reservations[earliest].releaseUs <= nowUs + reservations[earliest].durationUs)  reservations.erase(reservations.begin() + earliest);
+        }
+
+        job = queue[best];
+        queue.erase(queue.begin() + best);
+        return true;
+    }
+    return false;
+}
+
+void DXLBusScheduler::workerLoop() {
+    workerId.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+        uint64_t now = DXLBusStats::nowUs();
+        DXLBusJob job;
+        uint64_t waitUntilUs;
+        if (pick(now, job, waitUntilUs)) {
+            guard.unlock();
+            uint64_t start = DXLBusStats::nowUs();
+            int result = job.run();
+            uint64_t end = DXLBusStats::nowUs();
+            if (job.done)   job.done(result);
+            guard.lock();
+
+            DXLBusClassStats &s = stats[job.priority];
+            s.jobs++;
+            if (job.deadlineUs != 0 && start > job.deadlineUs)  s.deadlineMisses++;
+            uint64_t waited = (start > job.submitUs) ? start - job.submitUs : 0;
+            if (waited > s.maxWaitUs)   s.maxWaitUs = uint32_t(waited);
+            double elapsed = double(end - start);
+            s.averageUs = (s.jobs == 1) ? elapsed : 0.9 * s.averageUs + 0.1 * elapsed;
+            continue;
+        }
+
+        if (stopping) {
+            bool empty = true;
+            for (int p = 0; p < DXL_PRIO_CLASSES; p++)  empty = empty && queues[p].empty();
+            if (empty)  break;
+        }
+        if (waitUntilUs != 0)   wake.wait_for(guard, std::chrono::microseconds(waitUntilUs > now ? waitUntilUs - now : 0));
+        else                    wake.wait(guard);
+    }
+    workerId.store(std::thread::id(), std::memory_order_relaxed);
+}
+
+DXLBusClassStats DXLBusScheduler::getStats(int priority) {
+    std::lock_guard<std::mutex> guard(lock);
+    return stats[(priority < 0 || priority >= DXL_PRIO_CLASSES) ? DXL_PRIO_CONFIG : priority];
+}
+
+size_t DXLBusScheduler::pending() {
+    std::lock_guard<std::mutex> guard(lock);
+    size_t count = 0;
+    for (int p = 0; p < DXL_PRIO_CLASSES; p++)  count += queues[p].size();
+    return count;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLBusScheduler    ///////////////////////////////////////////////////////////////////////////
+    DXLBusScheduler bus;
+    panServo.setBusScheduler(&bus);
+    tiltServo.setBusScheduler(&bus);
+
+    std::thread diagnostics([&]() {                     // Gain dump no longer delays the tracking loop: each register read is its own job
+        const uint16_t gainAddress[3] = { ADDR_MX_POSITION_D_GAIN, ADDR_MX_POSITION_I_GAIN, ADDR_MX_POSITION_P_GAIN };
+        for (;;) {                                      // try*() calls: results come back with the job, the tracking loop's cannot mix in
+            for (int g = 0; g < 3; g++) {
+                DXLExpected<uint32_t> gain = tiltServo.tryRead(gainAddress[g], 2);
+                if (!gain)  printf("%s\n", gain.error().describe().c_str());
+            }
+        }
+    });
+
+    uint64_t next = DXLBusStats::nowUs();
+    for (int x = 0; x < 1000; x++) {                    // 100 Hz tracking loop
+        next += 10000;
+        bus.announce(next, 2000);                       // Keep bus free for next goal write
+        tiltServo.tryWriteGoalPosition(trajectory[x]);
+        std::this_thread::sleep_until(...next...);
+    }
+    DXLBusClassStats control = bus.getStats(DXL_PRIO_CONTROL);
+    printf("control: %llu writes, max wait %u us, %llu late\n", (unsigned long long)control.jobs, control.maxWaitUs, (unsigned long long)control.deadlineMisses);
+// End of Example Code
+*/
@@ -0,0 +1,93 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Priority bus scheduler (bus executor). One per port, one worker thread owns the bus and runs jobs one transaction at a time.
+
+Priority classes, highest first: emergency > control setpoints > telemetry > configuration/diagnostics.
+- Preemption at transaction boundaries: after every job the highest priority ready job runs next, so a long diagnostic
+  dump split into single-register jobs delays a goal write by at most one transaction.
+- Within a class, earliest deadline first, then submission order.
+- Deadline-aware admission: control loops announce() their next setpoint. A lower priority job is only started if its
+  estimated bus time ends before that release, otherwise the bus is held idle for the setpoint.
+- Job time estimate: given by submitter, else running average of the class.
+
+DXLServo::setBusScheduler() routes all packet calls of a servo through here. Any callable can also be submitted. Several
+threads may share one servo through try*() calls, which return their own job's result; the calls reporting through
+dxl_comm_result/dxl_error stay one thread per servo.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+#define DXL_SCHED_RESERVATION_GRACE_US      2000        // Announced setpoint not submitted this long after release: reservation dropped
+
+enum DXLBusPriority {
+    DXL_PRIO_EMERGENCY = 0,                             // Torque off, stop. Never held back.
+    DXL_PRIO_CONTROL,                                   // Goal/profile/torque setpoint writes
+    DXL_PRIO_TELEMETRY,                                 // Present values, moving, hardware error status
+    DXL_PRIO_CONFIG,                                    // EEPROM, RAM setting reads (gains, limits), diagnostics
+    DXL_PRIO_CLASSES
+};
+
+struct DXLBusJob {
+    std::function<int()> run;                           // One bus transaction (or short sequence), returns COMM_* result
+    std::function<void(int)> done;                      // Called on worker thread with run() result, may be empty
+    int priority;
+    uint64_t deadlineUs;                                // Latest start time (DXLBusStats::nowUs()), 0 none
+    uint32_t estimateUs;                                // Expected bus time, 0 use class average
+    uint64_t sequence, submitUs;                        // Set by scheduler
+
+    DXLBusJob() : priority(DXL_PRIO_CONFIG), deadlineUs(0), estimateUs(0), sequence(0), submitUs(0) {}
+};
+
+struct DXLBusClassStats {
+    uint64_t jobs;                                      // Jobs run
+    uint64_t deadlineMisses;                            // Started after deadline
+    uint64_t heldBack;                                  // Times job waited for an announced setpoint
+    uint32_t maxWaitUs;                                 // Longest submit-to-start time
+    double averageUs;                                   // Average run time, used as estimate
+};
+
+class DXLBusScheduler {
+private:
+    struct Reservation {
+        uint64_t releaseUs;
+        uint32_t durationUs;
+    };
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<DXLBusJob> queues[DXL_PRIO_CLASSES];
+    std::vector<Reservation> reservations;
+    DXLBusClassStats stats[DXL_PRIO_CLASSES];
+    uint64_t nextSequence;
+    bool running, stopping;
+    std::thread worker;
+    std::atomic<std::thread::id> workerId;
+
+    bool pick(uint64_t nowUs, DXLBusJob &job, uint64_t &waitUntilUs);     // Caller holds lock. false: nothing admissible, sleep until waitUntilUs (0 = until notified)
+    void workerLoop();
+
+public:
+    DXLBusScheduler();
+    ~DXLBusScheduler();
+    DXLBusScheduler(const DXLBusScheduler &) = delete;
+    DXLBusScheduler &operator=(const DXLBusScheduler &) = delete;
+
+    void start();                                       // Start worker thread, called by first submit() if not yet running
+    void stop();                                        // Run queued jobs and join worker
+
+    void submit(const DXLBusJob &job);                  // Queue job, returns at once
+    int runSync(int priority, const std::function<int()> &run, uint32_t estimateUs = 0, uint64_t deadlineUs = 0);      // Queue and wait for result. Runs inline if called on worker thread.
+    void announce(uint64_t releaseUs, uint32_t durationUs);     // Control setpoint of about durationUs expected at releaseUs, keep bus free for it
+
+    bool onWorkerThread() const { return workerId.load(std::memory_order_relaxed) == std::this_thread::get_id(); }
+    DXLBusClassStats getStats(int priority);
+    size_t pending();
+};
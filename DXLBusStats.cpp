@@ -0,0 +1,219 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Bus statistics for DXLServo packet calls. See DXLBusStats.h.
+
+Slots are claimed with compare-exchange on first use of a key (open addressing, linear probing), never released until process exit.
+reset() zeroes counters but keeps keys so pointers into the table stay valid for concurrent recorders.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLBusStats.h"
+
+#include <chrono>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+
+////////////////////////////////////////////////////   DXLLatencySnapshot   /////////////////////////////////////////////////////////////////////////////////////////
+
+double DXLLatencySnapshot::mean() const {
+    if (count == 0)     return 0.0;
+    return double(totalUs) / double(count);
+}
+
+double DXLLatencySnapshot::percentile(double p) const {
+    if (count == 0 || buckets.empty())  return 0.0;
+    if (p < 0.0)    p = 0.0;
+    if (p > 100.0)  p = 100.0;
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < buckets.size(); i++)     total += buckets[i];     // Bucket sum may lag count slightly while recording
+    if (total == 0)     return 0.0;
+
+    uint64_t rank = uint64_t((p / 100.0) * double(total) + 0.5);
+    if (rank == 0)  rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = DXLBusStats::bucketUpperBound(int(i));
+            return double(upper < maxUs ? upper : maxUs);
+        }
+    }
+    return double(maxUs);
+}
+
+////////////////////////////////////////////////////   DXLBusStats class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLBusStats::DXLBusStats() {
+    enabled.store(false, std::memory_order_relaxed);
+    for (int i = 0; i <= DXL_STATS_MAX_KEYS; i++) {
+        slots[i].key.store(0, std::memory_order_relaxed);
+    }
+    slots[DXL_STATS_MAX_KEYS].key.store(DXL_STATS_OVERFLOW_KEY, std::memory_order_relaxed);
+    reset();
+}
+
+DXLBusStats &DXLBusStats::instance() {
+    static DXLBusStats stats;
+    return stats;
+}
+
+uint64_t DXLBusStats::nowUs() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+int DXLBusStats::bucketIndex(uint32_t us) {
+    const uint32_t linear = 1u << (DXL_STATS_SUB_BITS + 1);        // Values below 16us get one bucket each
+    if (us < linear)    return int(us);
+
+    int exponent;
+#if defined(__GNUC__) || defined(__clang__)
+    exponent = 31 - __builtin_clz(us);
+#else
+    exponent = 0;
+    for (uint32_t v = us; v > 1; v >>= 1)   exponent++;
+#endif
+    int sub = int((us >> (exponent - DXL_STATS_SUB_BITS)) & ((1u << DXL_STATS_SUB_BITS) - 1));
+    return int(linear) + (exponent - DXL_STATS_SUB_BITS - 1) * (1 << DXL_STATS_SUB_BITS) + sub;
+}
+
+uint32_t DXLBusStats::bucketUpperBound(int index) {
+    const int linear = 1 << (DXL_STATS_SUB_BITS + 1);
+    if (index < linear)     return uint32_t(index);
+
+    int exponent = (index - linear) / (1 << DXL_STATS_SUB_BITS) + DXL_STATS_SUB_BITS + 1;
+    int sub = (index - linear) % (1 << DXL_STATS_SUB_BITS);
+    uint64_t width = uint64_t(1) << (exponent - DXL_STATS_SUB_BITS);
+    uint64_t lower = (uint64_t(1) << exponent) + uint64_t(sub) * width;
+    return uint32_t(lower + width - 1);
+}
+
+int DXLBusStats::commIndex(int commResult) {
+    switch (commResult) {
+    case COMM_SUCCESS:          return 0;
+    case COMM_PORT_BUSY:        return 1;
+    case COMM_TX_FAIL:          return 2;
+    case COMM_RX_FAIL:          return 3;
+    case COMM_TX_ERROR:         return 4;
+    case COMM_RX_WAITING:       return 5;
+    case COMM_RX_TIMEOUT:       return 6;
+    case COMM_RX_CORRUPT:       return 7;
+    case COMM_NOT_AVAILABLE:    return 8;
+    default:                    return 9;
+    }
+}
+
+DXLBusStats::Slot &DXLBusStats::findSlot(uint32_t key) {
+    uint32_t hash = key * 2654435761u;                  // Knuth multiplicative hash, IDs and addresses cluster in low bits
+    uint32_t start = (hash >> 16) & (DXL_STATS_MAX_KEYS - 1);
+    for (uint32_t probe = 0; probe < DXL_STATS_MAX_KEYS; probe++) {
+        Slot &slot = slots[(start + probe) & (DXL_STATS_MAX_KEYS - 1)];
+        uint32_t current = slot.key.load(std::memory_order_acquire);
+        if (current == key)     return slot;
+        if (current == 0) {
+            uint32_t expected = 0;
+            if (slot.key.compare_exchange_strong(expected, key, std::memory_order_acq_rel))     return slot;
+            if (expected == key)    return slot;    // Another thread claimed it for the same key
+        }
+    }
+    return slots[DXL_STATS_MAX_KEYS];                   // Table full
+}
+
+void DXLBusStats::record(uint8_t id, uint8_t instruction, uint16_t address, uint32_t latencyUs, int commResult, uint8_t error) {
+    uint32_t key = (uint32_t(id) << 24) | (uint32_t(instruction) << 16) | uint32_t(address);
+    Slot &slot = findSlot(key);
+
+    slot.count.fetch_add(1, std::memory_order_relaxed);
+    slot.totalUs.fetch_add(latencyUs, std::memory_order_relaxed);
+    slot.buckets[bucketIndex(latencyUs)].fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t seen = slot.minUs.load(std::memory_order_relaxed);
+    while (latencyUs < seen && !slot.minUs.compare_exchange_weak(seen, latencyUs, std::memory_order_relaxed)) {}
+    seen = slot.maxUs.load(std::memory_order_relaxed);
+    while (latencyUs > seen && !slot.maxUs.compare_exchange_weak(seen, latencyUs, std::memory_order_relaxed)) {}
+
+    comm[commIndex(commResult)].fetch_add(1, std::memory_order_relaxed);
+    if (commResult == COMM_SUCCESS && error != 0) {     // Error byte only valid when status packet received
+        if (error & 0x80)   alert.fetch_add(1, std::memory_order_relaxed);
+        int number = error & 0x7F;
+        packetError[(number > 0 && number < 8) ? number : 0].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void DXLBusStats::reset() {
+    for (int i = 0; i <= DXL_STATS_MAX_KEYS; i++) {
+        slots[i].count.store(0, std::memory_order_relaxed);
+        slots[i].totalUs.store(0, std::memory_order_relaxed);
+        slots[i].minUs.store(0xFFFFFFFF, std::memory_order_relaxed);
+        slots[i].maxUs.store(0, std::memory_order_relaxed);
+        for (int b = 0; b < DXL_STATS_BUCKETS; b++) {
+            slots[i].buckets[b].store(0, std::memory_order_relaxed);
+        }
+    }
+    for (int i = 0; i < DXL_STATS_COMM_CODES; i++)  comm[i].store(0, std::memory_order_relaxed);
+    alert.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < 8; i++)     packetError[i].store(0, std::memory_order_relaxed);
+}
+
+static void copySlot(uint32_t key, uint64_t count, uint64_t totalUs, uint32_t minUs, uint32_t maxUs, const std::atomic<uint32_t> *buckets, DXLLatencySnapshot &out) {
+    out.overflow = (key == DXL_STATS_OVERFLOW_KEY);
+    out.id = out.overflow ? 0 : uint8_t(key >> 24);
+    out.instruction = out.overflow ? 0 : uint8_t((key >> 16) & 0xFF);
+    out.address = out.overflow ? 0 : uint16_t(key & 0xFFFF);
+    out.count = count;
+    out.totalUs = totalUs;
+    out.minUs = (count > 0) ? minUs : 0;
+    out.maxUs = maxUs;
+    out.buckets.resize(DXL_STATS_BUCKETS);
+    for (int b = 0; b < DXL_STATS_BUCKETS; b++) {
+        out.buckets[b] = buckets[b].load(std::memory_order_relaxed);
+    }
+}
+
+std::vector<DXLLatencySnapshot> DXLBusStats::snapshot() const {
+    std::vector<DXLLatencySnapshot> result;
+    for (int i = 0; i <= DXL_STATS_MAX_KEYS; i++) {
+        uint32_t key = slots[i].key.load(std::memory_order_acquire);
+        uint64_t count = slots[i].count.load(std::memory_order_relaxed);
+        if (key == 0 || count == 0)     continue;
+
+        DXLLatencySnapshot snap;
+        copySlot(key, count, slots[i].totalUs.load(std::memory_order_relaxed), slots[i].minUs.load(std::memory_order_relaxed),
+                 slots[i].maxUs.load(std::memory_order_relaxed), slots[i].buckets, snap);
+        result.push_back(snap);
+    }
+    return result;
+}
+
+bool DXLBusStats::snapshot(uint8_t id, uint8_t instruction, uint16_t address, DXLLatencySnapshot &out) const {
+    uint32_t key = (uint32_t(id) << 24) | (uint32_t(instruction) << 16) | uint32_t(address);
+    for (int i = 0; i < DXL_STATS_MAX_KEYS; i++) {
+        if (slots[i].key.load(std::memory_order_acquire) != key)    continue;
+        copySlot(key, slots[i].count.load(std::memory_order_relaxed), slots[i].totalUs.load(std::memory_order_relaxed), slots[i].minUs.load(std::memory_order_relaxed),
+                 slots[i].maxUs.load(std::memory_order_relaxed), slots[i].buckets, out);
+        return out.count > 0;
+    }
+    return false;
+}
+
+DXLCommSnapshot DXLBusStats::commSnapshot() const {
+    DXLCommSnapshot snap;
+    for (int i = 0; i < DXL_STATS_COMM_CODES; i++)  snap.comm[i] = comm[i].load(std::memory_order_relaxed);
+    snap.alert = alert.load(std::memory_order_relaxed);
+    for (int i = 0; i < 8; i++)     snap.packetError[i] = packetError[i].load(std::memory_order_relaxed);
+    return snap;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLBusStats    ///////////////////////////////////////////////////////////////////////////
+    DXLBusStats::instance().enable(true);           // Leave on in production, ~2 clock reads + a few atomic adds per packet
+
+    tiltServo.writeGoalPosition(1, 2000);           // Goal write + isMoving() polling all recorded
+
+    std::vector<DXLLatencySnapshot> stats = DXLBusStats::instance().snapshot();
+    for (size_t i = 0; i < stats.size(); i++) {
+        printf("[ID:%03d] inst %3d addr %4d: n=%llu mean %.0fus p50 %.0fus p99 %.0fus max %uus\n", stats[i].id, stats[i].instruction, stats[i].address,
+               (unsigned long long)stats[i].count, stats[i].mean(), stats[i].percentile(50.0), stats[i].percentile(99.0), stats[i].maxUs);
+    }
+    DXLCommSnapshot comm = DXLBusStats::instance().commSnapshot();
+    printf("Timeouts: %llu, Corrupt: %llu\n", (unsigned long long)comm.comm[DXLBusStats::commIndex(COMM_RX_TIMEOUT)], (unsigned long long)comm.comm[DXLBusStats::commIndex(COMM_RX_CORRUPT)]);
+// End of Example Code
+*/
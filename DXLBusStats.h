@@ -0,0 +1,83 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Bus statistics for DXLServo packet calls.
+
+Every read/write TxRx made through DXLServo is timed and recorded against its (servo ID, instruction, register) key.
+Latencies go into HDR-style log-linear histograms (exact below 16us, 8 sub-buckets per power of two above, ~12.5% resolution).
+COMM_* results and status packet error bits are counted per bus. All counters are atomics, recording never takes a lock.
+When disabled (default), each packet call costs one relaxed atomic load, no clock reads.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+
+#define DXL_STATS_MAX_KEYS          256                 // Distinct (ID, instruction, register) keys tracked, power of 2. Overflow goes into one shared slot.
+#define DXL_STATS_SUB_BITS          3                   // Sub-bucket bits per power of two, 2^3 = 8 sub-buckets
+#define DXL_STATS_BUCKETS           240                 // Buckets covering 0us - 2^32us
+#define DXL_STATS_COMM_CODES        10                  // COMM_SUCCESS, PORT_BUSY, TX_FAIL, RX_FAIL, TX_ERROR, RX_WAITING, RX_TIMEOUT, RX_CORRUPT, NOT_AVAILABLE, other
+#define DXL_STATS_OVERFLOW_KEY      0xFFFFFFFF          // Key of shared slot once table is full
+
+struct DXLLatencySnapshot {                             // Copy of one histogram, safe to keep and query after the bus has moved on
+    uint8_t id;
+    uint8_t instruction;                                // INST_READ, INST_WRITE, INST_REBOOT, ...
+    uint16_t address;                                   // Control table address of first register touched, 0 for reboot
+    bool overflow;                                      // true if this is the shared slot for keys beyond DXL_STATS_MAX_KEYS
+    uint64_t count, totalUs;
+    uint32_t minUs, maxUs;
+    std::vector<uint32_t> buckets;
+
+    double mean() const;                                // Mean latency in microseconds
+    double percentile(double p) const;                  // Latency at percentile p (0.0 - 100.0) in microseconds, upper edge of bucket, capped at maxUs
+};
+
+struct DXLCommSnapshot {                                // Result counters for all packet calls
+    uint64_t comm[DXL_STATS_COMM_CODES];                // Index from DXLBusStats::commIndex()
+    uint64_t alert;                                     // Status packets with Alert bit (0x80) set, hardware error present on servo
+    uint64_t packetError[8];                            // Status packet error number (dxl_error & 0x7F): 1 Result Fail, 2 Instruction, 3 CRC, 4 Data Range, 5 Data Length, 6 Data Limit, 7 Access, [0] for anything else
+};
+
+class DXLBusStats {
+private:
+    struct Slot {
+        std::atomic<uint32_t> key;                      // (id << 24) | (instruction << 16) | address, 0 when free
+        std::atomic<uint64_t> count, totalUs;
+        std::atomic<uint32_t> minUs, maxUs;
+        std::atomic<uint32_t> buckets[DXL_STATS_BUCKETS];
+    };
+
+    std::atomic<bool> enabled;
+    Slot slots[DXL_STATS_MAX_KEYS + 1];                 // Last slot shared by overflow keys
+    std::atomic<uint64_t> comm[DXL_STATS_COMM_CODES];
+    std::atomic<uint64_t> alert;
+    std::atomic<uint64_t> packetError[8];
+
+    DXLBusStats();
+    DXLBusStats(const DXLBusStats &) = delete;
+    DXLBusStats &operator=(const DXLBusStats &) = delete;
+
+    Slot &findSlot(uint32_t key);
+
+public:
+    static DXLBusStats &instance();                     // Single set of statistics per process, shared by all DXLServo objects
+
+    void enable(bool on) {                              // Turn recording on or off at runtime
+        enabled.store(on, std::memory_order_relaxed);
+    }
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void record(uint8_t id, uint8_t instruction, uint16_t address, uint32_t latencyUs, int commResult, uint8_t error);     // Record one packet call. Lock-free, safe from any thread.
+    void reset();                                       // Clear all histograms and counters. Not atomic as a whole, call while bus is quiet for exact zero.
+
+    std::vector<DXLLatencySnapshot> snapshot() const;   // Copy of every histogram recorded so far
+    bool snapshot(uint8_t id, uint8_t instruction, uint16_t address, DXLLatencySnapshot &out) const;     // Copy of a single histogram, false if key never recorded
+    DXLCommSnapshot commSnapshot() const;               // Copy of result counters
+
+    static uint64_t nowUs();                            // Monotonic time in microseconds
+    static int bucketIndex(uint32_t us);                // Histogram bucket for latency value
+    static uint32_t bucketUpperBound(int index);        // Largest latency (us) that falls in bucket
+    static int commIndex(int commResult);               // Counter index for COMM_* result
+};
@@ -0,0 +1,135 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Servo to host clock synchronization from the MX Realtime Tick register. See DXLClockSync.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLClockSync.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define CLOCK_SLACK_US          100.0               // Bounds this far apart still count as agreeing (tick latched a little off the values)
+#define CLOCK_SKEW_MAX          500.0e-6            // Crystal tolerance is tens of ppm, more means a bad estimate
+#define CLOCK_DELAY_GAIN        0.125
+
+////////////////////////////////////////////////////   DXLClockSync definition   ////////////////////////////////////////////////////////////////////////////////////////
+
+void DXLClockSync::reset() {
+    count = 0, next = 0;
+    lastTick = 0, lastServoMs = 0, lastRxUs = 0;
+    offset = 0.0, offsetAtUs = 0;
+    skew = 0.0, uncertainty = 500.0, delay = 0.0;
+    anchorOffset = 0.0, anchorUs = 0;
+    pairs = 0;
+}
+
+void DXLClockSync::fit(uint64_t nowUs) {            // Intersect offset bounds of the window, carried to nowUs with the current skew
+    double lo = -1.0e300, hi = 1.0e300;
+    for (int i = 0; i < count; i++) {
+        const DXLClockPair &pair = window[i];
+        double servoUs = double(pair.servoMs) * 1000.0;
+        double carry = skew * (double(nowUs) - double(pair.lowUs));
+        lo = std::max(lo, double(pair.lowUs) - servoUs - 1000.0 + carry);
+        hi = std::min(hi, double(pair.highUs) - servoUs + carry);
+    }
+
+    if (lo > hi + CLOCK_SLACK_US) {                 // Servo rebooted (tick restarted) or host clock stepped: start over from the newest pair
+        window[0] = window[(next + DXL_CLOCK_WINDOW - 1) % DXL_CLOCK_WINDOW];
+        count = 1, next = 1;
+        double servoUs = double(window[0].servoMs) * 1000.0;
+        lo = double(window[0].lowUs) - servoUs - 1000.0;
+        hi = double(window[0].highUs) - servoUs;
+        anchorUs = 0;
+    }
+    offset = 0.5 * (lo + hi);
+    uncertainty = std::max(0.0, 0.5 * (hi - lo));
+    offsetAtUs = nowUs;
+
+    if (anchorUs == 0) {
+        anchorOffset = offset, anchorUs = nowUs;
+    }
+    else if (nowUs - anchorUs >= DXL_CLOCK_SKEW_INTERVAL_US) {
+        double measured = (offset - anchorOffset) / double(nowUs - anchorUs);
+        if (std::fabs(measured) <= CLOCK_SKEW_MAX)  skew += (skew == 0.0) ? measured : 0.25 * (measured - skew);
+        anchorOffset = offset, anchorUs = nowUs;
+    }
+}
+
+uint64_t DXLClockSync::observe(uint16_t tick, uint64_t lowUs, uint64_t highUs, uint64_t rxUs) {
+    tick = uint16_t(tick % DXL_CLOCK_TICK_MODULUS);
+    if (highUs < lowUs)     lowUs = highUs = lowUs / 2 + highUs / 2;        // Wire times longer than the round trip: wrong baud rate set, use the middle
+
+    int64_t servoMs = tick;
+    if (pairs > 0) {                                // Unwrap, host time between reads decides how many wraps were missed
+        int64_t delta = (int64_t(tick) - int64_t(lastTick) + DXL_CLOCK_TICK_MODULUS) % DXL_CLOCK_TICK_MODULUS;
+        double elapsedMs = double(rxUs - lastRxUs) / 1000.0;
+        double wraps = std::floor((elapsedMs - double(delta)) / DXL_CLOCK_TICK_MODULUS + 0.5);
+        if (wraps > 0.0)    delta += int64_t(wraps) * DXL_CLOCK_TICK_MODULUS;
+        servoMs = lastServoMs + delta;
+    }
+
+    DXLClockPair &pair = window[next];
+    pair.servoMs = servoMs;
+    pair.lowUs = lowUs, pair.highUs = highUs;
+    pair.rxUs = rxUs;
+    next = (next + 1) % DXL_CLOCK_WINDOW;
+    if (count < DXL_CLOCK_WINDOW)   count++;
+    fit(rxUs);
+
+    double tickStart = double(servoMs) * 1000.0 + offset;                  // Tick's millisecond on the host clock, cut to the host window
+    double lo = std::max(double(lowUs), tickStart);
+    double hi = std::min(double(highUs), tickStart + 1000.0);
+    uint64_t sampleUs = (lo <= hi) ? uint64_t(0.5 * (lo + hi)) : (lowUs / 2 + highUs / 2);
+
+    double age = double(rxUs - std::min(sampleUs, rxUs));
+    delay = (pairs == 0) ? age : delay + CLOCK_DELAY_GAIN * (age - delay);
+    lastTick = tick, lastServoMs = servoMs, lastRxUs = rxUs;
+    pairs++;
+    return sampleUs;
+}
+
+uint64_t DXLClockSync::toHostUs(int64_t servoMs) const {
+    double host = double(servoMs) * 1000.0 + 500.0 + offset;
+    return uint64_t(host + skew * (host - double(offsetAtUs)));
+}
+
+uint64_t DXLClockSync::tickToHostUs(uint16_t tick) const {
+    int64_t delta = (int64_t(tick % DXL_CLOCK_TICK_MODULUS) - int64_t(lastTick) + DXL_CLOCK_TICK_MODULUS) % DXL_CLOCK_TICK_MODULUS;
+    if (delta >= DXL_CLOCK_TICK_MODULUS / 2)    delta -= DXL_CLOCK_TICK_MODULUS;    // Slightly older than the last pair
+    return toHostUs(lastServoMs + delta);
+}
+
+uint64_t DXLClockSync::sampleTimeUs(uint64_t lowUs, uint64_t highUs, uint64_t rxUs) const {
+    if (highUs < lowUs)     return lowUs / 2 + highUs / 2;
+    if (pairs == 0)         return lowUs / 2 + highUs / 2;
+    uint64_t estimate = (rxUs > uint64_t(delay)) ? rxUs - uint64_t(delay) : 0;
+    return std::min(std::max(estimate, lowUs), highUs);
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLClockSync    ///////////////////////////////////////////////////////////////////////////
+#include "DXLProServo.h"
+
+int main() {
+    DXLServo pan;
+    pan.setDXLServo(0);                                 // MX-64, the only model with Realtime Tick
+    pan.identity = 1;
+    pan.initPortHandler();
+    pan.initPacketHandler();
+    pan.openPort();
+    pan.setPortBaudRate();
+
+    for (int i = 0; i < 200; i++) {                     // Timed reads pair the tick with their host window
+        DXLExpected<DXLTimedSample> sample = pan.readTimedPosition();
+        if (!sample)    continue;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    const DXLClockSync &clock = pan.getClockSync();
+    printf("offset %.0f us +- %.0f us, skew %.1f ppm, one-way delay %.0f us\n", clock.offsetUs(), clock.uncertaintyUs(), clock.skewPpm(), clock.oneWayDelayUs());
+
+    // Camera stabilization: pan angle now, not when the last status packet left the servo
+    double angle = pan.predictAngle(DXLBusStats::nowUs());
+    printf("pan %.3f deg\n", angle);
+    return 0;
+}
+// End of Example Code
+*/
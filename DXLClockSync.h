@@ -0,0 +1,66 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Servo to host clock synchronization from the MX Realtime Tick register.
+
+With read timing on (DXLServo::enableReadTiming()), every read DXLServo makes is stamped with the host time before its
+instruction went out (tx) and after its status packet arrived (rx), DXLBusStats::nowUs(). The servo took the values somewhere in between: after the whole instruction was on
+the wire and before the status packet started. Reads that cover Realtime Tick (MX, 1 ms per count, wraps after 32767)
+also say when on the servo's clock that was, to the millisecond.
+
+DXLClockSync turns those pairs into a mapping servo time -> host time:
+    offset      each pair bounds the offset: host window minus the tick's 1 ms span. Intersecting the bounds of recent
+                pairs narrows it well below the tick resolution, since ticks roll over at different points of the windows.
+                Pairs with a slow round trip give loose bounds and simply do not narrow it.
+    skew        servo crystal against host clock, from the offset drift between estimates at least 10 s apart.
+    delay       one-way delay: rx minus the host time the values were sampled, i.e. how old a sample is when it arrives.
+                Includes return delay time, status wire time and USB latency.
+Not thread safe, fed by whichever thread reads the servo (DXLServo::publishState()).
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#define DXL_CLOCK_TICK_MODULUS          32768           // Realtime Tick 0 - 32767 ms
+#define DXL_CLOCK_WINDOW                32              // Recent pairs intersected for the offset
+#define DXL_CLOCK_SKEW_INTERVAL_US      10000000        // Offset drift measured over at least this
+
+struct DXLClockPair {
+    int64_t servoMs;                                    // Unwrapped tick
+    uint64_t lowUs, highUs;                             // Host window the servo sampled in
+    uint64_t rxUs;
+};
+
+class DXLClockSync {
+private:
+    DXLClockPair window[DXL_CLOCK_WINDOW];
+    int count, next;
+    uint16_t lastTick;
+    int64_t lastServoMs;
+    uint64_t lastRxUs;
+    double offset;                                      // host us = servo ms * 1000 + offset + skew * (host us - offsetAtUs)
+    uint64_t offsetAtUs;
+    double skew, uncertainty, delay;
+    double anchorOffset;                                // Offset and time skew is measured against
+    uint64_t anchorUs;
+    uint64_t pairs;
+
+    void fit(uint64_t nowUs);
+
+public:
+    DXLClockSync() { reset(); }
+
+    void reset();
+    // One read covering Realtime Tick. lowUs/highUs: host window the servo sampled in, tx + instruction wire time and rx - status wire time.
+    // Returns the estimated host time the values were sampled.
+    uint64_t observe(uint16_t tick, uint64_t lowUs, uint64_t highUs, uint64_t rxUs);
+    uint64_t toHostUs(int64_t servoMs) const;           // Host time of the middle of an unwrapped servo millisecond
+    uint64_t tickToHostUs(uint16_t tick) const;         // Same for a raw tick within 16 s of the last pair
+    uint64_t sampleTimeUs(uint64_t lowUs, uint64_t highUs, uint64_t rxUs) const;     // Reads without the tick: rx - learned delay within the window, else its middle
+
+    bool isSynced() const               { return pairs >= 2; }
+    double offsetUs() const             { return offset; }
+    double skewPpm() const              { return skew * 1.0e6; }     // Offset drift, negative when the servo clock runs fast
+    double uncertaintyUs() const        { return uncertainty; }     // Half width of the offset bound, 500 us (tick resolution) or better
+    double oneWayDelayUs() const        { return delay; }           // Smoothed rx - sample time
+    uint64_t pairCount() const          { return pairs; }
+};
@@ -0,0 +1,227 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Control table snapshots. See DXLControlTable.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLControlTable.h"
+
+#include <string.h>
+
+// Not used elsewhere in the library, so not in DXLProServo.h
+#define ADDR_DXL_MODEL_NUMBER           0
+#define ADDR_DXL_FIRMWARE_VERSION       6
+#define ADDR_DXL_RETURN_DELAY_TIME      9
+#define ADDR_MX_MAX_VOLTAGE_LIMIT       32
+#define ADDR_MX_MIN_VOLTAGE_LIMIT       34
+#define ADDR_PRO_MAX_VOLTAGE_LIMIT      22
+#define ADDR_PRO_MIN_VOLTAGE_LIMIT      24
+#define DXL_REGISTER_NONE               0xFFFF
+
+struct DXLRegisterField {
+    const char *name;
+    int &(*field)(DXLControlTable &table);
+    uint16_t mxAddress, proAddress;                     // DXL_REGISTER_NONE: not on this servo type
+    uint8_t mxLength, proLength;
+    bool isSigned, isVolatile;
+};
+
+#define FIELD(name, member, mxAddr, mxLen, proAddr, proLen, sign, vol) \
+    { name, [](DXLControlTable &t) -> int & { return t.member; }, mxAddr, proAddr, mxLen, proLen, sign, vol }
+#define ELEMENT(name, member, i, mxAddr, mxLen, proAddr, proLen, sign, vol) \
+    { name, [](DXLControlTable &t) -> int & { return t.member[i]; }, mxAddr, proAddr, mxLen, proLen, sign, vol }
+
+static const DXLRegisterField registerFields[] = {
+    FIELD("model_number",           modelNumber,            ADDR_DXL_MODEL_NUMBER, 2,           ADDR_DXL_MODEL_NUMBER, 2,           false, false),
+    FIELD("firmware_version",       firmwareVersion,        ADDR_DXL_FIRMWARE_VERSION, 1,       ADDR_DXL_FIRMWARE_VERSION, 1,       false, false),
+    FIELD("baud_rate",              baudRate,               ADDR_MX_BAUD_RATE, 1,               ADDR_PRO_BAUD_RATE, 1,              false, false),
+    FIELD("return_delay_time",      returnDelayTime,        ADDR_DXL_RETURN_DELAY_TIME, 1,      ADDR_DXL_RETURN_DELAY_TIME, 1,      false, false),
+    FIELD("operating_mode",         operatingMode,          ADDR_MX_OPERATING_MODE, 1,          ADDR_PRO_OPERATING_MODE, 1,         false, false),
+    FIELD("homing_offset",          homingOffset,           ADDR_MX_HOMING_OFFSET, 4,           ADDR_PRO_HOMING_OFFSET, 4,          true,  false),
+    FIELD("moving_threshold",       movingThreshold,        ADDR_MX_MOVING_THRESHOLD, 4,        ADDR_PRO_MOVING_THRESHOLD, 4,       false, false),
+    FIELD("temperature_limit",      temperatureLimit,       ADDR_MX_TEMPERATURE_LIMIT, 1,       ADDR_PRO_TEMPERATURE_LIMIT, 1,      false, false),
+    FIELD("max_voltage_limit",      maxVoltageLimit,        ADDR_MX_MAX_VOLTAGE_LIMIT, 2,       ADDR_PRO_MAX_VOLTAGE_LIMIT, 2,      false, false),
+    FIELD("min_voltage_limit",      minVoltageLimit,        ADDR_MX_MIN_VOLTAGE_LIMIT, 2,       ADDR_PRO_MIN_VOLTAGE_LIMIT, 2,      false, false),
+    FIELD("current_limit",          currentLimit,           ADDR_MX_CURRENT_LIMIT, 2,           ADDR_PRO_TORQUE_LIMIT, 2,           false, false),
+    FIELD("acceleration_limit",     accelerationLimit,      ADDR_MX_ACCELERATION_LIMIT, 4,      ADDR_PRO_ACCELERATION_LIMIT, 4,     false, false),
+    FIELD("velocity_limit",         velocityLimit,          ADDR_MX_VELOCITY_LIMIT, 4,          ADDR_PRO_VELOCITY_LIMIT, 4,         false, false),
+    FIELD("max_position_limit",     maxPositionLimit,       ADDR_MX_MAX_POSITION_LIMIT, 4,      ADDR_PRO_MAX_POSITION_LIMIT, 4,     true,  false),
+    FIELD("min_position_limit",     minPositionLimit,       ADDR_MX_MIN_POSITION_LIMIT, 4,      ADDR_PRO_MIN_POSITION_LIMIT, 4,     true,  false),
+    ELEMENT("ext_port_mode_1",      extPortMode, 0,         DXL_REGISTER_NONE, 0,               ADDR_PRO_EXT_PORT_MODE_1, 1,        false, false),
+    ELEMENT("ext_port_mode_2",      extPortMode, 1,         DXL_REGISTER_NONE, 0,               ADDR_PRO_EXT_PORT_MODE_2, 1,        false, false),
+    ELEMENT("ext_port_mode_3",      extPortMode, 2,         DXL_REGISTER_NONE, 0,               ADDR_PRO_EXT_PORT_MODE_3, 1,        false, false),
+    ELEMENT("ext_port_mode_4",      extPortMode, 3,         DXL_REGISTER_NONE, 0,               ADDR_PRO_EXT_PORT_MODE_4, 1,        false, false),
+    FIELD("shutdown",               shutdown,               ADDR_MX_SHUTDOWN, 1,                ADDR_PRO_SHUTDOWN, 1,               false, false),
+
+    FIELD("torque_enable",          torqueEnable,           ADDR_MX_TORQUE_ENABLE, 1,           ADDR_PRO_TORQUE_ENABLE, 1,          false, false),
+    FIELD("led",                    led,                    ADDR_MX_LED, 1,                     DXL_REGISTER_NONE, 0,               false, false),
+    FIELD("led_red",                ledRed,                 DXL_REGISTER_NONE, 0,               ADDR_PRO_LED_RED, 1,                false, false),
+    FIELD("led_green",              ledGreen,               DXL_REGISTER_NONE, 0,               ADDR_PRO_LED_GREEN, 1,              false, false),
+    FIELD("led_blue",               ledBlue,                DXL_REGISTER_NONE, 0,               ADDR_PRO_LED_BLUE, 1,               false, false),
+    FIELD("status_return_level",    statusReturnLevel,      ADDR_MX_STATUS_RETURN_LEVEL, 1,     ADDR_PRO_STATUS_RETURN_LEVEL, 1,    false, false),
+    FIELD("registered_instruction", registeredInstruction,  ADDR_MX_REGISTERED_INSTRUCTION, 1,  ADDR_PRO_REGISTERED_INSTRUCTION, 1, false, true),
+    FIELD("hardware_error_status",  hardwareErrorStatus,    ADDR_MX_HARDWARE_ERROR_STATUS, 1,   ADDR_PRO_HARDWARE_ERROR_STATUS, 1,  false, false),
+    ELEMENT("position_p_gain",      positionGain, 0,        ADDR_MX_POSITION_P_GAIN, 2,         ADDR_PRO_POSITION_P_GAIN, 2,        false, false),
+    ELEMENT("position_i_gain",      positionGain, 1,        ADDR_MX_POSITION_I_GAIN, 2,         DXL_REGISTER_NONE, 0,               false, false),
+    ELEMENT("position_d_gain",      positionGain, 2,        ADDR_MX_POSITION_D_GAIN, 2,         DXL_REGISTER_NONE, 0,               false, false),
+    ELEMENT("position_ff1_gain",    positionGain, 3,        ADDR_MX_POSITION_FF1_GAIN, 2,       DXL_REGISTER_NONE, 0,               false, false),
+    ELEMENT("position_ff2_gain",    positionGain, 4,        ADDR_MX_POSITION_FF2_GAIN, 2,       DXL_REGISTER_NONE, 0,               false, false),
+    FIELD("goal_current",           goalCurrent,            ADDR_MX_GOAL_CURRENT, 2,            ADDR_PRO_GOAL_TORQUE, 2,            true,  false),
+    FIELD("goal_velocity",          goalVelocity,           ADDR_MX_GOAL_VELOCITY, 4,           ADDR_PRO_GOAL_VELOCITY, 4,          true,  false),
+    FIELD("goal_acceleration",      goalAcceleration,       DXL_REGISTER_NONE, 0,               ADDR_PRO_GOAL_ACCELERATION, 4,      true,  false),
+    FIELD("profile_acceleration",   profileAcceleration,    ADDR_MX_PROFILE_ACCELERATION, 4,    DXL_REGISTER_NONE, 0,               false, false),
+    FIELD("profile_velocity",       profileVelocity,        ADDR_MX_PROFILE_VELOCITY, 4,        DXL_REGISTER_NONE, 0,               false, false),
+    FIELD("goal_position",          goalPosition,           ADDR_MX_GOAL_POSITION, 4,           ADDR_PRO_GOAL_POSITION, 4,          true,  false),
+    FIELD("moving",                 moving,                 ADDR_MX_MOVING, 1,                  ADDR_PRO_MOVING, 1,                 false, true),
+    FIELD("moving_status",          movingStatus,           ADDR_MX_MOVING_STATUS, 1,           DXL_REGISTER_NONE, 0,               false, true),
+    FIELD("present_current",        presentCurrent,         ADDR_MX_PRESENT_CURRENT, 2,         ADDR_PRO_PRESENT_CURRENT, 2,        true,  true),
+    FIELD("present_velocity",       presentVelocity,        ADDR_MX_PRESENT_VELOCITY, 4,        ADDR_PRO_PRESENT_VELOCITY, 4,       true,  true),
+    FIELD("present_position",       presentPosition,        ADDR_MX_PRESENT_POSITION, 4,        ADDR_PRO_PRESENT_POSITION, 4,       true,  true),
+    FIELD("present_temperature",    presentTemperature,     ADDR_MX_PRESENT_TEMPERATURE, 1,     ADDR_PRO_PRESENT_TEMPERATURE, 1,    false, true),
+    ELEMENT("ext_port_data_1",      extPortData, 0,         DXL_REGISTER_NONE, 0,               ADDR_PRO_EXT_PORT_DATA_1, 2,        false, true),
+    ELEMENT("ext_port_data_2",      extPortData, 1,         DXL_REGISTER_NONE, 0,               ADDR_PRO_EXT_PORT_DATA_2, 2,        false, true),
+    ELEMENT("ext_port_data_3",      extPortData, 2,         DXL_REGISTER_NONE, 0,               ADDR_PRO_EXT_PORT_DATA_3, 2,        false, true),
+    ELEMENT("ext_port_data_4",      extPortData, 3,         DXL_REGISTER_NONE, 0,               ADDR_PRO_EXT_PORT_DATA_4, 2,        false, true),
+};
+
+static const size_t registerFieldCount = sizeof(registerFields) / sizeof(registerFields[0]);
+
+static int &fieldRef(DXLControlTable &table, const DXLRegisterField &f) {
+    return f.field(table);
+}
+
+static int fieldValue(const DXLControlTable &table, const DXLRegisterField &f) {
+    return f.field(const_cast<DXLControlTable &>(table));        // Read only
+}
+
+static size_t tableLength(int servoType) {
+    return (servoType == DXL_PRO_M42) ? DXL_PRO_TABLE_LENGTH : DXL_MX_TABLE_LENGTH;
+}
+
+////////////////////////////////////////////////////   DXLControlTable definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLControlTable::DXLControlTable() {
+    servoType = DXL_MX_64, id = 0;
+    timeUs = 0, reads = 0;
+    for (size_t i = 0; i < registerFieldCount; i++)     fieldRef(*this, registerFields[i]) = 0;
+}
+
+bool DXLControlTable::decode() {
+    bool pro = (servoType == DXL_PRO_M42);
+    if (raw.size() < tableLength(servoType))    return false;
+    for (size_t i = 0; i < registerFieldCount; i++) {
+        const DXLRegisterField &f = registerFields[i];
+        uint16_t address = pro ? f.proAddress : f.mxAddress;
+        uint8_t length = pro ? f.proLength : f.mxLength;
+        int &out = fieldRef(*this, f);
+        if (address == DXL_REGISTER_NONE) {
+            out = 0;
+            continue;
+        }
+        const uint8_t *p = &raw[address];
+        if (length == 1)        out = f.isSigned ? int(int8_t(p[0])) : int(p[0]);
+        else if (length == 2)   out = f.isSigned ? int(int16_t(DXL_MAKEWORD(p[0], p[1]))) : int(DXL_MAKEWORD(p[0], p[1]));
+        else                    out = int(int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(p[0], p[1]), DXL_MAKEWORD(p[2], p[3]))));
+    }
+    return true;
+}
+
+int DXLControlTable::value(const std::string &name) const {
+    for (size_t i = 0; i < registerFieldCount; i++) {
+        if (name == registerFields[i].name)     return fieldValue(*this, registerFields[i]);
+    }
+    return 0;
+}
+
+DXLExpected<DXLControlTable> DXLControlTable::capture(DXLServo &servo, uint16_t maxRead) {
+    DXLControlTable table;
+    table.servoType = servo.servoType;
+    table.id = servo.identity;
+    table.raw.resize(tableLength(servo.servoType));
+    if (maxRead == 0)   maxRead = DXL_SNAPSHOT_MAX_READ;
+
+    for (size_t address = 0; address < table.raw.size(); address += maxRead) {
+        uint16_t length = uint16_t(std::min(table.raw.size() - address, size_t(maxRead)));
+        table.reads++;
+        if (servo.readBlockTxRx(uint16_t(address), length, &table.raw[address]) != COMM_SUCCESS || (servo.dxl_error & 0x7F) != 0) {
+            DXL_LOG_ERROR(servo.identity, uint16_t(address), servo.dxl_comm_result, "Control table read of %d bytes failed", int(length));
+            return DXLExpected<DXLControlTable>(DXLError(servo.dxl_comm_result, servo.dxl_error, uint8_t(servo.identity), uint16_t(address), servo.getLastAttempts()));
+        }
+    }
+    table.timeUs = DXLBusStats::nowUs();
+    table.decode();
+    return DXLExpected<DXLControlTable>(table);
+}
+
+size_t DXLControlTable::captureFleet(const std::vector<DXLServo *> &servos, std::vector<DXLControlTable> &tables) {
+    tables.assign(servos.size(), DXLControlTable());
+    if (servos.empty())     return 0;
+
+    DXLServo *first = servos[0];
+    dynamixel::GroupBulkRead bulkRead(DXLTimeoutPort::underlying(first->prtHandler), first->pktHandler);       // Claims the real port, not a timeout wrapper
+    for (size_t i = 0; i < servos.size(); i++) {
+        tables[i].servoType = servos[i]->servoType;
+        tables[i].id = servos[i]->identity;
+        bulkRead.addParam(uint8_t(servos[i]->identity), 0, uint16_t(tableLength(servos[i]->servoType)));
+    }
+
+    int result;
+    if (first->getBusScheduler() != 0)  result = first->getBusScheduler()->runSync(DXL_PRIO_CONFIG, [&]() { return bulkRead.txRxPacket(); });
+    else                                result = bulkRead.txRxPacket();
+    first->dxl_comm_result = result;
+    if (result != COMM_SUCCESS)     DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, result, "Fleet control table bulk read incomplete: %s", first->pktHandler->getTxRxResult(result));
+
+    size_t captured = 0;
+    uint64_t now = DXLBusStats::nowUs();
+    for (size_t i = 0; i < servos.size(); i++) {
+        uint8_t id = uint8_t(servos[i]->identity);
+        uint16_t length = uint16_t(tableLength(servos[i]->servoType));
+        if (!bulkRead.isAvailable(id, 0, length))   continue;       // Did not answer, raw left empty
+        tables[i].raw.resize(length);
+        for (uint16_t address = 0; address < length; address++)     tables[i].raw[address] = uint8_t(bulkRead.getData(id, address, 1));  // Local copy, no bus traffic
+        tables[i].timeUs = now;
+        tables[i].decode();
+        captured++;
+    }
+    return captured;
+}
+
+std::vector<DXLRegisterChange> dxlDiffControlTable(const DXLControlTable &before, const DXLControlTable &after, bool includeVolatile) {
+    std::vector<DXLRegisterChange> changes;
+    bool pro = (after.servoType == DXL_PRO_M42);
+    for (size_t i = 0; i < registerFieldCount; i++) {
+        const DXLRegisterField &f = registerFields[i];
+        uint16_t address = pro ? f.proAddress : f.mxAddress;
+        if (address == DXL_REGISTER_NONE || (f.isVolatile && !includeVolatile))     continue;
+        int a = fieldValue(before, f), b = fieldValue(after, f);
+        if (a == b)     continue;
+        DXLRegisterChange change;
+        change.name = f.name;
+        change.address = address;
+        change.before = a;
+        change.after = b;
+        changes.push_back(change);
+    }
+    return changes;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLControlTable    ///////////////////////////////////////////////////////////////////////////
+    // Fleet audit against a reference configuration captured once from a known good unit
+    DXLExpected<DXLControlTable> reference = DXLControlTable::capture(panServo);
+    if (!reference)     return 1;
+
+    std::vector<DXLServo *> fleet = { &panServo, &tiltServo };
+    std::vector<DXLControlTable> tables;
+    DXLControlTable::captureFleet(fleet, tables);       // One bulk read for all servos
+    for (size_t i = 0; i < tables.size(); i++) {
+        if (tables[i].raw.empty()) {
+            printf("ID %d did not answer\n", tables[i].id);
+            continue;
+        }
+        if (tables[i].servoType != reference.value().servoType)     continue;
+        std::vector<DXLRegisterChange> changes = dxlDiffControlTable(reference.value(), tables[i]);
+        for (size_t c = 0; c < changes.size(); c++) {
+            printf("ID %d %s (%d): %d -> %d\n", tables[i].id, changes[c].name.c_str(), changes[c].address, changes[c].before, changes[c].after);
+        }
+    }
+// End of Example Code
+*/
@@ -0,0 +1,59 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Control table snapshots.
+
+capture() reads the whole EEPROM and RAM area in as few block reads as the packet size allows, instead of a getter per
+register:
+    MX:  0 - 146 (147 bytes, one read)
+    Pro: 0 - 892 (893 bytes, one read at the default chunk size)
+captureFleet() does the same for every servo on a port with one GroupBulkRead, one status packet per servo.
+The raw bytes are decoded into DXLControlTable fields using the ADDR_* definitions in DXLProServo.h.
+dxlDiffControlTable() lists the decoded fields that differ between two snapshots, e.g. against a known good configuration.
+Fields a servo type does not have are left at 0 and never reported by dxlDiffControlTable().
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+#define DXL_MX_TABLE_LENGTH             147             // Up to Present Temperature
+#define DXL_PRO_TABLE_LENGTH            893             // Up to Hardware Error Status
+#define DXL_SNAPSHOT_MAX_READ           900             // Bytes per read, SDK receive buffer is 1024 including header and stuffing
+
+struct DXLControlTable {
+    int servoType, id;
+    std::vector<uint8_t> raw;                           // Control table bytes from address 0
+    uint64_t timeUs;                                    // DXLBusStats::nowUs() after read
+    int reads;                                          // Packet calls spent, 0 for bulk read
+
+    // EEPROM
+    int modelNumber, firmwareVersion, baudRate, returnDelayTime, operatingMode, homingOffset, movingThreshold;
+    int temperatureLimit, maxVoltageLimit, minVoltageLimit, currentLimit, accelerationLimit, velocityLimit;
+    int maxPositionLimit, minPositionLimit, shutdown;
+    int extPortMode[4];                                 // Pro only
+    // RAM
+    int torqueEnable, led, ledRed, ledGreen, ledBlue, statusReturnLevel, registeredInstruction, hardwareErrorStatus;
+    int positionGain[5];                                // P, I, D, FF1, FF2. Pro: P only.
+    int goalCurrent, goalVelocity, goalAcceleration, profileAcceleration, profileVelocity, goalPosition;
+    int moving, movingStatus, presentCurrent, presentVelocity, presentPosition, presentTemperature;
+    int extPortData[4];                                 // Pro only
+
+    DXLControlTable();
+
+    bool decode();                                      // Fill fields from raw, false if raw too short for servoType
+    int value(const std::string &name) const;           // Decoded field by name as in dxlDiffControlTable(), 0 if unknown
+
+    static DXLExpected<DXLControlTable> capture(DXLServo &servo, uint16_t maxRead = DXL_SNAPSHOT_MAX_READ);
+    static size_t captureFleet(const std::vector<DXLServo *> &servos, std::vector<DXLControlTable> &tables);     // Returns number captured, failed entries have empty raw
+};
+
+struct DXLRegisterChange {
+    std::string name;
+    uint16_t address;
+    int before, after;
+};
+
+std::vector<DXLRegisterChange> dxlDiffControlTable(const DXLControlTable &before, const DXLControlTable &after, bool includeVolatile = false);    // Volatile: present values, moving flags
@@ -0,0 +1,279 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Position gain tuning from step response telemetry. See DXLGainTuner.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLGainTuner.h"
+#include "DXLWriteBatch.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#define MX_CURRENT_UNIT_AMPS            0.00336         // 3.36mA, as convertValtoCurr()
+#define PRO_CURRENT_UNIT_AMPS           0.004028        // 4.028mA
+
+#define MX_STEP_BLOCK_START             ADDR_MX_PRESENT_CURRENT      // 126: current(2) velocity(4) position(4)
+#define MX_STEP_BLOCK_LENGTH            10
+#define PRO_STEP_BLOCK_START            ADDR_PRO_PRESENT_POSITION    // 611: position(4) velocity(4) reserved(2) current(2)
+#define PRO_STEP_BLOCK_LENGTH           12
+
+#define MX_GAIN_MAX                     16383
+#define PRO_GAIN_MAX                    32767
+#define TUNER_REST_US                   20000           // Position held this long counts as at rest before a step
+
+static const int mxGainAddress[DXL_GAIN_COUNT] = { ADDR_MX_POSITION_P_GAIN, ADDR_MX_POSITION_I_GAIN, ADDR_MX_POSITION_D_GAIN, ADDR_MX_POSITION_FF1_GAIN, ADDR_MX_POSITION_FF2_GAIN };
+static const int gainSeed[DXL_GAIN_COUNT] = { 100, 10, 50, 50, 50 };       // Starting value when a gain is 0 and scaling cannot move it
+
+////////////////////////////////////////////////////   DXLGainTuner class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLGainTuner::DXLGainTuner(DXLServo *tuned) {
+    servo = tuned;
+    stepSize = (servo->servoType == DXL_PRO_M42) ? 7000 : 200;       // ~10 and ~18 degrees
+    captureMs = 500;
+    maxTrials = 40;
+    direction = 1;
+}
+
+bool DXLGainTuner::readGains(DXLPositionGains &gains) {
+    gains = DXLPositionGains();
+    if (servo->servoType == DXL_PRO_M42) {
+        DXLExpected<uint32_t> value = servo->tryRead(ADDR_PRO_POSITION_P_GAIN, 2);
+        if (!value)     return false;
+        gains.gain[0] = int(value.value());
+        return true;
+    }
+    for (int i = 0; i < DXL_GAIN_COUNT; i++) {
+        DXLExpected<uint32_t> value = servo->tryRead(mxGainAddress[i], 2);
+        if (!value)     return false;
+        gains.gain[i] = int(value.value());
+    }
+    return true;
+}
+
+bool DXLGainTuner::writeGains(const DXLPositionGains &gains) {
+    if (servo->servoType == DXL_PRO_M42)    return bool(servo->tryWrite(ADDR_PRO_POSITION_P_GAIN, 2, uint32_t(gains.gain[0])));
+    DXLWriteBatch batch;                                    // Two packets per trial instead of five
+    for (int i = 0; i < DXL_GAIN_COUNT; i++)    batch.write(*servo, mxGainAddress[i], 2, uint32_t(gains.gain[i]));
+    return bool(batch.flush());
+}
+
+bool DXLGainTuner::sample(DXLStepSample &out, uint64_t startUs) {
+    bool pro = (servo->servoType == DXL_PRO_M42);
+    uint8_t block[PRO_STEP_BLOCK_LENGTH];
+    if (servo->readBlockTxRx(pro ? PRO_STEP_BLOCK_START : MX_STEP_BLOCK_START, pro ? PRO_STEP_BLOCK_LENGTH : MX_STEP_BLOCK_LENGTH, block) != COMM_SUCCESS)   return false;
+    out.timeUs = DXLBusStats::nowUs() - startUs;
+    const uint8_t *position = pro ? block : block + 6;
+    const uint8_t *current = pro ? block + 10 : block;
+    out.position = int(int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(position[0], position[1]), DXL_MAKEWORD(position[2], position[3]))));
+    out.current = int(int16_t(DXL_MAKEWORD(current[0], current[1])));
+    return true;
+}
+
+bool DXLGainTuner::waitForRest(int &position) {      // Previous step may still be ringing, it would skew the next trial
+    int threshold = (servo->servoType == DXL_PRO_M42) ? DXL_PRO_MOVING_STATUS_THRESHOLD : DXL_MX_MOVING_STATUS_THRESHOLD;
+    uint64_t startUs = DXLBusStats::nowUs();
+    DXLStepSample point;
+    if (!sample(point, startUs))    return false;
+    int reference = point.position;
+    uint64_t heldSinceUs = point.timeUs;
+    while (point.timeUs - heldSinceUs < TUNER_REST_US && point.timeUs < uint64_t(captureMs) * 1000) {
+        if (!sample(point, startUs))    return false;
+        if (abs(point.position - reference) > threshold) {
+            reference = point.position;
+            heldSinceUs = point.timeUs;
+        }
+    }
+    position = point.position;
+    return true;
+}
+
+bool DXLGainTuner::measureStep(const DXLPositionGains &gains, DXLStepResponse &response, double settleBand) {
+    bool pro = (servo->servoType == DXL_PRO_M42);
+    capture.clear();
+    if (!writeGains(gains))     return false;
+
+    int start;
+    if (!waitForRest(start))    return false;
+    int goal = start + direction * stepSize;
+    if (goal < servo->getPositionLimitSetting(false) || goal > servo->getPositionLimitSetting(true)) {    // Step back into range instead
+        direction = -direction;
+        goal = start + direction * stepSize;
+    }
+    direction = -direction;
+
+    if (!servo->tryWrite(pro ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION, 4, uint32_t(goal)))     return false;
+    uint64_t startUs = DXLBusStats::nowUs();
+    uint64_t windowUs = uint64_t(captureMs) * 1000;
+    capture.reserve(size_t(captureMs) * 2);
+
+    DXLStepSample point;
+    while (DXLBusStats::nowUs() - startUs < windowUs) {
+        if (!sample(point, startUs))    return false;
+        capture.push_back(point);
+    }
+
+    response = analyze(capture, start, goal, settleBand, pro ? PRO_CURRENT_UNIT_AMPS : MX_CURRENT_UNIT_AMPS);
+    DXL_LOG_DEBUG(servo->identity, DXL_LOG_NONE, COMM_SUCCESS, "Step: rise %.1f ms, overshoot %.1f%%, settle %.1f ms, %d samples",
+        response.riseTimeSec * 1000.0, response.overshootPct, response.settlingTimeSec * 1000.0, int(response.samples));
+    return true;
+}
+
+DXLStepResponse DXLGainTuner::analyze(const std::vector<DXLStepSample> &samples, int startPosition, int goalPosition, double settleBand, double ampsPerUnit) {
+    DXLStepResponse response;
+    response.riseTimeSec = 0.0, response.overshootPct = 0.0, response.settlingTimeSec = 0.0;
+    response.steadyStateError = 0.0, response.peakCurrentAmps = 0.0;
+    response.settled = false;
+    response.samples = samples.size();
+    response.sampleRateHz = 0.0;
+    if (samples.empty() || goalPosition == startPosition)  return response;
+
+    double span = double(goalPosition - startPosition);
+    double windowSec = double(samples.back().timeUs) * 1.0e-6;
+    if (windowSec > 0.0)    response.sampleRateHz = double(samples.size() - 1) / windowSec;
+
+    double t10 = -1.0, t90 = -1.0, peak = 0.0;
+    size_t lastOutside = samples.size();                // Index of last sample outside the settle band
+    int peakCurrent = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        double progress = double(samples[i].position - startPosition) / span;       // 0 at start, 1 at goal, either direction
+        double t = double(samples[i].timeUs) * 1.0e-6;
+        if (t10 < 0.0 && progress >= 0.1)   t10 = t;
+        if (t90 < 0.0 && progress >= 0.9)   t90 = t;
+        peak = std::max(peak, progress);
+        if (fabs(progress - 1.0) > settleBand)  lastOutside = i;
+        peakCurrent = std::max(peakCurrent, abs(samples[i].current));
+    }
+
+    response.riseTimeSec = (t10 >= 0.0 && t90 >= 0.0) ? t90 - t10 : windowSec;
+    response.overshootPct = std::max(0.0, peak - 1.0) * 100.0;
+    response.peakCurrentAmps = double(peakCurrent) * ampsPerUnit;
+    response.settled = (lastOutside != samples.size() - 1);
+    if (!response.settled)                  response.settlingTimeSec = windowSec;
+    else if (lastOutside == samples.size()) response.settlingTimeSec = 0.0;     // Never left the band
+    else                                    response.settlingTimeSec = double(samples[lastOutside + 1].timeUs) * 1.0e-6;
+
+    size_t tail = std::max(size_t(1), samples.size() / 10);
+    double sum = 0.0;
+    for (size_t i = samples.size() - tail; i < samples.size(); i++)     sum += double(goalPosition - samples[i].position);
+    response.steadyStateError = sum / double(tail);
+    return response;
+}
+
+double DXLGainTuner::cost(const DXLStepResponse &response, const DXLTuningTarget &target) {
+    double total = response.settlingTimeSec;
+    total += std::max(0.0, response.riseTimeSec - target.riseTimeSec);
+    total += target.overshootWeight * std::max(0.0, response.overshootPct - target.maxOvershootPct);
+    total += target.errorWeight * fabs(response.steadyStateError);
+    if (!response.settled)  total += response.settlingTimeSec;      // Unsettled counts twice, always worse than slow but settled
+    return total;
+}
+
+bool DXLGainTuner::tune(const DXLTuningTarget &target, DXLPositionGains &best, DXLStepResponse *bestResponse) {
+    bool pro = (servo->servoType == DXL_PRO_M42);
+    int gainMax = pro ? PRO_GAIN_MAX : MX_GAIN_MAX;
+    static const int mxOrder[DXL_GAIN_COUNT] = { 0, 2, 1, 3, 4 };  // P and D dominate the step, I and feedforward trim
+    int order[DXL_GAIN_COUNT];
+    int count = pro ? 1 : DXL_GAIN_COUNT;
+    for (int i = 0; i < count; i++)     order[i] = pro ? 0 : mxOrder[i];
+
+    if (!readGains(best))   return false;
+    DXLStepResponse response, trial;
+    if (!measureStep(best, response, target.settleBand))    return false;
+    double bestCost = cost(response, target);
+    int trials = 1;
+
+    double scale = 2.0;
+    while (trials < maxTrials && scale > 1.1) {
+        bool improved = false;
+        for (int k = 0; k < count && trials < maxTrials; k++) {
+            int index = order[k];
+            double factors[2] = { scale, 1.0 / scale };
+            for (int f = 0; f < 2 && trials < maxTrials; f++) {
+                DXLPositionGains candidate = best;
+                int value = candidate.gain[index];
+                int next = (value == 0) ? ((factors[f] > 1.0) ? gainSeed[index] : 0) : int(double(value) * factors[f] + 0.5);
+                next = std::min(std::max(next, 0), gainMax);
+                if (next == value)  continue;
+                candidate.gain[index] = next;
+
+                if (!measureStep(candidate, trial, target.settleBand)) {
+                    writeGains(best);
+                    return false;
+                }
+                trials++;
+                double trialCost = cost(trial, target);
+                if (trialCost < bestCost) {
+                    best = candidate;
+                    bestCost = trialCost;
+                    response = trial;
+                    improved = true;
+                    break;                              // Keep direction that helped, next gain
+                }
+            }
+        }
+        if (!improved)  scale = sqrt(scale);
+    }
+
+    if (!writeGains(best))  return false;
+    if (bestResponse != 0)  *bestResponse = response;
+    DXL_LOG_INFO(servo->identity, DXL_LOG_NONE, COMM_SUCCESS, "Tuned gains P %d I %d D %d FF1 %d FF2 %d after %d steps: settle %.1f ms, overshoot %.1f%%",
+        best.gain[0], best.gain[1], best.gain[2], best.gain[3], best.gain[4], trials, response.settlingTimeSec * 1000.0, response.overshootPct);
+    return true;
+}
+
+bool DXLGainTuner::saveGains(const std::string &path, const DXLServo &servo, const DXLPositionGains &gains) {
+    std::vector<std::string> lines;
+    std::ifstream in(path.c_str());
+    std::string line;
+    while (std::getline(in, line)) {                    // Keep other servos' lines
+        std::istringstream fields(line);
+        int id;
+        if (line.empty() || line[0] == '#' || !(fields >> id) || id != servo.identity)  lines.push_back(line);
+    }
+    in.close();
+
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!out)   return false;
+    if (lines.empty() || lines[0] != "# id type P I D FF1 FF2")     out << "# id type P I D FF1 FF2\n";
+    for (size_t i = 0; i < lines.size(); i++)   out << lines[i] << "\n";
+    out << servo.identity << " " << servo.servoType;
+    for (int i = 0; i < DXL_GAIN_COUNT; i++)    out << " " << gains.gain[i];
+    out << "\n";
+    return bool(out);
+}
+
+bool DXLGainTuner::loadGains(const std::string &path, const DXLServo &servo, DXLPositionGains &gains) {
+    std::ifstream in(path.c_str());
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#')     continue;
+        std::istringstream fields(line);
+        int id, type;
+        DXLPositionGains read;
+        if (!(fields >> id >> type) || id != servo.identity || type != servo.servoType)     continue;
+        for (int i = 0; i < DXL_GAIN_COUNT; i++)    fields >> read.gain[i];
+        if (!fields)    return false;
+        gains = read;
+        return true;
+    }
+    return false;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLGainTuner    ///////////////////////////////////////////////////////////////////////////
+    DXLGainTuner tuner(&panServo);
+    DXLPositionGains gains;
+    if (!DXLGainTuner::loadGains("gains.txt", panServo, gains)) {          // Tune once, reuse afterwards
+        DXLTuningTarget target;
+        target.riseTimeSec = 0.04;
+        target.maxOvershootPct = 1.0;
+        tuner.setStep(150, 400);                        // 150 position values, 400ms capture per trial
+        DXLStepResponse response;
+        if (tuner.tune(target, gains, &response)) {
+            printf("Rise %.1f ms, settle %.1f ms at %.0f Hz sampling\n", response.riseTimeSec * 1000.0, response.settlingTimeSec * 1000.0, response.sampleRateHz);
+            DXLGainTuner::saveGains("gains.txt", panServo, gains);
+        }
+    }
+    panServo.setPositionGain(gains.gain[0], gains.gain[1], gains.gain[2], gains.gain[3], gains.gain[4]);
+// End of Example Code
+*/
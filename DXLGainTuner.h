@@ -0,0 +1,86 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Position gain tuning from step response telemetry.
+
+Each trial sets candidate gains, commands a step from the present position and samples Present Position (and current)
+back to back until the capture window ends. The response is reduced to rise time (10 - 90%), overshoot, settling time
+(within band of step) and steady state error, and scored against a DXLTuningTarget. Gains are searched coordinate-wise:
+each gain is scaled up and down, the best trial is kept and the scale shrinks when nothing improves.
+    MX:  P, I, D, FF1, FF2 (80 - 90)
+    Pro: P (594)
+Steps alternate direction so the joint ends near where it started. Profile Velocity/Acceleration are left as set, so the
+result is the response the tracking loops actually see.
+
+Position gains are RAM on both servo types. Tuned gains are kept as the servo's config with saveGains()/loadGains() and
+can be applied at start up through DXLServoConfig (DXLAsync.h) or setPositionGain().
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+#define DXL_GAIN_COUNT          5                       // P, I, D, FF1, FF2
+
+struct DXLPositionGains {
+    int gain[DXL_GAIN_COUNT];                           // P, I, D, FF1, FF2. Pro uses P only.
+
+    DXLPositionGains() { for (int i = 0; i < DXL_GAIN_COUNT; i++)  gain[i] = 0; }
+};
+
+struct DXLStepSample {
+    uint64_t timeUs;                                    // Since step command
+    int position, current;                              // Raw register values
+};
+
+struct DXLStepResponse {
+    double riseTimeSec, overshootPct, settlingTimeSec;  // settlingTimeSec is capture window if never settled
+    double steadyStateError;                            // Position values, mean over last tenth of window
+    double peakCurrentAmps;
+    bool settled;
+    size_t samples;
+    double sampleRateHz;
+};
+
+struct DXLTuningTarget {
+    double riseTimeSec;                                 // Rise time wanted, faster is not rewarded
+    double maxOvershootPct;
+    double settleBand;                                  // Fraction of step
+    double overshootWeight, errorWeight;                // Cost per % overshoot beyond limit, per position value of steady state error
+
+    DXLTuningTarget() : riseTimeSec(0.05), maxOvershootPct(2.0), settleBand(0.02), overshootWeight(0.05), errorWeight(0.01) {}
+};
+
+class DXLGainTuner {
+private:
+    DXLServo *servo;
+    int stepSize;                                       // Position values
+    int captureMs;
+    int maxTrials;
+    int direction;                                      // Next step direction, alternates
+    std::vector<DXLStepSample> capture;
+
+    bool writeGains(const DXLPositionGains &gains);
+    bool sample(DXLStepSample &out, uint64_t startUs);
+    bool waitForRest(int &position);                    // Sample until position holds still, at most one capture window
+
+public:
+    DXLGainTuner(DXLServo *tuned);
+
+    void setStep(int positionValues, int windowMs) { stepSize = positionValues; captureMs = windowMs; }
+    void setMaxTrials(int trials) { maxTrials = trials; }
+
+    bool readGains(DXLPositionGains &gains);            // Gains now in the servo's registers
+    bool measureStep(const DXLPositionGains &gains, DXLStepResponse &response, double settleBand = 0.02);   // One trial, raw samples in getCapture()
+    const std::vector<DXLStepSample> &getCapture() const { return capture; }
+
+    static DXLStepResponse analyze(const std::vector<DXLStepSample> &samples, int startPosition, int goalPosition, double settleBand, double ampsPerUnit);
+    static double cost(const DXLStepResponse &response, const DXLTuningTarget &target);
+
+    bool tune(const DXLTuningTarget &target, DXLPositionGains &best, DXLStepResponse *bestResponse = 0);  // Search from present gains, leaves best applied
+
+    static bool saveGains(const std::string &path, const DXLServo &servo, const DXLPositionGains &gains);  // One line per servo ID, replaces that ID's line
+    static bool loadGains(const std::string &path, const DXLServo &servo, DXLPositionGains &gains);
+};
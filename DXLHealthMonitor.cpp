@@ -0,0 +1,357 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Multi-rate health monitoring for DXLServo objects on one bus. See DXLHealthMonitor.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLHealthMonitor.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////   DXLHealthMonitor class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLHealthMonitor::DXLHealthMonitor(dynamixel::PortHandler *port, dynamixel::PacketHandler *packet) : bulkRead(DXLTimeoutPort::underlying(port), packet), sideRead(DXLTimeoutPort::underlying(port), packet) {
+    rateHz[DXL_HEALTH_HARDWARE_ERROR] = 10.0;
+    rateHz[DXL_HEALTH_CURRENT] = 50.0;
+    rateHz[DXL_HEALTH_TEMPERATURE] = 1.0;
+    budgetFraction = 0.1;
+    maxTokensUs = 100000.0 * budgetFraction;            // At most 100ms of unused budget carried over
+    tokensUs = maxTokensUs;
+    lastPollUs = 0;
+    baudRate = 57600;
+    lastResult = COMM_SUCCESS;
+    deferredCount = 0;
+    transactionCount = 0;
+    busScheduler = 0;
+}
+
+void DXLHealthMonitor::signalRegister(int servoType, int signal, uint16_t &address, uint16_t &length) {
+    bool pro = (servoType == DXL_PRO_M42);
+    switch (signal) {
+    case DXL_HEALTH_HARDWARE_ERROR:
+        address = pro ? ADDR_PRO_HARDWARE_ERROR_STATUS : ADDR_MX_HARDWARE_ERROR_STATUS;
+        length = 1;
+        break;
+    case DXL_HEALTH_CURRENT:
+        address = pro ? ADDR_PRO_PRESENT_CURRENT : ADDR_MX_PRESENT_CURRENT;
+        length = 2;
+        break;
+    default:
+        address = pro ? ADDR_PRO_PRESENT_TEMPERATURE : ADDR_MX_PRESENT_TEMPERATURE;
+        length = 1;
+        break;
+    }
+}
+
+bool DXLHealthMonitor::addServo(DXLServo *servo) {
+    Entry entry;
+    entry.servo = servo;
+    entry.id = uint8_t(servo->identity);
+    bool pro = (servo->servoType == DXL_PRO_M42);
+
+    DXLExpected<uint32_t> tempLimit = servo->tryRead(pro ? ADDR_PRO_TEMPERATURE_LIMIT : ADDR_MX_TEMPERATURE_LIMIT, 1);
+    DXLExpected<uint32_t> currentLimit = servo->tryRead(pro ? ADDR_PRO_TORQUE_LIMIT : ADDR_MX_CURRENT_LIMIT, 2);
+    if (!tempLimit || !currentLimit) {
+        DXL_LOG_ERROR(servo->identity, DXL_LOG_NONE, (!tempLimit ? tempLimit : currentLimit).error().comm, "Health monitor could not read limits, servo not added");
+        return false;
+    }
+    entry.tempLimit = int(tempLimit.value());
+    entry.currentLimit = int(currentLimit.value());
+
+    for (int s = 0; s < DXL_HEALTH_SIGNALS; s++) {
+        entry.nextDueUs[s] = 0;                         // Everything due on first poll
+        entry.level[s] = 0;
+        entry.raw[s] = 0;
+        entry.valid[s] = false;
+    }
+    entry.alertHandled = false;
+    entry.spanStart = 0;
+    entry.spanEnd = 0;
+    entry.sideStart = 0;
+    entry.sideEnd = 0;
+    entries.push_back(entry);
+
+    if (servo->baudRate > 0)    baudRate = servo->baudRate;
+    return true;
+}
+
+void DXLHealthMonitor::addSharedRead(DXLServo *servo, uint16_t address, uint16_t length) {
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].servo == servo) {
+            entries[i].shared.push_back(std::make_pair(address, length));
+            return;
+        }
+    }
+    DXL_LOG_ERROR(servo->identity, address, DXL_LOG_NONE, "Shared read for servo not added to health monitor");
+}
+
+void DXLHealthMonitor::setRate(int signal, double hz) {
+    if (signal < 0 || signal >= DXL_HEALTH_SIGNALS)     return;
+    rateHz[signal] = (hz > 0.0) ? hz : 0.0;
+}
+
+void DXLHealthMonitor::setBusBudget(double fraction) {
+    budgetFraction = std::min(1.0, std::max(0.0, fraction));
+    maxTokensUs = 100000.0 * budgetFraction;
+    tokensUs = std::min(tokensUs, maxTokensUs);
+}
+
+double DXLHealthMonitor::transactionUs(int extraId, bool extraSide, uint16_t extraStart, uint16_t extraEnd) const {
+    // Per bulk read: instruction 10 bytes + 5 per ID, one status packet per ID 11 bytes + data. 10 bits per byte.
+    int bytes = 0;
+    for (int side = 0; side < 2; side++) {
+        int ids = 0, groupBytes = 10;
+        for (size_t i = 0; i < entries.size(); i++) {
+            uint16_t start = side ? entries[i].sideStart : entries[i].spanStart;
+            uint16_t end = side ? entries[i].sideEnd : entries[i].spanEnd;
+            if (int(i) == extraId && bool(side) == extraSide) {
+                start = extraStart;
+                end = extraEnd;
+            }
+            if (end == 0)   continue;
+            ids++;
+            groupBytes += 5 + 11 + (end - start);
+        }
+        if (ids > 0)    bytes += groupBytes;
+    }
+    return double(bytes) * 10.0 * 1000000.0 / double(baudRate);
+}
+
+bool DXLHealthMonitor::signalDue(const Entry &entry, int signal, uint64_t nowUs, uint64_t &dueUs) const {
+    bool alert = (signal == DXL_HEALTH_HARDWARE_ERROR) && (entry.servo->dxl_error & 0x80) && !entry.alertHandled;
+    dueUs = alert ? 0 : entry.nextDueUs[signal];        // An alert counts as due the longest
+    return alert || (rateHz[signal] > 0.0 && nowUs >= dueUs);
+}
+
+bool DXLHealthMonitor::poll(uint64_t nowUs) {
+    if (entries.empty())    return false;
+
+    if (lastPollUs != 0 && nowUs > lastPollUs)  tokensUs = std::min(maxTokensUs, tokensUs + double(nowUs - lastPollUs) * budgetFraction);
+    lastPollUs = nowUs;
+
+    // Shared reads first, they are paid for by the control loop
+    for (size_t i = 0; i < entries.size(); i++) {
+        Entry &entry = entries[i];
+        entry.spanStart = 0;
+        entry.spanEnd = 0;
+        entry.sideStart = 0;
+        entry.sideEnd = 0;
+        for (size_t r = 0; r < entry.shared.size(); r++) {
+            uint16_t start = entry.shared[r].first, end = uint16_t(entry.shared[r].first + entry.shared[r].second);
+            if (entry.spanEnd == 0) {
+                entry.spanStart = start;
+                entry.spanEnd = end;
+            }
+            else {
+                entry.spanStart = std::min(entry.spanStart, start);
+                entry.spanEnd = std::max(entry.spanEnd, end);
+            }
+        }
+        if ((entry.servo->dxl_error & 0x80) == 0)   entry.alertHandled = false;        // Alert cleared (or never set) since last look
+    }
+
+    // Due health signals in priority order, each pays only for the bytes it adds: widening the block, or the second
+    // bulk read if that is cheaper. Short of budget, the signal due longest goes first and may take the bucket into debt.
+    uint64_t oldestDueUs = UINT64_MAX;
+    for (int s = 0; s < DXL_HEALTH_SIGNALS; s++) {
+        for (size_t i = 0; i < entries.size(); i++) {
+            uint64_t dueUs;
+            if (signalDue(entries[i], s, nowUs, dueUs))     oldestDueUs = std::min(oldestDueUs, dueUs);
+        }
+    }
+    std::vector<std::pair<int, int> > accepted;        // (entry, signal), signal + DXL_HEALTH_SIGNALS when in sideRead
+    uint64_t waitingDueUs = UINT64_MAX;                 // Due time of the longest due signal waiting for budget
+    for (int s = 0; s < DXL_HEALTH_SIGNALS; s++) {
+        for (size_t i = 0; i < entries.size(); i++) {
+            Entry &entry = entries[i];
+            uint64_t dueUs;
+            if (!signalDue(entry, s, nowUs, dueUs))     continue;
+
+            uint16_t address, length;
+            signalRegister(entry.servo->servoType, s, address, length);
+            uint16_t start = address, end = uint16_t(address + length);
+            uint16_t sideStart = address, sideEnd = end;
+            if (entry.spanEnd != 0) {
+                start = std::min(entry.spanStart, start);
+                end = std::max(entry.spanEnd, end);
+            }
+            if (entry.sideEnd != 0) {
+                sideStart = std::min(entry.sideStart, sideStart);
+                sideEnd = std::max(entry.sideEnd, sideEnd);
+            }
+            double baseUs = transactionUs(-1, false, 0, 0);
+            double costUs = transactionUs(int(i), false, start, end) - baseUs;
+            double sideCostUs = transactionUs(int(i), true, sideStart, sideEnd) - baseUs;
+            bool side = sideCostUs < costUs;
+            if (side)   costUs = sideCostUs;
+            bool affordable = costUs <= tokensUs || (tokensUs >= maxTokensUs && dueUs <= oldestDueUs);     // Full bucket: into debt, so a read dearer than the bucket still runs
+            if (!affordable || dueUs > waitingDueUs) {  // Signals due since later wait behind, or they would keep the bucket from filling
+                deferredCount++;
+                waitingDueUs = std::min(waitingDueUs, dueUs);
+                continue;
+            }
+            tokensUs -= costUs;
+            if (side) {
+                entry.sideStart = sideStart;
+                entry.sideEnd = sideEnd;
+            }
+            else {
+                entry.spanStart = start;
+                entry.spanEnd = end;
+            }
+            accepted.push_back(std::make_pair(int(i), side ? s + DXL_HEALTH_SIGNALS : s));
+        }
+    }
+
+    bulkRead.clearParam();
+    sideRead.clearParam();
+    bool any = false, anySide = false;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].spanEnd != 0) {
+            bulkRead.addParam(entries[i].id, entries[i].spanStart, uint16_t(entries[i].spanEnd - entries[i].spanStart));
+            any = true;
+        }
+        if (entries[i].sideEnd != 0) {
+            sideRead.addParam(entries[i].id, entries[i].sideStart, uint16_t(entries[i].sideEnd - entries[i].sideStart));
+            anySide = true;
+        }
+    }
+    if (!any && !anySide)   return false;
+
+    auto transfer = [&]() {
+        int result = any ? bulkRead.txRxPacket() : COMM_SUCCESS;
+        if (result == COMM_SUCCESS && anySide)  result = sideRead.txRxPacket();
+        return result;
+    };
+    uint64_t start = DXLBusStats::nowUs();
+    if (busScheduler != 0)  lastResult = busScheduler->runSync(DXL_PRIO_TELEMETRY, transfer, uint32_t(transactionUs(-1, false, 0, 0)));
+    else                    lastResult = transfer();
+    transactionCount++;
+    if (DXLTrace::instance().isEnabled()) {
+        DXLTraceEvent event;
+        event.startUs = start;
+        event.endUs = DXLBusStats::nowUs();
+        event.bus = DXLTimeoutPort::underlying(entries[0].servo->prtHandler);
+        event.result = lastResult;
+        event.address = 0;
+        event.length = 0;
+        event.id = BROADCAST_ID;
+        event.instruction = INST_BULK_READ;
+        event.error = 0;
+        DXLTrace::instance().record(event, entries[0].servo->deviceName.c_str());
+    }
+    if (lastResult != COMM_SUCCESS) {
+        DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, lastResult, "Health monitor bulk read failed");
+        return false;                                   // Signals stay due, retried next poll
+    }
+
+    for (size_t a = 0; a < accepted.size(); a++) {
+        Entry &entry = entries[accepted[a].first];
+        int signal = accepted[a].second % DXL_HEALTH_SIGNALS;
+        dynamixel::GroupBulkRead &group = (accepted[a].second >= DXL_HEALTH_SIGNALS) ? sideRead : bulkRead;
+        uint16_t address, length;
+        signalRegister(entry.servo->servoType, signal, address, length);
+        if (!group.isAvailable(entry.id, address, length))  continue;
+        evaluate(entry, signal, group.getData(entry.id, address, length), nowUs);
+        entry.nextDueUs[signal] = (rateHz[signal] > 0.0) ? nowUs + uint64_t(1000000.0 / rateHz[signal]) : UINT64_MAX;
+        if (signal == DXL_HEALTH_HARDWARE_ERROR)    entry.alertHandled = true;
+    }
+    return true;
+}
+
+void DXLHealthMonitor::evaluate(Entry &entry, int signal, uint32_t data, uint64_t nowUs) {
+    int raw, limit, level;
+    double value;
+    if (signal == DXL_HEALTH_HARDWARE_ERROR) {
+        raw = int(data & 0xFF);
+        limit = 0;
+        level = (raw != 0) ? 2 : 0;
+        value = raw;
+    }
+    else if (signal == DXL_HEALTH_CURRENT) {
+        raw = int(int16_t(data));
+        limit = entry.currentLimit;
+        int magnitude = abs(raw);                       // Reverse torque counts the same
+        level = (limit <= 0) ? 0 : (magnitude >= limit) ? 2 : (magnitude >= 0.9 * limit) ? 1 : 0;
+        value = entry.servo->convertValtoCurr(raw);
+    }
+    else {
+        raw = int(data & 0xFF);
+        limit = entry.tempLimit;
+        level = (raw >= limit) ? 2 : (raw >= 0.9 * limit) ? 1 : 0;
+        value = raw;
+    }
+
+    int previous = entry.level[signal];
+    entry.raw[signal] = raw;
+    entry.level[signal] = level;
+    bool first = !entry.valid[signal];
+    entry.valid[signal] = true;
+    if (level == previous && !(first && level != 0))    return;
+
+    if (level == 2)         DXL_LOG_ERROR(entry.id, DXL_LOG_NONE, raw, "Health: signal %d at or beyond limit %d", signal, limit);
+    else if (level == 1)    DXL_LOG_WARN(entry.id, DXL_LOG_NONE, raw, "Health: signal %d within 10 percent of limit %d", signal, limit);
+    else                    DXL_LOG_INFO(entry.id, DXL_LOG_NONE, raw, "Health: signal %d back to normal", signal);
+
+    if (callback) {
+        DXLHealthEvent event;
+        event.servo = entry.servo;
+        event.id = entry.id;
+        event.signal = signal;
+        event.level = level;
+        event.previousLevel = previous;
+        event.value = value;
+        event.raw = raw;
+        event.limit = limit;
+        event.timeUs = nowUs;
+        callback(event);
+    }
+}
+
+bool DXLHealthMonitor::getSharedData(DXLServo *servo, uint16_t address, uint16_t length, uint32_t &value) {
+    uint8_t id = uint8_t(servo->identity);
+    if (lastResult != COMM_SUCCESS || !bulkRead.isAvailable(id, address, length))  return false;
+    value = bulkRead.getData(id, address, length);
+    return true;
+}
+
+bool DXLHealthMonitor::getLatest(DXLServo *servo, int signal, double &value, int &level) const {
+    if (signal < 0 || signal >= DXL_HEALTH_SIGNALS)     return false;
+    for (size_t i = 0; i < entries.size(); i++) {
+        const Entry &entry = entries[i];
+        if (entry.servo != servo || !entry.valid[signal])   continue;
+        level = entry.level[signal];
+        value = (signal == DXL_HEALTH_CURRENT) ? servo->convertValtoCurr(entry.raw[signal]) : double(entry.raw[signal]);
+        return true;
+    }
+    return false;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLHealthMonitor    ///////////////////////////////////////////////////////////////////////////
+    DXLHealthMonitor health(panServo.prtHandler, panServo.pktHandler);         // Servos share one U2D2
+    health.addServo(&panServo);
+    health.addServo(&tiltServo);
+    health.addSharedRead(&panServo, ADDR_PRO_PRESENT_POSITION, 4);             // Control loop reads position anyway
+    health.addSharedRead(&tiltServo, ADDR_PRO_PRESENT_POSITION, 4);            // Current (621) and temperature (625) then extend the block by a few bytes,
+                                                                                // hardware error status (892) is read in a second small bulk read
+    health.setBusBudget(0.05);
+    health.setCallback([](const DXLHealthEvent &event) {
+        if (event.signal == DXL_HEALTH_HARDWARE_ERROR && event.level == 2) {
+            int status = event.raw;
+            event.servo->checkShutdown(status);                                 // Reboot unless overheated
+        }
+        else if (event.signal == DXL_HEALTH_TEMPERATURE && event.level == 2) {
+            event.servo->disableTorque();
+        }
+    });
+
+    for (;;) {                                                                  // 100 Hz control loop
+        health.poll();
+        uint32_t pan, tilt;
+        if (health.getSharedData(&panServo, ADDR_PRO_PRESENT_POSITION, 4, pan) && health.getSharedData(&tiltServo, ADDR_PRO_PRESENT_POSITION, 4, tilt)) {
+            // ... control using int32_t(pan), int32_t(tilt)
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+// End of Example Code
+*/
@@ -0,0 +1,100 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Multi-rate health monitoring for DXLServo objects on one bus.
+
+Replaces manual checkPresentTemperature()/checkPresentCurrent()/checkShutdown() polling. Each signal has its own rate
+(defaults: hardware error 10 Hz, current 50 Hz, temperature 1 Hz). Due signals are folded into one GroupBulkRead per poll()
+together with the registers the control loop reads anyway (addSharedRead()), one contiguous block per servo. A signal far
+from that block (Pro Hardware Error Status at 892, some 280 bytes past Present Position) goes instead into a second, small
+bulk read in the same poll when that costs less wire time than widening the block to reach it.
+Health reads only spend a configurable share of bus time: the extra wire time a signal adds to the transaction is paid
+from a budget that refills with elapsed time. Over budget, lower priority signals wait (hardware error > current > temperature),
+and so does any signal due since later than one already waiting. Once the bucket is full the signal due longest runs even if
+it costs more than the bucket holds, taking it into debt: every due signal runs eventually and the long run share still holds.
+A status packet with the alert bit set makes hardware error due at once.
+
+Threshold events are raised on level change only: 0 normal, 1 within 10% of limit, 2 at or beyond limit (as checkPresent*()).
+Hardware error: 2 whenever the register is non zero. Recovery (reboot etc.) is left to the callback, see DXLServo::checkShutdown().
+
+Not thread safe: call poll() from the thread that owns the bus. Protocol 2.0 only (bulk read).
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <functional>
+#include <vector>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+enum DXLHealthSignal {                                  // In priority order, lowest value served first when over budget
+    DXL_HEALTH_HARDWARE_ERROR = 0,
+    DXL_HEALTH_CURRENT,
+    DXL_HEALTH_TEMPERATURE,
+    DXL_HEALTH_SIGNALS
+};
+
+struct DXLHealthEvent {
+    DXLServo *servo;
+    uint8_t id;
+    int signal;                                         // DXLHealthSignal
+    int level, previousLevel;                           // 0 normal, 1 close to limit, 2 at/beyond limit
+    double value;                                       // Temperature in C, current in A, hardware error status bits
+    int raw, limit;                                     // Register value and limit compared against (raw units)
+    uint64_t timeUs;                                    // DXLBusStats::nowUs() of the read
+};
+
+typedef std::function<void(const DXLHealthEvent &)> DXLHealthCallback;
+
+class DXLHealthMonitor {
+private:
+    struct Entry {
+        DXLServo *servo;
+        uint8_t id;
+        int tempLimit, currentLimit;                    // Read once from EEPROM in addServo()
+        std::vector<std::pair<uint16_t, uint16_t> > shared;    // (address, length) read every poll for the control loop
+        uint64_t nextDueUs[DXL_HEALTH_SIGNALS];
+        int level[DXL_HEALTH_SIGNALS];
+        int raw[DXL_HEALTH_SIGNALS];
+        bool valid[DXL_HEALTH_SIGNALS];
+        bool alertHandled;                              // Alert bit already answered with a hardware error read
+        uint16_t spanStart, spanEnd;                    // Block planned for current poll, end exclusive. spanEnd == 0: not in transaction.
+        uint16_t sideStart, sideEnd;                    // Block in the second bulk read, as spanStart/spanEnd
+    };
+
+    dynamixel::GroupBulkRead bulkRead;
+    dynamixel::GroupBulkRead sideRead;                  // Signals cheaper read apart from the main block
+    std::vector<Entry> entries;
+    double rateHz[DXL_HEALTH_SIGNALS];
+    double budgetFraction;                              // Share of bus time health reads may add
+    double tokensUs, maxTokensUs;
+    uint64_t lastPollUs;
+    int baudRate;
+    int lastResult;
+    uint64_t deferredCount, transactionCount;
+    DXLHealthCallback callback;
+    DXLBusScheduler *busScheduler;
+
+    static void signalRegister(int servoType, int signal, uint16_t &address, uint16_t &length);
+    double transactionUs(int extraId, bool extraSide, uint16_t extraStart, uint16_t extraEnd) const;   // Wire time of planned transactions, with one span replaced
+    void evaluate(Entry &entry, int signal, uint32_t data, uint64_t nowUs);
+    bool signalDue(const Entry &entry, int signal, uint64_t nowUs, uint64_t &dueUs) const;    // Rate or alert make it due, dueUs since when (alert 0)
+
+public:
+    DXLHealthMonitor(dynamixel::PortHandler *port, dynamixel::PacketHandler *packet);
+
+    bool addServo(DXLServo *servo);                     // Call after port open. Reads temperature and current limits once. false if limits unreadable.
+    void addSharedRead(DXLServo *servo, uint16_t address, uint16_t length);      // Registers read on every poll() regardless of health schedule
+    void setRate(int signal, double hz);                // 0 disables signal
+    void setBusBudget(double fraction);                 // 0.0 - 1.0 share of bus time for health reads, default 0.1
+    void setCallback(const DXLHealthCallback &cb) { callback = cb; }
+    void setBusScheduler(DXLBusScheduler *scheduler) { busScheduler = scheduler; }    // Run bulk read as telemetry job, as DXLServo::setBusScheduler()
+
+    bool poll(uint64_t nowUs);                          // Run at most one bulk read with shared reads and due signals. false if nothing to read or comm failure.
+    bool poll() { return poll(DXLBusStats::nowUs()); }
+
+    bool getSharedData(DXLServo *servo, uint16_t address, uint16_t length, uint32_t &value);    // Value from last poll(), false if not read
+    bool getLatest(DXLServo *servo, int signal, double &value, int &level) const;              // Last health value, false if never read
+    int getLastResult() const { return lastResult; }
+    uint64_t getDeferredCount() const { return deferredCount; }         // Due signals postponed by budget
+    uint64_t getTransactionCount() const { return transactionCount; }
+};
@@ -0,0 +1,201 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Leveled logging for DXLServo and helpers. See DXLLog.h.
+
+Producers claim a queue cell with one compare-exchange, format straight into it and publish with a release store.
+Writer thread sleeps on a condition variable when idle. Producers only take its lock to notify when the writer is actually asleep.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLLog.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+
+static uint64_t logNowUs() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+////////////////////////////////////////////////////   DXLLogger class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLLogger::DXLLogger() {
+    for (size_t i = 0; i < DXL_LOG_QUEUE_SIZE; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos.store(0, std::memory_order_relaxed);
+    runtimeLevel.store(DXL_LOG_LEVEL_TRACE, std::memory_order_relaxed);
+    async.store(true, std::memory_order_relaxed);
+    running.store(false, std::memory_order_relaxed);
+    stopping.store(false, std::memory_order_relaxed);
+    idle.store(false, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    sink = stdout;
+}
+
+DXLLogger::~DXLLogger() {
+    stop();
+}
+
+DXLLogger &DXLLogger::instance() {
+    static DXLLogger logger;
+    return logger;
+}
+
+const char *DXLLogger::levelName(int level) {
+    switch (level) {
+    case DXL_LOG_LEVEL_TRACE:   return "T";
+    case DXL_LOG_LEVEL_DEBUG:   return "D";
+    case DXL_LOG_LEVEL_INFO:    return "I";
+    case DXL_LOG_LEVEL_WARN:    return "W";
+    case DXL_LOG_LEVEL_ERROR:   return "E";
+    default:                    return "?";
+    }
+}
+
+void DXLLogger::startWorker() {
+    std::lock_guard<std::mutex> lock(startLock);
+    if (running.load(std::memory_order_acquire) || stopping.load(std::memory_order_relaxed))     return;
+    worker = std::thread(&DXLLogger::workerLoop, this);
+    running.store(true, std::memory_order_release);
+}
+
+void DXLLogger::log(int level, int id, int reg, int result, const char *format, ...) {
+    if (level < runtimeLevel.load(std::memory_order_relaxed))   return;
+
+    bool queued = async.load(std::memory_order_relaxed) && !stopping.load(std::memory_order_relaxed);
+    if (!queued) {                                      // Synchronous path, format on stack and write now
+        DXLLogRecord record;
+        record.timeUs = logNowUs();
+        record.level = level, record.id = id, record.reg = reg, record.result = result;
+        va_list args;
+        va_start(args, format);
+        vsnprintf(record.text, DXL_LOG_TEXT_MAX, format, args);
+        va_end(args);
+        std::lock_guard<std::mutex> lock(sinkLock);
+        writeRecord(record);
+        fflush(sink);
+        return;
+    }
+
+    if (!running.load(std::memory_order_acquire))   startWorker();
+
+    Cell *cell;
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells[pos & (DXL_LOG_QUEUE_SIZE - 1)];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))     break;
+        }
+        else if (diff < 0) {                            // Queue full, writer behind. Drop rather than block hot path.
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    DXLLogRecord &record = cell->record;
+    record.timeUs = logNowUs();
+    record.level = level, record.id = id, record.reg = reg, record.result = result;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(record.text, DXL_LOG_TEXT_MAX, format, args);
+    va_end(args);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    wakeWriter();
+}
+
+void DXLLogger::wakeWriter() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);                    // Pairs with the fence in workerLoop, publish before checking idle
+    if (!idle.load(std::memory_order_relaxed))  return;
+    std::lock_guard<std::mutex> lock(wakeLock);
+    wakeCond.notify_one();
+}
+
+bool DXLLogger::hasRecord() const {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    return cells[pos & (DXL_LOG_QUEUE_SIZE - 1)].sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+bool DXLLogger::drainOne() {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell *cell = &cells[pos & (DXL_LOG_QUEUE_SIZE - 1)];
+    if (cell->sequence.load(std::memory_order_acquire) != pos + 1)  return false;      // Empty, or next record still being formatted
+
+    writeRecord(cell->record);
+    cell->sequence.store(pos + DXL_LOG_QUEUE_SIZE, std::memory_order_release);
+    dequeuePos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void DXLLogger::writeRecord(const DXLLogRecord &record) {
+    size_t length = strnlen(record.text, DXL_LOG_TEXT_MAX);
+    while (length > 0 && record.text[length - 1] == '\n')   length--;     // Callers may end messages with newline, one is added here
+
+    fprintf(sink, "[%s %llu.%06llu]", levelName(record.level), (unsigned long long)(record.timeUs / 1000000), (unsigned long long)(record.timeUs % 1000000));
+    if (record.id != DXL_LOG_NONE)      fprintf(sink, "[ID:%03d]", record.id);
+    if (record.reg != DXL_LOG_NONE)     fprintf(sink, "[REG:%d]", record.reg);
+    if (record.result != DXL_LOG_NONE)  fprintf(sink, "[RES:%d]", record.result);
+    fprintf(sink, " %.*s\n", int(length), record.text);
+}
+
+void DXLLogger::workerLoop() {
+    for (;;) {
+        bool wrote = false;
+        {
+            std::lock_guard<std::mutex> lock(sinkLock);
+            while (drainOne())  wrote = true;
+            if (wrote)  fflush(sink);
+        }
+        if (wrote) {
+            std::lock_guard<std::mutex> lock(wakeLock);
+            drainedCond.notify_all();
+            continue;
+        }
+        if (stopping.load(std::memory_order_acquire) && dequeuePos.load(std::memory_order_relaxed) == enqueuePos.load(std::memory_order_acquire))     return;
+
+        std::unique_lock<std::mutex> lock(wakeLock);
+        idle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);                // Set idle before the last look at the queue, see wakeWriter()
+        wakeCond.wait(lock, [this] { return hasRecord() || stopping.load(std::memory_order_acquire); });
+        idle.store(false, std::memory_order_relaxed);
+        if (!hasRecord()) {                                                 // Stopping with a record claimed but still being formatted
+            lock.unlock();
+            std::this_thread::yield();
+        }
+    }
+}
+
+void DXLLogger::setAsync(bool on) {
+    if (!on)    flush();
+    async.store(on, std::memory_order_relaxed);
+}
+
+void DXLLogger::setSink(FILE *file) {
+    flush();
+    std::lock_guard<std::mutex> lock(sinkLock);
+    sink = (file != 0) ? file : stdout;
+}
+
+void DXLLogger::flush() {
+    if (!running.load(std::memory_order_acquire))   return;
+    size_t target = enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeLock);
+    drainedCond.wait(lock, [this, target] { return dequeuePos.load(std::memory_order_acquire) >= target || !running.load(std::memory_order_acquire); });
+}
+
+void DXLLogger::stop() {
+    std::lock_guard<std::mutex> lock(startLock);
+    stopping.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> wake(wakeLock);
+        wakeCond.notify_one();
+    }
+    if (worker.joinable())  worker.join();
+    running.store(false, std::memory_order_release);
+    std::lock_guard<std::mutex> wake(wakeLock);
+    drainedCond.notify_all();
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Leveled logging for DXLServo and helpers.
+
+Levels below DXL_LOG_LEVEL are removed by the preprocessor, format strings and arguments are not compiled in.
+Default DXL_LOG_LEVEL: DEBUG, or WARN when NDEBUG is defined (Release builds). Override with -DDXL_LOG_LEVEL=<n>.
+Records carry structured fields (servo ID, register, result) and are formatted into a fixed slot of a bounded lock-free queue.
+A background thread writes them to the sink, so the calling thread never blocks on stdout. Full queue drops the record and counts it.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <stdint.h>
+#include <stdio.h>
+
+#define DXL_LOG_LEVEL_TRACE         0
+#define DXL_LOG_LEVEL_DEBUG         1
+#define DXL_LOG_LEVEL_INFO          2
+#define DXL_LOG_LEVEL_WARN          3
+#define DXL_LOG_LEVEL_ERROR         4
+#define DXL_LOG_LEVEL_OFF           5
+
+#ifndef DXL_LOG_LEVEL
+#ifdef NDEBUG
+#define DXL_LOG_LEVEL               DXL_LOG_LEVEL_WARN
+#else
+#define DXL_LOG_LEVEL               DXL_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define DXL_LOG_QUEUE_SIZE          1024                // Records in async queue, power of 2
+#define DXL_LOG_TEXT_MAX            192                 // Formatted message bytes per record, longer messages truncated
+#define DXL_LOG_NONE                (-1)                // Field value for "not applicable" (no ID, register or result)
+
+// Usage: DXL_LOG_INFO(id, reg, result, format, args...). Fields set to DXL_LOG_NONE are left out of the output line.
+#define DXL_LOG_AT(level, id, reg, result, ...)     DXLLogger::instance().log(level, int(id), int(reg), int(result), __VA_ARGS__)
+
+#if DXL_LOG_LEVEL <= DXL_LOG_LEVEL_TRACE
+#define DXL_LOG_TRACE(id, reg, result, ...)         DXL_LOG_AT(DXL_LOG_LEVEL_TRACE, id, reg, result, __VA_ARGS__)
+#else
+#define DXL_LOG_TRACE(id, reg, result, ...)         ((void)0)
+#endif
+#if DXL_LOG_LEVEL <= DXL_LOG_LEVEL_DEBUG
+#define DXL_LOG_DEBUG(id, reg, result, ...)         DXL_LOG_AT(DXL_LOG_LEVEL_DEBUG, id, reg, result, __VA_ARGS__)
+#else
+#define DXL_LOG_DEBUG(id, reg, result, ...)         ((void)0)
+#endif
+#if DXL_LOG_LEVEL <= DXL_LOG_LEVEL_INFO
+#define DXL_LOG_INFO(id, reg, result, ...)          DXL_LOG_AT(DXL_LOG_LEVEL_INFO, id, reg, result, __VA_ARGS__)
+#else
+#define DXL_LOG_INFO(id, reg, result, ...)          ((void)0)
+#endif
+#if DXL_LOG_LEVEL <= DXL_LOG_LEVEL_WARN
+#define DXL_LOG_WARN(id, reg, result, ...)          DXL_LOG_AT(DXL_LOG_LEVEL_WARN, id, reg, result, __VA_ARGS__)
+#else
+#define DXL_LOG_WARN(id, reg, result, ...)          ((void)0)
+#endif
+#if DXL_LOG_LEVEL <= DXL_LOG_LEVEL_ERROR
+#define DXL_LOG_ERROR(id, reg, result, ...)         DXL_LOG_AT(DXL_LOG_LEVEL_ERROR, id, reg, result, __VA_ARGS__)
+#else
+#define DXL_LOG_ERROR(id, reg, result, ...)         ((void)0)
+#endif
+
+struct DXLLogRecord {
+    uint64_t timeUs;                                    // Monotonic time when logged
+    int level, id, reg, result;                         // Structured fields, DXL_LOG_NONE if not applicable
+    char text[DXL_LOG_TEXT_MAX];                        // Formatted message, trailing newline stripped
+};
+
+class DXLLogger {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;                   // Bounded MPMC queue cell sequence (Vyukov), only one consumer used
+        DXLLogRecord record;
+    };
+
+    Cell cells[DXL_LOG_QUEUE_SIZE];
+    std::atomic<size_t> enqueuePos, dequeuePos;
+    std::atomic<int> runtimeLevel;
+    std::atomic<bool> async, running, stopping;
+    std::atomic<bool> idle;                             // Writer is waiting on wakeCond, producers must notify
+    std::atomic<uint64_t> dropped;
+
+    std::mutex sinkLock;                                // Held only by writer thread, or caller in synchronous mode
+    std::mutex startLock;
+    std::mutex wakeLock;                                // Guards writer sleep and flush() waits, never held while writing
+    std::condition_variable wakeCond;                   // Writer waits here when the queue is empty: enqueue, stop
+    std::condition_variable drainedCond;                // flush() waits here, writer notifies after each written batch
+    FILE *sink;
+    std::thread worker;
+
+    DXLLogger();
+    ~DXLLogger();
+    DXLLogger(const DXLLogger &) = delete;
+    DXLLogger &operator=(const DXLLogger &) = delete;
+
+    void startWorker();
+    void workerLoop();
+    bool drainOne();                                    // Write one queued record to sink, false if queue empty
+    bool hasRecord() const;                             // Next record is published and ready to write
+    void wakeWriter();
+    void writeRecord(const DXLLogRecord &record);
+
+public:
+    static DXLLogger &instance();
+
+#if defined(__GNUC__) || defined(__clang__)
+    void log(int level, int id, int reg, int result, const char *format, ...) __attribute__((format(printf, 6, 7)));
+#else
+    void log(int level, int id, int reg, int result, const char *format, ...);
+#endif
+
+    void setLevel(int level) {                          // Runtime filter on top of compile-time DXL_LOG_LEVEL
+        runtimeLevel.store(level, std::memory_order_relaxed);
+    }
+    int getLevel() const {
+        return runtimeLevel.load(std::memory_order_relaxed);
+    }
+    void setAsync(bool on);                             // false: write on calling thread (e.g. before fork or in crash handlers). Default true.
+    void setSink(FILE *file);                           // Output stream, default stdout. Caller keeps ownership.
+    void flush();                                       // Block until every record queued before the call is written
+    void stop();                                        // Flush and stop writer thread. Logging after stop() writes synchronously.
+    uint64_t droppedCount() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    static const char *levelName(int level);
+};
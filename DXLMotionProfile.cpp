@@ -0,0 +1,288 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Synchronized arrival multi-axis moves. See DXLMotionProfile.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLMotionProfile.h"
+
+#include <cmath>
+
+// Register units, same as DXLServo::convert*() functions
+#define MX_VELOCITY_UNIT_RPM            0.229
+#define MX_ACCEL_UNIT_RPM2              214.577
+#define PRO_VELOCITY_UNIT_RPM           0.00389076
+#define PRO_ACCEL_UNIT_RPM2             (58000.0 / 288.5)
+#define MX_POSITION_PER_REV             4096.0
+#define PRO_POSITION_PER_REV            263187.0        // 131593 per 180 degrees
+
+#define MX_PROFILE_BLOCK_START          ADDR_MX_PROFILE_ACCELERATION     // 108: accel(4) vel(4) goal position(4)
+#define MX_PROFILE_BLOCK_LENGTH         12
+#define PRO_PROFILE_BLOCK_START         ADDR_PRO_GOAL_POSITION           // 596: goal position(4) velocity(4) torque(2) acceleration(4)
+#define PRO_PROFILE_BLOCK_LENGTH        14
+
+////////////////////////////////////////////////////   Move time estimate   /////////////////////////////////////////////////////////////////////////////////////////
+
+double dxlProfileTimeSec(double revolutions, double velocityRpm, double accelRpm2) {
+    double d = fabs(revolutions);
+    if (d == 0.0 || velocityRpm <= 0.0)     return 0.0;
+    if (accelRpm2 <= 0.0)   return d / velocityRpm * 60.0;      // Unlimited acceleration: constant velocity
+    if (d >= velocityRpm * velocityRpm / accelRpm2)    return (d / velocityRpm + velocityRpm / accelRpm2) * 60.0;
+    return 2.0 * sqrt(d / accelRpm2) * 60.0;            // Never reaches profile velocity
+}
+
+double dxlProfileTimeSec(int servoType, int distance, int velocityValue, int accelValue) {
+    bool pro = (servoType == DXL_PRO_M42);
+    return dxlProfileTimeSec(double(distance) / (pro ? PRO_POSITION_PER_REV : MX_POSITION_PER_REV),
+        double(velocityValue) * (pro ? PRO_VELOCITY_UNIT_RPM : MX_VELOCITY_UNIT_RPM), double(accelValue) * (pro ? PRO_ACCEL_UNIT_RPM2 : MX_ACCEL_UNIT_RPM2));
+}
+
+////////////////////////////////////////////////////   DXLCoordinatedMove class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+void DXLCoordinatedMove::addAxis(DXLServo *servo, int goalPosition, double maxVelocityRpm, double maxAccelRpm2) {
+    addAxis(servo, goalPosition, 0, maxVelocityRpm, maxAccelRpm2);
+    axes.back().startKnown = false;
+}
+
+void DXLCoordinatedMove::addAxis(DXLServo *servo, int goalPosition, int startPosition, double maxVelocityRpm, double maxAccelRpm2) {
+    bool pro = (servo->servoType == DXL_PRO_M42);
+    DXLAxisMove axis;
+    axis.servo = servo;
+    axis.startPosition = startPosition;
+    axis.goalPosition = goalPosition;
+    axis.startKnown = true;
+    axis.maxVelocityRpm = (maxVelocityRpm > 0.0) ? maxVelocityRpm : (pro ? PROFILE_PRO_VELOCITY_MAX * PRO_VELOCITY_UNIT_RPM : PROFILE_MX_VELOCITY_MAX * MX_VELOCITY_UNIT_RPM);
+    axis.maxAccelRpm2 = (maxAccelRpm2 > 0.0) ? maxAccelRpm2 : PROFILE_ACCELERATION_MAX * (pro ? PRO_ACCEL_UNIT_RPM2 : MX_ACCEL_UNIT_RPM2);
+    axis.velocityRpm = 0.0;
+    axis.accelRpm2 = 0.0;
+    axis.velocityValue = 0;
+    axis.accelValue = 0;
+    axes.push_back(axis);
+    planned = false;
+}
+
+void DXLCoordinatedMove::addAxisAngle(DXLServo *servo, double goalAngle, double maxVelocityRpm, double maxAccelRpm2) {
+    addAxis(servo, servo->convertPostoVal(goalAngle), maxVelocityRpm, maxAccelRpm2);
+}
+
+void DXLCoordinatedMove::clear() {
+    axes.clear();
+    durationSec = 0.0;
+    accelSec = 0.0;
+    planned = false;
+}
+
+double DXLCoordinatedMove::revolutions(const DXLServo *servo, int distance) {
+    return fabs(double(distance)) / ((servo->servoType == DXL_PRO_M42) ? PRO_POSITION_PER_REV : MX_POSITION_PER_REV);
+}
+
+bool DXLCoordinatedMove::plan() {
+    planned = false;
+    if (axes.empty())   return false;
+
+    for (size_t i = 0; i < axes.size(); i++) {
+        if (axes[i].startKnown)     continue;
+        DXLExpected<int> position = axes[i].servo->tryReadCurrentPosition();
+        if (!position) {
+            DXL_LOG_ERROR(axes[i].servo->identity, DXL_LOG_NONE, position.error().comm, "Coordinated move: could not read start position");
+            axes[0].servo->dxl_comm_result = position.error().comm;      // Reported by execute()
+            return false;
+        }
+        axes[i].startPosition = position.value();
+        axes[i].startKnown = true;
+    }
+
+    // Times in minutes to match rpm and rev/min2 units
+    double K = 0.0, M = 0.0;                            // Longest cruise-limited and accel-limited terms over all axes
+    for (size_t i = 0; i < axes.size(); i++) {
+        double d = revolutions(axes[i].servo, axes[i].goalPosition - axes[i].startPosition);
+        K = std::max(K, d / axes[i].maxVelocityRpm);
+        M = std::max(M, d / axes[i].maxAccelRpm2);
+    }
+
+    double cruise, accel;                               // cruise = T - accel time, every axis: v = d / cruise, a = v / accel
+    if (K * K >= M) {
+        cruise = K;
+        accel = (K > 0.0) ? M / K : 0.0;
+    }
+    else {
+        cruise = sqrt(M);
+        accel = cruise;
+    }
+    durationSec = (cruise + accel) * 60.0;
+    accelSec = accel * 60.0;
+
+    for (size_t i = 0; i < axes.size(); i++) {
+        DXLAxisMove &axis = axes[i];
+        bool pro = (axis.servo->servoType == DXL_PRO_M42);
+        double d = revolutions(axis.servo, axis.goalPosition - axis.startPosition);
+        axis.velocityRpm = (cruise > 0.0) ? d / cruise : 0.0;
+        axis.accelRpm2 = (accel > 0.0) ? axis.velocityRpm / accel : 0.0;
+
+        // 0 means unlimited on both servo types, an axis that does not move gets the slowest profile instead
+        axis.velocityValue = std::min(limitValue(axis.maxVelocityRpm, pro ? PRO_VELOCITY_UNIT_RPM : MX_VELOCITY_UNIT_RPM),
+            std::max(1, int(axis.velocityRpm / (pro ? PRO_VELOCITY_UNIT_RPM : MX_VELOCITY_UNIT_RPM) + 0.5)));
+        axis.accelValue = std::min(limitValue(axis.maxAccelRpm2, pro ? PRO_ACCEL_UNIT_RPM2 : MX_ACCEL_UNIT_RPM2),
+            std::max(1, int(axis.accelRpm2 / (pro ? PRO_ACCEL_UNIT_RPM2 : MX_ACCEL_UNIT_RPM2) + 0.5)));
+    }
+
+    // Rounded to register units (MX acceleration steps are 214.577 rev/min2) the axes no longer take the same time on
+    // short or slow moves. The slowest rounded axis sets the move time, unless some axis cannot move that slowly even
+    // at the lowest register values (tiny Pro moves), then that axis' slowest does. Every axis is refitted to it.
+    double moveSec = -1.0, ceilingSec = -1.0;
+    for (size_t i = 0; i < axes.size(); i++) {
+        int distance = axes[i].goalPosition - axes[i].startPosition;
+        if (distance == 0)  continue;
+        double sec = dxlProfileTimeSec(axes[i].servo->servoType, distance, axes[i].velocityValue, axes[i].accelValue);
+        double slowestSec = dxlProfileTimeSec(axes[i].servo->servoType, distance, 1, 1);
+        moveSec = std::max(moveSec, sec);
+        ceilingSec = (ceilingSec < 0.0) ? slowestSec : std::min(ceilingSec, slowestSec);
+    }
+    if (moveSec > 0.0) {
+        moveSec = std::min(moveSec, ceilingSec);
+        size_t longest = 0;
+        durationSec = -1.0;
+        for (size_t i = 0; i < axes.size(); i++) {
+            int distance = axes[i].goalPosition - axes[i].startPosition;
+            if (distance == 0)  continue;
+            fitAxis(axes[i], moveSec);
+            double sec = dxlProfileTimeSec(axes[i].servo->servoType, distance, axes[i].velocityValue, axes[i].accelValue);
+            if (sec > durationSec) {
+                durationSec = sec;
+                longest = i;
+            }
+        }
+        const DXLAxisMove &axis = axes[longest];
+        bool pro = (axis.servo->servoType == DXL_PRO_M42);
+        double v = axis.velocityValue * (pro ? PRO_VELOCITY_UNIT_RPM : MX_VELOCITY_UNIT_RPM), a = axis.accelValue * (pro ? PRO_ACCEL_UNIT_RPM2 : MX_ACCEL_UNIT_RPM2);
+        double d = revolutions(axis.servo, axis.goalPosition - axis.startPosition);
+        accelSec = (d >= v * v / a) ? v / a * 60.0 : durationSec / 2.0;
+    }
+    for (size_t i = 0; i < axes.size(); i++) {
+        bool pro = (axes[i].servo->servoType == DXL_PRO_M42);
+        axes[i].velocityRpm = axes[i].velocityValue * (pro ? PRO_VELOCITY_UNIT_RPM : MX_VELOCITY_UNIT_RPM);
+        axes[i].accelRpm2 = axes[i].accelValue * (pro ? PRO_ACCEL_UNIT_RPM2 : MX_ACCEL_UNIT_RPM2);
+    }
+
+    planned = true;
+    return true;
+}
+
+int DXLCoordinatedMove::limitValue(double limit, double unit) {
+    return std::max(1, int(limit / unit + 1.0e-9));
+}
+
+void DXLCoordinatedMove::fitAxis(DXLAxisMove &axis, double timeSec) {
+    // Every acceleration value up to the limit, each with the velocity value whose trapezoid takes closest to timeSec:
+    // time = d/v + v/a solved for v (the cruise root), rounded. Ties keep the acceleration nearest the planned one.
+    bool pro = (axis.servo->servoType == DXL_PRO_M42);
+    double velocityUnit = pro ? PRO_VELOCITY_UNIT_RPM : MX_VELOCITY_UNIT_RPM, accelUnit = pro ? PRO_ACCEL_UNIT_RPM2 : MX_ACCEL_UNIT_RPM2;
+    int distance = axis.goalPosition - axis.startPosition;
+    double d = revolutions(axis.servo, distance), t = timeSec / 60.0;
+    int maxVelocity = limitValue(axis.maxVelocityRpm, velocityUnit);
+    int maxAccel = std::min(limitValue(axis.maxAccelRpm2, accelUnit), DXL_PROFILE_FIT_MAX_ACCEL);
+
+    int bestVelocity = axis.velocityValue, bestAccel = axis.accelValue;
+    double bestError = fabs(dxlProfileTimeSec(axis.servo->servoType, distance, bestVelocity, bestAccel) - timeSec);
+    for (int accel = 1; accel <= maxAccel; accel++) {
+        double a = accel * accelUnit;
+        double disc = t * t * a * a - 4.0 * d * a;
+        if (disc < 0.0)     continue;                   // Even a triangle at this acceleration takes longer
+        double v = (t * a - sqrt(disc)) / 2.0;
+        int base = int(v / velocityUnit);
+        for (int velocity = base; velocity <= base + 1; velocity++) {
+            if (velocity < 1 || velocity > maxVelocity)     continue;
+            double error = fabs(dxlProfileTimeSec(axis.servo->servoType, distance, velocity, accel) - timeSec);
+            if (error < bestError - 1.0e-9 || (error < bestError + 1.0e-9 && abs(accel - axis.accelValue) < abs(bestAccel - axis.accelValue))) {
+                bestError = error;
+                bestVelocity = velocity;
+                bestAccel = accel;
+            }
+        }
+    }
+    axis.velocityValue = bestVelocity;
+    axis.accelValue = bestAccel;
+}
+
+bool DXLCoordinatedMove::groupWrite() {
+    DXLServo *first = axes[0].servo;
+    bool mixed = false;
+    for (size_t i = 1; i < axes.size(); i++)    mixed = mixed || (axes[i].servo->servoType != first->servoType);
+
+    std::vector<std::vector<uint8_t> > blocks(axes.size());     // Group write keeps pointers until txPacket()
+    for (size_t i = 0; i < axes.size(); i++) {
+        const DXLAxisMove &axis = axes[i];
+        std::vector<uint8_t> &block = blocks[i];
+        uint32_t goal = uint32_t(axis.goalPosition), vel = uint32_t(axis.velocityValue), acc = uint32_t(axis.accelValue);
+        if (axis.servo->servoType == DXL_PRO_M42) {
+            int torque = axis.servo->getCurrentLimitSetting();
+            if (torque <= 0)    torque = DXL_PRO_M42_TORQUE_LIMIT_MAX;
+            uint8_t data[PRO_PROFILE_BLOCK_LENGTH] = {
+                DXL_LOBYTE(DXL_LOWORD(goal)), DXL_HIBYTE(DXL_LOWORD(goal)), DXL_LOBYTE(DXL_HIWORD(goal)), DXL_HIBYTE(DXL_HIWORD(goal)),
+                DXL_LOBYTE(DXL_LOWORD(vel)), DXL_HIBYTE(DXL_LOWORD(vel)), DXL_LOBYTE(DXL_HIWORD(vel)), DXL_HIBYTE(DXL_HIWORD(vel)),
+                DXL_LOBYTE(torque), DXL_HIBYTE(torque),
+                DXL_LOBYTE(DXL_LOWORD(acc)), DXL_HIBYTE(DXL_LOWORD(acc)), DXL_LOBYTE(DXL_HIWORD(acc)), DXL_HIBYTE(DXL_HIWORD(acc)) };
+            block.assign(data, data + PRO_PROFILE_BLOCK_LENGTH);
+        }
+        else {
+            uint8_t data[MX_PROFILE_BLOCK_LENGTH] = {
+                DXL_LOBYTE(DXL_LOWORD(acc)), DXL_HIBYTE(DXL_LOWORD(acc)), DXL_LOBYTE(DXL_HIWORD(acc)), DXL_HIBYTE(DXL_HIWORD(acc)),
+                DXL_LOBYTE(DXL_LOWORD(vel)), DXL_HIBYTE(DXL_LOWORD(vel)), DXL_LOBYTE(DXL_HIWORD(vel)), DXL_HIBYTE(DXL_HIWORD(vel)),
+                DXL_LOBYTE(DXL_LOWORD(goal)), DXL_HIBYTE(DXL_LOWORD(goal)), DXL_LOBYTE(DXL_HIWORD(goal)), DXL_HIBYTE(DXL_HIWORD(goal)) };
+            block.assign(data, data + MX_PROFILE_BLOCK_LENGTH);
+        }
+    }
+
+    int result;
+    if (!mixed) {
+        bool pro = (first->servoType == DXL_PRO_M42);
+        dynamixel::GroupSyncWrite syncWrite(DXLTimeoutPort::underlying(first->prtHandler), first->pktHandler,
+            pro ? PRO_PROFILE_BLOCK_START : MX_PROFILE_BLOCK_START, pro ? PRO_PROFILE_BLOCK_LENGTH : MX_PROFILE_BLOCK_LENGTH);
+        for (size_t i = 0; i < axes.size(); i++)    syncWrite.addParam(uint8_t(axes[i].servo->identity), &blocks[i][0]);
+        result = syncWrite.txPacket();
+    }
+    else {
+        dynamixel::GroupBulkWrite bulkWrite(DXLTimeoutPort::underlying(first->prtHandler), first->pktHandler);
+        for (size_t i = 0; i < axes.size(); i++) {
+            bool pro = (axes[i].servo->servoType == DXL_PRO_M42);
+            bulkWrite.addParam(uint8_t(axes[i].servo->identity), pro ? PRO_PROFILE_BLOCK_START : MX_PROFILE_BLOCK_START,
+                pro ? PRO_PROFILE_BLOCK_LENGTH : MX_PROFILE_BLOCK_LENGTH, &blocks[i][0]);
+        }
+        result = bulkWrite.txPacket();
+    }
+    first->dxl_comm_result = result;
+    for (size_t i = 0; i < axes.size(); i++)    axes[i].servo->invalidateProfileCache();     // Profile registers changed behind DXLServo's back
+    return result == COMM_SUCCESS;
+}
+
+int DXLCoordinatedMove::execute() {
+    if (axes.empty())   return COMM_TX_ERROR;
+    if (!planned && !plan())    return axes[0].servo->dxl_comm_result;
+
+    DXLServo *first = axes[0].servo;
+    uint64_t writeUs = 0;
+    auto write = [this, &writeUs]() { writeUs = DXLBusStats::nowUs(); groupWrite(); return 0; };
+    if (first->getBusScheduler() != 0)  first->getBusScheduler()->runSync(DXL_PRIO_CONTROL, write);
+    else    write();
+
+    if (first->dxl_comm_result != COMM_SUCCESS) {
+        DXL_LOG_ERROR(first->identity, DXL_LOG_NONE, first->dxl_comm_result, "%s", first->pktHandler->getTxRxResult(first->dxl_comm_result));
+    }
+    else {
+        for (size_t i = 0; i < axes.size(); i++)    axes[i].servo->noteGoal(axes[i].goalPosition, axes[i].velocityValue, axes[i].accelValue, writeUs);     // Profile now known to each servo
+        DXL_LOG_DEBUG(DXL_LOG_NONE, DXL_LOG_NONE, COMM_SUCCESS, "Coordinated move of %d axes, %.3f s", int(axes.size()), durationSec);
+    }
+    return first->dxl_comm_result;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLCoordinatedMove    ///////////////////////////////////////////////////////////////////////////
+    DXLCoordinatedMove move;
+    for (int x = 0; x < 10; x++) {
+        move.clear();
+        move.addAxisAngle(&panServo, panAngles[x], 40.0, 3000.0);      // rpm, rev/min2 limits per axis
+        move.addAxisAngle(&tiltServo, tiltAngles[x], 40.0, 3000.0);
+        if (move.execute() != COMM_SUCCESS)     break;
+        printf("Both axes arrive in %.3f s\n", move.getDuration());
+        crossSleep(1);
+    }
+// End of Example Code
+*/
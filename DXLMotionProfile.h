@@ -0,0 +1,71 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Synchronized arrival multi-axis moves.
+
+Each axis gets a trapezoidal profile with the same acceleration time and the same total time, velocities and
+accelerations scaled by distance. All axes start together, arrive together, and the joint space path is a straight line
+(no dog-leg from the faster axis finishing first). Shortest common time honouring every axis' velocity/acceleration limit:
+    K = max(d/vmax), M = max(d/amax)
+    K*K >= M: cruise profile, T = K + M/K, accel time M/K
+    else:     triangle profile, T = 2*sqrt(M)
+Register units are coarse (MX acceleration 214.577 rev/min2), so after rounding the slowest axis' actual profile time is
+the move time (capped at what the lowest register values allow on every axis) and each axis gets the register values
+whose profile comes closest to it.
+Profile and goal are pushed in one group write per move:
+    MX:  Profile Acceleration, Profile Velocity, Goal Position (108 - 119)
+    Pro: Goal Position, Goal Velocity, Goal Torque, Goal Acceleration (596 - 609). Goal Torque set to the servo's current limit.
+GroupSyncWrite if every axis is the same servo type, GroupBulkWrite for mixed MX/Pro.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+#define DXL_PROFILE_FIT_MAX_ACCEL       4096            // Acceleration values tried when refitting an axis to the move time
+
+// Move time estimates from profile registers, used by DXLServo to sleep through moves instead of polling Moving.
+// Trapezoid with the servo's Profile Velocity/Acceleration (Pro: Goal Velocity/Acceleration), triangle if the distance
+// is too short to reach velocity. Velocity 0 (unlimited) gives 0: no prediction, check straight away.
+double dxlProfileTimeSec(double revolutions, double velocityRpm, double accelRpm2);
+double dxlProfileTimeSec(int servoType, int distance, int velocityValue, int accelValue);   // Register values, per servo model units
+
+struct DXLAxisMove {
+    DXLServo *servo;
+    int startPosition, goalPosition;                    // Raw position values
+    bool startKnown;                                    // false: read by plan()
+    double maxVelocityRpm, maxAccelRpm2;                // Axis limits used for planning
+
+    // Planned by DXLCoordinatedMove::plan()
+    double velocityRpm, accelRpm2;                      // As written, after rounding to register units
+    int velocityValue, accelValue;                      // Register values written
+};
+
+class DXLCoordinatedMove {
+private:
+    std::vector<DXLAxisMove> axes;
+    double durationSec, accelSec;
+    bool planned;
+
+    static double revolutions(const DXLServo *servo, int distance);     // Position value difference to revolutions
+    static int limitValue(double limit, double unit);  // Largest register value within limit, at least 1
+    static void fitAxis(DXLAxisMove &axis, double timeSec);     // Register values whose profile takes closest to timeSec
+    bool groupWrite();
+
+public:
+    DXLCoordinatedMove() : durationSec(0.0), accelSec(0.0), planned(false) {}
+
+    void addAxis(DXLServo *servo, int goalPosition, double maxVelocityRpm = 0.0, double maxAccelRpm2 = 0.0);     // Limits 0: PROFILE_*_MAX defaults
+    void addAxis(DXLServo *servo, int goalPosition, int startPosition, double maxVelocityRpm, double maxAccelRpm2);
+    void addAxisAngle(DXLServo *servo, double goalAngle, double maxVelocityRpm = 0.0, double maxAccelRpm2 = 0.0);
+    void clear();
+
+    bool plan();                                        // Read unknown start positions, compute common profile. false on comm failure.
+    int execute();                                      // plan() if needed, then one group write. Returns COMM_* result.
+
+    double getDuration() const { return durationSec; }  // Planned move time, seconds
+    double getAccelTime() const { return accelSec; }    // Acceleration (and deceleration) phase, seconds
+    size_t axisCount() const { return axes.size(); }
+    const DXLAxisMove &getAxis(size_t index) const { return axes[index]; }
+};
@@ -0,0 +1,754 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Native Dynamixel Protocol 2.0 packet codec and PacketHandler. See DXLPacket.h.
+
+Result codes, status waits and packet timeouts follow the SDK Protocol2PacketHandler so the two are interchangeable.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLPacket.h"
+#include "DXLRetryPolicy.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+struct DXLCrcTables {
+    uint16_t table[4][256];                             // table[k][v]: CRC of byte v followed by k zero bytes
+
+    DXLCrcTables() {
+        for (int v = 0; v < 256; v++) {
+            uint16_t crc = uint16_t(v << 8);
+            for (int bit = 0; bit < 8; bit++)   crc = (crc & 0x8000) ? uint16_t((crc << 1) ^ 0x8005) : uint16_t(crc << 1);
+            table[0][v] = crc;
+        }
+        for (int k = 1; k < 4; k++) {
+            for (int v = 0; v < 256; v++) {
+                uint16_t crc = table[k - 1][v];
+                table[k][v] = uint16_t((crc << 8) ^ table[0][crc >> 8]);
+            }
+        }
+    }
+};
+
+static const DXLCrcTables &crcTables() {
+    static const DXLCrcTables tables;
+    return tables;
+}
+
+uint16_t dxlCrc16(uint16_t crc, const uint8_t *data, size_t length) {
+    const uint16_t (*t)[256] = crcTables().table;
+    while (length >= 4) {                               // The CRC register overlaps the first two bytes, the other two enter directly
+        uint16_t x = uint16_t(crc ^ ((data[0] << 8) | data[1]));
+        crc = uint16_t(t[3][x >> 8] ^ t[2][x & 0xFF] ^ t[1][data[2]] ^ t[0][data[3]]);
+        data += 4;
+        length -= 4;
+    }
+    while (length-- > 0) {
+        crc = uint16_t((crc << 8) ^ t[0][((crc >> 8) ^ *data++) & 0xFF]);
+    }
+    return crc;
+}
+
+////////////////////////////////////////////////////   DXLPacketWriter definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLPacketWriter::DXLPacketWriter(uint8_t *out, size_t outCapacity, uint8_t id, uint8_t instruction) {
+    buffer = out, capacity = outCapacity, size = DXL_PACKET_HEADER_LENGTH;
+    previous[0] = 0, previous[1] = instruction;         // Instruction is never 0xFF, so no pattern spans into the header
+    overflow = (outCapacity < DXL_PACKET_HEADER_LENGTH + 2);
+    if (overflow)   return;
+    buffer[0] = 0xFF, buffer[1] = 0xFF, buffer[2] = 0xFD, buffer[3] = 0x00;
+    buffer[4] = id;
+    buffer[5] = 0, buffer[6] = 0;
+    buffer[7] = instruction;
+}
+
+void DXLPacketWriter::put(const uint8_t *data, size_t length) {        // FF FF FD becomes FF FF FD FD
+    if (overflow || length == 0)    return;
+    if (length <= 8 && size + length <= capacity) {    // Register values: no memchr() call, usually no 0xFD at all
+        size_t k = 0;
+        while (k < length && data[k] != 0xFD)   k++;
+        if (k == length) {
+            memcpy(buffer + size, data, length);
+            size += length;
+            if (length >= 2)    previous[0] = data[length - 2], previous[1] = data[length - 1];
+            else                previous[0] = previous[1], previous[1] = data[0];
+            return;
+        }
+    }
+    size_t i = 0;
+    while (i < length) {
+        const uint8_t *fd = static_cast<const uint8_t *>(memchr(data + i, 0xFD, length - i));
+        size_t run = fd ? size_t(fd - (data + i)) + 1 : length - i;
+        if (size + run > capacity) {
+            overflow = true;
+            return;
+        }
+        memcpy(buffer + size, data + i, run);
+        size += run;
+        if (fd) {
+            size_t j = size_t(fd - data);
+            uint8_t before1 = j >= 1 ? data[j - 1] : previous[1];
+            uint8_t before2 = j >= 2 ? data[j - 2] : (j == 1 ? previous[1] : previous[0]);
+            if (before1 == 0xFF && before2 == 0xFF) {
+                if (size + 1 > capacity) {
+                    overflow = true;
+                    return;
+                }
+                buffer[size++] = 0xFD;
+            }
+        }
+        i += run;
+    }
+    if (length >= 2)    previous[0] = data[length - 2], previous[1] = data[length - 1];
+    else                previous[0] = previous[1], previous[1] = data[0];
+}
+
+void DXLPacketWriter::put16(uint16_t value) {
+    uint8_t bytes[2] = { DXL_LOBYTE(value), DXL_HIBYTE(value) };
+    put(bytes, 2);
+}
+
+void DXLPacketWriter::put32(uint32_t value) {
+    uint8_t bytes[4] = { DXL_LOBYTE(DXL_LOWORD(value)), DXL_HIBYTE(DXL_LOWORD(value)), DXL_LOBYTE(DXL_HIWORD(value)), DXL_HIBYTE(DXL_HIWORD(value)) };
+    put(bytes, 4);
+}
+
+size_t DXLPacketWriter::finish() {
+    if (overflow || size + 2 > capacity)    return 0;
+    uint16_t length = uint16_t(size + 2 - 7);           // Instruction, stuffed parameters, CRC
+    buffer[5] = DXL_LOBYTE(length), buffer[6] = DXL_HIBYTE(length);
+    uint16_t crc = dxlCrc16(0, buffer, size);
+    buffer[size] = DXL_LOBYTE(crc), buffer[size + 1] = DXL_HIBYTE(crc);
+    return size + 2;
+}
+
+////////////////////////////////////////////////////   Status packet parsing   /////////////////////////////////////////////////////////////////////////////////////////
+
+static size_t unstuff(uint8_t *data, size_t length) {   // In place, returns new length. Error byte ahead is never 0xFF.
+    uint8_t *fd = static_cast<uint8_t *>(memchr(data, 0xFD, length));
+    if (fd == 0)    return length;
+    size_t w = size_t(fd - data), r = w;
+    while (r < length) {
+        uint8_t c = data[r];
+        data[w++] = c;
+        if (c == 0xFD && w >= 3 && data[w - 2] == 0xFF && data[w - 3] == 0xFF && r + 1 < length && data[r + 1] == 0xFD)  r += 2;
+        else    r++;
+    }
+    return w;
+}
+
+int dxlParseStatus(uint8_t *buffer, size_t available, DXLStatusView &status, size_t &consumed, size_t *needed) {
+    size_t idx = 0;
+    for (;;) {
+        const uint8_t *ff = idx < available ? static_cast<const uint8_t *>(memchr(buffer + idx, 0xFF, available - idx)) : 0;
+        if (ff == 0) {                                  // No header start, nothing worth keeping
+            consumed = available;
+            if (needed)     *needed = available + DXL_PACKET_STATUS_MIN_LENGTH;
+            return COMM_RX_WAITING;
+        }
+        idx = size_t(ff - buffer);
+        if (available - idx < DXL_PACKET_STATUS_MIN_LENGTH) {
+            consumed = idx;
+            if (needed)     *needed = idx + DXL_PACKET_STATUS_MIN_LENGTH;
+            return COMM_RX_WAITING;
+        }
+        const uint8_t *p = buffer + idx;
+        uint16_t length = DXL_MAKEWORD(p[5], p[6]);
+        if (p[1] != 0xFF || p[2] != 0xFD || p[3] != 0x00 || p[4] > 0xFC || p[7] != INST_STATUS
+            || length < 4 || size_t(length) + 7 > DXL_PACKET_MAX_LENGTH) {
+            idx++;                                      // Not a status header, resync on the next 0xFF
+            continue;
+        }
+        size_t total = size_t(length) + 7;
+        if (available - idx < total) {
+            consumed = idx;
+            if (needed)     *needed = idx + total;
+            return COMM_RX_WAITING;
+        }
+        consumed = idx + total;
+        if (needed)     *needed = consumed;
+        uint16_t crc = DXL_MAKEWORD(p[total - 2], p[total - 1]);
+        if (dxlCrc16(0, p, total - 2) != crc)   return COMM_RX_CORRUPT;
+
+        status.id = p[4];
+        status.error = p[8];
+        status.params = buffer + idx + 9;
+        status.length = uint16_t(unstuff(buffer + idx + 9, length - 4));
+        return COMM_SUCCESS;
+    }
+}
+
+int dxlParseStatuses(uint8_t *buffer, size_t available, DXLStatusView *statuses, int maxStatuses, int &count) {
+    size_t offset = 0;
+    bool corrupt = false;
+    count = 0;
+    while (count < maxStatuses && offset < available) {
+        size_t consumed;
+        int result = dxlParseStatus(buffer + offset, available - offset, statuses[count], consumed);
+        offset += consumed;
+        if (result == COMM_SUCCESS)             count++;
+        else if (result == COMM_RX_CORRUPT)     corrupt = true;
+        else    break;
+    }
+    if (count == maxStatuses)   return COMM_SUCCESS;
+    return corrupt ? COMM_RX_CORRUPT : COMM_RX_WAITING;
+}
+
+////////////////////////////////////////////////////   DXLStatusStream definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLStatusStream::DXLStatusStream(dynamixel::PortHandler *streamPort) {
+    port = streamPort;
+#if defined(__linux__)
+    linuxPort = dynamic_cast<DXLPortHandlerLinux *>(streamPort);
+#endif
+    readCalls = 0;
+    reset();
+}
+
+void DXLStatusStream::reset() {
+    head = tail = scan = 0;
+    total = 0;
+    state = SYNC;
+}
+
+int DXLStatusStream::fill() {
+    if (head == tail)   head = tail = scan = 0;         // Empty, restart at ring start so the read is not split at the end
+    size_t offset = tail & (DXL_RX_RING_SIZE - 1);
+    size_t space = DXL_RX_RING_SIZE - (tail - head);
+    if (space > DXL_RX_RING_SIZE - offset)  space = DXL_RX_RING_SIZE - offset;
+    if (space == 0)     return 0;
+
+    int n;
+    readCalls++;
+#if defined(__linux__)
+    if (linuxPort != 0)     n = linuxPort->readAvailable(ring + offset, int(space));
+    else
+#endif
+    n = port->readPort(ring + offset, int(space));     // SDK handlers return what is there without waiting
+    if (n <= 0)     return 0;
+    tail += size_t(n);
+    return n;
+}
+
+int DXLStatusStream::next(DXLStatusView &status) {
+    static const uint8_t header[4] = { 0xFF, 0xFF, 0xFD, 0x00 };
+    for (;;) {
+        if (state == SYNC) {                            // head = candidate header start, scan - head bytes of it matched
+            while (scan < tail && scan - head < 4) {
+                uint8_t c = at(scan);
+                size_t matched = scan - head;
+                if (c == header[matched])   scan++;
+                else if (c == 0xFF) {                   // FF FF FF or FF FF FD FF: keep the longest FF run that can still start a header
+                    head = (matched == 2) ? scan - 1 : scan;
+                    scan++;
+                }
+                else    head = ++scan;
+            }
+            if (scan - head < 4)    return COMM_RX_WAITING;
+            state = HEADER;
+        }
+        if (state == HEADER) {
+            if (tail - head < DXL_PACKET_HEADER_LENGTH)     return COMM_RX_WAITING;
+            uint16_t length = DXL_MAKEWORD(at(head + 5), at(head + 6));
+            if (at(head + 4) > 0xFC || at(head + 7) != INST_STATUS || length < 4 || size_t(length) + 7 > DXL_PACKET_MAX_LENGTH) {
+                scan = ++head;                          // False header, resync one byte on
+                state = SYNC;
+                continue;
+            }
+            total = size_t(length) + 7;
+            state = BODY;
+        }
+        if (tail - head < total)    return COMM_RX_WAITING;
+
+        size_t offset = head & (DXL_RX_RING_SIZE - 1);
+        uint8_t *packet = ring + offset;
+        if (offset + total > DXL_RX_RING_SIZE) {        // Wraps, parse a linear copy
+            size_t first = DXL_RX_RING_SIZE - offset;
+            memcpy(scratch, ring + offset, first);
+            memcpy(scratch + first, ring, total - first);
+            packet = scratch;
+        }
+        size_t consumed;
+        int result = dxlParseStatus(packet, total, status, consumed);
+        head += total;
+        scan = head;
+        state = SYNC;
+        return result;
+    }
+}
+
+////////////////////////////////////////////////////   DXLPacketHandler definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+const char *DXLPacketHandler::getTxRxResult(int result) {
+    switch (result) {
+    case COMM_SUCCESS:          return "[TxRxResult] Communication success!";
+    case COMM_PORT_BUSY:        return "[TxRxResult] Port is in use!";
+    case COMM_TX_FAIL:          return "[TxRxResult] Failed transmit instruction packet!";
+    case COMM_RX_FAIL:          return "[TxRxResult] Failed get status packet from device!";
+    case COMM_TX_ERROR:         return "[TxRxResult] Incorrect instruction packet!";
+    case COMM_RX_WAITING:       return "[TxRxResult] Now receiving status packet!";
+    case COMM_RX_TIMEOUT:       return "[TxRxResult] There is no status packet!";
+    case COMM_RX_CORRUPT:       return "[TxRxResult] Incorrect status packet!";
+    case COMM_NOT_AVAILABLE:    return "[TxRxResult] Protocol does not support this function!";
+    default:                    return "";
+    }
+}
+
+const char *DXLPacketHandler::getRxPacketError(uint8_t error) {
+    if (error & 0x80)   return "[RxPacketError] Hardware error occurred. Check the error at control table!";
+    switch (error & 0x7F) {
+    case 0:     return "";
+    case 1:     return "[RxPacketError] Failed to process the instruction packet!";
+    case 2:     return "[RxPacketError] Undefined instruction or incorrect instruction!";
+    case 3:     return "[RxPacketError] CRC doesn't match!";
+    case 4:     return "[RxPacketError] The data value is out of range!";
+    case 5:     return "[RxPacketError] The data length does not match as expected!";
+    case 6:     return "[RxPacketError] The data value exceeds the limit value!";
+    case 7:     return "[RxPacketError] Writing or Reading is not available to target address!";
+    default:    return "[RxPacketError] Unknown error code!";
+    }
+}
+
+void DXLPacketHandler::printTxRxResult(int result) {
+    printf("%s\n", getTxRxResult(result));
+}
+
+void DXLPacketHandler::printRxPacketError(uint8_t error) {
+    printf("%s\n", getRxPacketError(error));
+}
+
+static dynamixel::PortHandler *busOf(dynamixel::PortHandler *port) {     // Real port behind a DXLTimeoutPort: is_using_ claimed there, shared by all servos on it
+    return DXLTimeoutPort::underlying(port);
+}
+
+DXLStatusStream &DXLPacketHandler::streamFor(dynamixel::PortHandler *port) {
+    port = busOf(port);                                 // One stream per real port, wrapped or not
+    std::lock_guard<std::mutex> guard(streamsLock);
+    std::unique_ptr<DXLStatusStream> &stream = streams[port];
+    if (!stream)    stream.reset(new DXLStatusStream(port));
+    return *stream;
+}
+
+uint64_t DXLPacketHandler::rxReads(dynamixel::PortHandler *port) {
+    return streamFor(port).reads();
+}
+
+int DXLPacketHandler::sendPacket(dynamixel::PortHandler *port, const uint8_t *packet, size_t length) {
+    if (length == 0 || length > DXL_PACKET_MAX_LENGTH)  return COMM_TX_ERROR;
+    dynamixel::PortHandler *bus = busOf(port);
+    if (bus->is_using_)     return COMM_PORT_BUSY;
+    bus->is_using_ = true;
+
+    port->clearPort();
+    streamFor(port).reset();                            // Late bytes of an earlier reply must not match this one
+    int written = port->writePort(const_cast<uint8_t *>(packet), int(length));
+    if (written != int(length)) {
+        bus->is_using_ = false;
+        return COMM_TX_FAIL;
+    }
+    return COMM_SUCCESS;
+}
+
+int DXLPacketHandler::rxStatus(dynamixel::PortHandler *port, DXLStatusView &status) {
+    DXLStatusStream &stream = streamFor(port);
+    int result;
+    for (;;) {
+        result = stream.next(status);                   // Replies already buffered cost no read
+        if (result != COMM_RX_WAITING)  break;
+        if (stream.fill() > 0)  continue;
+        if (port->isPacketTimeout()) {
+            result = (stream.buffered() == 0) ? COMM_RX_TIMEOUT : COMM_RX_CORRUPT;
+            break;
+        }
+    }
+    busOf(port)->is_using_ = false;
+    return result;
+}
+
+int DXLPacketHandler::txRxStatus(dynamixel::PortHandler *port, uint8_t *txPacket, size_t txLength, uint8_t id, uint16_t readLength, DXLStatusView &status) {
+    int result = sendPacket(port, txPacket, txLength);
+    if (result != COMM_SUCCESS)     return result;
+    if (id == DXL_PACKET_BROADCAST_ID) {                // No status packets to wait for
+        busOf(port)->is_using_ = false;
+        return COMM_SUCCESS;
+    }
+
+    port->setPacketTimeout(uint16_t(readLength + DXL_PACKET_STATUS_MIN_LENGTH));
+    do {
+        result = rxStatus(port, status);
+    } while (result == COMM_SUCCESS && status.id != id);
+    return result;
+}
+
+int DXLPacketHandler::txPacket(dynamixel::PortHandler *port, uint8_t *txpacket) {
+    uint16_t length = DXL_MAKEWORD(txpacket[5], txpacket[6]);
+    if (length < 3)     return COMM_TX_ERROR;
+    uint8_t tx[DXL_PACKET_MAX_LENGTH];
+    DXLPacketWriter writer(tx, sizeof(tx), txpacket[4], txpacket[7]);
+    writer.put(txpacket + 8, length - 3);
+    size_t size = writer.finish();
+    if (size == 0)  return COMM_TX_ERROR;
+    return sendPacket(port, tx, size);
+}
+
+int DXLPacketHandler::rxPacket(dynamixel::PortHandler *port, uint8_t *rxpacket) {         // SDK layout: header at 0, unstuffed
+    DXLStatusView status;
+    int result = rxStatus(port, status);
+    if (result != COMM_SUCCESS)     return result;
+    memcpy(rxpacket, status.params - 9, size_t(status.length) + 9);     // Header and error byte precede params in the stream
+    uint16_t length = uint16_t(status.length + 4);
+    rxpacket[5] = DXL_LOBYTE(length), rxpacket[6] = DXL_HIBYTE(length);
+    return COMM_SUCCESS;
+}
+
+int DXLPacketHandler::txRxPacket(dynamixel::PortHandler *port, uint8_t *txpacket, uint8_t *rxpacket, uint8_t *error) {
+    int result = txPacket(port, txpacket);
+    if (result != COMM_SUCCESS)     return result;
+
+    uint8_t id = txpacket[4], instruction = txpacket[7];
+    if (instruction == INST_BULK_READ || instruction == INST_SYNC_READ) {
+        busOf(port)->is_using_ = false;
+        return COMM_NOT_AVAILABLE;
+    }
+    if (id == DXL_PACKET_BROADCAST_ID) {
+        busOf(port)->is_using_ = false;
+        return COMM_SUCCESS;
+    }
+    if (instruction == INST_READ)   port->setPacketTimeout(uint16_t(DXL_MAKEWORD(txpacket[10], txpacket[11]) + DXL_PACKET_STATUS_MIN_LENGTH));
+    else    port->setPacketTimeout(uint16_t(DXL_PACKET_STATUS_MIN_LENGTH));
+
+    do {
+        result = rxPacket(port, rxpacket);
+    } while (result == COMM_SUCCESS && rxpacket[4] != id);
+    if (result == COMM_SUCCESS && error != 0)   *error = rxpacket[8];
+    return result;
+}
+
+int DXLPacketHandler::ping(dynamixel::PortHandler *port, uint8_t id, uint8_t *error) {
+    return ping(port, id, 0, error);
+}
+
+int DXLPacketHandler::ping(dynamixel::PortHandler *port, uint8_t id, uint16_t *model_number, uint8_t *error) {
+    if (id >= DXL_PACKET_BROADCAST_ID)  return COMM_NOT_AVAILABLE;
+    uint8_t tx[16];
+    DXLPacketWriter writer(tx, sizeof(tx), id, INST_PING);
+    DXLStatusView status;
+    int result = txRxStatus(port, tx, writer.finish(), id, 3, status);
+    if (result != COMM_SUCCESS)     return result;
+    if (error != 0)     *error = status.error;
+    if (model_number != 0 && status.length >= 2)    *model_number = DXL_MAKEWORD(status.params[0], status.params[1]);
+    return COMM_SUCCESS;
+}
+
+int DXLPacketHandler::broadcastPing(dynamixel::PortHandler *port, std::vector<uint8_t> &id_list) {
+    const size_t statusLength = 14;                     // Ping reply: model number and firmware version
+    const int maxId = 252;
+    id_list.clear();
+
+    uint8_t tx[16];
+    DXLPacketWriter writer(tx, sizeof(tx), DXL_PACKET_BROADCAST_ID, INST_PING);
+    int result = sendPacket(port, tx, writer.finish());
+    if (result != COMM_SUCCESS)     return result;
+
+    std::vector<uint8_t> rx(statusLength * maxId);
+    double txTimePerByteMs = (1000.0 / double(port->getBaudRate())) * 10.0;
+    port->setPacketTimeout(double(rx.size()) * txTimePerByteMs + 3.0 * maxId);     // Every ID answers in turn
+    size_t received = 0;
+    while (received < rx.size() && !port->isPacketTimeout()) {
+        int n = port->readPort(&rx[received], int(rx.size() - received));
+        if (n > 0)  received += size_t(n);
+    }
+    busOf(port)->is_using_ = false;
+
+    size_t offset = 0;
+    while (offset < received) {
+        DXLStatusView status;
+        size_t consumed;
+        result = dxlParseStatus(&rx[offset], received - offset, status, consumed);
+        offset += consumed;
+        if (result == COMM_SUCCESS)     id_list.push_back(status.id);
+        else if (result == COMM_RX_WAITING)     break;
+    }
+    return id_list.empty() ? COMM_RX_TIMEOUT : COMM_SUCCESS;
+}
+
+int DXLPacketHandler::action(dynamixel::PortHandler *port, uint8_t id) {
+    uint8_t tx[16];
+    DXLPacketWriter writer(tx, sizeof(tx), id, INST_ACTION);
+    DXLStatusView status;
+    return txRxStatus(port, tx, writer.finish(), id, 0, status);
+}
+
+int DXLPacketHandler::reboot(dynamixel::PortHandler *port, uint8_t id, uint8_t *error) {
+    uint8_t tx[16];
+    DXLPacketWriter writer(tx, sizeof(tx), id, INST_REBOOT);
+    DXLStatusView status;
+    int result = txRxStatus(port, tx, writer.finish(), id, 0, status);
+    if (result == COMM_SUCCESS && error != 0 && id != DXL_PACKET_BROADCAST_ID)  *error = status.error;
+    return result;
+}
+
+int DXLPacketHandler::factoryReset(dynamixel::PortHandler *port, uint8_t id, uint8_t option, uint8_t *error) {
+    uint8_t tx[16];
+    DXLPacketWriter writer(tx, sizeof(tx), id, INST_FACTORY_RESET);
+    writer.put8(option);
+    DXLStatusView status;
+    int result = txRxStatus(port, tx, writer.finish(), id, 0, status);
+    if (result == COMM_SUCCESS && error != 0 && id != DXL_PACKET_BROADCAST_ID)  *error = status.error;
+    return result;
+}
+
+int DXLPacketHandler::readTx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t length) {
+    if (id >= DXL_PACKET_BROADCAST_ID)  return COMM_NOT_AVAILABLE;
+    uint8_t tx[16];
+    DXLPacketWriter writer(tx, sizeof(tx), id, INST_READ);
+    writer.put16(address);
+    writer.put16(length);
+    int result = sendPacket(port, tx, writer.finish());
+    if (result == COMM_SUCCESS)     port->setPacketTimeout(uint16_t(length + DXL_PACKET_STATUS_MIN_LENGTH));
+    return result;
+}
+
+int DXLPacketHandler::readRx(dynamixel::PortHandler *port, uint8_t id, uint16_t length, uint8_t *data, uint8_t *error) {
+    DXLStatusView status;
+    int result;
+    do {
+        result = rxStatus(port, status);
+    } while (result == COMM_SUCCESS && status.id != id);
+    if (result != COMM_SUCCESS)     return result;
+
+    if (error != 0)     *error = status.error;
+    if (status.length < length) {
+        if (status.error == 0)  return COMM_RX_CORRUPT;
+        memset(data, 0, length);                        // Error replies carry no data
+    }
+    memcpy(data, status.params, status.length < length ? status.length : length);
+    return COMM_SUCCESS;
+}
+
+int DXLPacketHandler::readTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t length, uint8_t *data, uint8_t *error) {
+    if (id >= DXL_PACKET_BROADCAST_ID)  return COMM_NOT_AVAILABLE;
+    uint8_t tx[16];
+    DXLPacketWriter writer(tx, sizeof(tx), id, INST_READ);
+    writer.put16(address);
+    writer.put16(length);
+    DXLStatusView status;
+    int result = txRxStatus(port, tx, writer.finish(), id, length, status);
+    if (result != COMM_SUCCESS)     return result;
+
+    if (error != 0)     *error = status.error;
+    if (status.length < length) {
+        if (status.error == 0)  return COMM_RX_CORRUPT;
+        memset(data, 0, length);
+    }
+    memcpy(data, status.params, status.length < length ? status.length : length);
+    return COMM_SUCCESS;
+}
+
+int DXLPacketHandler::read1ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint8_t *data, uint8_t *error) {
+    return readTxRx(port, id, address, 1, data, error);
+}
+
+int DXLPacketHandler::read2ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t *data, uint8_t *error) {
+    uint8_t bytes[2] = { 0, 0 };
+    int result = readTxRx(port, id, address, 2, bytes, error);
+    if (result == COMM_SUCCESS)     *data = DXL_MAKEWORD(bytes[0], bytes[1]);
+    return result;
+}
+
+int DXLPacketHandler::read4ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint32_t *data, uint8_t *error) {
+    uint8_t bytes[4] = { 0, 0, 0, 0 };
+    int result = readTxRx(port, id, address, 4, bytes, error);
+    if (result == COMM_SUCCESS)     *data = DXL_MAKEDWORD(DXL_MAKEWORD(bytes[0], bytes[1]), DXL_MAKEWORD(bytes[2], bytes[3]));
+    return result;
+}
+
+int DXLPacketHandler::writeTxOnly(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t length, uint8_t *data) {
+    uint8_t tx[DXL_PACKET_MAX_LENGTH];
+    DXLPacketWriter writer(tx, sizeof(tx), id, INST_WRITE);
+    writer.put16(address);
+    writer.put(data, length);
+    int result = sendPacket(port, tx, writer.finish());
+    if (result == COMM_SUCCESS)     busOf(port)->is_using_ = false;
+    return result;
+}
+
+int DXLPacketHandler::writeTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t length, uint8_t *data, uint8_t *error) {
+    uint8_t tx[DXL_PACKET_MAX_LENGTH];
+    DXLPacketWriter writer(tx, sizeof(tx), id, INST_WRITE);
+    writer.put16(address);
+    writer.put(data, length);
+    DXLStatusView status;
+    int result = txRxStatus(port, tx, writer.finish(), id, 0, status);
+    if (result == COMM_SUCCESS && error != 0 && id != DXL_PACKET_BROADCAST_ID)  *error = status.error;
+    return result;
+}
+
+int DXLPacketHandler::write1ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint8_t data, uint8_t *error) {
+    return writeTxRx(port, id, address, 1, &data, error);
+}
+
+int DXLPacketHandler::write2ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t data, uint8_t *error) {
+    uint8_t bytes[2] = { DXL_LOBYTE(data), DXL_HIBYTE(data) };
+    return writeTxRx(port, id, address, 2, bytes, error);
+}
+
+int DXLPacketHandler::write4ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint32_t data, uint8_t *error) {
+    uint8_t bytes[4] = { DXL_LOBYTE(DXL_LOWORD(data)), DXL_HIBYTE(DXL_LOWORD(data)), DXL_LOBYTE(DXL_HIWORD(data)), DXL_HIBYTE(DXL_HIWORD(data)) };
+    return writeTxRx(port, id, address, 4, bytes, error);
+}
+
+int DXLPacketHandler::syncReadTx(dynamixel::PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length) {
+    uint8_t tx[DXL_PACKET_MAX_LENGTH];
+    DXLPacketWriter writer(tx, sizeof(tx), DXL_PACKET_BROADCAST_ID, INST_SYNC_READ);
+    writer.put16(start_address);
+    writer.put16(data_length);
+    writer.put(param, param_length);
+    int result = sendPacket(port, tx, writer.finish());
+    if (result == COMM_SUCCESS)     port->setPacketTimeout(uint16_t((DXL_PACKET_STATUS_MIN_LENGTH + data_length) * param_length));
+    return result;
+}
+
+int DXLPacketHandler::syncWriteTxOnly(dynamixel::PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length) {
+    uint8_t tx[DXL_PACKET_MAX_LENGTH];
+    DXLPacketWriter writer(tx, sizeof(tx), DXL_PACKET_BROADCAST_ID, INST_SYNC_WRITE);
+    writer.put16(start_address);
+    writer.put16(data_length);
+    writer.put(param, param_length);
+    int result = sendPacket(port, tx, writer.finish());
+    if (result == COMM_SUCCESS)     busOf(port)->is_using_ = false;
+    return result;
+}
+
+int DXLPacketHandler::bulkReadTx(dynamixel::PortHandler *port, uint8_t *param, uint16_t param_length) {
+    uint8_t tx[DXL_PACKET_MAX_LENGTH];
+    DXLPacketWriter writer(tx, sizeof(tx), DXL_PACKET_BROADCAST_ID, INST_BULK_READ);
+    writer.put(param, param_length);
+    int result = sendPacket(port, tx, writer.finish());
+    if (result == COMM_SUCCESS) {
+        size_t wait = 0;
+        for (uint16_t i = 0; i + 5 <= param_length; i += 5)     wait += DXL_MAKEWORD(param[i + 3], param[i + 4]) + DXL_PACKET_STATUS_MIN_LENGTH;      // ID, address, length per entry
+        port->setPacketTimeout(uint16_t(wait));
+    }
+    return result;
+}
+
+int DXLPacketHandler::bulkWriteTxOnly(dynamixel::PortHandler *port, uint8_t *param, uint16_t param_length) {
+    uint8_t tx[DXL_PACKET_MAX_LENGTH];
+    DXLPacketWriter writer(tx, sizeof(tx), DXL_PACKET_BROADCAST_ID, INST_BULK_WRITE);
+    writer.put(param, param_length);
+    int result = sendPacket(port, tx, writer.finish());
+    if (result == COMM_SUCCESS)     busOf(port)->is_using_ = false;
+    return result;
+}
+
+int DXLPacketHandler::syncReadTxRx(dynamixel::PortHandler *port, uint16_t startAddress, uint16_t dataLength, const uint8_t *ids, int count,
+                                   uint8_t *rxBuffer, size_t rxCapacity, DXLStatusView *statuses, int &received) {
+    received = 0;
+    int result = syncReadTx(port, startAddress, dataLength, const_cast<uint8_t *>(ids), uint16_t(count));
+    if (result != COMM_SUCCESS)     return result;
+
+    size_t available = 0, parsed = 0;                   // Replies stay where they land, views point at them
+    size_t wait = size_t(count) * (DXL_PACKET_STATUS_MIN_LENGTH + dataLength);
+    if (wait > rxCapacity)  wait = rxCapacity;
+    bool corrupt = false;
+    for (;;) {
+        if (available < wait) {
+            int n = port->readPort(rxBuffer + available, int(wait - available));
+            if (n > 0)  available += size_t(n);
+        }
+        while (received < count && parsed < available) {
+            size_t consumed, needed;
+            result = dxlParseStatus(rxBuffer + parsed, available - parsed, statuses[received], consumed, &needed);
+            if (result == COMM_RX_WAITING) {
+                if (parsed + needed > wait)     wait = parsed + needed > rxCapacity ? rxCapacity : parsed + needed;      // Stuffing made a reply longer
+                parsed += consumed;
+                break;
+            }
+            parsed += consumed;
+            if (result == COMM_SUCCESS)     received++;
+            else    corrupt = true;
+        }
+        if (received == count) {
+            result = COMM_SUCCESS;
+            break;
+        }
+        if (wait <= available)  wait = available + DXL_PACKET_STATUS_MIN_LENGTH > rxCapacity ? rxCapacity : available + DXL_PACKET_STATUS_MIN_LENGTH;     // Corrupt reply skipped, more to come
+        if (available >= rxCapacity) {
+            result = COMM_RX_FAIL;
+            break;
+        }
+        if (available < wait && port->isPacketTimeout()) {
+            result = corrupt ? COMM_RX_CORRUPT : COMM_RX_TIMEOUT;
+            break;
+        }
+    }
+    busOf(port)->is_using_ = false;
+    return result;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code: encode/decode cost per packet    ///////////////////////////////////////////////////////////////////////////
+// No port needed, times the codec alone against the SDK's byte at a time CRC. Sync Read reply: 8 servos, 4 bytes each.
+#include <chrono>
+
+    const int rounds = 1000000;
+    uint8_t packet[64], replies[8 * 15];
+    uint8_t position[4] = { 0x00, 0x08, 0x00, 0x00 };
+    size_t replySize = 0;
+    for (uint8_t id = 1; id <= 8; id++) {                          // Build the reply burst once
+        DXLPacketWriter writer(replies + replySize, sizeof(replies) - replySize, id, INST_STATUS);
+        writer.put8(0);                                             // Error byte
+        writer.put(position, 4);
+        replySize += writer.finish();
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    size_t bytes = 0;
+    for (int i = 0; i < rounds; i++) {
+        DXLPacketWriter writer(packet, sizeof(packet), 1, INST_WRITE);
+        writer.put16(ADDR_PRO_GOAL_POSITION);
+        writer.put32(uint32_t(i));
+        bytes += writer.finish();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    uint8_t work[sizeof(replies)];
+    DXLStatusView statuses[8];
+    int found = 0;
+    for (int i = 0; i < rounds; i++) {
+        memcpy(work, replies, replySize);                           // Parsing unstuffs in place
+        dxlParseStatuses(work, replySize, statuses, 8, found);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    dynamixel::Protocol2PacketHandler *sdk = dynamixel::Protocol2PacketHandler::getInstance();
+    uint16_t crc = 0;
+    for (int i = 0; i < rounds; i++)    crc ^= sdk->updateCRC(0, replies, uint16_t(replySize - 2));
+    auto t3 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)    crc ^= dxlCrc16(0, replies, replySize - 2);
+    auto t4 = std::chrono::steady_clock::now();
+
+    double ns = 1e9 / rounds;
+    printf("encode write: %.1f ns/packet\n", std::chrono::duration<double>(t1 - t0).count() * ns);
+    printf("decode sync read reply: %.1f ns/servo\n", std::chrono::duration<double>(t2 - t1).count() * ns / 8);
+    printf("CRC over %zu bytes: SDK %.1f ns, slice-by-4 %.1f ns (%u %zu)\n", replySize - 2, std::chrono::duration<double>(t3 - t2).count() * ns,
+        std::chrono::duration<double>(t4 - t3).count() * ns, crc, bytes);
+
+    // Running DXLServo on the native handler
+    DXLServo servo;
+    servo.setDXLServo(1);
+    servo.setPacketBackend(DXL_PACKET_NATIVE);
+    servo.initPortHandler();
+    servo.initPacketHandler();
+    servo.openPort();
+    servo.setPortBaudRate();
+    printf("position %d\n", servo.readCurrentPosition());
+
+    // Reads per Sync Read: with everything arrived at one wakeup this prints 1 whatever the servo count
+    DXLPacketHandler *native = static_cast<DXLPacketHandler *>(servo.pktHandler);
+    dynamixel::GroupSyncRead syncRead(servo.prtHandler, native, ADDR_PRO_PRESENT_POSITION, 4);
+    for (uint8_t id = 1; id <= 8; id++)     syncRead.addParam(id);
+    uint64_t before = native->rxReads(servo.prtHandler);
+    syncRead.txRxPacket();
+    printf("reads for 8 replies: %llu\n", (unsigned long long)(native->rxReads(servo.prtHandler) - before));
+// End of Example Code
+*/
@@ -0,0 +1,155 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Native Dynamixel Protocol 2.0 packet codec and a PacketHandler built on it.
+
+Codec: packets are encoded straight into caller buffers and status packets are decoded where they were received, so
+nothing is allocated or copied on either path.
+    DXLPacketWriter     instruction packet builder. Parameters are byte stuffed as they are appended, a memchr() for 0xFD
+                        decides whether a run can be copied as is (it nearly always can).
+    dxlCrc16()          CRC-16 (poly 0x8005), slice-by-4 tables: four table lookups per 4 bytes instead of one per byte.
+    dxlParseStatus()    finds, checks and unstuffs one status packet in place. DXLStatusView then points into the buffer.
+    dxlParseStatuses()  the same over a buffer holding the back to back replies of a Sync or Bulk Read.
+
+Receive: DXLStatusStream keeps a ring buffer per port. Each fill() is one read of whatever the port has (with
+DXLPortHandlerLinux: one read() per epoll wakeup), and an incremental state machine (sync on FF FF FD 00, header, body)
+picks complete status packets out of it without rescanning bytes it has already seen. Replies that arrived together are
+then handed out without further reads, so the reads per Sync/Bulk Read stay about constant with the number of servos,
+where the SDK makes at least two per status packet (header, then rest).
+
+DXLPacketHandler implements dynamixel::PacketHandler for Protocol 2.0 with the codec, so DXLServo and the SDK Group*
+classes run on it unchanged. Select with DXLServo::setPacketBackend(DXL_PACKET_NATIVE) before initPacketHandler().
+Packet buffers live on the stack instead of the SDK's malloc() per call. syncReadTxRx() additionally returns every reply
+of a Sync Read as views into one receive buffer.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+#include "DXLPortHandlerLinux.h"
+
+#define DXL_PACKET_MAX_LENGTH           1024            // Whole packet after stuffing, as SDK TXPACKET_MAX_LEN/RXPACKET_MAX_LEN
+#define DXL_PACKET_HEADER_LENGTH        8               // FF FF FD 00, ID, length (2), instruction
+#define DXL_PACKET_STATUS_MIN_LENGTH    11              // Header, error, CRC
+#define DXL_PACKET_BROADCAST_ID         0xFE
+#define DXL_RX_RING_SIZE                4096            // Power of two, holds a broadcast ping's replies
+
+uint16_t dxlCrc16(uint16_t crc, const uint8_t *data, size_t length);     // Start with crc = 0
+
+class DXLPacketWriter {
+private:
+    uint8_t *buffer;
+    size_t capacity, size;
+    uint8_t previous[2];                                // Last two unstuffed bytes, stuffing looks across put() calls
+    bool overflow;
+
+public:
+    DXLPacketWriter(uint8_t *out, size_t outCapacity, uint8_t id, uint8_t instruction);
+
+    void put(const uint8_t *data, size_t length);       // Appends parameters with byte stuffing
+    void put8(uint8_t value) { put(&value, 1); }
+    void put16(uint16_t value);                         // Little endian
+    void put32(uint32_t value);
+    size_t finish();                                    // Fills length and CRC. Packet size, 0 if it did not fit.
+};
+
+struct DXLStatusView {                                  // Decoded status packet, params point into the receive buffer
+    uint8_t id;
+    uint8_t error;
+    const uint8_t *params;                              // Parameters after the error byte, already unstuffed
+    uint16_t length;
+};
+
+// COMM_SUCCESS, COMM_RX_WAITING or COMM_RX_CORRUPT. consumed: bytes done with, noise and corrupt packets included.
+// needed (optional): buffer bytes the pending packet takes, so the caller can read exactly that much more.
+int dxlParseStatus(uint8_t *buffer, size_t available, DXLStatusView &status, size_t &consumed, size_t *needed = 0);
+int dxlParseStatuses(uint8_t *buffer, size_t available, DXLStatusView *statuses, int maxStatuses, int &count);     // Sync/Bulk Read replies, COMM_SUCCESS once maxStatuses found
+
+class DXLStatusStream {
+private:
+    enum State { SYNC, HEADER, BODY };
+
+    dynamixel::PortHandler *port;
+#if defined(__linux__)
+    DXLPortHandlerLinux *linuxPort;                     // Non zero if port supports readAvailable()
+#endif
+    uint8_t ring[DXL_RX_RING_SIZE];
+    uint8_t scratch[DXL_PACKET_MAX_LENGTH];             // Packets that wrap around the ring end are parsed here
+    size_t head, tail, scan;                            // Free running: head = oldest kept byte, scan = next byte to examine
+    size_t total;                                       // Packet length once header seen
+    State state;
+    uint64_t readCalls;
+
+    uint8_t at(size_t index) const { return ring[index & (DXL_RX_RING_SIZE - 1)]; }
+
+public:
+    explicit DXLStatusStream(dynamixel::PortHandler *streamPort);
+
+    void reset();                                       // Drop buffered bytes, before sending an instruction
+    int fill();                                         // One read of whatever arrived, returns bytes added
+    int next(DXLStatusView &status);                    // COMM_SUCCESS, COMM_RX_CORRUPT (packet dropped) or COMM_RX_WAITING. View valid until next fill().
+    size_t buffered() const { return tail - head; }
+    uint64_t reads() const { return readCalls; }
+};
+
+class DXLPacketHandler : public dynamixel::PacketHandler {
+private:
+    std::mutex streamsLock;
+    std::map<dynamixel::PortHandler *, std::unique_ptr<DXLStatusStream> > streams;
+
+    DXLStatusStream &streamFor(dynamixel::PortHandler *port);
+    int rxStatus(dynamixel::PortHandler *port, DXLStatusView &status);     // One status packet, sets is_using_ false. View valid until next receive on port.
+    int txRxStatus(dynamixel::PortHandler *port, uint8_t *txPacket, size_t txLength, uint8_t id, uint16_t readLength, DXLStatusView &status);
+
+public:
+    DXLPacketHandler() {}
+    virtual ~DXLPacketHandler() {}
+
+    int sendPacket(dynamixel::PortHandler *port, const uint8_t *packet, size_t length);     // Encoded packet, claims port (COMM_PORT_BUSY if in use)
+    uint64_t rxReads(dynamixel::PortHandler *port);     // Reads made by the port's status stream so far
+
+    // Sync Read of count IDs into rxBuffer (count * (11 + dataLength) bytes plus stuffing). statuses[i] is filled in
+    // order of arrival. received: replies decoded before the result, COMM_RX_TIMEOUT if some IDs did not answer.
+    int syncReadTxRx(dynamixel::PortHandler *port, uint16_t startAddress, uint16_t dataLength, const uint8_t *ids, int count,
+                     uint8_t *rxBuffer, size_t rxCapacity, DXLStatusView *statuses, int &received);
+
+    virtual float getProtocolVersion() { return 2.0; }
+    virtual const char *getTxRxResult(int result);
+    virtual const char *getRxPacketError(uint8_t error);
+    virtual void printTxRxResult(int result);
+    virtual void printRxPacketError(uint8_t error);
+
+    // SDK layout: txpacket/rxpacket unstuffed, txpacket length field must be set by the caller
+    virtual int txPacket(dynamixel::PortHandler *port, uint8_t *txpacket);
+    virtual int rxPacket(dynamixel::PortHandler *port, uint8_t *rxpacket);
+    virtual int txRxPacket(dynamixel::PortHandler *port, uint8_t *txpacket, uint8_t *rxpacket, uint8_t *error = 0);
+
+    virtual int ping(dynamixel::PortHandler *port, uint8_t id, uint8_t *error = 0);
+    virtual int ping(dynamixel::PortHandler *port, uint8_t id, uint16_t *model_number, uint8_t *error = 0);
+    virtual int broadcastPing(dynamixel::PortHandler *port, std::vector<uint8_t> &id_list);
+    virtual int action(dynamixel::PortHandler *port, uint8_t id);
+    virtual int reboot(dynamixel::PortHandler *port, uint8_t id, uint8_t *error = 0);
+    virtual int factoryReset(dynamixel::PortHandler *port, uint8_t id, uint8_t option = 0, uint8_t *error = 0);
+
+    virtual int readTx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t length);
+    virtual int readRx(dynamixel::PortHandler *port, uint8_t id, uint16_t length, uint8_t *data, uint8_t *error = 0);
+    virtual int readTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t length, uint8_t *data, uint8_t *error = 0);
+    virtual int read1ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint8_t *data, uint8_t *error = 0);
+    virtual int read2ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t *data, uint8_t *error = 0);
+    virtual int read4ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint32_t *data, uint8_t *error = 0);
+
+    virtual int writeTxOnly(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t length, uint8_t *data);
+    virtual int writeTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t length, uint8_t *data, uint8_t *error = 0);
+    virtual int write1ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint8_t data, uint8_t *error = 0);
+    virtual int write2ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint16_t data, uint8_t *error = 0);
+    virtual int write4ByteTxRx(dynamixel::PortHandler *port, uint8_t id, uint16_t address, uint32_t data, uint8_t *error = 0);
+
+    virtual int syncReadTx(dynamixel::PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length);
+    virtual int syncWriteTxOnly(dynamixel::PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length);
+    virtual int bulkReadTx(dynamixel::PortHandler *port, uint8_t *param, uint16_t param_length);
+    virtual int bulkWriteTxOnly(dynamixel::PortHandler *port, uint8_t *param, uint16_t param_length);
+};
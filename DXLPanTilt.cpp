@@ -0,0 +1,205 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Pan-tilt head kinematics and tracker. See DXLPanTilt.h.
+
+Offsets are handled in closed form: with lateral offset l the pan angle is atan2(dy, dx) - asin(l / r), written as
+atan2(l, sqrt(r^2 - l^2)) so the loop needs only atan2 and sqrt. Same for the optical offset on tilt.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLPanTilt.h"
+
+#include <cmath>
+
+#define PANTILT_RAD_TO_DEG      57.29577951308232
+#define MX_TICKS_PER_DEG        (4095.0 / 360.0)        // As convertPostoVal()
+#define PRO_TICKS_PER_DEG       (131593.0 / 180.0)
+
+////////////////////////////////////////////////////   DXLPanTilt class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLPanTilt::DXLPanTilt(DXLServo *panServo, DXLServo *tiltServo, const DXLPanTiltGeometry &geom) {
+    pan = panServo;
+    tilt = tiltServo;
+    geometry = geom;
+    panTicksPerDeg = (pan->servoType == DXL_PRO_M42) ? PRO_TICKS_PER_DEG : MX_TICKS_PER_DEG;
+    tiltTicksPerDeg = (tilt->servoType == DXL_PRO_M42) ? PRO_TICKS_PER_DEG : MX_TICKS_PER_DEG;
+    panMin = pan->getPositionLimitSetting(false);
+    panMax = pan->getPositionLimitSetting(true);
+    tiltMin = tilt->getPositionLimitSetting(false);
+    tiltMax = tilt->getPositionLimitSetting(true);
+    panHome = 0;
+    tiltHome = 0;
+    lastPan = 0;
+    lastTilt = 0;
+    haveLast = false;
+}
+
+void DXLPanTilt::useServoLimits() {
+    setJointLimits(pan->getPositionLimitSetting(false), pan->getPositionLimitSetting(true), tilt->getPositionLimitSetting(false), tilt->getPositionLimitSetting(true));
+    panHome = pan->getHomingOffset();
+    tiltHome = tilt->getHomingOffset();
+}
+
+void DXLPanTilt::setJointLimits(int panMinimum, int panMaximum, int tiltMinimum, int tiltMaximum) {
+    panMin = std::min(panMinimum, panMaximum);
+    panMax = std::max(panMinimum, panMaximum);
+    tiltMin = std::min(tiltMinimum, tiltMaximum);
+    tiltMax = std::max(tiltMinimum, tiltMaximum);
+}
+
+bool DXLPanTilt::solveAngles(double x, double y, double z, double &panDeg, double &tiltDeg) const {
+    double dx = x - geometry.originX, dy = y - geometry.originY, dz = z - geometry.originZ;
+    double r2 = dx * dx + dy * dy;
+    double l = geometry.lateral, o = geometry.optical;
+    if (r2 <= l * l)    return false;                   // Target inside offset circle of pan axis
+
+    double along = sqrt(r2 - l * l);                    // Horizontal distance along boresight
+    panDeg = (atan2(dy, dx) - atan2(l, along)) * PANTILT_RAD_TO_DEG;
+
+    double rh = along - geometry.tiltForward;
+    double d2 = rh * rh + dz * dz;
+    if (d2 <= o * o)    return false;
+    tiltDeg = (atan2(dz, rh) - atan2(o, sqrt(d2 - o * o))) * PANTILT_RAD_TO_DEG;
+    return true;
+}
+
+bool DXLPanTilt::solve(double x, double y, double z, int &panTicks, int &tiltTicks) const {
+    uint8_t clamped = 0;
+    solveBatch(&x, &y, &z, 1, &panTicks, &tiltTicks, &clamped);
+    return clamped == 0;
+}
+
+size_t DXLPanTilt::solveBatch(const double *x, const double *y, const double *z, size_t count, int *panTicks, int *tiltTicks, uint8_t *clamped) const {
+    const double ox = geometry.originX, oy = geometry.originY, oz = geometry.originZ;
+    const double l = geometry.lateral, l2 = l * l, o = geometry.optical, o2 = o * o, forward = geometry.tiltForward;
+    const double panScale = geometry.panDirection * PANTILT_RAD_TO_DEG * panTicksPerDeg;
+    const double tiltScale = geometry.tiltDirection * PANTILT_RAD_TO_DEG * tiltTicksPerDeg;
+    const double panBase = geometry.panZeroAngle * panTicksPerDeg - double(panHome) + 0.5;     // +0.5: round as convertPostoVal()
+    const double tiltBase = geometry.tiltZeroAngle * tiltTicksPerDeg - double(tiltHome) + 0.5;
+    const double pMin = std::max(panMin, pan->getPositionLimitSetting(false)), pMax = std::min(panMax, pan->getPositionLimitSetting(true));
+    const double tMin = std::max(tiltMin, tilt->getPositionLimitSetting(false)), tMax = std::min(tiltMax, tilt->getPositionLimitSetting(true));
+
+    size_t clampCount = 0;
+    for (size_t i = 0; i < count; i++) {                // No branches: invalid targets are flagged, not skipped
+        double dx = x[i] - ox, dy = y[i] - oy, dz = z[i] - oz;
+        double r2 = dx * dx + dy * dy;
+        double along = sqrt(std::max(r2 - l2, 0.0));
+        double panRad = atan2(dy, dx) - atan2(l, along);
+        double rh = along - forward;
+        double d2 = rh * rh + dz * dz;
+        double tiltRad = atan2(dz, rh) - atan2(o, sqrt(std::max(d2 - o2, 0.0)));
+
+        double p = panBase + panScale * panRad;
+        double t = tiltBase + tiltScale * tiltRad;
+        double pc = std::min(std::max(p, pMin), pMax);
+        double tc = std::min(std::max(t, tMin), tMax);
+        panTicks[i] = int(floor(pc));
+        tiltTicks[i] = int(floor(tc));
+
+        uint8_t bad = uint8_t((r2 <= l2) | (d2 <= o2) | (pc != p) | (tc != t));
+        if (clamped != 0)   clamped[i] = bad;
+        clampCount += bad;
+    }
+    return clampCount;
+}
+
+int DXLPanTilt::writeGoals(int panTicks, int tiltTicks) {
+    int result;
+    uint8_t panData[4] = { DXL_LOBYTE(DXL_LOWORD(panTicks)), DXL_HIBYTE(DXL_LOWORD(panTicks)), DXL_LOBYTE(DXL_HIWORD(panTicks)), DXL_HIBYTE(DXL_HIWORD(panTicks)) };
+    uint8_t tiltData[4] = { DXL_LOBYTE(DXL_LOWORD(tiltTicks)), DXL_HIBYTE(DXL_LOWORD(tiltTicks)), DXL_LOBYTE(DXL_HIWORD(tiltTicks)), DXL_HIBYTE(DXL_HIWORD(tiltTicks)) };
+    uint16_t panAddress = (pan->servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION;
+    uint16_t tiltAddress = (tilt->servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION;
+
+    if (panAddress == tiltAddress) {
+        dynamixel::GroupSyncWrite syncWrite(DXLTimeoutPort::underlying(pan->prtHandler), pan->pktHandler, panAddress, 4);
+        syncWrite.addParam(uint8_t(pan->identity), panData);
+        syncWrite.addParam(uint8_t(tilt->identity), tiltData);
+        result = syncWrite.txPacket();
+    }
+    else {                                              // Mixed MX/Pro head
+        dynamixel::GroupBulkWrite bulkWrite(DXLTimeoutPort::underlying(pan->prtHandler), pan->pktHandler);
+        bulkWrite.addParam(uint8_t(pan->identity), panAddress, 4, panData);
+        bulkWrite.addParam(uint8_t(tilt->identity), tiltAddress, 4, tiltData);
+        result = bulkWrite.txPacket();
+    }
+    return result;
+}
+
+int DXLPanTilt::lookAt(double x, double y, double z) {
+    double panDeg, tiltDeg;
+    if (!solveAngles(x, y, z, panDeg, tiltDeg)) {      // No pointing at all, do not move
+        DXL_LOG_ERROR(pan->identity, DXL_LOG_NONE, DXL_COMM_OUT_OF_RANGE, "Look at (%g, %g, %g) unreachable, target inside the head offsets", x, y, z);
+        pan->dxl_comm_result = DXL_COMM_OUT_OF_RANGE;
+        return DXL_COMM_OUT_OF_RANGE;
+    }
+    int panTicks, tiltTicks;
+    bool reachable = solve(x, y, z, panTicks, tiltTicks);
+    if (!reachable)     DXL_LOG_WARN(pan->identity, DXL_LOG_NONE, DXL_COMM_OUT_OF_RANGE, "Look at (%g, %g, %g) beyond position limits, goals clamped", x, y, z);
+
+    int result;
+    if (pan->getBusScheduler() != 0)    result = pan->getBusScheduler()->runSync(DXL_PRIO_CONTROL, [&]() { return writeGoals(panTicks, tiltTicks); });
+    else                                result = writeGoals(panTicks, tiltTicks);
+    pan->dxl_comm_result = result;
+    if (result != COMM_SUCCESS) {
+        DXL_LOG_ERROR(pan->identity, DXL_LOG_NONE, result, "%s", pan->pktHandler->getTxRxResult(result));
+        return result;
+    }
+    lastPan = panTicks;
+    lastTilt = tiltTicks;
+    haveLast = true;
+    if (!reachable)     pan->dxl_comm_result = DXL_COMM_OUT_OF_RANGE;
+    return pan->dxl_comm_result;
+}
+
+int DXLPanTilt::trackNearest(const double *x, const double *y, const double *z, size_t count, size_t &chosen) {
+    chosen = count;
+    if (count == 0)     return COMM_SUCCESS;
+    panScratch.resize(count);
+    tiltScratch.resize(count);
+    clampScratch.resize(count);
+    solveBatch(x, y, z, count, &panScratch[0], &tiltScratch[0], &clampScratch[0]);
+
+    double bestCost = 0.0;                              // Prefer reachable targets, then smallest joint move (normalized to degrees)
+    for (size_t i = 0; i < count; i++) {
+        double dp = haveLast ? double(panScratch[i] - lastPan) / panTicksPerDeg : 0.0;
+        double dt = haveLast ? double(tiltScratch[i] - lastTilt) / tiltTicksPerDeg : 0.0;
+        double cost = dp * dp + dt * dt + (clampScratch[i] ? 1.0e12 : 0.0);
+        if (chosen == count || cost < bestCost) {
+            chosen = i;
+            bestCost = cost;
+        }
+    }
+
+    int result;
+    int panTicks = panScratch[chosen], tiltTicks = tiltScratch[chosen];
+    if (pan->getBusScheduler() != 0)    result = pan->getBusScheduler()->runSync(DXL_PRIO_CONTROL, [&]() { return writeGoals(panTicks, tiltTicks); });
+    else                                result = writeGoals(panTicks, tiltTicks);
+    pan->dxl_comm_result = result;
+    if (result == COMM_SUCCESS) {
+        lastPan = panTicks;
+        lastTilt = tiltTicks;
+        haveLast = true;
+    }
+    return result;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLPanTilt    ///////////////////////////////////////////////////////////////////////////
+    panServo.setPositionLimit(false, 90.0);              // Joint limits picked up by DXLPanTilt
+    panServo.setPositionLimit(true, 270.0);
+    tiltServo.setPositionLimit(false, 135.0);
+    tiltServo.setPositionLimit(true, 225.0);
+
+    DXLPanTiltGeometry geometry;
+    geometry.originZ = 0.45;                            // Tilt axis 45cm above floor
+    geometry.tiltForward = 0.02;
+    geometry.optical = 0.035;                           // Camera lens 3.5cm above tilt axis
+    DXLPanTilt head(&panServo, &tiltServo, geometry);
+    head.useServoLimits();
+
+    for (;;) {                                          // Detector output in metres, robot frame
+        std::vector<double> xs, ys, zs;
+        detector.next(xs, ys, zs);
+        size_t chosen;
+        if (head.trackNearest(&xs[0], &ys[0], &zs[0], xs.size(), chosen) != COMM_SUCCESS)   break;
+    }
+// End of Example Code
+*/
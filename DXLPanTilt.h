@@ -0,0 +1,65 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Pan-tilt head kinematics: 3D target point to pan/tilt goal positions, and a tracker that writes both goals in one sync write.
+
+Frame: x forward, y left, z up, origin on the pan axis at the height of the tilt axis (originX/Y/Z in DXLPanTiltGeometry).
+Pan rotates about z, positive towards +y. Tilt rotates about the panned y axis, positive raises the boresight.
+Offsets (metres):
+- tiltForward: tilt axis ahead of pan axis along the panned x direction
+- lateral:     boresight beside the pan axis (left positive), e.g. camera mounted off centre
+- optical:     boresight above the tilt axis, perpendicular to it
+Servo angle = zero angle + direction * joint angle, then ticks as writeGoalAngle(): convertPostoVal(angle) - homing offset.
+Results clamped to joint limits, taken from setPositionLimit() values by default, and never past the limits last set through
+each servo (getPositionLimitSetting()), even if those changed after setJointLimits().
+
+solveBatch() works on structure-of-arrays input with a branch free loop body, so the compiler can vectorize it
+(gcc -O3 -ffast-math uses libmvec atan2/sqrt).
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+struct DXLPanTiltGeometry {
+    double originX, originY, originZ;                   // Pan/tilt reference point in target frame
+    double tiltForward, lateral, optical;               // Offsets, see above
+    double panZeroAngle, tiltZeroAngle;                 // Servo angle (degrees, as convertValtoPos()) when looking along +x, level
+    double panDirection, tiltDirection;                 // +1 or -1, servo angle change per joint angle change
+
+    DXLPanTiltGeometry() : originX(0.0), originY(0.0), originZ(0.0), tiltForward(0.0), lateral(0.0), optical(0.0),
+        panZeroAngle(180.0), tiltZeroAngle(180.0), panDirection(1.0), tiltDirection(1.0) {}     // MX: 180 degrees is centre of travel
+};
+
+class DXLPanTilt {
+private:
+    DXLServo *pan, *tilt;
+    DXLPanTiltGeometry geometry;
+    int panMin, panMax, tiltMin, tiltMax;               // Joint limits in position values
+    double panTicksPerDeg, tiltTicksPerDeg;
+    int panHome, tiltHome;                              // Homing offsets subtracted as in writeGoalAngle()
+    int lastPan, lastTilt;                              // Last goals written, for trackNearest()
+    bool haveLast;
+    std::vector<int> panScratch, tiltScratch;
+    std::vector<uint8_t> clampScratch;
+
+    int writeGoals(int panTicks, int tiltTicks);
+
+public:
+    DXLPanTilt(DXLServo *panServo, DXLServo *tiltServo, const DXLPanTiltGeometry &geom = DXLPanTiltGeometry());
+
+    void setGeometry(const DXLPanTiltGeometry &geom) { geometry = geom; }
+    const DXLPanTiltGeometry &getGeometry() const { return geometry; }
+    void useServoLimits();                              // Joint limits from last setPositionLimit() on each servo, homing offsets from getHomingOffset()
+    void setJointLimits(int panMinimum, int panMaximum, int tiltMinimum, int tiltMaximum);     // Position values
+
+    bool solveAngles(double x, double y, double z, double &panDeg, double &tiltDeg) const;     // Joint angles, false if target too close to an axis for the offsets
+    bool solve(double x, double y, double z, int &panTicks, int &tiltTicks) const;             // Goal positions, false if unreachable or clamped
+    size_t solveBatch(const double *x, const double *y, const double *z, size_t count, int *panTicks, int *tiltTicks, uint8_t *clamped) const;    // Returns number clamped. clamped may be 0.
+
+    int lookAt(double x, double y, double z);           // Solve and write both goals in one sync write. Returns COMM_* result, DXL_COMM_OUT_OF_RANGE
+                                                        // if the target is unreachable: inside the offsets (nothing written) or past a limit (clamped goals written)
+    int trackNearest(const double *x, const double *y, const double *z, size_t count, size_t &chosen);     // One frame of detections: solve all, aim at the one closest to current goal
+};
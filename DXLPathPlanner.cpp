@@ -0,0 +1,338 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Time-optimal timing of a multi-axis path under per-servo velocity and acceleration limits. See DXLPathPlanner.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLPathPlanner.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define PATH_EPSILON                    1.0e-9          // Position change treated as none
+#define PATH_LIMIT_TOLERANCE            1.0e-6          // Relative excess over a limit accepted by the check
+#define PATH_REFINE_PASSES              24              // Local slow-downs before scaling the whole timing
+
+////////////////////////////////////////////////////   DXLPathPlanner definition   ////////////////////////////////////////////////////////////////////////////////////////
+
+int DXLPathPlanner::addAxis(double velocity, double accel) {
+    DXLPathAxisLimits axis;
+    axis.velocity = velocity;
+    axis.accel = accel;
+    limits.push_back(axis);
+    clearPath();                                        // Points added so far have one value too few
+    return int(limits.size()) - 1;
+}
+
+int DXLPathPlanner::addAxis(DXLServo *servo, bool readLimits) {
+    int velocityValue, accelValue;
+    if (readLimits) {
+        velocityValue = servo->getVelocityLimit();
+        if (servo->dxl_comm_result != COMM_SUCCESS)     return -1;      // Logged by getVelocityLimit()
+        accelValue = servo->getAccelLimit();
+        if (servo->dxl_comm_result != COMM_SUCCESS)     return -1;
+    }
+    else {
+        velocityValue = servo->getVelocityLimitSetting();
+        accelValue = servo->getAccelLimitSetting();
+    }
+    if (velocityValue <= 0)     velocityValue = (servo->servoType == DXL_PRO_M42) ? PROFILE_PRO_VELOCITY_MAX : PROFILE_MX_VELOCITY_MAX;     // Never set or unlimited
+    if (accelValue <= 0)        accelValue = PROFILE_ACCELERATION_MAX;
+
+    double velocity = double(velocityValue) * servo->countsPerSecPerUnit();
+    double accel = double(accelValue) * servo->countsPerSec2PerUnit();
+    DXL_LOG_DEBUG(servo->identity, DXL_LOG_NONE, DXL_LOG_NONE, "Path axis limits %.0f /s, %.0f /s2", velocity, accel);
+    return addAxis(velocity, accel);
+}
+
+void DXLPathPlanner::addPoint(const double *positions) {
+    path.insert(path.end(), positions, positions + limits.size());
+    planned = false;
+}
+
+void DXLPathPlanner::addPoint(const std::vector<double> &positions) {
+    if (positions.size() != limits.size()) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Path point has %d values for %d axes", int(positions.size()), int(limits.size()));
+        return;
+    }
+    addPoint(positions.data());
+}
+
+void DXLPathPlanner::clearPath() {
+    path.clear();
+    grid.clear();
+    speed2.clear();
+    times.clear();
+    planned = false;
+}
+
+void DXLPathPlanner::buildGrid(double maxStep) {        // Resample at equal steps of path length, no more than maxStep: ds is the same distance everywhere
+    size_t n = limits.size(), count = path.size() / n;
+    std::vector<double> length(count, 0.0);             // Along the path to each point
+    for (size_t p = 1; p < count; p++) {
+        double squares = 0.0;
+        for (size_t a = 0; a < n; a++)  squares += (path[p * n + a] - path[(p - 1) * n + a]) * (path[p * n + a] - path[(p - 1) * n + a]);
+        length[p] = length[p - 1] + sqrt(squares);
+    }
+    grid.clear();
+    if (length.back() < PATH_EPSILON)   return;
+    size_t steps = std::max(size_t(2), size_t(ceil(length.back() / maxStep)));     // Rest to rest needs a point between
+    size_t segment = 1;
+    for (size_t k = 0; k <= steps; k++) {
+        double at = length.back() * double(k) / double(steps);
+        while (segment < count - 1 && length[segment] < at)     segment++;
+        double span = length[segment] - length[segment - 1];
+        double f = (span > PATH_EPSILON) ? std::min(std::max((at - length[segment - 1]) / span, 0.0), 1.0) : 1.0;
+        for (size_t a = 0; a < n; a++)  grid.push_back(path[(segment - 1) * n + a] + f * (path[segment * n + a] - path[(segment - 1) * n + a]));
+    }
+}
+
+void DXLPathPlanner::stepRow(size_t point, size_t axis, bool end, double &du, double &dx) const {
+    // Axis acceleration d2q/dt2 = du u + dx x at one end of step point, x = (ds/dt)2 at the step start, u constant across
+    // it: start q' u + q'' x, end q' u + q'' (x + 2u). q', q'' of the curve itself, so the ends hold exactly what is streamed.
+    double q, d1, d2;
+    curve(point, axis, end ? 1.0 : 0.0, q, d1, d2);
+    du = end ? d1 + 2.0 * d2 : d1;
+    dx = d2;
+}
+
+double DXLPathPlanner::pointBound(size_t point, double nextBound) const {
+    // Constraints on u as lower/upper bounds a + b x, reaching the next point's interval included. Each lower/upper pair with a
+    // steeper lower bound caps x where they cross; velocity limits and rows without u (turning points) cap x directly.
+    double lowA[2 * DXL_TRAJECTORY_MAX_AXES + 1], lowB[2 * DXL_TRAJECTORY_MAX_AXES + 1];
+    double highA[2 * DXL_TRAJECTORY_MAX_AXES + 1], highB[2 * DXL_TRAJECTORY_MAX_AXES + 1];
+    int bounds = 0;
+    double bound = HUGE_VAL;
+    for (size_t a = 0; a < limits.size(); a++) {
+        for (int end = 0; end < 2; end++) {
+            double du, dx;
+            stepRow(point, a, end != 0, du, dx);
+            if (end == 0 && fabs(du) > PATH_EPSILON) {  // Start: du = q', |q'| sqrt(x) <= vmax
+                double v = limits[a].velocity / fabs(du);
+                bound = std::min(bound, v * v);
+            }
+            if (fabs(du) > PATH_EPSILON) {
+                lowA[bounds] = -limits[a].accel / fabs(du), highA[bounds] = limits[a].accel / fabs(du);
+                lowB[bounds] = highB[bounds] = -dx / du;
+                bounds++;
+            }
+            else if (fabs(dx) > PATH_EPSILON)   bound = std::min(bound, limits[a].accel / fabs(dx));
+        }
+    }
+    lowA[bounds] = 0.0, highA[bounds] = 0.5 * nextBound;    // 0 <= x + 2u <= nextBound
+    lowB[bounds] = highB[bounds] = -0.5;
+    bounds++;
+
+    for (int l = 0; l < bounds; l++) {
+        for (int h = 0; h < bounds; h++) {
+            double slope = lowB[l] - highB[h];
+            if (slope > 0.0)    bound = std::min(bound, (highA[h] - lowA[l]) / slope);
+        }
+    }
+    return std::max(bound, 0.0);
+}
+
+double DXLPathPlanner::maxAccel(size_t point, double x, double nextBound) const {
+    double u = 0.5 * (nextBound - x);
+    for (size_t a = 0; a < limits.size(); a++) {
+        for (int end = 0; end < 2; end++) {
+            double du, dx;
+            stepRow(point, a, end != 0, du, dx);
+            if (fabs(du) > PATH_EPSILON)    u = std::min(u, (limits[a].accel - dx * x / (du > 0.0 ? 1.0 : -1.0)) / fabs(du));
+        }
+    }
+    return u;
+}
+
+void DXLPathPlanner::timeGrid(const std::vector<double> &caps) {
+    size_t count = grid.size() / limits.size();
+    std::vector<double> reachable(count);               // Controllable set [0, reachable[i]], backward from rest at the end
+    reachable[count - 1] = 0.0;
+    for (size_t i = count - 1; i-- > 0; )   reachable[i] = (i == 0) ? 0.0 : std::min(pointBound(i, reachable[i + 1]), caps[i]);
+
+    speed2.assign(count, 0.0);                          // Forward from rest, fastest that stays controllable
+    for (size_t i = 0; i + 1 < count; i++) {
+        double u = maxAccel(i, speed2[i], reachable[i + 1]);
+        speed2[i + 1] = std::min(std::max(speed2[i] + 2.0 * u, 0.0), reachable[i + 1]);
+    }
+    retime();
+}
+
+void DXLPathPlanner::retime() {
+    times.assign(speed2.size(), 0.0);
+    for (size_t i = 0; i + 1 < speed2.size(); i++) {
+        double rootSum = sqrt(speed2[i]) + sqrt(speed2[i + 1]);
+        times[i + 1] = times[i] + ((rootSum > 0.0) ? 2.0 / rootSum : 0.0);
+    }
+}
+
+static double quadraticPeak(const double at[3]) {       // Largest |f| on [0, 1] of the quadratic through f(0), f(1/2), f(1)
+    double c2 = 2.0 * (at[2] - 2.0 * at[1] + at[0]), c1 = at[2] - at[0] - c2;
+    double peak = std::max(fabs(at[0]), fabs(at[2]));
+    if (fabs(c2) > PATH_EPSILON) {
+        double s = -c1 / (2.0 * c2);
+        if (s > 0.0 && s < 1.0)     peak = std::max(peak, fabs((c2 * s + c1) * s + at[0]));
+    }
+    return peak;
+}
+
+double DXLPathPlanner::stepExcess(size_t point) const {
+    // On the curve x = (ds/dt)2 grows linearly in s across the step and u is constant, so per axis
+    //     dq/dt = q' sqrt(x),   d2q/dt2 = q'' x + q' u     with q', q'' of the Catmull-Rom cubic at s
+    // q' and d2q/dt2 are quadratic in s, largest at an end or the vertex; velocity is bounded by max |q'| and the larger x.
+    double u = 0.5 * (speed2[point + 1] - speed2[point]), worst = 0.0;
+    double x[3] = { speed2[point], std::max(speed2[point] + u, 0.0), speed2[point + 1] };
+    for (size_t a = 0; a < limits.size(); a++) {
+        double slope[3], accel[3];                      // At s = 0, 1/2, 1
+        for (int k = 0; k < 3; k++) {
+            double q, d2q;
+            curve(point, a, 0.5 * k, q, slope[k], d2q);
+            accel[k] = d2q * x[k] + slope[k] * u;
+        }
+        double slopePeak = quadraticPeak(slope);
+        double velocity2 = slopePeak * slopePeak * std::max(x[0], x[2]);      // Squared, so both shares scale with x
+        worst = std::max(worst, std::max(velocity2 / (limits[a].velocity * limits[a].velocity), quadraticPeak(accel) / limits[a].accel));
+    }
+    return worst;
+}
+
+bool DXLPathPlanner::plan(double maxStep) {
+    planned = false;
+    grid.clear(), speed2.clear(), times.clear();
+    size_t n = limits.size();
+    if (n == 0 || n > DXL_TRAJECTORY_MAX_AXES || path.size() < 2 * n || !(maxStep > 0.0))     return false;
+    for (size_t a = 0; a < n; a++) {
+        if (!(limits[a].velocity > 0.0) || !(limits[a].accel > 0.0)) {
+            DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Path axis %d has no velocity or acceleration limit", int(a));
+            return false;
+        }
+    }
+    buildGrid(maxStep);
+    size_t count = grid.size() / n;
+    if (count < 3)  return false;                       // Every point the same
+
+    // Limits hold at both ends of every step; inside one the curve can still pass them. Cap the speed where a step does, by
+    // what it exceeds (velocity squared and acceleration both scale with x), and plan again.
+    std::vector<double> caps(count, HUGE_VAL);
+    timeGrid(caps);
+    double worst = 0.0;
+    for (int pass = 0; ; pass++) {
+        worst = 0.0;
+        bool capped = false;
+        for (size_t i = 0; i + 1 < count; i++) {
+            double excess = stepExcess(i);
+            worst = std::max(worst, excess);
+            if (excess <= 1.0 + PATH_LIMIT_TOLERANCE || pass == PATH_REFINE_PASSES)     continue;
+            caps[i] = std::min(caps[i], speed2[i] / excess);
+            caps[i + 1] = std::min(caps[i + 1], speed2[i + 1] / excess);
+            capped = true;
+        }
+        if (!capped)    break;
+        timeGrid(caps);
+    }
+    if (worst > 1.0 + PATH_LIMIT_TOLERANCE) {           // Not settled locally: slowing all of it by the excess is exact
+        for (size_t i = 0; i < count; i++)  speed2[i] /= worst;
+        retime();
+    }
+    planned = true;
+    DXL_LOG_INFO(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Path planned: %d axes, %d grid points, %.3f s", int(n), int(count), times.back());
+    return true;
+}
+
+size_t DXLPathPlanner::locate(double timeSec, double &s, double &ds) const {
+    size_t count = times.size();
+    size_t i = size_t(std::upper_bound(times.begin(), times.end(), timeSec) - times.begin());
+    if (i == 0 || i >= count) {                         // Before start or at/after end, at rest
+        s = 0.0, ds = 0.0;
+        return (i == 0) ? 0 : count - 1;
+    }
+    i--;                                                // times[i] <= timeSec < times[i + 1], u constant between
+    double tau = timeSec - times[i];
+    double u = 0.5 * (speed2[i + 1] - speed2[i]);
+    s = std::min(std::max(sqrt(speed2[i]) * tau + 0.5 * u * tau * tau, 0.0), 1.0);
+    ds = std::max(sqrt(speed2[i]) + u * tau, 0.0);
+    return i;
+}
+
+void DXLPathPlanner::curve(size_t point, size_t axis, double s, double &q, double &dq, double &d2q) const {
+    // Catmull-Rom through the grid points: the kink at a path point is spread over the steps next to it, as the second
+    // difference the plan used there assumes, instead of turning in no time
+    size_t n = limits.size(), count = grid.size() / n;
+    double p1 = grid[point * n + axis], p2 = grid[std::min(point + 1, count - 1) * n + axis];
+    double p0 = (point > 0) ? grid[(point - 1) * n + axis] : 2.0 * p1 - p2;             // Straight on past the ends
+    double p3 = (point + 2 < count) ? grid[(point + 2) * n + axis] : 2.0 * p2 - p1;
+    double m1 = 0.5 * (p2 - p0), m2 = 0.5 * (p3 - p1);
+    double s2 = s * s, s3 = s2 * s;
+    q = (2.0 * s3 - 3.0 * s2 + 1.0) * p1 + (s3 - 2.0 * s2 + s) * m1 + (-2.0 * s3 + 3.0 * s2) * p2 + (s3 - s2) * m2;
+    dq = (6.0 * s2 - 6.0 * s) * p1 + (3.0 * s2 - 4.0 * s + 1.0) * m1 + (-6.0 * s2 + 6.0 * s) * p2 + (3.0 * s2 - 2.0 * s) * m2;
+    d2q = (12.0 * s - 6.0) * p1 + (6.0 * s - 4.0) * m1 + (-12.0 * s + 6.0) * p2 + (6.0 * s - 2.0) * m2;
+}
+
+void DXLPathPlanner::positionAt(double timeSec, double *positions) const {
+    if (!planned)   return;
+    double s, ds, dq, d2q;
+    size_t point = locate(timeSec, s, ds);
+    for (size_t a = 0; a < limits.size(); a++)  curve(point, a, s, positions[a], dq, d2q);
+}
+
+void DXLPathPlanner::velocityAt(double timeSec, double *velocities) const {
+    if (!planned)   return;
+    double s, ds, q, d2q;
+    size_t point = locate(timeSec, s, ds);
+    for (size_t a = 0; a < limits.size(); a++) {
+        curve(point, a, s, q, velocities[a], d2q);
+        velocities[a] *= ds;
+    }
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+
+bool DXLPathPlanner::writeTrajectory(const std::string &outPath, const std::vector<DXLTrajectoryAxis> &axes, double rateHz) const {
+    if (!planned || axes.size() != limits.size() || !(rateHz > 0.0))    return false;
+    uint64_t samples = uint64_t(ceil(getDuration() * rateHz)) + 1;     // Last sample at the end, at rest
+    DXLTrajectoryWriter writer;
+    if (!writer.create(outPath, axes, samples, rateHz))     return false;
+
+    std::vector<double> positions(limits.size());
+    for (uint64_t k = 0; k < samples; k++) {
+        positionAt(std::min(double(k) / rateHz, getDuration()), positions.data());
+        for (size_t a = 0; a < limits.size(); a++)  writer.column(a)[k] = int32_t(lround(positions[a]));
+    }
+    return writer.finish();
+}
+
+#endif
+
+////////////////////////////////////////////////////    Example Code Using DXLPathPlanner    ///////////////////////////////////////////////////////////////////////////
+/*
+int main() {
+    DXLServo pan, tilt;
+    pan.setDXLServo(0), tilt.setDXLServo(0);
+    pan.identity = 1, tilt.identity = 2;
+    pan.initPortHandler(), pan.initPacketHandler();
+    tilt.prtHandler = pan.prtHandler, tilt.pktHandler = pan.pktHandler;
+    pan.setlowAccelLimit(), tilt.setlowAccelLimit();    // Limits the plan honours, no following error shutdown
+
+    DXLPathPlanner planner;
+    planner.addAxis(&pan);                              // Velocity/Acceleration Limit read from each servo
+    planner.addAxis(&tilt);
+    for (int i = 0; i <= 720; i++) {                    // Lissajous scan, geometry only
+        double point[2] = { 2048.0 + 600.0 * sin(i * M_PI / 180.0), 2048.0 + 300.0 * sin(2.0 * i * M_PI / 180.0) };
+        planner.addPoint(point);
+    }
+    if (!planner.plan())    return 1;
+    printf("Scan takes %.2f s\n", planner.getDuration());
+
+    std::vector<DXLTrajectoryAxis> axes;
+    axes.push_back(DXLTrajectoryAxis(DXL_MX_64, 1, pan.getHomingOffset()));
+    axes.push_back(DXLTrajectoryAxis(DXL_MX_64, 2, tilt.getHomingOffset()));
+    if (!planner.writeTrajectory("scan.traj", axes, 200.0))     return 1;
+
+    DXLTrajectoryFile scan;
+    scan.open("scan.traj");
+    DXLTrajectoryStreamer streamer(&scan);
+    streamer.attach(0, &pan), streamer.attach(1, &tilt);
+    pan.enableTorque(), tilt.enableTorque();
+    streamer.play();
+    return 0;
+}
+*/
+// End of Example Code
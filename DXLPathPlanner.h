@@ -0,0 +1,83 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Time-optimal timing of a multi-axis path under per-servo velocity and acceleration limits.
+
+The path is geometric: a sequence of joint positions (raw position values, one per axis) with no timing. plan() finds
+the fastest traversal, start and end at rest, that keeps every axis within its Velocity Limit and Acceleration Limit,
+instead of hand-tuned waypoint timing:
+    grid        path resampled at equal steps of length, at most maxStep position values, s = point index
+    curve       Catmull-Rom through the grid points, q' and q'' per axis at each end of every step
+    limits      with x = (ds/dt)2 and u = d2s/dt2 constant across a step, per axis j at both of its ends
+                    |q'j| sqrt(x) <= vmax_j,   |q'j u + q''j x| <= amax_j       (x + 2u at the step end)
+                all linear in (x, u), so the reachable x at each point is one interval [0, xmax]
+    backward    largest x at each point from which the end can still be reached (controllable set)
+    forward     from rest, greatest u at every point that stays inside the next controllable set
+    check       velocity and acceleration of the curve across each step (acceleration is quadratic there, its peak exact);
+                where a step exceeds a limit its speed is capped by the excess and the passes run again
+The greedy forward pass is time-optimal over the grid (reachability analysis, as TOPP-RA). Limits hold on the streamed
+motion itself, between grid points too, so output sampled at any rate stays within them (up to rounding to position
+values), sparse corners included: those are rounded within one step and slowed to what the curve allows.
+
+Output is sampled at a fixed rate into a DXLTrajectoryFile for DXLTrajectoryStreamer, or at any time with positionAt().
+Limits come from the servo registers (getVelocityLimit()/getAccelLimit()), the values last set through DXLServo, or are
+given directly in position units per second.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+#include "DXLProServo.h"
+#include "DXLTrajectoryFile.h"
+
+#define DXL_PATH_MAX_STEP               4.0             // Default grid step, position values on the axis moving most
+
+struct DXLPathAxisLimits {
+    double velocity;                                    // Position values per second
+    double accel;                                       // Position values per second2
+};
+
+class DXLPathPlanner {
+private:
+    std::vector<DXLPathAxisLimits> limits;
+    std::vector<double> path;                           // Points as added, axisCount() values each
+    std::vector<double> grid;                           // Planned points, axisCount() values each
+    std::vector<double> speed2;                         // (ds/dt)2 at each grid point
+    std::vector<double> times;                          // Seconds from start at each grid point
+    bool planned;
+
+    void buildGrid(double maxStep);
+    void timeGrid(const std::vector<double> &caps);     // Backward and forward passes, x at each point at most caps[point]
+    void retime();                                      // times from speed2
+    double stepExcess(size_t point) const;              // Largest share of a limit (velocity squared) used on the curve across step point, > 1 over
+    double pointBound(size_t point, double nextBound) const;    // Largest x at point that still reaches [0, nextBound] at the next one
+    double maxAccel(size_t point, double x, double nextBound) const;   // Greatest u at point from x, staying inside [0, nextBound]
+    void stepRow(size_t point, size_t axis, bool end, double &du, double &dx) const;    // Axis acceleration = du u + dx x at step start or end
+    size_t locate(double timeSec, double &s, double &ds) const;    // Grid interval at timeSec, fraction s into it and ds/dt
+    void curve(size_t point, size_t axis, double s, double &q, double &dq, double &d2q) const;     // Position, dq/ds and d2q/ds2 at s into interval point
+
+public:
+    DXLPathPlanner() : planned(false) {}
+
+    int addAxis(double velocity, double accel);         // Limits in position values per second (squared). Returns axis index.
+    int addAxis(DXLServo *servo, bool readLimits = true);   // Velocity/Acceleration Limit registers, read or last set through servo (never set: PROFILE_*_MAX). -1 on read failure.
+    size_t axisCount() const { return limits.size(); }
+    const DXLPathAxisLimits &getLimits(size_t axis) const { return limits[axis]; }
+
+    void addPoint(const double *positions);             // One raw position value per axis
+    void addPoint(const std::vector<double> &positions);
+    void clearPath();
+    size_t pointCount() const { return path.size() / (limits.empty() ? 1 : limits.size()); }
+
+    bool plan(double maxStep = DXL_PATH_MAX_STEP);      // false if no axes or fewer than 2 distinct points
+    bool isPlanned() const { return planned; }
+    double getDuration() const { return times.empty() ? 0.0 : times.back(); }     // Seconds
+    void positionAt(double timeSec, double *positions) const;       // Planned positions at timeSec, clamped to the path ends
+    void velocityAt(double timeSec, double *velocities) const;      // Position values per second
+
+#if defined(__linux__) || defined(__APPLE__)
+    // Samples at rateHz from start to end at rest, rounded to position values. axes: one per planner axis, as dxlCompileTrajectory().
+    bool writeTrajectory(const std::string &outPath, const std::vector<DXLTrajectoryAxis> &axes, double rateHz) const;
+#endif
+};
@@ -0,0 +1,415 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Low latency serial PortHandler for Linux. See DXLPortHandlerLinux.h.
+
+Baud rate table, custom divisor fallback and packet timeout formula follow the SDK PortHandlerLinux so the two are interchangeable.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+
+#include "DXLPortHandlerLinux.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+
+#include <cmath>
+
+#include "DXLLog.h"
+
+static int baudToCFlag(int baudrate) {
+    switch (baudrate) {
+    case 9600:      return B9600;
+    case 19200:     return B19200;
+    case 38400:     return B38400;
+    case 57600:     return B57600;
+    case 115200:    return B115200;
+    case 230400:    return B230400;
+    case 460800:    return B460800;
+    case 500000:    return B500000;
+    case 576000:    return B576000;
+    case 921600:    return B921600;
+    case 1000000:   return B1000000;
+    case 1152000:   return B1152000;
+    case 1500000:   return B1500000;
+    case 2000000:   return B2000000;
+    case 2500000:   return B2500000;
+    case 3000000:   return B3000000;
+    case 3500000:   return B3500000;
+    case 4000000:   return B4000000;
+    default:        return -1;
+    }
+}
+
+////////////////////////////////////////////////////   DXLPortHandlerLinux class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLPortHandlerLinux::DXLPortHandlerLinux(const char *port_name, const DXLPortOptions &opts) {
+    socketFd = -1;
+    epollFd = -1;
+    baudRate = DEFAULT_BAUDRATE_;
+    options = opts;
+    lowLatencyActive = false;
+    packetStartMs = 0.0;
+    packetTimeoutMs = 0.0;
+    txTimePerByteMs = 0.0;
+    corked = false;
+    pendingBytes = 0;
+    is_using_ = false;
+    setPortName(port_name);
+}
+
+bool DXLPortHandlerLinux::openPort() {
+    return setBaudRate(baudRate);
+}
+
+void DXLPortHandlerLinux::closePort() {
+    if (socketFd != -1) {
+        if (pendingBytes > 0)   flushWrites();
+        close(socketFd);
+    }
+    if (epollFd != -1)  close(epollFd);
+    socketFd = -1;
+    epollFd = -1;
+}
+
+void DXLPortHandlerLinux::clearPort() {            // Called before every packet write: stale input only, corked packets stay queued
+    tcflush(socketFd, TCIFLUSH);
+}
+
+void DXLPortHandlerLinux::setPortName(const char *port_name) {
+    strncpy(portName, port_name, sizeof(portName) - 1);
+    portName[sizeof(portName) - 1] = 0;
+}
+
+char *DXLPortHandlerLinux::getPortName() {
+    return portName;
+}
+
+bool DXLPortHandlerLinux::setBaudRate(const int baudrate) {
+    closePort();
+    baudRate = baudrate;
+    return setupPort(baudrate);
+}
+
+int DXLPortHandlerLinux::getBaudRate() {
+    return baudRate;
+}
+
+int DXLPortHandlerLinux::getBytesAvailable() {
+    int bytesAvailable = 0;
+    ioctl(socketFd, FIONREAD, &bytesAvailable);
+    return bytesAvailable;
+}
+
+bool DXLPortHandlerLinux::setupPort(int baudrate) {
+    int cflagBaud = baudToCFlag(baudrate);
+    bool custom = (cflagBaud == -1);
+    if (custom)     cflagBaud = B38400;             // Custom divisor applied below, as SDK
+
+    bool blocking = !options.useEpoll && (options.vmin > 0 || options.vtime > 0);
+    socketFd = open(portName, O_RDWR | O_NOCTTY | (blocking ? 0 : O_NONBLOCK));
+    if (socketFd < 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Error opening serial port %s: %s", portName, strerror(errno));
+        return false;
+    }
+
+    struct termios newtio;
+    memset(&newtio, 0, sizeof(newtio));
+    newtio.c_cflag = cflagBaud | CS8 | CLOCAL | CREAD;
+    newtio.c_iflag = IGNPAR;
+    newtio.c_oflag = 0;
+    newtio.c_lflag = 0;
+    newtio.c_cc[VTIME] = options.useEpoll ? 0 : cc_t(options.vtime);
+    newtio.c_cc[VMIN] = options.useEpoll ? 0 : cc_t(options.vmin);
+    cfsetispeed(&newtio, cflagBaud);
+    cfsetospeed(&newtio, cflagBaud);
+    tcflush(socketFd, TCIOFLUSH);
+    if (tcsetattr(socketFd, TCSANOW, &newtio) != 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Error setting termios on %s: %s", portName, strerror(errno));
+        closePort();
+        return false;
+    }
+
+    if (custom && !setCustomBaudrate(baudrate)) {
+        closePort();
+        return false;
+    }
+
+    lowLatencyActive = false;
+    if (options.lowLatency)     applyLowLatency();
+
+    if (options.useEpoll) {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = socketFd;
+        if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, socketFd, &event) != 0) {
+            DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, errno, "epoll unavailable on %s, falling back to polling reads", portName);
+            if (epollFd >= 0)   close(epollFd);
+            epollFd = -1;
+        }
+    }
+
+    txTimePerByteMs = (1000.0 / double(baudrate)) * 10.0;
+    return true;
+}
+
+bool DXLPortHandlerLinux::setCustomBaudrate(int speed) {
+    struct serial_struct ss;
+    if (ioctl(socketFd, TIOCGSERIAL, &ss) != 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Custom baudrate %d not supported on %s", speed, portName);
+        return false;
+    }
+    ss.flags = (ss.flags & ~ASYNC_SPD_MASK) | ASYNC_SPD_CUST;
+    ss.custom_divisor = (ss.baud_base + (speed / 2)) / speed;
+    int closestSpeed = ss.baud_base / ss.custom_divisor;
+    if (closestSpeed < speed * 98 / 100 || closestSpeed > speed * 102 / 100) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot set %s baudrate to %d, closest is %d", portName, speed, closestSpeed);
+        return false;
+    }
+    if (ioctl(socketFd, TIOCSSERIAL, &ss) < 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "TIOCSSERIAL failed on %s", portName);
+        return false;
+    }
+    return true;
+}
+
+void DXLPortHandlerLinux::applyLowLatency() {
+    struct serial_struct ss;
+    if (ioctl(socketFd, TIOCGSERIAL, &ss) != 0) {
+        DXL_LOG_DEBUG(DXL_LOG_NONE, DXL_LOG_NONE, errno, "%s has no serial settings, low latency not applied", portName);
+        return;
+    }
+    ss.flags |= ASYNC_LOW_LATENCY;
+    if (ioctl(socketFd, TIOCSSERIAL, &ss) != 0) {
+        DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Could not set ASYNC_LOW_LATENCY on %s: %s", portName, strerror(errno));
+        return;
+    }
+    lowLatencyActive = true;
+}
+
+int DXLPortHandlerLinux::waitReadable(int timeoutMs) {
+    if (epollFd < 0)    return 1;                   // No epoll, caller polls
+    struct epoll_event event;
+    int ready;
+    do {
+        ready = epoll_wait(epollFd, &event, 1, timeoutMs);
+    } while (ready < 0 && errno == EINTR);
+    return ready;
+}
+
+int DXLPortHandlerLinux::readPort(uint8_t *packet, int length) {
+    if (pendingBytes > 0)   flushWrites();          // Corked instruction must be on the wire before waiting for its status
+
+    int received = 0;
+    for (;;) {
+        int n = int(read(socketFd, packet + received, size_t(length - received)));
+        if (n > 0)  received += n;
+        else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Read error on %s: %s", portName, strerror(errno));
+            return received;
+        }
+
+        if (received >= length || epollFd < 0)     return received;       // Without epoll, behave like SDK: return what is there
+
+        double remainingMs = packetTimeoutMs - getTimeSinceStart();
+        if (packetTimeoutMs <= 0.0 || remainingMs <= 0.0)   return received;
+        if (waitReadable(int(ceil(remainingMs))) <= 0)      return received;
+    }
+}
+
+int DXLPortHandlerLinux::readAvailable(uint8_t *buffer, int capacity) {
+    if (pendingBytes > 0)   flushWrites();
+
+    if (epollFd >= 0) {                             // Sleep until the first byte, then take all that came with it
+        double remainingMs = packetTimeoutMs - getTimeSinceStart();
+        if (packetTimeoutMs > 0.0 && remainingMs > 0.0 && waitReadable(int(ceil(remainingMs))) <= 0)  return 0;
+    }
+    int n;
+    do {
+        n = int(read(socketFd, buffer, size_t(capacity)));
+    } while (n < 0 && errno == EINTR);
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Read error on %s: %s", portName, strerror(errno));
+    }
+    return n > 0 ? n : 0;
+}
+
+int DXLPortHandlerLinux::writeAll(const uint8_t *data, int length) {
+    int sent = 0;
+    while (sent < length) {
+        int n = int(write(socketFd, data + sent, size_t(length - sent)));
+        if (n > 0) {
+            sent += n;
+        }
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            tcdrain(socketFd);                      // Output buffer full, wait for it to empty
+        }
+        else {
+            DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Write error on %s: %s", portName, strerror(errno));
+            return -1;
+        }
+    }
+    return sent;
+}
+
+int DXLPortHandlerLinux::writePort(uint8_t *packet, int length) {
+    if (!corked)    return writeAll(packet, length);
+
+    if (pendingBytes + length > DXL_PORT_CORK_BYTES) {
+        if (flushWrites() < 0)  return -1;
+        corked = true;
+        if (length > DXL_PORT_CORK_BYTES)   return writeAll(packet, length);
+    }
+    memcpy(corkBuffer + pendingBytes, packet, size_t(length));
+    pendingBytes += length;
+    return length;                                  // Reported as sent so SDK txPacket() succeeds
+}
+
+void DXLPortHandlerLinux::cork() {
+    corked = true;
+}
+
+int DXLPortHandlerLinux::flushWrites() {
+    corked = false;
+    if (pendingBytes == 0)  return 0;
+    int sent = writeAll(corkBuffer, pendingBytes);
+    pendingBytes = 0;
+    return sent;
+}
+
+int DXLPortHandlerLinux::writePackets(const struct iovec *packets, int count) {
+    if (pendingBytes > 0 && flushWrites() < 0)  return -1;      // Keep packet order
+
+    int total = 0;
+    for (int i = 0; i < count; i++)     total += int(packets[i].iov_len);
+
+    int n;
+    do {
+        n = int(writev(socketFd, packets, count));
+    } while (n < 0 && errno == EINTR);
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Write error on %s: %s", portName, strerror(errno));
+        return -1;
+    }
+    if (n < 0)  n = 0;
+
+    int skipped = 0;                                // Partial writev, send rest packet by packet
+    for (int i = 0; i < count && n < total; i++) {
+        int packetLength = int(packets[i].iov_len);
+        if (skipped + packetLength > n) {
+            int offset = (n > skipped) ? n - skipped : 0;
+            if (writeAll(static_cast<const uint8_t *>(packets[i].iov_base) + offset, packetLength - offset) < 0)    return -1;
+            n += packetLength - offset;
+        }
+        skipped += packetLength;
+    }
+    return total;
+}
+
+void DXLPortHandlerLinux::setPacketTimeout(uint16_t packet_length) {
+    double latency = options.latencyMs;
+    if (latency <= 0.0)     latency = lowLatencyActive ? 1.0 : 16.0;
+    packetStartMs = getCurrentTime();
+    packetTimeoutMs = (txTimePerByteMs * double(packet_length)) + (latency * 2.0) + 2.0;
+}
+
+void DXLPortHandlerLinux::setPacketTimeout(double msec) {
+    packetStartMs = getCurrentTime();
+    packetTimeoutMs = msec;
+}
+
+bool DXLPortHandlerLinux::isPacketTimeout() {
+    if (getTimeSinceStart() > packetTimeoutMs) {
+        packetTimeoutMs = 0;
+        return true;
+    }
+    return false;
+}
+
+double DXLPortHandlerLinux::getCurrentTime() {
+    struct timespec tv;
+    clock_gettime(CLOCK_MONOTONIC, &tv);
+    return double(tv.tv_sec) * 1000.0 + double(tv.tv_nsec) * 0.001 * 0.001;
+}
+
+double DXLPortHandlerLinux::getTimeSinceStart() {
+    double elapsed = getCurrentTime() - packetStartMs;
+    if (elapsed < 0.0)  packetStartMs = getCurrentTime();
+    return elapsed;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code: benchmark against SDK handler over a pty    ///////////////////////////////////////////////////////////////////////////
+// Link with -lutil for openpty(). A thread on the master side answers every READ of 4 bytes with a fixed status packet,
+// so the loop measures handler overhead only (pty has no latency timer, real U2D2 gains are larger).
+#include <pty.h>
+#include <thread>
+#include <atomic>
+#include "DXLPacket.h"
+
+    int master, slave;
+    char slaveName[100];
+    openpty(&master, &slave, slaveName, 0, 0);
+    std::atomic<bool> stop(false);
+    std::thread responder([&]() {
+        uint8_t rx[64];
+        uint8_t status[] = { 0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x08, 0x00, 0x55, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00 };
+        uint16_t crc = dxlCrc16(0, status, 13);
+        status[13] = DXL_LOBYTE(crc), status[14] = DXL_HIBYTE(crc);
+        while (!stop) {
+            if (read(master, rx, sizeof(rx)) > 0)  write(master, status, sizeof(status));
+        }
+    });
+
+    DXLServo sdkServo, fastServo;
+    sdkServo.setDXLServo(1), fastServo.setDXLServo(1);
+    sdkServo.deviceName = slaveName, fastServo.deviceName = slaveName;
+    fastServo.setPortBackend(DXL_PORT_LOW_LATENCY);
+    DXLServo *servos[2] = { &sdkServo, &fastServo };
+    for (int s = 0; s < 2; s++) {
+        servos[s]->setDXLID(1);
+        servos[s]->initPortHandler();
+        servos[s]->initPacketHandler();
+        servos[s]->openPort();
+        servos[s]->setPortBaudRate();
+        DXLBusStats::instance().reset();
+        DXLBusStats::instance().enable(true);
+        for (int i = 0; i < 10000; i++)    servos[s]->readCurrentPosition();
+        DXLLatencySnapshot snap;
+        DXLBusStats::instance().snapshot(1, INST_READ, ADDR_PRO_PRESENT_POSITION, snap);
+        printf("%s: mean %.1fus p50 %.1fus p99 %.1fus cpu %s\n", s ? "low latency" : "sdk", snap.mean(), snap.percentile(50), snap.percentile(99),
+            s ? "sleeps in epoll" : "spins in readPort");
+        servos[s]->closePort();
+    }
+    stop = true;
+    close(master);
+    responder.join();
+
+    // Corked writes: every queued packet reaches the wire, though txPacket() clears the port before each one
+    int pair[2];
+    openpty(&pair[0], &pair[1], slaveName, 0, 0);
+    DXLPortHandlerLinux corkPort(slaveName);
+    corkPort.openPort();
+    DXLPacketHandler codec;                             // sendPacket() clears the port like the SDK txPacket()
+    const int corkedPackets = 20;
+    uint8_t value[4] = { 0x00, 0x08, 0x00, 0x00 };
+    corkPort.cork();
+    for (int i = 0; i < corkedPackets; i++)     codec.writeTxOnly(&corkPort, uint8_t(i + 1), ADDR_PRO_GOAL_POSITION, 4, value);
+    corkPort.flushWrites();
+    usleep(20000);
+    uint8_t wire[1024];
+    int received = int(read(pair[0], wire, sizeof(wire)));
+    printf("corked %d packets, %d bytes on the wire, expected %d\n", corkedPackets, received, corkedPackets * 16);     // Write: 12 + 4 data bytes each
+    corkPort.closePort();
+    close(pair[0]);
+// End of Example Code
+*/
+
+#endif
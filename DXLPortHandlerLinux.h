@@ -0,0 +1,86 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Low latency serial PortHandler for Linux. Drop-in replacement for the SDK PortHandlerLinux, select with
+DXLServo::setPortBackend(DXL_PORT_LOW_LATENCY) before initPortHandler().
+
+Differences to SDK handler:
+- ASYNC_LOW_LATENCY set on the tty. FTDI driver (U2D2, USB2Dynamixel) drops its latency timer from 16ms to 1ms,
+  so a status packet reaches userspace ~1ms after the servo sends it instead of up to 16ms.
+- Raw termios with configurable VMIN/VTIME, input/output flushed on open.
+- Writes can be corked: packets queued with writePort() go out in one write() on flushWrites() or before the next read.
+  The SDK frees its packet buffer once txPacket() returns, so corked packets are copied into one contiguous buffer.
+  Callers that own their buffers can skip the copy with writePackets(), a single writev().
+- Optional epoll reads: readPort() sleeps until the requested byte count has arrived or the packet deadline passes,
+  instead of the SDK busy loop of zero-length reads. Packet timeout is derived from the actual latency timer.
+  readAvailable() instead takes everything that arrived in one read(), used by DXLStatusStream.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+
+#include <sys/uio.h>
+#include <stdint.h>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+
+#define DXL_PORT_CORK_BYTES         1024                // Corked bytes per write(), cork flushed early when full
+
+struct DXLPortOptions {
+    bool lowLatency;                                    // Set ASYNC_LOW_LATENCY (ignored by drivers without it, e.g. pty)
+    bool useEpoll;                                      // Block in epoll_wait() for exact read length instead of returning short reads
+    int vmin, vtime;                                    // termios VMIN/VTIME. Used only without epoll: non zero opens port blocking so reads sleep in the driver.
+    double latencyMs;                                   // Driver latency allowance used in packet timeout, 0 = 1ms with lowLatency, 16ms without
+
+    DXLPortOptions() : lowLatency(true), useEpoll(true), vmin(0), vtime(0), latencyMs(0.0) {}
+};
+
+class DXLPortHandlerLinux : public dynamixel::PortHandler {
+protected:                                              // Shared with DXLPortHandlerUring
+    int socketFd, epollFd;
+    int baudRate;
+    char portName[100];
+    DXLPortOptions options;
+    bool lowLatencyActive;                              // ASYNC_LOW_LATENCY accepted by driver
+
+    double packetStartMs, packetTimeoutMs;
+    double txTimePerByteMs;
+
+    bool corked;
+    int pendingBytes;
+    uint8_t corkBuffer[DXL_PORT_CORK_BYTES];
+
+    bool setupPort(int baudrate);
+    bool setCustomBaudrate(int speed);
+    void applyLowLatency();
+    int waitReadable(int timeoutMs);                    // >0 readable, 0 timeout, <0 error
+    int writeAll(const uint8_t *data, int length);     // Loops over partial writes, -1 on error
+    double getCurrentTime();
+    double getTimeSinceStart();
+
+public:
+    explicit DXLPortHandlerLinux(const char *port_name, const DXLPortOptions &opts = DXLPortOptions());
+    virtual ~DXLPortHandlerLinux() { closePort(); }
+
+    virtual bool openPort();
+    virtual void closePort();
+    virtual void clearPort();
+    virtual void setPortName(const char *port_name);
+    virtual char *getPortName();
+    virtual bool setBaudRate(const int baudrate);
+    virtual int getBaudRate();
+    virtual int getBytesAvailable();
+    virtual int readPort(uint8_t *packet, int length);
+    virtual int readAvailable(uint8_t *buffer, int capacity);  // One read() of whatever has arrived, waits for the first byte with epoll. 0 on timeout.
+    virtual int writePort(uint8_t *packet, int length);
+    virtual void setPacketTimeout(uint16_t packet_length);
+    virtual void setPacketTimeout(double msec);
+    virtual bool isPacketTimeout();
+
+    void cork();                                        // Queue following writePort() calls
+    int flushWrites();                                  // Send queued packets in one write() and uncork, returns bytes written or -1
+    int writePackets(const struct iovec *packets, int count);     // Several caller owned packets in one writev(), returns bytes written or -1
+    bool isLowLatency() const { return lowLatencyActive; }
+    const DXLPortOptions &getOptions() const { return options; }
+};
+
+#endif
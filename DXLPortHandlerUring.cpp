@@ -0,0 +1,389 @@
+/*///////////////////////////////////////////////////////////////////////////////
+io_uring serial PortHandler for Linux. See DXLPortHandlerUring.h.
+
+Only Protocol 2.0 instructions that get a status packet are held back for the linked submission (decided from the packet
+header), everything else is written at once so broadcasts and sync writes are not delayed.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+
+#include "DXLPortHandlerUring.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <atomic>
+#include <cmath>
+
+#include "DXLLog.h"
+
+#if defined(DXL_HAVE_IO_URING)
+#include <linux/io_uring.h>
+#endif
+
+#define DXL_URING_TAG_WRITE         1
+#define DXL_URING_TAG_READ          2
+#define DXL_URING_TAG_TIMEOUT       3
+#define DXL_URING_TAG_CANCEL        4
+
+static bool expectsStatus(const uint8_t *packet, int length) {     // Protocol 2.0: not broadcast, or broadcast ping/sync/bulk read
+    if (length < 10 || packet[0] != 0xFF || packet[1] != 0xFF || packet[2] != 0xFD)    return false;
+    uint8_t id = packet[4], instruction = packet[7];
+    if (id != 0xFE)     return true;
+    return instruction == 0x01 || instruction == 0x82 || instruction == 0x92;     // Ping, Sync Read, Bulk Read
+}
+
+////////////////////////////////////////////////////   DXLPortHandlerUring class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLPortHandlerUring::DXLPortHandlerUring(const char *port_name, const DXLPortOptions &opts) : DXLPortHandlerLinux(port_name, opts) {
+    ringFd = -1;
+    ringTried = false;
+    sqRing = cqRing = sqeMemory = 0;
+    sqRingSize = cqRingSize = sqeMemorySize = 0;
+    sqTail = sqMask = sqArray = 0;
+    cqHead = cqTail = cqMask = 0;
+    sqes = cqes = 0;
+    txPending = 0;
+    enterCalls = 0;
+}
+
+DXLPortHandlerUring::~DXLPortHandlerUring() {
+    closePort();
+    teardownRing();
+}
+
+bool DXLPortHandlerUring::setupRing() {
+#if defined(DXL_HAVE_IO_URING)
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = int(syscall(__NR_io_uring_setup, DXL_URING_ENTRIES, &params));
+    if (fd < 0) {
+        DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, errno, "io_uring not available on %s (%s), using read/write", portName, strerror(errno));
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_FAST_POLL)) {  // Older kernels fail a tty read with EAGAIN instead of waiting
+        DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "io_uring on %s cannot poll ttys (kernel before 5.7), using read/write", portName);
+        close(fd);
+        return false;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+        if (cqRingSize > sqRingSize)    sqRingSize = cqRingSize;
+        cqRingSize = sqRingSize;
+    }
+    sqRing = mmap(0, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    cqRing = single ? sqRing : mmap(0, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    sqeMemorySize = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqeMemory = mmap(0, sqeMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqeMemory == MAP_FAILED) {
+        DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, errno, "io_uring ring mapping failed on %s, using read/write", portName);
+        ringFd = fd;
+        teardownRing();
+        return false;
+    }
+
+    uint8_t *sq = static_cast<uint8_t *>(sqRing), *cq = static_cast<uint8_t *>(cqRing);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    sqes = sqeMemory;
+    cqes = cq + params.cq_off.cqes;
+    ringFd = fd;
+    DXL_LOG_INFO(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "io_uring transport active on %s", portName);
+    return true;
+#else
+    DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Built without io_uring headers, %s uses read/write", portName);
+    return false;
+#endif
+}
+
+void DXLPortHandlerUring::teardownRing() {
+    if (sqeMemory != 0 && sqeMemory != MAP_FAILED)  munmap(sqeMemory, sqeMemorySize);
+    if (cqRing != 0 && cqRing != MAP_FAILED && cqRing != sqRing)    munmap(cqRing, cqRingSize);
+    if (sqRing != 0 && sqRing != MAP_FAILED)    munmap(sqRing, sqRingSize);
+    sqRing = cqRing = sqeMemory = 0;
+    if (ringFd >= 0)    close(ringFd);
+    ringFd = -1;
+}
+
+void DXLPortHandlerUring::abandonRing() {
+    teardownRing();
+    txPending = 0;
+    if (socketFd == -1)     return;
+    struct termios tio;                                 // Back to what setupPort() chose for the plain path
+    if (tcgetattr(socketFd, &tio) == 0) {
+        tio.c_cc[VMIN] = options.useEpoll ? 0 : cc_t(options.vmin);
+        tio.c_cc[VTIME] = options.useEpoll ? 0 : cc_t(options.vtime);
+        tcsetattr(socketFd, TCSANOW, &tio);
+    }
+    bool blocking = !options.useEpoll && (options.vmin > 0 || options.vtime > 0);
+    if (blocking)   fcntl(socketFd, F_SETFL, fcntl(socketFd, F_GETFL) & ~O_NONBLOCK);
+}
+
+bool DXLPortHandlerUring::openPort() {
+    return setBaudRate(baudRate);
+}
+
+bool DXLPortHandlerUring::setBaudRate(const int baudrate) {
+    txPending = 0;
+    bool opened = DXLPortHandlerLinux::setBaudRate(baudrate);
+    if (opened && !ringTried) {                         // Ring outlives reopening, the fd goes in each SQE
+        ringTried = true;
+        setupRing();
+    }
+    if (opened && ringFd >= 0) {                        // VMIN 0 would complete reads with 0 bytes at once. VMIN 1 and O_NONBLOCK
+        struct termios tio;                             // give EAGAIN instead, which io_uring turns into a poll wait.
+        if (tcgetattr(socketFd, &tio) == 0) {
+            tio.c_cc[VMIN] = 1;
+            tio.c_cc[VTIME] = 0;
+            tcsetattr(socketFd, TCSANOW, &tio);
+        }
+        fcntl(socketFd, F_SETFL, fcntl(socketFd, F_GETFL) | O_NONBLOCK);
+    }
+    return opened;
+}
+
+void DXLPortHandlerUring::closePort() {
+    if (txPending > 0 && socketFd != -1)    sendPending();
+    DXLPortHandlerLinux::closePort();
+}
+
+void DXLPortHandlerUring::clearPort() {              // Before every packet write: an instruction no read picked up (TxOnly) goes now
+    if (txPending > 0 && socketFd != -1)    sendPending();
+    DXLPortHandlerLinux::clearPort();
+}
+
+int DXLPortHandlerUring::sendPending() {
+    int length = txPending;
+    txPending = 0;
+    return writeAll(txBuffer, length);
+}
+
+int DXLPortHandlerUring::writePort(uint8_t *packet, int length) {
+    if (ringFd < 0)     return DXLPortHandlerLinux::writePort(packet, length);
+
+    if (txPending > 0 && (txPending + length > DXL_PORT_CORK_BYTES || !expectsStatus(packet, length))) {
+        if (sendPending() < 0)  return -1;
+    }
+    if (!expectsStatus(packet, length) || length > DXL_PORT_CORK_BYTES)    return writeAll(packet, length);
+    memcpy(txBuffer + txPending, packet, size_t(length));      // Goes out with the status read
+    txPending += length;
+    return length;
+}
+
+int DXLPortHandlerUring::transfer(uint8_t *rx, int rxLength) {
+#if defined(DXL_HAVE_IO_URING)
+    double remainingMs = packetTimeoutMs - getTimeSinceStart();
+    if (packetTimeoutMs <= 0.0 || remainingMs <= 0.0) {        // Deadline gone: send what is pending, take what is there
+        if (txPending > 0 && sendPending() < 0)     return 0;
+        int n;
+        do {
+            n = int(read(socketFd, rx, size_t(rxLength)));
+        } while (n < 0 && errno == EINTR);
+        return n > 0 ? n : 0;
+    }
+
+    struct __kernel_timespec timeout;
+    timeout.tv_sec = (long long)(remainingMs / 1000.0);
+    timeout.tv_nsec = (long long)((remainingMs - double(timeout.tv_sec) * 1000.0) * 1000000.0);
+
+    struct io_uring_sqe *ring = static_cast<struct io_uring_sqe *>(sqes);
+    unsigned tail = *sqTail, mask = *sqMask;
+    unsigned submitted = 0;
+    if (txPending > 0) {                                // write -> read: the read only starts once the instruction is out
+        struct io_uring_sqe *sqe = &ring[tail & mask];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = socketFd;
+        sqe->addr = (unsigned long long)(uintptr_t)txBuffer;
+        sqe->len = unsigned(txPending);
+        sqe->off = (unsigned long long)-1;              // Current position, the only one a tty has
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->user_data = DXL_URING_TAG_WRITE;
+        sqArray[tail & mask] = tail & mask;
+        tail++, submitted++;
+    }
+    struct io_uring_sqe *sqe = &ring[tail & mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = socketFd;
+    sqe->addr = (unsigned long long)(uintptr_t)rx;
+    sqe->len = unsigned(rxLength);
+    sqe->off = (unsigned long long)-1;
+    sqe->flags = IOSQE_IO_LINK;                         // read -> link timeout: cancelled at the packet deadline
+    sqe->user_data = DXL_URING_TAG_READ;
+    sqArray[tail & mask] = tail & mask;
+    tail++, submitted++;
+
+    sqe = &ring[tail & mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_LINK_TIMEOUT;
+    sqe->addr = (unsigned long long)(uintptr_t)&timeout;
+    sqe->len = 1;
+    sqe->user_data = DXL_URING_TAG_TIMEOUT;
+    sqArray[tail & mask] = tail & mask;
+    tail++, submitted++;
+
+    reinterpret_cast<std::atomic<unsigned> *>(sqTail)->store(tail, std::memory_order_release);
+    int txLength = txPending;
+    txPending = 0;
+
+    int received = 0;
+    unsigned completed = 0, toSubmit = submitted;
+    while (completed < submitted) {
+        enterCalls++;
+        int entered = int(syscall(__NR_io_uring_enter, ringFd, toSubmit, submitted - completed, IORING_ENTER_GETEVENTS, 0, 0));
+        if (entered < 0 && errno != EINTR) {
+            DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "io_uring_enter failed on %s: %s", portName, strerror(errno));
+            completed += reap(received, txLength);
+            if (completed < submitted && !cancelTransfer(toSubmit, submitted - completed, txLength, received)) {
+                DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, errno, "Could not cancel io_uring requests on %s, closing the ring, using read/write", portName);
+                abandonRing();
+            }
+            break;
+        }
+        if (entered > 0)    toSubmit -= unsigned(entered) < toSubmit ? unsigned(entered) : toSubmit;
+        completed += reap(received, txLength);
+    }
+    return received;                                    // 0: timed out (read cancelled) or failed
+#else
+    return DXLPortHandlerLinux::readAvailable(rx, rxLength);
+#endif
+}
+
+unsigned DXLPortHandlerUring::reap(int &received, int txLength) {
+#if defined(DXL_HAVE_IO_URING)
+    std::atomic<unsigned> *head = reinterpret_cast<std::atomic<unsigned> *>(cqHead);
+    unsigned h = head->load(std::memory_order_relaxed), count = 0;
+    unsigned t = reinterpret_cast<std::atomic<unsigned> *>(cqTail)->load(std::memory_order_acquire);
+    for (; h != t; h++, count++) {
+        const struct io_uring_cqe *cqe = &static_cast<const struct io_uring_cqe *>(cqes)[h & *cqMask];
+        if (cqe->user_data == DXL_URING_TAG_READ && cqe->res > 0)    received = cqe->res;
+        else if (cqe->user_data == DXL_URING_TAG_WRITE && cqe->res != txLength) {
+            DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, cqe->res < 0 ? -cqe->res : 0, "Write error on %s: %d of %d bytes", portName, cqe->res, txLength);
+        }
+    }
+    head->store(h, std::memory_order_release);
+    return count;
+#else
+    (void)received, (void)txLength;
+    return 0;
+#endif
+}
+
+bool DXLPortHandlerUring::cancelTransfer(unsigned unsubmitted, unsigned outstanding, int txLength, int &received) {
+#if defined(DXL_HAVE_IO_URING)
+    // SQEs the failed enter did not take are still queued and go in first, then the cancels. Cancelling the head of the
+    // chain (write, else read) ends the rest of it with -ECANCELED. Every request and every cancel gives one CQE.
+    struct io_uring_sqe *ring = static_cast<struct io_uring_sqe *>(sqes);
+    unsigned tail = *sqTail, mask = *sqMask, cancels = 0;
+    const uint64_t targets[2] = { DXL_URING_TAG_WRITE, DXL_URING_TAG_READ };
+    for (int i = (txLength > 0) ? 0 : 1; i < 2; i++) {
+        struct io_uring_sqe *sqe = &ring[tail & mask];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = targets[i];                         // user_data of the request to cancel
+        sqe->user_data = DXL_URING_TAG_CANCEL;
+        sqArray[tail & mask] = tail & mask;
+        tail++, cancels++;
+    }
+    reinterpret_cast<std::atomic<unsigned> *>(sqTail)->store(tail, std::memory_order_release);
+
+    unsigned pending = outstanding + cancels, completed = 0, toSubmit = unsubmitted + cancels;
+    while (completed < pending) {
+        enterCalls++;
+        int entered = int(syscall(__NR_io_uring_enter, ringFd, toSubmit, pending - completed, IORING_ENTER_GETEVENTS, 0, 0));
+        if (entered < 0 && errno != EINTR)  return false;
+        if (entered > 0)    toSubmit -= unsigned(entered) < toSubmit ? unsigned(entered) : toSubmit;
+        int late = 0;                                   // A read that finished before the cancel still counts
+        completed += reap(late, txLength);
+        if (late > 0)   received = late;
+    }
+    return true;
+#else
+    (void)unsubmitted, (void)outstanding, (void)txLength, (void)received;
+    return true;
+#endif
+}
+
+int DXLPortHandlerUring::readPort(uint8_t *packet, int length) {
+    if (ringFd < 0)     return DXLPortHandlerLinux::readPort(packet, length);
+
+    int received = 0;
+    for (;;) {                                          // Same contract as the epoll path: full length or deadline
+        received += transfer(packet + received, length - received);
+        if (received >= length)     return received;
+        double remainingMs = packetTimeoutMs - getTimeSinceStart();
+        if (packetTimeoutMs <= 0.0 || remainingMs <= 0.0)   return received;
+    }
+}
+
+int DXLPortHandlerUring::readAvailable(uint8_t *buffer, int capacity) {
+    if (ringFd < 0)     return DXLPortHandlerLinux::readAvailable(buffer, capacity);
+    return transfer(buffer, capacity);
+}
+
+/*
+////////////////////////////////////////////////////    Example Code: benchmark against SDK and epoll handlers over a pty    ///////////////////////////////////////////////////////////////////////////
+// Link with -lutil for openpty(). Same responder as the DXLPortHandlerLinux example: every READ gets a fixed position reply
+// (CRC from dxlCrc16()). Measures transport overhead only, pty has no latency timer.
+#include <pty.h>
+#include <thread>
+#include <atomic>
+
+    int master, slave;
+    char slaveName[100];
+    openpty(&master, &slave, slaveName, 0, 0);
+    std::atomic<bool> stop(false);
+    std::thread responder([&]() {
+        uint8_t rx[64];
+        uint8_t status[15];
+        DXLPacketWriter writer(status, sizeof(status), 1, INST_STATUS);
+        uint8_t params[5] = { 0x00, 0x00, 0x08, 0x00, 0x00 };      // Error byte, position 2048
+        writer.put(params, 5);
+        writer.finish();
+        while (!stop) {
+            if (read(master, rx, sizeof(rx)) > 0)  write(master, status, sizeof(status));
+        }
+    });
+
+    DXLServo sdkServo, epollServo, uringServo;
+    DXLServo *servos[3] = { &sdkServo, &epollServo, &uringServo };
+    const char *names[3] = { "sdk", "epoll", "io_uring" };
+    epollServo.setPortBackend(DXL_PORT_LOW_LATENCY);
+    uringServo.setPortBackend(DXL_PORT_IO_URING);
+    for (int s = 0; s < 3; s++) {
+        servos[s]->setDXLServo(1);
+        servos[s]->deviceName = slaveName;
+        servos[s]->setDXLID(1);
+        servos[s]->initPortHandler();
+        servos[s]->initPacketHandler();
+        servos[s]->openPort();
+        servos[s]->setPortBaudRate();
+        DXLBusStats::instance().reset();
+        DXLBusStats::instance().enable(true);
+        for (int i = 0; i < 10000; i++)    servos[s]->readCurrentPosition();
+        DXLLatencySnapshot snap;
+        DXLBusStats::instance().snapshot(1, INST_READ, ADDR_PRO_PRESENT_POSITION, snap);
+        printf("%s: mean %.1fus p50 %.1fus p99 %.1fus\n", names[s], snap.mean(), snap.percentile(50), snap.percentile(99));
+        servos[s]->closePort();
+    }
+    printf("io_uring_enter per read: %.2f\n", double(static_cast<DXLPortHandlerUring *>(uringServo.prtHandler)->submissions()) / 10000.0);
+    stop = true;
+    close(master);
+    responder.join();
+// End of Example Code
+*/
+
+#endif
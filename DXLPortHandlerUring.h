@@ -0,0 +1,71 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+io_uring serial PortHandler for Linux. Select with DXLServo::setPortBackend(DXL_PORT_IO_URING) before initPortHandler().
+
+Builds on DXLPortHandlerLinux (same termios setup, low latency flag and packet timeout) and changes only how bytes move:
+writePort() keeps the instruction packet, and the following read submits it together with the status read as linked
+SQEs, write -> read -> link timeout, in one io_uring_enter(). A transaction then costs one system call instead of
+write + epoll_wait + read, and the read sleeps in the kernel until the reply arrives or the packet timeout cancels it.
+A held instruction no read follows (unicast TxOnly) is written when the next packet starts, or on closePort().
+
+The ring is set up with the raw system calls (no liburing needed) on first open. Where io_uring is missing, blocked
+(seccomp, containers) or too old to poll a tty (no IORING_FEAT_FAST_POLL, before 5.7) the handler logs it once and
+falls back to the plain DXLPortHandlerLinux read/write path. If io_uring_enter() fails mid transaction, the requests still
+in flight (they point at the caller's buffer) are cancelled and reaped before returning; if even that fails the ring is
+closed and the port stays on read/write.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+
+#include <stdint.h>
+
+#include "DXLPortHandlerLinux.h"
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define DXL_HAVE_IO_URING
+#endif
+#endif
+
+#define DXL_URING_ENTRIES           8                   // Three SQEs per transaction
+
+class DXLPortHandlerUring : public DXLPortHandlerLinux {
+private:
+    int ringFd;                                         // -1: not set up or unavailable, plain path used
+    bool ringTried;
+    void *sqRing, *cqRing, *sqeMemory;
+    size_t sqRingSize, cqRingSize, sqeMemorySize;
+    unsigned *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    void *sqes, *cqes;
+
+    uint8_t txBuffer[DXL_PORT_CORK_BYTES];              // Instruction waiting to go out with the next read
+    int txPending;
+    uint64_t enterCalls;
+
+    bool setupRing();
+    void teardownRing();
+    void abandonRing();                                 // Ring closed after a failure, port set back for the plain path
+    int transfer(uint8_t *rx, int rxLength);            // Pending write and one read in one submission, returns bytes read
+    unsigned reap(int &received, int txLength);         // Takes completed CQEs, returns how many
+    bool cancelTransfer(unsigned unsubmitted, unsigned outstanding, int txLength, int &received);   // Cancels what transfer() left in flight, reaps it all
+    int sendPending();                                  // Write alone, for writes without a read to follow
+
+public:
+    explicit DXLPortHandlerUring(const char *port_name, const DXLPortOptions &opts = DXLPortOptions());
+    virtual ~DXLPortHandlerUring();
+
+    virtual bool openPort();
+    virtual void closePort();
+    virtual void clearPort();
+    virtual bool setBaudRate(const int baudrate);
+    virtual int readPort(uint8_t *packet, int length);
+    virtual int writePort(uint8_t *packet, int length);
+    virtual int readAvailable(uint8_t *buffer, int capacity);
+
+    bool isUringActive() const { return ringFd >= 0; }
+    uint64_t submissions() const { return enterCalls; }   // io_uring_enter() calls so far
+};
+
+#endif
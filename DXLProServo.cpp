@@ -1,2557 +1,3068 @@
-
-using namespace std;
-
-/*******************************************************************************
-* Copyright 2017 ROBOTIS CO., LTD.
-*
-* Licensed under the Apache License, Version 2.0 (the "License");
-* you may not use this file except in compliance with the License.
-* You may obtain a copy of the License at
-*
-*     http://www.apache.org/licenses/LICENSE-2.0
-*
-* Unless required by applicable law or agreed to in writing, software
-* distributed under the License is distributed on an "AS IS" BASIS,
-* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-* See the License for the specific language governing permissions and
-* limitations under the License.
-*******************************************************************************/
-
-/*///////////////////////////////////////////////////////////////////////////////
-Created by: Sayyed Omar Kamal
-Date: 8 June 2018
-
-For Dynamixel MX-64 and Pro M42 servos specifically. Control tables for MX and Pro servos in header file. Code allows use of either servo by setting servoType variable when creating DXLServo object.
-Most Register addresses added as required by project. Unused ones may be added in future. 
-Most basic functionalities added; 
-- Position control via direct integer value or angle. 
-- Velocity and Acceleration changes via direct integer or velocity/acceleration. 
-- Current or Torque (depending on servo type) changes via direct integer or current. 
-- Read/Write of most used Parameters (Position, Velocity, Acceleration, Current/Torque, Present values, Limits, Gains, internal states, etc). 
-- Conversion between high level (angle, velocity, acceleration) and low level integers
-
-Code built in Linux Ubuntu environment. Cross platform functionality not fully implemented yet. Focus on Ubuntu for now.
-
-Requires Dynamixel SDK:
-https://github.com/ROBOTIS-GIT/DynamixelSDK
-eManual for environment Setup
-http://emanual.robotis.com/docs/en/software/dynamixel/dynamixel_sdk/overview/
-
-///////////////////////////////////////////////////////////////////////////////*/
-
-#include "DXLProServo.h"
-
-/*
-// If getch() needed. getch call for Windows is _getch(), for non-Windows, need to use below code
-int getch(void)
-{
-//#if defined(__linux__) || defined(__APPLE__)
-    struct termios oldt, newt;
-    int ch;
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    ch = getchar();
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    return ch;
-//#elif defined(_WIN32) || defined(_WIN64)
-//    return _getch();
-//#endif
-}
-*/
-
-// if kbhit() needed
-/*
-int kbhit(void)
-{
-#if defined(__linux__) || defined(__APPLE__)
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
-
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
-
-    ch = getchar();
-
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
-
-    if (ch != EOF)
-    {
-        ungetc(ch, stdin);
-        return 1;
-    }
-
-    return 0;
-#elif defined(_WIN32) || defined(_WIN64)
-    return _kbhit();
-#endif
-}
-*/
-
-void crossSleep(int time) {			// Cross platform sleep() func. Linux/Unix: time in seconds. Windows: time in milliseconds. May be busy sleep. Change to non-busy sleep.
-#if defined(__linux__) || defined(__APPLE__)
-    if (time >= 10) {
-        printf("Sleeping for more than 10 seconds. System will not respond in that time. Are you sure?\n");
-    }
-    sleep(time);		// Change to ms sleep later
-#elif defined(_WIN32) || defined(_WIN64)
-    _sleep(time);
-#endif
-}
-
-////////////////////////////////////////////////////   DXLServo class definition   /////////////////////////////////////////////////////////////////////////////////////////
-
-DXLServo::DXLServo() {							// Constructor
-    identity = 1;								// default ID 1
-    protocolVersion = 2.0;						// default Protocol 2.0
-    baudRate = 57600;							// default 57,600 baud
-
-    goalPositionVector.clear();					// Initialize empty vectors at start
-	goalAngleVector.clear();
-    present_position = 0, present_current = 0.0, present_temperature = 25;				// Basic starting values, change with read later
-    limitAccel = 1, limitVel = 1, limitCurrent = 0, limitPosMin = 0, limitPosMax = 4095, homeOffset = 0;
-    profileAccel = 1, profileVel = 1;
-
-    for (int i = 0; i < 4; i++) {			// Initialize all External Port Modes to 0;
-        externalPort[i] = 0;
-    }
-
-
-    dxl_comm_result = COMM_TX_FAIL;				// Initial comm result
-    dxl_error = 0;								// Dynamixel error
-}
-
-DXLServo::~DXLServo() {							// Destructor
-
-}
-
-void DXLServo::enableTorque() {			// Enable Dynamixel Torque
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_TORQUE_ENABLE;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_TORQUE_ENABLE;
-
-    dxl_comm_result = this->pktHandler->write1ByteTxRx(this->prtHandler, identity, address, TORQUE_ENABLE, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-    else
-    {
-        printf("Dynamixel#%d has been successfully connected \n", identity);
-    }
-}
-
-void DXLServo::disableTorque() {			// Disable Dynamixel Torque
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_TORQUE_ENABLE;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_TORQUE_ENABLE;
-
-    dxl_comm_result = this->pktHandler->write1ByteTxRx(this->prtHandler, identity, address, TORQUE_DISABLE, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-}
-
-void DXLServo::addToGoalPosVector(const std::vector<int> &posVector) {			// Store a vector of preselected Goal Positions into internal vector
-    for (int i = 0; i < posVector.size(); i++) {
-        goalPositionVector.push_back(posVector[i]);
-    }
-}
-
-int DXLServo::checkGoalPosVector() {			// Check internal vector for invalid data
-    if (goalPositionVector.size() == 0) {
-        printf("Error! Goal Position Vector is empty!\n");
-        return -1;
-    }
-    else {
-        bool check = false;
-        int limit;
-        if (servoType == DXL_MX_64) {
-            limit = 4095;
-        }
-        else if (servoType == DXL_PRO_M42) {
-            limit = 131593;
-        }
-        for (int i = 0; i < goalPositionVector.size(); i++) {
-            if (abs(goalPositionVector[i]) > limit) {
-                printf("Error! Goal Position Vector contains invalid position at index %d!\n", i);
-                printf("!!! Modify or reinitialize Position Vector !!!\n");
-                check = true;
-                break;			// Exit for loop at any point error occurs
-            }
-            // if (servoType == DXL_MX_64 && goalPositionVector[i] < 0) {
-                // printf("Error! MX servo cannot have negative position at index %d!\n", i);
-                // printf("!!! Modify or reinitialize Position Vector !!!\n");
-                // check = true;
-                // break;			// Exit for loop at any point error occurs
-            // }
-        }
-        if (check) return 0;
-        else return 1;
-    }
-}
-
-void DXLServo::writeGoalPosition(int vectorPosition) {						// Write DXL position from internal stored vector. Input: vectorPosition = index of positon stored in internal vector
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_GOAL_POSITION;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_GOAL_POSITION;
-
-    if (goalPositionVector.size() == 0) {				// If array is empty
-        printf("Error! Goal Position Vector is empty!\n");
-    }
-    else {
-        dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, goalPositionVector[vectorPosition], &dxl_error);
-        if (dxl_comm_result != COMM_SUCCESS)
-        {
-            printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        }
-        else if (dxl_error != 0)
-        {
-            printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        }
-        int count = 0;
-        while (isMoving()) {		// internal Moving check to disallow actions while not in position. Comment out if changing to external Moving check
-            count += 1;
-            if( (count % 30) == 0 )    printf("Servo still moving...\n");
-            //crossSleep(1);		// Assume Linux, sleep for 1s
-            //sleep(1);			// Unix, Linux: sleep for 1s
-            //_sleep(500);		// Windows: sleep for 0.5s
-            //std::this_thread::sleep_for(std::chrono::milliseconds(500));	// C++ standard library non-busy sleep
-        }
-        count = 0;
-    }
-    //return;
-}
-
-void DXLServo::writeGoalPosition(int select, int vectorPosition) {			// Write DXL position from either internal Position or direct integer entry. Inputs: select: 0 = Internal vector, 1 = direct entry. vectorPosition: Index of stored position in internal vector or direct integer value of desired position
-    int address, limit;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_GOAL_POSITION;
-        limit = 4096;		// Max integer value for position of MX servo
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_GOAL_POSITION;
-        limit = pow(2, 31);		// Max integer value for position of Pro servo
-    }
-    if (select == 0) {			// Internal Position Vector
-        if (vectorPosition > goalPositionVector.size() || vectorPosition < 0) {
-            printf("Error! Invalid vector reference!");
-            return;
-        }
-        dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, goalPositionVector[vectorPosition], &dxl_error);
-        if (dxl_comm_result != COMM_SUCCESS)
-        {
-            printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        }
-        else if (dxl_error != 0)
-        {
-            printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        }
-    }
-    else if (select == 1) {		// Direct entry
-        if (abs(vectorPosition) >= 0 && abs(vectorPosition) < limit) {
-            dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, vectorPosition, &dxl_error);
-            if (dxl_comm_result != COMM_SUCCESS)
-            {
-                printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-            }
-            else if (dxl_error != 0)
-            {
-                printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-            }
-        }
-        else {
-            printf("Error! Invalid value of desired Goal Position; Values between 0 - %i only, from -180 to +180 degrees in units of 0.088 degrees!\n", limit);
-        }
-    }
-    else {
-        printf("Error! Invalid Select value; 0 for internal reference or 1 for direct entry!\n");
-    }
-    int count = 0;
-    while (isMoving()) {		// internal Moving check to disallow actions while not in position. Comment out if changing to external Moving check
-        count += 1;
-        if( (count % 30) == 0 )    printf("Servo still moving...\n");
-        //crossSleep(1);		// Assume Linux, sleep for 1s
-        //sleep(1);			// Unix, Linux: sleep for 1s
-        //_sleep(500);		// Windows: sleep for 0.5s
-        //std::this_thread::sleep_for(std::chrono::milliseconds(500));	// C++ standard library non-busy sleep
-    }
-    count = 0;
-}
-
-int DXLServo::readCurrentPosition() {			// Read servo's position, returns integer value. For angle, use readCurrentAngle().
-    bool success = true;
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_PRESENT_POSITION;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_PRESENT_POSITION;
-
-    printf("Reading Present Position\n");
-    int position = -1;
-    dxl_comm_result = this->pktHandler->read4ByteTxRx(this->prtHandler, identity, address, (uint32_t*)&position, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Present Position read\n");
-        if (position < 0) {
-            printf("Error! Position value is negative! Unexpected Error\n");
-            return -1;
-        }
-        present_position = position;
-    }
-    return position;
-}
-
-double DXLServo::readCurrentAngle() {			// Read servo's position, returns in angle (degrees).
-    bool success = true;
-    int address, temp;
-    double angle;
-
-    if (servoType == DXL_MX_64)  address = ADDR_MX_PRESENT_POSITION;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_PRESENT_POSITION;
-
-    printf("Reading Present Angle\n");
-    int position = -1;
-    dxl_comm_result = this->pktHandler->read4ByteTxRx(this->prtHandler, identity, address, (uint32_t*)&position, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Present Angle read\n");
-//        if (position < 0 && servoType == DXL_MX_64) {
-//            printf("Error! Position value is negative! Unexpected Error\n");
-//            return -1.0;
-//        }
-//        else if (position < 0 && servoType == DXL_PRO_M42) {
-//            temp = -(position);
-//        }
-//        else{
-        temp = position;
-        //}
-        angle = convertValtoPos( (temp + homeOffset) );		// Current angle including homing offset
-        present_position = temp;
-    }
-    return angle;
-}
-
-void DXLServo::addToGoalAngleVect(const std::vector<double> &angVector) {		// Store a vector of preselected Goal Positions into internal vector
-    for (int i = 0; i < angVector.size(); i++) {
-        goalAngleVector.push_back(angVector[i]);
-    }
-}
-
-int DXLServo::checkGoalAngleVect() {			// Check internal vector for invalid data
-    if (goalAngleVector.size() == 0) {
-        printf("Error! Goal Angle Vector is empty!\n");
-        return -1;
-    }
-    else {
-        bool check = false;
-        double limit = 180.0;
-//        if (servoType == DXL_MX_64) {
-//            limit = 360;
-//        }
-//        else if (servoType == DXL_PRO_M42) {
-//            limit = 180;
-//        }
-        for (int i = 0; i < goalAngleVector.size(); i++) {
-            if (abs(goalAngleVector[i]) > limit) {
-                printf("Error! Exceeded limit at index %d!\n", i);
-                printf("!!! Modify or reinitialize Position Vector !!!\n");
-                check = true;
-                break;			// Exit for loop at any point error occurs
-            }
-//            if (servoType == DXL_MX_64 && goalAngleVector[i] < 0) {
-//                printf("Error! MX servo cannot have negative position at index %d!\n", i);
-//                printf("!!! Modify or reinitialize Position Vector !!!\n");
-//                check = true;
-//                break;			// Exit for loop at any point error occurs
-//            }
-        }
-        if (check) return 0;
-        else return 1;
-    }
-}
-
-void DXLServo::writeGoalAngle(int vectorAngle) {			// Write DXL position from internal stored vector. Input: vectorAngle = index of positon stored in internal vector
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_GOAL_POSITION;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_GOAL_POSITION;
-
-    if (goalAngleVector.size() == 0) {				// If array is empty
-        printf("Error! Goal Position Vector is empty!\n");
-        return;
-    }
-    else if (vectorAngle > goalAngleVector.size() || vectorAngle < 0) {		// if reference to vector is negative or exceeds vector size
-        printf("Error! Invalid vector reference!");
-        return;
-    }
-    else {
-        int valPos = convertPostoVal(goalAngleVector[vectorAngle]);
-        valPos = valPos - homeOffset;
-        dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, valPos, &dxl_error);
-        if (dxl_comm_result != COMM_SUCCESS)
-        {
-            printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        }
-        else if (dxl_error != 0)
-        {
-            printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        }
-        int count = 0;
-        while (isMoving()) {			// internal Moving check to disallow actions while not in position. Comment out if changing to external Moving check
-            count += 1;
-            if( (count % 30) == 0 )    printf("Servo still moving...\n");
-            //crossSleep(1);		// Assume Linux, sleep for 1s
-            //sleep(1);			// Unix, Linux: sleep for 1s
-            //_sleep(500);		// Windows: sleep for 0.5s
-            //std::this_thread::sleep_for(std::chrono::milliseconds(500));	// C++ standard library non-busy sleep
-        }
-        count = 0;
-        //printf("Goal angle write done\n");
-    }
-}
-
-void DXLServo::writeGoalAngle(int select, double vectorAngle) {			// Write DXL position from either internal Angle or direct integer entry. Inputs: select: 0 = Internal vector, 1 = direct entry. vectorPosition: Index of stored position in internal vector or direct integer value of desired position
-    int address, limit;
-    double unit;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_GOAL_POSITION;
-        limit = 4096;
-        unit = 0.088;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_GOAL_POSITION;
-        limit = pow(2, 31);
-        unit = 0.00137;
-    }
-
-    if (select == 0) {			// Internal Position Vector
-        if (vectorAngle > goalAngleVector.size() || vectorAngle < 0) {
-            printf("Error! Invalid vector reference!");
-            return;
-        }
-        int valPos = convertPostoVal(goalAngleVector[vectorAngle]);
-        valPos = valPos - homeOffset;
-        dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, valPos, &dxl_error);
-        if (dxl_comm_result != COMM_SUCCESS)
-        {
-            printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        }
-        else if (dxl_error != 0)
-        {
-            printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        }
-    }
-    else if (select == 1) {		// Direct entry
-        int valPos = convertPostoVal(vectorAngle);
-        valPos = valPos - homeOffset;
-        if (abs(valPos) < limit) {
-            dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, valPos, &dxl_error);
-            if (dxl_comm_result != COMM_SUCCESS)
-            {
-                printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-            }
-            else if (dxl_error != 0)
-            {
-                printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-            }
-        }
-        else {
-            printf("Error! Invalid value of desired Goal Position; Values between 0 - %i only, from 0 to 360 degrees in units of %f degrees!\n", limit, unit);
-        }
-    }
-    else {
-        printf("Error! Invalid Select value; 0 for internal reference or 1 for direct entry!\n");
-    }
-    int count = 0;
-    while (isMoving()) {			// internal Moving check to disallow actions while not in position. Comment out if changing to external Moving check
-        count += 1;
-        if( (count % 30) == 0 )    printf("Servo still moving...\n");
-        //crossSleep(1);		// Assume Linux, sleep for 1s
-        //sleep(1);			// Unix, Linux: sleep for 1s
-        //_sleep(500);		// Windows: sleep for 0.5s
-        //std::this_thread::sleep_for(std::chrono::milliseconds(500));	// C++ standard library non-busy sleep
-    }
-    count = 0;
-}
-
-int DXLServo::checkOperating() {			// Returns status of Operate Mode register
-    //bool success = true;
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_OPERATING_MODE;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_OPERATING_MODE;
-
-    printf("Reading Operate Mode\n");
-    uint8_t *set_operate_mode = new uint8_t;
-    dxl_comm_result = this->pktHandler->read1ByteTxRx(this->prtHandler, identity, address, set_operate_mode, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        //success = false;
-    }
-
-    printf("Operate Mode read\n");
-    int opMode = 0;
-    opMode = (opMode << 8) + set_operate_mode[0];
-
-    if (opMode < 0) {
-        printf("Error! Operate Mode value is negative!\n");
-        return -1;
-    }
-    else return opMode;
-}
-
-int DXLServo::checkPositionMode() {				// Checks if Operate Mode is set to Position Control Mode, warning if not.
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_OPERATING_MODE;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_OPERATING_MODE;
-
-    uint8_t *set_operate_mode = new uint8_t;
-    dxl_comm_result = this->pktHandler->read1ByteTxRx(this->prtHandler, identity, address, set_operate_mode, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    int opMode = 0;
-    opMode = (opMode << 8) + set_operate_mode[0];
-
-    if (opMode < 0) {
-        printf("Error! Operate Mode value is negative! Unexpected error!\n");
-        return -1;
-    }
-    else if (opMode != 3) {
-        printf("Warning! Operate Mode not set to Position Control!\n");
-        return 0;
-    }
-    else return 1;
-}
-
-void DXLServo::setOperatingMode(int mode) {				// Change Operate Mode. Input: mode: 0 = Current Control, 1 = Velocity Control, 2 = Position (Single turn) Control (default), 3 = Extended Position (Multi turn) Control, 4 = Current based Position Control, 5 = PWM Control
-    bool success = true;
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_OPERATING_MODE;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_OPERATING_MODE;
-
-    uint8_t opMode = 3;									// Default Operating Mode: 3, Position Control
-    std::string modeSet;
-    // add MX or PRO check
-    switch (mode) {
-    case 0:
-        opMode = DXL_MX_CURRENT_CONTROL_MODE;
-        modeSet = "Current";
-        break;
-    case 1:
-        opMode = DXL_VELOCITY_CONTROL_MODE;
-        modeSet = "Velocity";
-        break;
-    case 2:
-        opMode = DXL_POSITION_CONTROL_MODE;
-        modeSet = "Position";
-        break;
-    case 3:
-        opMode = DXL_EXTENDED_CONTROL_MODE;
-        modeSet = "Extended Position";
-        break;
-    case 4:
-        opMode = DXL_MX_CURRENT_POSITION_CONTROL_MODE;
-        modeSet = "Current Position";
-        break;
-    case 5:
-        opMode = DXL_MX_PWM_CONTROL_MODE;
-        modeSet = "PWM";
-        break;
-    }
-
-    if (servoType == DXL_PRO_M42 && (opMode == 4 || opMode == 5)) {
-        printf("ERROR! Pro servo does not implement Current based Position or PWM Control!\n");
-        return;
-    }
-
-    dxl_comm_result = this->pktHandler->write1ByteTxRx(this->prtHandler, identity, address, opMode, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        //printf("Operating Mode set to: %s Control Mode\n", modeSet);
-        cout << "Operating Mode set to: " << modeSet << " Control Mode." << endl;
-    }
-}
-
-void DXLServo::setMaxCurrentLimit() {       // Sets Current limit to the max value before stall torque occurs
-    bool success = true;
-    int address, limit;
-    //double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_CURRENT_LIMIT;
-        limit = DXL_MX_CURRENT_LIMIT_MAX;
-        //mult = 0.00336;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_TORQUE_LIMIT;
-        limit = DXL_PRO_M42_TORQUE_LIMIT_MAX;
-        //mult = 0.004028;
-    }
-
-    dxl_comm_result = this->pktHandler->write2ByteTxRx(this->prtHandler, identity, address, limit, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        //double set = limit * mult;
-        double set = convertValtoCurr(limit);
-        printf("Current limit set to max %.2f amps\n", set);
-        limitCurrent = limit;
-    }
-}
-
-void DXLServo::setCurrentLimit(double amps) {		// Sets Current limit to desired current value. Limited by precalculated max current before stall torque occurs.
-    bool success = true;
-    int address;
-    double currLimit;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_CURRENT_LIMIT;
-        currLimit = 4.0;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_TORQUE_LIMIT;
-        currLimit = 2.1;
-    }
-
-    if (amps > currLimit || amps < 0.0) {
-        printf("Error! Invalid value of current limit! Select between 0.0 and %f!\n", currLimit);
-        return;
-    }
-
-    if (amps < (0.2 * currLimit)) {
-        printf("Warning! Setting value to less than 0.2 of limit, \nServo may not function properly under load!\n");
-    }
-
-    int limit;
-    limit = convertCurrtoVal(amps);
-    //if (servoType == DXL_MX_64) {
-    //	limit = int(int((amps / 0.00336) + 0.5));								// Rounding number trick; int(float value + 0.5)
-    //}
-    //else {
-    //	limit = int(int((amps / 0.004028) + 0.5));
-    //}
-
-    dxl_comm_result = this->pktHandler->write2ByteTxRx(this->prtHandler, identity, address, limit, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        //success = false;
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Current Limit set to %.2f amps\n", amps);
-        limitCurrent = limit;
-    }
-}
-
-void DXLServo::setCurrentLimit(int limit) {				// Sets Current limit via direct integer value. Limited by MX value limit or Pro M42 servo corresponding max current before stall torque occurs
-    bool success = true;
-    int address, currLimit;
-    //double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_CURRENT_LIMIT;
-        currLimit = 1941;
-        //mult = 0.00336;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_TORQUE_LIMIT;
-        currLimit = 521;
-        //mult = 0.004028;
-    }
-
-    if (limit > currLimit || limit < 0) {
-        printf("Error! Invalid value of current limit! Select between 0 and %d!\n", currLimit);
-        return;
-    }
-
-    if (limit < (currLimit / 5)) {
-        printf("Warning! Setting value to less than 0.2 of limit, \nservo may not function properly under load!\n");
-    }
-
-    dxl_comm_result = this->pktHandler->write2ByteTxRx(this->prtHandler, identity, address, limit, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        //double set = double(limit)* mult;
-        double set = convertValtoCurr(limit);
-        printf("Current Limit set to %.2f\n", set);
-        limitCurrent = limit;
-    }
-}
-
-void DXLServo::set80rpmVelLimit() {			// Sets Velocity Limit to 80rpm
-    bool success = true;
-    int address, velLimit;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_VELOCITY_LIMIT;
-        velLimit = DXL_MX_VELOCITY_LIMIT_80;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_VELOCITY_LIMIT;
-        velLimit = DXL_PRO_M42_VELOCITY_LIMIT_80;
-    }
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, velLimit, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = true;
-    }
-
-    if (success) {
-        printf("Velocity Limit set to 80rpm\n");
-        limitVel = velLimit;
-    }
-}
-
-void DXLServo::setVelocityLimit(int limit) {			// Sets Velocity limit via direct integer value
-    bool success = true;
-    int address, velLimit;
-    //double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_VELOCITY_LIMIT;
-        velLimit = 1023;
-        //mult = 0.229;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_VELOCITY_LIMIT;
-        velLimit = 25710;       // Actual limit for Pro servo is 2^31, but unlikely to use such high speed, severely limited for position application
-        //mult = 0.00389076;
-    }
-
-    if (limit > velLimit || limit < 0) {
-        printf("Error! Invalid value of velocity limit! Select between 0 and %d!\n", velLimit);
-        return;
-    }
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, limit, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        //int set = int(limit * mult);
-        int set = convertValtoVel(limit);
-        printf("Velocity Limit set to %i rpm\n", set);
-        limitVel = limit;
-    }
-}
-
-void DXLServo::setVelocityLimit(double limit) {			// Set velocity limit to desired velocity (rpm)
-    bool success = true;
-    int address;
-    double velLimit = 235.0;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_VELOCITY_LIMIT;
-        //velLimit = 1023;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_VELOCITY_LIMIT;
-        //velLimit = 60400;       // Actual limit for Pro servo is 2^31 * 0.00389076, but unlikely to use such high speed, severely limited for position application
-    }
-
-    if (limit > velLimit || limit < 0) {
-        printf("Error! Invalid value of velocity limit! Select between 0 and 235.0!\n");
-        return;
-    }
-
-    int pass = convertVeltoVal(limit);
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, pass, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Velocity Limit set to %.3f rpm\n", limit);
-        limitVel = pass;
-    }
-}
-
-int DXLServo::getVelocityLimit() {				// Read value of Velocity Limit set in servo. Returns integer value, conversion available. Change func to return double instead of int?
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_VELOCITY_LIMIT;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_VELOCITY_LIMIT;
-
-    int velocLim = 0;
-    dxl_comm_result = this->pktHandler->read4ByteTxRx(this->prtHandler, identity, address, (uint32_t*)&velocLim, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    double velocity = convertValtoVel(velocLim);
-    printf("Velocity Limit at %f rpm\n", velocity);
-    //return velocity;
-    return velocLim;
-}
-
-void DXLServo::setlowAccelLimit() {				// Sets Acceleration to low precalculated value. DXL servo acceleration far too high for position application, causes following error and shutdown.
-    bool success = true;
-    int address, limit;
-    //double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_ACCELERATION_LIMIT;
-        limit = DXL_MX_ACCELERATION_LIMIT_LOW;
-        //mult = 214.577;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_ACCELERATION_LIMIT;
-        limit = DXL_PRO_M42_ACCEL_LIMIT_LOW;
-        //mult = 201.039;
-    }
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, limit, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        //double set = limit * mult;
-        double set = convertValtoAcc(limit);
-        printf("Acceleration set to %.3f rev/min2\n", set);
-        limitAccel = DXL_MX_ACCELERATION_LIMIT_LOW;
-    }
-}
-
-void DXLServo::setAccelLimit(int limit) {				// Sets Acceleration limit, limited to 100 * unit. Modifiable.
-    bool success = true;
-    int address;
-    //double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_ACCELERATION_LIMIT;
-        //mult = 214.577;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_ACCELERATION_LIMIT;
-        //mult = 201.039;
-    }
-
-    if (limit > 100 || limit < 0) {
-        printf("Error! Invalid value of acceleration limit! Select between 0 and 100!/n100 value limit for safe operation!\n");
-        return;
-    }
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, limit, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        //double set = limit * mult;
-        double set = convertValtoAcc(limit);
-        printf("Acceleration set to %.3f rev/min2\n", set);
-        limitAccel = limit;
-    }
-}
-
-void DXLServo::setAccelLimit(double limit) {			// Sets Acceleration limit, limited to 100 * unit.
-    bool success = true;
-    int address;
-    double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_ACCELERATION_LIMIT;
-        mult = 214.577;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_ACCELERATION_LIMIT;
-        mult = 201.039;
-    }
-
-    if (limit > (100 * mult) || limit < 0) {
-        printf("Error! Invalid value of acceleration limit! Select between 0 and 100 * %.3f!/n100 value limit for safe operation!\n", mult);
-        return;
-    }
-
-    int pass = convertAcctoVal(limit);
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, pass, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Acceleration set to %.3f rev/min2\n", limit);
-        limitAccel = pass;
-    }
-}
-
-int DXLServo::getAccelLimit() {				// Read value of Acceleration limit, return in integer. Conversion available.
-    bool success = true;
-    int address;
-    //double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_ACCELERATION_LIMIT;
-        //mult = 214.577;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_ACCELERATION_LIMIT;
-        //mult = 201.039;
-    }
-
-    printf("Reading acceleration limit\n");
-
-    int accelLim = 0;
-    dxl_comm_result = this->pktHandler->read4ByteTxRx(this->prtHandler, identity, address, (uint32_t*)&accelLim, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) printf("Acceleration limit read\n");
-    //double accel = accelLim * mult;
-    double accel = convertValtoAcc(accelLim);
-    printf("Acceleration Limit at  %.3f rev/min2\n", accel);
-    return accelLim;
-}
-
-void DXLServo::setPositionLimit(bool minMax, int position) {		// Sets Position limits of servo. Inputs: minMax false for Min, true for Max; Position int for direct transmission
-    bool success = true;
-    int address, limitMin, limitMax;
-    std::string set;
-    if (!minMax) {									// minMax == false, Min Position Limit
-        if (servoType == DXL_MX_64) {
-            address = ADDR_MX_MIN_POSITION_LIMIT;
-            limitMin = 0;
-        }
-        else if (servoType == DXL_PRO_M42) {
-            address = ADDR_PRO_MIN_POSITION_LIMIT;
-            limitMin = int( -(pow(2.0,31.0)) );
-        }
-        set = "Minimum";
-    }
-    else {
-        if (servoType == DXL_MX_64) {
-            address = ADDR_MX_MAX_POSITION_LIMIT;			// minMax == true, Max Position Limit
-            limitMax = 4096;
-        }
-        else if (servoType == DXL_PRO_M42) {
-            address = ADDR_PRO_MAX_POSITION_LIMIT;
-            limitMax = int( pow(2.0, 31.0) );
-        }
-        set = "Maximum";
-    }
-
-    if (position < limitMin || position > limitMax) {		// check that position does not exceed limits
-        printf("ERROR! Value exceeds limits!\nSelect between %i and %i!\n", limitMin, limitMax);
-        return;
-    }
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, position, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        double angle = convertValtoPos(position);
-        cout << set << " Position limit set to " << angle << " degrees" << endl;
-        if (!minMax)	limitPosMin = position;
-        else			limitPosMax = position;
-    }
-}
-
-void DXLServo::setPositionLimit(bool minMax, double angle) {		// Sets Position limits of servo. Inputs: minMax false for Min, true for Max; angle in degrees
-    bool success = true;
-    int address;
-    double limitMin, limitMax;
-    std::string set;
-    if (!minMax) {									// minMax == false, Min Position Limit
-        if (servoType == DXL_MX_64) {
-            address = ADDR_MX_MIN_POSITION_LIMIT;
-            limitMin = 0.0;
-        }
-        else if (servoType == DXL_PRO_M42) {
-            address = ADDR_PRO_MIN_POSITION_LIMIT;
-            limitMin = -( pow(2.0, 31.0) );
-        }
-        set = "Minimum";
-    }
-    else {
-        if (servoType == DXL_MX_64) {
-            address = ADDR_MX_MAX_POSITION_LIMIT;			// minMax == true, Max Position Limit
-            limitMax = 360.0;
-        }
-        else if (servoType == DXL_PRO_M42) {
-            address = ADDR_PRO_MAX_POSITION_LIMIT;
-            limitMax = int( pow(2.0, 31.0) );
-        }
-        set = "Maximum";
-    }
-
-    if (angle < limitMin || angle > limitMax) {		// check that angle does not exceed limits
-        printf("ERROR! Value exceeds limits!\nSelect between %f and %f!\n", limitMin, limitMax);
-        return;
-    }
-
-    int position = convertPostoVal(angle);
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, position, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        cout << set << " Position limit set to " << angle << " degrees" << endl;
-        if (!minMax)	limitPosMin = position;
-        else			limitPosMax = position;
-    }
-}
-
-void DXLServo::setProfileAcceleration(int accel) {			// Sets Acceleration value for move while servo torque is enabled. Input: accel: direct integer value for transmission.
-    bool success = true;
-    int address;
-    //double mult;
-    if (servoType == DXL_MX_64){
-        address = ADDR_MX_PROFILE_ACCELERATION;
-        //mult = 214.577;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        //// Can edit to use Goal Var if Pro servo used to distinguish between speed control and Positioning Move Profile.
-        //printf("Error! Profile Variable only for MX servos!\nUse Goal Acceleration for Pro servo!\n");
-        //return;
-        address = ADDR_PRO_GOAL_ACCELERATION;
-        //mult = 201.039;
-    }
-
-    if (accel == 0) {
-        printf("Error! Value of 0 will give infinite acceleration! Disallowed for safe operation!\n");
-        return;
-    }
-    // Assumes Acceleration limit has been set/read in code before
-    else if (accel > limitAccel || accel < 0) {
-        printf("Error! Invalid value! Select value between 1 - %d!\n", limitAccel);
-        return;
-    }
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, accel, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        //double set = double(accel) * 214.577;
-        double set = convertValtoAcc(accel);
-        printf("Profile acceleration set to %.3f rev/min2\n", set);
-        profileAccel = accel;
-    }
-}
-
-void DXLServo::setProfileAcceleration(double accel) {			// Sets Acceleration value for move while servo torque is enabled. Input: accel: acceleration (rpm2)
-    bool success = true;
-    int address;
-    //double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_PROFILE_ACCELERATION;
-        //mult = 214.577;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        //// Can edit to use Goal Var if Pro servo used to distinguish between speed control and Positioning Move Profile.
-        //printf("Error! Profile Variable only for MX servos!\nUse Goal Acceleration for Pro servo!\n");
-        //return;
-        address = ADDR_PRO_GOAL_ACCELERATION;
-        //mult = 201.039;
-    }
-    // Assumes Acceleration limit has been set/read in code before
-    double limit = convertValtoAcc(limitAccel);
-
-    if (accel == 0) {
-        printf("Error! Value of 0 will give infinite acceleration! Disallowed for safe operation!\n");
-        return;
-    }
-    else if (accel > limit || accel < 0) {
-        printf("Error! Invalid value! Select value between 1 - %f!\n", limit);
-        return;
-    }
-
-    // Convert to integer for transmission
-    int pass = convertAcctoVal(accel);
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, accel, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Profile acceleration set to %.3f rev/min2\n", accel);
-        profileAccel = pass;
-    }
-}
-
-int DXLServo::checkProfileAcceleration() {				// Read value of Profile Acceleration register, returns direct integer value. Conversion available.
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_PROFILE_ACCELERATION;
-    else if (servoType == DXL_PRO_M42) {
-        //printf("Error! Profile Variable only for MX servos!\nUse Goal Acceleration for Pro servo!\n");
-        //return -1;
-        address = ADDR_PRO_GOAL_ACCELERATION;
-    }
-    printf("Reading Profile Acceleration\n");
-    int accel = -1;
-    dxl_comm_result = this->pktHandler->read4ByteTxRx(this->prtHandler, identity, address, (uint32_t*)&accel, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    printf("Profile Acceleration read\n");
-    double trueAccel = convertValtoAcc(accel);
-
-    if (accel < 0) {
-        printf("Error! Value is negative! Unexpected error!\n");
-        return -1;
-    }
-    else return accel;
-}
-
-void DXLServo::setProfileVelocity(int vel) {			// Sets Velocity value for move while servo torque is enabled. Input: vel: direct integer value for transmission
-    bool success = true;
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_PROFILE_VELOCITY;
-    else if (servoType == DXL_PRO_M42) {
-        //printf("Error! Profile Variable only for MX servos!\nUse Goal Velocity for Pro servo!\n");
-        //return;
-        address = ADDR_PRO_GOAL_VELOCITY;
-    }
-
-    if (vel == 0) {
-        printf("Warning! Value of 0 will give infinite velocity! Disallowed for safe operation!\n");
-        return;
-    }
-    // Assumes Velocity limit has been set/read in code before
-    else if (vel > limitVel || vel < 0) {
-        printf("Error! Invalid value! Select value between 1 - %d!\n", limitVel);
-        return;
-    }
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, vel, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        double set = convertValtoVel(vel);
-        printf("Profile Velocity set to %.3f rpm\n", set);
-        profileVel = vel;
-    }
-}
-
-void DXLServo::setProfileVelocity(double vel) {			// Sets Velocity value for move while servo torque is enabled. Input: vel: velocity (rpm)
-    bool success = true;
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_PROFILE_VELOCITY;
-    else if (servoType == DXL_PRO_M42) {
-        //printf("Error! Profile Variable only for MX servos!\nUse Goal Velocity for Pro servo!\n");
-        //return;
-        address = ADDR_PRO_GOAL_VELOCITY;
-    }
-
-    double limit = convertValtoVel(limitVel);
-
-    if (vel == 0) {
-        printf("Warning! Value of 0 will give infinite velocity! Disallowed for safe operation!\n");
-        return;
-    }
-    // Assumes Velocity limit has been set/read in code before
-    else if (vel > limit || vel < 0) {
-        printf("Error! Invalid value! Select value between 1 - %d!\n", limitVel);
-        return;
-    }
-
-    int pass = convertVeltoVal(vel);
-
-    dxl_comm_result = this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, pass, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Profile Velocity set to %.3f rpm\n", vel);
-        profileVel = pass;
-    }
-}
-
-int DXLServo::checkProfileVelocity() {				// Reads value of register in servo, returns direct integer value. Conversion available.
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_PROFILE_VELOCITY;
-    else if (servoType == DXL_PRO_M42) {
-        //printf("Error! Profile Variable only for MX servos!\nUse Goal Velocity for Pro servo!\n");
-        //return -1;
-        address = ADDR_PRO_GOAL_VELOCITY;
-    }
-
-    int vel = -1;
-    dxl_comm_result = this->pktHandler->read4ByteTxRx(this->prtHandler, identity, address, (uint32_t*)&vel, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    double trueVel = convertValtoVel(vel);		// convert to rpm, for future use
-
-    if (vel < 0) {
-        printf("Error! Value is negative! Unexpected error!\n");
-        return -1;
-    }
-    else return vel;
-}
-
-int DXLServo::checkPresentTemperature() {			// Checks temperature of servo, issues warnings for close to limit and exceeded limit. ADD: shutdown check if exceed.
-    int addressLim, addressTemp;
-    if (servoType == DXL_MX_64) {
-        addressLim = ADDR_MX_TEMPERATURE_LIMIT;
-        addressTemp = ADDR_MX_PRESENT_TEMPERATURE;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        addressLim = ADDR_PRO_TEMPERATURE_LIMIT;
-        addressTemp = ADDR_PRO_PRESENT_TEMPERATURE;
-    }
-
-    uint8_t *limitTemp = new uint8_t;
-    dxl_comm_result = this->pktHandler->read1ByteTxRx(this->prtHandler, identity, addressLim, limitTemp, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    int limTemp = 0;
-    limTemp = (limTemp << 8) + limitTemp[0];
-
-    if (limTemp < 0) {					// Error in comm function return, unexpected error
-        printf("Error! Value (EEPROM Limit) is negative! Unexpected error!\n");
-        return -1;
-    }
-    else {									// Return value should be 80 with Temp Limit EEPROM value unchanged
-        uint8_t *presTemp = new uint8_t;
-        dxl_comm_result = this->pktHandler->read1ByteTxRx(this->prtHandler, identity, addressTemp, presTemp, &dxl_error);
-        if (dxl_comm_result != COMM_SUCCESS)
-        {
-            printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        }
-        else if (dxl_error != 0)
-        {
-            printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        }
-
-        int valTemp = 0;
-        valTemp = (valTemp << 8) + presTemp[0];
-
-        if (valTemp < 0) {
-            printf("Error! Value (Presnt Temperature) is negative! Unexpected error!\n");
-            return -1;
-        }
-        else if (valTemp >= (0.9 * limTemp) && valTemp < limTemp) {			// If Present Temperature is around 90% of limit or higher but lower than limit
-            printf("Warning! Temperature has reached 90 percent of limit!\n");
-            return 1;
-        }
-        else if (valTemp >= limTemp) {					// If Present Temperature is at or exceeds limit ( 80 - 100 C )
-            printf("Error! Temperature has exceeded limit! Shutdown triggering!\n");
-			//ADD checkShutdown()
-            return 2;
-        }
-    }
-    return 0;
-}
-
-int DXLServo::getPresentTemperature() {				// Reads Present Temperature register, returns integer value, actual temperature value equal (1:1). Warning: For MX servo, temperature sensor on PCB, not motor. Actual motor temperature may be higher than reported.
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_PRESENT_TEMPERATURE;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_PRESENT_TEMPERATURE;
-    printf("Reading Present Temperature\n");
-    uint8_t *presTemp = new uint8_t;
-    dxl_comm_result = this->pktHandler->read1ByteTxRx(this->prtHandler, identity, address, presTemp, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    printf("Present Temperature read\n");
-    int valTemp = 0;
-    valTemp = (valTemp << 8) + presTemp[0];
-
-    if (valTemp < 0 || valTemp > 100) {							// Present Temperature valid range: 0 - 100, outside range -> Error
-        printf("Error! Value is outside valid range! Unexpected error!\n");
-        return -1;
-    }
-    return valTemp;			// Temperature value ~= Actual Temperature, 1:1 relation
-}
-
-int DXLServo::checkPresentCurrent() {
-    int address;
-    if (servoType == DXL_MX_64)  address = ADDR_MX_PRESENT_CURRENT;
-    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_PRESENT_CURRENT;
-
-    if (limitCurrent <= 0) {													// Limit should not be 0 or negative
-        printf("Error! Limit has not been set or unexpected error has occurred!\n");
-        return -1;
-    }
-    else {
-        printf("Reading Present Current\n");
-        uint16_t *presCur = new uint16_t;
-        dxl_comm_result = this->pktHandler->read2ByteTxRx(this->prtHandler, identity, address, presCur, &dxl_error);
-        if (dxl_comm_result != COMM_SUCCESS)
-        {
-            printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        }
-        else if (dxl_error != 0)
-        {
-            printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        }
-
-        printf("Present Current read\n");
-        int current = 0;
-        current = ((current << 16) + presCur[0]) | ((current << 8) + presCur[1]);
-
-        if (current < 0) {
-            printf("Error! Value is negative! Unexpected Error!\n");
-            return -1;
-        }
-        else if (current >= (0.9*limitCurrent) && current < limitCurrent) {
-            printf("Warning! Current is close to limit!\n");
-            return 1;
-        }
-        else if (current >= limitCurrent) {
-            printf("Error! Current has exceeded limit!\n");
-            return 2;
-        }
-    }
-    return 0;
-}
-
-double DXLServo::getPresentCurrent() {
-    bool success = true;
-    int address, limit;
-    //double mult;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_PRESENT_CURRENT;
-        limit = 1941;
-        //mult = 0.00336;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_PRESENT_CURRENT;
-        limit = 32767;
-        //mult = 0.004028;
-    }
-
-    printf("Reading Present Current\n");
-    uint16_t *presCur = new uint16_t;
-    dxl_comm_result = this->pktHandler->read2ByteTxRx(this->prtHandler, identity, address, presCur, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Present Current read\n");
-        int current = 0;
-        current = ((current << 16) + presCur[0]) | ((current << 8) + presCur[1]);
-
-        if (current < 0 || current > limit) {
-            printf("Error! Value is outside valid range! Unexpected Error!\n");
-            return -1;
-        }
-
-        double actCurr = static_cast<double>(current);
-        actCurr = convertValtoCurr(current);
-        //actCurr = actCurr * mult;   // Actual Current in amps
-        return actCurr;
-    }
-    return 0.0; //if problem
-}
-
-int DXLServo::getHomingOffset() {			// Read value of Homing Offset set in servo, returns direct integer value.
-    bool success = true;
-    int address;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_HOMING_OFFSET;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_HOMING_OFFSET;
-    }
-
-    printf("Reading Homing Offset\n");
-    int homingOffset = 0;
-    dxl_comm_result = this->pktHandler->read4ByteTxRx(this->prtHandler, identity, address, (uint32_t*)&homingOffset, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Homing Offset read\n");
-        homeOffset = homingOffset;
-    }
-    return homingOffset;
-}
-
-bool DXLServo::isMoving() {				// Moving check for servo, for use with write position functions to ensure subsequent write does not occur while servo still in motion.
-    int address;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_MOVING;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_MOVING;
-    }
-
-    uint8_t *move = new uint8_t;
-    dxl_comm_result = this->pktHandler->read1ByteTxRx(this->prtHandler, identity, address, move, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    int valMove = 0;
-    valMove = (valMove << 8) + move[0];
-
-    if (valMove > 0)    return true;
-    else    return false;
-}
-
-int DXLServo::convertPostoVal(double angle) {			// Convert position in degrees to integer value for transmission
-    //int factor,
-    int valuePos;
-    if (servoType == DXL_MX_64) {
-        //factor = 4096;
-        valuePos = int( (angle * (4095.0/360.0)) + 0.5);   // 0 - 360 degrees
-    }
-    else if (servoType == DXL_PRO_M42) {
-        //factor = 131593;
-        valuePos = int( (angle * (131593.0/180.0)) +0.5); // -180 - +180 degrees
-    }
-
-    return valuePos;
-}
-
-double DXLServo::convertValtoPos(int position) {		// Convert integer value from transmission to position in degrees
-    double angle;
-    if (servoType == DXL_MX_64) {
-        angle = double(position) * (360.0/4095.0);   // 0 - 4095
-    }
-    else if (servoType == DXL_PRO_M42) {
-        angle = double(position) * (180.0/131593.0); // -131,593 - +131,593
-    }
-
-    return angle;
-}
-
-int DXLServo::convertCurrtoVal(double current) {			// Convert current in amps to integer value for transmission
-    int valueCurr;
-    if (servoType == DXL_MX_64) {
-        valueCurr = int( (current/0.00336) + 0.5);   // 3.36mA units, 0 - 1941
-    }
-    else if (servoType == DXL_PRO_M42) {
-        //valueCurr = int( (current / 0.004028) + 0.5);	 // 4.028mA units, 0 - 32767, should be limited by Torque Limit
-        valueCurr = int( (current / (8250.0/2048.0)) + 0.5);	 // 4.028mA units, 0 - 32767, should be limited by Torque Limit
-    }
-
-    if (valueCurr > limitCurrent) {
-        printf("ERROR! Current limit exceeded!\n");
-        return limitCurrent;
-    }
-    return valueCurr;
-}
-
-double DXLServo::convertValtoCurr(int value) {		// Convert integer value from transmission to current in amps
-    double current;
-    if (servoType == DXL_MX_64) {
-        current = double(value) * 0.00336;   // 3.36mA units, 0 - ~ 4 amps
-    }
-    else if (servoType == DXL_PRO_M42) {
-        //current = double(value) * 0.004028;	 // 4.028mA units, 0 - ~ 2.1 amps
-        current = double(value) * (8250.0/2048.0);	 // 4.028mA units, 0 - ~ 2.1 amps
-    }
-
-    return current;
-}
-
-int DXLServo::convertVeltoVal(double velocity) {			// Convert velocity in rpm to integer value for transmission
-    int valueVel;
-    if (servoType == DXL_MX_64) {
-        valueVel = int((velocity / 0.229) + 0.5);   // 0.229rpm units, 0 - 1023
-    }
-    else if (servoType == DXL_PRO_M42) {
-        valueVel = int((velocity / 0.00389076) + 0.5);	 // 0.00389076rpm units, 0 - 2^32, should be limited by Velocity Limit
-    }
-
-    if (valueVel > limitVel) {
-        printf("ERROR! Velocity limit exceeded!\n");
-        return limitVel;
-    }
-    return valueVel;
-}
-
-double DXLServo::convertValtoVel(int value) {				// Convert integer value from transmission to velocity in rpm
-    double velocity;
-    if (servoType == DXL_MX_64) {
-        velocity = double(value) * 0.229;   // 0.229rpm units
-    }
-    else if (servoType == DXL_PRO_M42) {
-        velocity = double(value) * 0.00389076;	 // 0.00389076rpm units
-    }
-
-    return velocity;
-}
-
-int DXLServo::convertAcctoVal(double accel) {				// Convert acceleration in rpm2 to integer value for transmission
-    int valueAcc;
-    if (servoType == DXL_MX_64) {
-        valueAcc = int((accel / 214.577) + 0.5);   // 214.577rpm2 units, 0 - 32767
-    }
-    else if (servoType == DXL_PRO_M42) {
-        //valueAcc = int((accel / 201.039) + 0.5);	 // 201.039rpm2 units, 0 - 2^32, should be limited by Acceleration Limit
-        valueAcc = int((accel / (58000.0/288.5)) + 0.5);	 // 201.039rpm2 units, 0 - 2^32, should be limited by Acceleration Limit
-    }
-
-    if (valueAcc > limitAccel) {
-        printf("ERROR! Velocity limit exceeded!\n");
-        return limitAccel;
-    }
-    return valueAcc;
-}
-
-double DXLServo::convertValtoAcc(int value) {			// Convert integer value from transmission to acceleration in rpm2
-    double accel;
-    if (servoType == DXL_MX_64) {
-        accel = double(value) * 214.577;   // 214.577rpm2 units
-    }
-    else if (servoType == DXL_PRO_M42) {
-        //accel = double(value) * 201.039;	 // 201.039rpm2 units
-        accel = double(value) * (58000.0/288.5);	 // 201.039rpm2 units
-    }
-
-    return accel;
-}
-
-void DXLServo::servoReboot() {
-    // Try reboot. Only for servos on Protocol 2.0.
-    // Dynamixel LED will flicker while it reboots
-    if (protocolVersion != 2.0) {
-        printf("Reboot only available for Protocol 2.0!\nPower down servo to reboot in Protocol 1.0!\n");
-        return;
-    }
-
-    dxl_comm_result = this->pktHandler->reboot(this->prtHandler, identity, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        this->pktHandler->printTxRxResult(dxl_comm_result);
-    }
-    else if (dxl_error != 0)
-    {
-        this->pktHandler->printRxPacketError(dxl_error);
-    }
-}
-
-void DXLServo::selectExtPortMode(int port, int mode) {			// Inputs: port: 1 - 4, select port number; mode: 0 - 3, select port function: 0 - Analog Input mode, 1 - Output mode, 2 - Pull-up Input mode, 3 - Pull-up Output mode
-    if (servoType == DXL_MX_64) {
-        printf("Error! External Port function not available on MX servos!\n");
-        return;
-    }
-
-    int address;
-    switch (port) {
-    case 1: {
-        address = ADDR_PRO_EXT_PORT_MODE_1;
-        break;
-    }
-    case 2: {
-        address = ADDR_PRO_EXT_PORT_MODE_2;
-        break;
-    }
-    case 3: {
-        address = ADDR_PRO_EXT_PORT_MODE_3;
-        break;
-    }
-    case 4: {
-        address = ADDR_PRO_EXT_PORT_MODE_4;
-        break;
-    }
-    default:
-        printf("Error! Invalid Port number selected! Choose between 1 - 4!\n");
-        return;
-    }
-
-    uint8_t extmode = uint8_t(mode);
-    string function;
-    switch (mode) {
-    case 0: {
-        function = "Analog Input";
-        break;
-    }
-    case 1: {
-        function = "Output";
-        break;
-    }
-    case 2: {
-        function = "Pull-up Input";
-        break;
-    }
-    case 3: {
-        function = "Pull-up Output";
-        break;
-    }
-    default:
-        printf("Error! Invalid Mode number selected! Choose between 0 - 3!\n");
-        return;
-    }
-
-    dxl_comm_result = this->pktHandler->write1ByteTxRx(this->prtHandler, identity, address, extmode, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    cout << "External Port " << port << " set to " << function << " mode." << endl;
-    externalPort[port - 1] = mode;
-}
-
-void DXLServo::setExtPortData(int port, int data) {				// Inputs: port: 1 - 4, select port number; data: 0 or 1, for Output and Pull-up Output Modes only, 0 for 0V, 1 for 3.3V
-    if (servoType == DXL_MX_64) {
-        printf("Error! External Port function not available on MX servos!\n");
-        return;
-    }
-
-    if (externalPort[port] == 0 || externalPort[port] == 3) {
-        printf("Error! External Port is in Input Mode! Read only!\n");
-        return;
-    }
-
-    bool success = true;
-    int address;
-    switch (port) {
-    case 1: {
-        address = ADDR_PRO_EXT_PORT_DATA_1;
-        break;
-    }
-    case 2: {
-        address = ADDR_PRO_EXT_PORT_DATA_2;
-        break;
-    }
-    case 3: {
-        address = ADDR_PRO_EXT_PORT_DATA_3;
-        break;
-    }
-    case 4: {
-        address = ADDR_PRO_EXT_PORT_DATA_4;
-        break;
-    }
-    default:
-        printf("Error! Invalid Port number selected! Choose between 1 - 4!\n");
-        return;
-    }
-
-    dxl_comm_result = this->pktHandler->write2ByteTxRx(this->prtHandler, identity, address, data, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if (success) {
-        printf("Port %i Data set to %i.\n", port, data);
-    }
-}
-
-int DXLServo::readExtPortData(int port) {				// Input: port: External Port select number, 1 - 4
-    if (servoType == DXL_MX_64) {
-        printf("Error! External Port function not available on MX servos!\n");
-        return -1;
-    }
-
-    bool success = true;
-    int address;
-    switch (port) {
-    case 1: {
-        address = ADDR_PRO_EXT_PORT_DATA_1;
-        break;
-    }
-    case 2: {
-        address = ADDR_PRO_EXT_PORT_DATA_2;
-        break;
-    }
-    case 3: {
-        address = ADDR_PRO_EXT_PORT_DATA_3;
-        break;
-    }
-    case 4: {
-        address = ADDR_PRO_EXT_PORT_DATA_4;
-        break;
-    }
-    default:
-        printf("Error! Invalid Port number selected! Choose between 1 - 4!\n");
-        return -1;
-    }
-
-    uint16_t *pass = new uint16_t;
-    dxl_comm_result = this->pktHandler->read2ByteTxRx(this->prtHandler, identity, address, pass, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        success = false;
-    }
-
-    if(success){
-        printf("External Data %i read\n", port);
-        int extData = 0;
-        extData = ((extData << 16) + pass[0]) | ((extData << 8) + pass[1]);
-        return extData;
-    }
-
-    return 0;
-}
-
-void  DXLServo::setLED(int color, int light) {
-    int address, limit;
-    string select;
-    switch (color) {
-    case 0: {
-        address = ADDR_MX_LED;
-        limit = 1;
-        select = "Single";
-        break;
-    }
-    case 1: {
-        address = ADDR_PRO_LED_RED;
-        limit = 255;
-        select = "Red";
-        break;
-    }
-    case 2: {
-        address = ADDR_PRO_LED_GREEN;
-        limit = 255;
-        select = "Green";
-        break;
-    }
-    case 3: {
-        address = ADDR_PRO_LED_BLUE;
-        limit = 255;
-        select = "Blue";
-        break;
-    }
-    default:
-        printf("Error! Invalid Port number selected! Choose between 1 - 4!\n");
-        return;
-    }
-
-    if (light > limit)		light = limit;
-    if (light < 0) {
-        printf("Error! Negative numbers not allowed!\n");
-        return;
-    }
-
-    uint8_t pass = uint8_t(light);
-    dxl_comm_result = this->pktHandler->write1ByteTxRx(this->prtHandler, identity, address, pass, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    cout << select << " LED set to " << light << endl;
-}
-
-void DXLServo::setPositionGain(int gainP, int gainI, int gainD, int gainF1, int gainF2) {			// gainI, gainD, gainF1, gainF2 default to 0, gainP required in code.
-    bool success = true;
-    if (servoType == DXL_PRO_M42) {
-        printf("Setting Position P Gain\n");
-        dxl_comm_result = this->pktHandler->write2ByteTxRx(this->prtHandler, identity, ADDR_PRO_POSITION_P_GAIN, gainP, &dxl_error);
-        if (dxl_comm_result != COMM_SUCCESS)
-        {
-            printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        }
-        else if (dxl_error != 0)
-        {
-            printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-            success = false;
-        }
-
-        if (success) {
-            printf("Position P Gain set to %i\n", gainP);
-        }
-    }
-    else if (servoType == DXL_MX_64) {
-        int address[5] = { ADDR_MX_POSITION_P_GAIN, ADDR_MX_POSITION_I_GAIN, ADDR_MX_POSITION_D_GAIN, ADDR_MX_POSITION_FF1_GAIN, ADDR_MX_POSITION_FF2_GAIN };
-        int gain[5] = { gainP, gainI, gainD, gainF1, gainF2 };
-        //char out[5] = { 'P', 'I', 'D', 'FF1', 'FF2' };
-        char out[5] = { 'P', 'I', 'D', '1', '2' };
-
-        printf("Setting Position Gains for P, I, D, FF1st, FF2nd\n");
-        for (int i = 0; i < 5; i++) {
-            dxl_comm_result = this->pktHandler->write2ByteTxRx(this->prtHandler, identity, address[i], gain[i], &dxl_error);
-            if (dxl_comm_result != COMM_SUCCESS)
-            {
-                printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-            }
-            else if (dxl_error != 0)
-            {
-                printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-                success = false;
-            }
-
-            if (success) {
-                printf("Position %c Gain set to %i\n", out[i], gain[i]);
-            }
-        }
-    }
-    else {
-        printf("Error! Servo type undefined!\n");
-    }
-}
-
-void DXLServo::readPositionGain(vector<int> &setGains) {			// Input: setGains: vector of ints for the gain values read. MX will return vector of 5 ints, Pro will return vector of single int. Change to overload, if int return int, if vector return vector?
-    bool success = true;
-    //uint16_t *presGain = new uint16_t;
-    if (servoType == DXL_PRO_M42) {			// Only 1 gain value, read and store into vector once
-        printf("Setting Position P Gain\n");
-        uint16_t *presGain = new uint16_t;
-        dxl_comm_result = this->pktHandler->read2ByteTxRx(this->prtHandler, identity, ADDR_PRO_POSITION_P_GAIN, presGain, &dxl_error);
-        if (dxl_comm_result != COMM_SUCCESS)
-        {
-            printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-        }
-        else if (dxl_error != 0)
-        {
-            printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-        }
-
-        printf("Present Current read\n");
-        int gainP = 0;
-        gainP = ((gainP << 16) + presGain[0]) | ((gainP << 8) + presGain[1]);
-
-        if (success) {
-            printf("Position P Gain set to %i\n", gainP);
-            setGains.push_back(gainP);
-        }
-    }
-    else if (servoType == DXL_MX_64) {			// 5 gain values to read and store into vector
-        int address[5] = { ADDR_MX_POSITION_P_GAIN, ADDR_MX_POSITION_I_GAIN, ADDR_MX_POSITION_D_GAIN, ADDR_MX_POSITION_FF1_GAIN, ADDR_MX_POSITION_FF2_GAIN };
-        //int gain[5] = { 0, 0, 0, 0, 0 };
-        //char out[5] = { 'P', 'I', 'D', 'FF1', 'FF2' };
-        char out[5] = { 'P', 'I', 'D', '1', '2' };
-
-        printf("Setting Position Gains for P, I, D, FF1st, FF2nd\n");
-        for (int i = 0; i < 5; i++) {
-            uint16_t *presGain = new uint16_t;
-            dxl_comm_result = this->pktHandler->read2ByteTxRx(this->prtHandler, identity, address[i], presGain, &dxl_error);
-            if (dxl_comm_result != COMM_SUCCESS)
-            {
-                printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-            }
-            else if (dxl_error != 0)
-            {
-                printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-            }
-
-            //printf("Present Current read\n");
-            int gain = 0;
-            gain = ((gain << 16) + presGain[0]) | ((gain << 8) + presGain[1]);
-
-            if (success) {
-                printf("Position %c Gain set to %i\n", out[i], gain);
-                setGains.push_back(gain);
-            }
-            //presGain = 0;		// reset uint for next loop
-        }
-    }
-    else {
-        printf("Error! Servo type undefined!\n");
-    }
-}
-
-int DXLServo::checkShutdown(int statusBits) {
-    int address;
-    bool hardErr = false;
-    if (servoType == DXL_MX_64) {
-        address = ADDR_MX_HARDWARE_ERROR_STATUS;
-    }
-    else if (servoType == DXL_PRO_M42) {
-        address = ADDR_PRO_HARDWARE_ERROR_STATUS;
-    }
-
-    uint8_t *status = new uint8_t;
-    dxl_comm_result = this->pktHandler->read1ByteTxRx(this->prtHandler, identity, address, status, &dxl_error);
-    if (dxl_comm_result != COMM_SUCCESS)
-    {
-        printf("%s\n", this->pktHandler->getTxRxResult(dxl_comm_result));
-    }
-    else if (dxl_error != 0)
-    {
-        printf("%s\n", this->pktHandler->getRxPacketError(dxl_error));
-    }
-
-    int valStatus = 0;
-    valStatus = (valStatus << 8) + status[0];
-    statusBits = valStatus;
-
-    if (valStatus > 0) {
-        printf("Hardware Error detected! Servo in Shutdown! Checking error...\n");
-        hardErr = true;
-    }
-    else {
-        printf("No error detetcted, continue.\n");
-        return 0;
-    }
-
-    //unsigned int statusBits = (unsigned int)status;
-    if (hardErr) {
-        if ( ( valStatus & 0x04) == 1 ) {		// bit 2 set means Overheating Error. Typical procedure is to power off and let cool. However, forums describe MX servos temperature sensor to be on pcb instead of motor so by the time the error is detected, motor is likely to have burnt out.
-            printf("Overheating Error Detected! Do NOT reboot servo!\nDisconnect power from servo and leave for at least half hour!\n");
-            if(servoType == DXL_MX_64)	printf("MX Overheat Error may mean that motor has burnt out. Replacement may be necessary.\n");
-            // TOADD: disable servoReboot() command for half hour. Just put thread to sleep for 30 mins?
-            return -1;
-        }
-        else {		// If not Overheat Error, can try reboot. TOADD: Identify individual errors and suggest remedies.
-            servoReboot();
-            return 1;
-        }
-    }
-    return 0;
-}
-
-////////////////////////////////////////////////////   End of DXLServo class   /////////////////////////////////////////////////////////////////////////////////////////////
-
-/*
-////////////////////
-//		29 Mar 2018 changes not yet implemented in example.
-//      21 May: Linux test
-//      7 June: MX and Pro functionality. Pro functions untested (awaiting Pro servo).
-////////////////////
-
-////////////////////////////////////////////////////    Example Code Using DXLServo functions    ///////////////////////////////////////////////////////////////////////////
-int main() {
-    // Initialize Servo objects and parameters
-
-    DXLServo panServo;								// DXLServo object 1
-    if (panServo.getDXLID() != 1) {				// Ensure Pan set to ID 1
-        panServo.setDXLID(1);
-    }
-    panServo.setDeviceName(0);						// USB port ttyUSB0
-    panServo.setDXLServo(0);                        // MX-64 servo in use
-
-    DXLServo tiltServo;								// DXLServo object 2
-    if (tiltServo.getDXLID() != 2) {				// Ensure Tilt set to ID 2
-        tiltServo.setDXLID(2);
-    }
-    tiltServo.setDeviceName(0);						// USB port ttyUSB0
-    tiltServo.setDXLServo(0);                        // MX-64 servo in use
-
-    // Open USB Port in Linux. ADD: Windows version if necessary
-    int fd = 0;
-    fd = open(panServo.deviceName.c_str(), O_CREAT | O_RDWR | O_NOCTTY | O_NDELAY);
-    //fd = open(panServo.deviceName.c_str(), O_RDWR | O_NOCTTY);
-    if (fd == -1)    cout << "unable to open USB" << endl;
-    else    cout << "USB Port Opened" << endl;
-
-    //initialize Port and Packet handlers, open port, set baudrate
-    panServo.initPortHandler();
-    panServo.initPacketHandler();
-    panServo.openPort();
-    panServo.setPortBaudRate();
-
-    // TOCHANGE: Merge all port and packet handler calls into one class as only one instance needed per U2D2, not per servo.
-    tiltServo.initPortHandler();
-    tiltServo.initPacketHandler();
-    tiltServo.openPort();
-    tiltServo.setPortBaudRate();
-
-    cout << "Ports Opened" << endl;
-
-
-    //EEPROM Write, do before enabling Torque
-    tiltServo.setOperatingMode(2);  //Set operating mode to Position Mode, internal = 3
-    tiltServo.setMaxCurrentLimit();  //Set Current Limit to internally defined max limit for each servo type; 4A for MX, 2.1A for Pro M42
-    tiltServo.set80rpmVelLimit();   // Set velocity limit to 80 rpm via internal defined value
-    int velLimit = tiltServo.getVelocityLimit();
-    cout << "Velocity Limit: " << velLimit << " rpm." << endl;
-    tiltServo.setVelocityLimit(80.0);   // Set velocity limit to 80 rpm using double conversion function
-    velLimit = tiltServo.getVelocityLimit();
-    cout << "Velocity Limit: " << velLimit << " rpm." << endl;
-    tiltServo.setlowAccelLimit();   // Set accel limit to internally defined value
-    int accLimit = tiltServo.getAccelLimit();
-    cout << "Accel Limit: " << accLimit << " rev/min2." << endl;
-    tiltServo.setAccelLimit(6400.0);    // Set accel limit to 6400 rpm2 via double conversion
-    accLimit = tiltServo.getAccelLimit();
-    cout << "Accel Limit: " << accLimit << " rev/min2." << endl;
-    //tiltServo.setCurrentLimit(3.5);    //Set current limit to 3.5A, val = 1042
-    //tiltServo.setCurrentLimit(1200);    //Set current Limit to val = 1200, 4.032A
-
-
-    // Enable Torque outputs
-    panServo.enableTorque();
-    tiltServo.enableTorque();
-    cout << "Torque Enabled" << endl;
-
-    //int pan = 0, tilt = 0;
-    int currentPanPos = 0, currentTiltPos = 0, currentPanTemp = 0, currentTiltTemp = 0, homePanOffset = 0, homeTiltOffset = 0;
-    double currentPanI = 0, currentTiltI = 0;
-    int cycle = 3;
-
-    while (cycle > 0) {
-        //printf("Press any key to continue! (or press ESC to quit!)\n");
-        //if (getch() == ESC_ASCII_VALUE) break;
-
-        // std::cout << "Hello.\nPress enter to continue." << std::endl;
-        //std::cin.get();
-        //sleep(2);
-        crossSleep(1);		// Linux, sleep 1s
-
-        // Read current Pan position and offset
-        currentPanPos = panServo.readCurrentPosition();
-        homePanOffset = panServo.getHomingOffset();
-        cout << "Pan Offset: " << homePanOffset << "." << endl;
-        double anglePan = double(currentPanPos + homePanOffset) * 0.088;
-        //double anglePan = ( (double)currentPanPos * 0.088 ) - 180 - (homePanOffset * 0.088);
-        cout << "Pan Position: " << anglePan << " degrees." << endl;
-        double angleP = panServo.readCurrentAngle();
-        cout << "Pan Angle = " << angleP << " degrees" << endl;
-
-        // Read current Tilt position and offset
-        currentTiltPos = tiltServo.readCurrentPosition();
-        homeTiltOffset = tiltServo.getHomingOffset();
-        cout << "Tilt Offset: " << homeTiltOffset << "." << endl;
-        cout << "Tilt Pos Val: " << currentTiltPos << "." << endl;
-        double angleTilt = double(currentTiltPos + homeTiltOffset) * 0.088;
-        //double angleTilt = ( (double)currentTiltPos * 0.088 ) - 180 - (homeTiltOffset * 0.088);
-        cout << "Tilt Position: " << angleTilt << " degrees." << endl;
-        double angleT = tiltServo.readCurrentAngle();
-        cout << "Tilt Angle = " << angleT << " degrees" << endl;
-
-        // Read present temperature of servo
-        currentPanTemp = panServo.getPresentTemperature();
-        cout << "Pan Temp: " << currentPanTemp << "C." << endl;
-        currentTiltTemp = tiltServo.getPresentTemperature();
-        cout << "Tilt Temp: " << currentTiltTemp << "C." << endl;
-
-        // Read present current through servo. Undefined before 1st move
-        currentPanI = panServo.getPresentCurrent();
-        cout << "Pan Current: " << std::fixed << std::setprecision(2) << currentPanI << "A." << endl;
-        currentTiltI = tiltServo.getPresentCurrent();
-        cout << "Tilt Current: " << std::fixed << std::setprecision(2) << currentTiltI << "A." << endl;
-
-        // Set Profile Acceleration and Velocity then read their respective registers
-        tiltServo.setProfileAcceleration(5);
-        int profileAccel = tiltServo.checkProfileAcceleration();
-        cout << "Profile Acc Val: " << profileAccel << " ." << endl;
-        tiltServo.setProfileVelocity(10);
-        int profileVel = tiltServo.checkProfileVelocity();
-        cout << "Profile Vel Val: " << profileVel << " ." << endl;
-
-        // Read the internal gains of the servo
-        vector<int> gains;
-        gains.clear();
-        tiltServo.readPositionGain(gains);
-        cout << "Position Gains are: P = " << gains[0] << ", I = " << gains[1] << ", D = " << gains[2] << ", FF1 = " << gains[3] << ", FF2 = " << gains[4] << "." << endl;;
-        gains.clear();
-
-        // GoalPosition function test
-        tiltServo.writeGoalPosition(1);
-        std::vector<int> tiltGoals;
-        tiltGoals.clear();
-//        tiltGoals.push_back(1830);
-//        tiltGoals.push_back(1900);
-//        tiltGoals.push_back(1700);
-        int start = 1603;
-        for(int i = 0; i < 10; i++){
-            tiltGoals.push_back(start);
-            start += 45;
-        }
-        tiltServo.addToGoalPosVector(tiltGoals);
-        int checkGPV = tiltServo.checkGoalPosVector();
-//        tiltServo.writeGoalPosition(1);
-//        //sleep(2);
-//        crossSleep(1);		// Linux, sleep 1s
-//        angleT = tiltServo.readCurrentAngle();
-//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
-//        tiltServo.writeGoalPosition(1, 2000);
-//        //sleep(2);
-//        crossSleep(1);		// Linux, sleep 1s
-//        angleT = tiltServo.readCurrentAngle();
-//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
-//        tiltServo.writeGoalPosition(0, 2);
-//        //sleep(2);
-//        crossSleep(1);		// Linux, sleep 1s
-//        angleT = tiltServo.readCurrentAngle();
-//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
-        for(int x = 0; x < 10; x++){
-            tiltServo.writeGoalPosition(x);
-            crossSleep(1);		// Linux, sleep 1s
-            angleT = tiltServo.readCurrentAngle();
-            cout << "Tilt Angle = " << angleT << " degrees" << endl;
-        }
-
-        tiltGoals.clear();
-        tiltServo.resetGoalPosVector();
-
-        //GoalAngle function test
-        vector<double> goalAngles;
-        goalAngles.clear();
-//        goalAngles.push_back(0.0);
-//        goalAngles.push_back(6.15);
-//        goalAngles.push_back(-11.43);
-        double start1 = -20.0;
-        for(int i = 0; i < 10; i++){
-            goalAngles.push_back(start1);
-            start1 += 4.0;
-        }
-        tiltServo.addToGoalAngleVect(goalAngles);
-        int checkGAV = tiltServo.checkGoalAngleVect();
-//        tiltServo.writeGoalAngle(1);
-//        crossSleep(1);
-//        angleT = tiltServo.readCurrentAngle();
-//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
-//        tiltServo.writeGoalAngle(1, 14.95);
-//        crossSleep(1);
-//        angleT = tiltServo.readCurrentAngle();
-//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
-//        tiltServo.writeGoalAngle(0, 2);
-//        crossSleep(1);
-//        angleT = tiltServo.readCurrentAngle();
-//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
-        for(int x = 0; x < 10; x++){
-            tiltServo.writeGoalAngle(x);
-            crossSleep(1);		// Linux, sleep 1s
-            angleT = tiltServo.readCurrentAngle();
-            cout << "Tilt Angle = " << angleT << " degrees" << endl;
-        }
-
-        goalAngles.clear();
-        tiltServo.resetGoalAngleVect();
-
-        cycle -= 1;
-        cout << "Next Cycle" << endl << endl;
-    }
-
-    // Close DXLServo
-
-    // Clear internal position vectors
-    panServo.resetGoalPosVector();
-    tiltServo.resetGoalPosVector();
-
-    // Disable DXLs Torque outputs
-    panServo.disableTorque();
-    tiltServo.disableTorque();
-    cout << "Torque Disabled" << endl;
-
-    // Close Comms port
-    panServo.closePort();
-    tiltServo.closePort();
-    close(fd);
-    cout << "Ports Closed" << endl;
-
-    return 0;
-}
-// End of C++ Example Code using DXLServo functions
-*/
-
-// C Style code of SDK functions
-/*int main()
-{
-// Initialize PortHandler instance
-// Set the port path
-// Get methods and members of PortHandlerLinux or PortHandlerWindows
-dynamixel::PortHandler *portHandler1 = dynamixel::PortHandler::getPortHandler(DEVICENAME1);
-dynamixel::PortHandler *portHandler2 = dynamixel::PortHandler::getPortHandler(DEVICENAME2);
-
-// Initialize PacketHandler instance
-// Set the protocol version
-// Get methods and members of Protocol1PacketHandler or Protocol2PacketHandler
-dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(PROTOCOL_VERSION);
-
-int index1 = 0, index2 = 0;
-int dxl_comm_result = COMM_TX_FAIL;             // Communication result
-
-
-//CHANGE THIS WHEN TESTING ON QUICABOT!
-//int dxl_goal_position[2] = { DXL_MINIMUM_POSITION_VALUE, DXL_MAXIMUM_POSITION_VALUE };         // Goal position
-int dxl1_goal_position[5] = { 1024, 1536, 2048, 2560, 3072 };         // Goal position for Pan
-int dxl2_goal_position[6] = { 1536, 1875, 2216, 2560, 2898, 3072 };         // Goal position for Tilt
-//CHANGE THIS WHEN TESTING ON QUICABOT!
-
-uint8_t dxl_error = 0;                          // Dynamixel error
-int32_t dxl1_present_position = 0;               // Present position: Pan
-int32_t dxl2_present_position = 0;               // Present position: Tilt
-int32_t dxl1_present_current = 0;               // Present current: Pan
-int32_t dxl2_present_current = 0;               // Present current: Tilt
-int32_t dxl1_present_temperature = 0;               // Present temperature: Pan
-int32_t dxl2_present_temperature = 0;               // Present temperature: Tilt
-
-
-// Open port 1
-if (portHandler1->openPort())
-{
-printf("Succeeded to open the port!\n");
-}
-else
-{
-printf("Failed to open the port!\n");
-printf("Press any key to terminate...\n");
-_getch();
-return 0;
-}
-// Open port 2
-if (portHandler2->openPort())
-{
-printf("Succeeded to open the port!\n");
-}
-else
-{
-printf("Failed to open the port!\n");
-printf("Press any key to terminate...\n");
-_getch();
-return 0;
-}
-
-// Set port baudrate for motor 1
-if (portHandler1->setBaudRate(BAUDRATE))
-{
-printf("Succeeded to change the baudrate!\n");
-}
-else
-{
-printf("Failed to change the baudrate!\n");
-printf("Press any key to terminate...\n");
-_getch();
-return 0;
-}
-// Set port baudrate for motor 2
-if (portHandler2->setBaudRate(BAUDRATE))
-{
-printf("Succeeded to change the baudrate!\n");
-}
-else
-{
-printf("Failed to change the baudrate!\n");
-printf("Press any key to terminate...\n");
-_getch();
-return 0;
-}
-
-// Enable Dynamixel Torque for DXL 1
-dxl_comm_result = packetHandler->write1ByteTxRx(portHandler1, DXL_ID1, ADDR_MX_TORQUE_ENABLE, TORQUE_ENABLE, &dxl_error);
-if (dxl_comm_result != COMM_SUCCESS)
-{
-// printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-}
-else if (dxl_error != 0)
-{
-// printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-}
-else
-{
-printf("Dynamixel#%d has been successfully connected \n", DXL_ID1);
-}
-// Enable Dynamixel Torque for DXL 2
-dxl_comm_result = packetHandler->write1ByteTxRx(portHandler2, DXL_ID2, ADDR_MX_TORQUE_ENABLE, TORQUE_ENABLE, &dxl_error);
-if (dxl_comm_result != COMM_SUCCESS)
-{
-// printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-}
-else if (dxl_error != 0)
-{
-// printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-}
-else
-{
-printf("Dynamixel#%d has been successfully connected \n", DXL_ID2);
-}
-
-while (1)
-{
-printf("Press any key to continue! (or press ESC to quit!)\n");
-if (_getch() == ESC_ASCII_VALUE)
-break;
-
-// Write goal position to DXL1
-dxl_comm_result = packetHandler->write4ByteTxRx(portHandler1, DXL_ID1, ADDR_MX_GOAL_POSITION, dxl1_goal_position[index1], &dxl_error);
-if (dxl_comm_result != COMM_SUCCESS)
-{
-printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-}
-else if (dxl_error != 0)
-{
-printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-}
-// Write goal position to DXL2
-dxl_comm_result = packetHandler->write4ByteTxRx(portHandler2, DXL_ID2, ADDR_MX_GOAL_POSITION, dxl2_goal_position[index2], &dxl_error);
-if (dxl_comm_result != COMM_SUCCESS)
-{
-printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-}
-else if (dxl_error != 0)
-{
-printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-}
-
-do
-{
-// Read present position of DXL1
-dxl_comm_result = packetHandler->read4ByteTxRx(portHandler1, DXL_ID1, ADDR_MX_PRESENT_POSITION, (uint32_t*)&dxl1_present_position, &dxl_error);
-if (dxl_comm_result != COMM_SUCCESS)
-{
-printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-}
-else if (dxl_error != 0)
-{
-printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-}
-// Read present position of DXL2
-dxl_comm_result = packetHandler->read4ByteTxRx(portHandler2, DXL_ID2, ADDR_MX_PRESENT_POSITION, (uint32_t*)&dxl2_present_position, &dxl_error);
-if (dxl_comm_result != COMM_SUCCESS)
-{
-printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-}
-else if (dxl_error != 0)
-{
-printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-}
-
-printf("[ID:%03d] GoalPos:%03d  PresPos:%03d\t[ID:%03d] GoalPos:%03d  PresPos:%03d\n", DXL_ID1, dxl1_goal_position[index1], dxl1_present_position, DXL_ID2, dxl2_goal_position[index2], dxl2_present_position);
-
-} while ((abs(dxl1_goal_position[index1] - dxl1_present_position) > DXL_MX_MOVING_STATUS_THRESHOLD) || (abs(dxl2_goal_position[index2] - dxl2_present_position) > DXL_MX_MOVING_STATUS_THRESHOLD));
-
-// Change goal position: Pan
-if ( index1 >= 0 && index1 < ( sizeof dxl1_goal_position / sizeof *dxl1_goal_position ) )
-{
-index1 += 1;
-}
-else
-{
-index1 = 0;
-}
-// Change goal position: Tilt
-if ( index2 >= 0 && index2 < (sizeof dxl2_goal_position / sizeof *dxl2_goal_position))
-{
-index2 += 1;
-}
-else
-{
-index2 = 0;
-}
-}
-
-// Disable Dynamixel Torqueof DXL1
-dxl_comm_result = packetHandler->write1ByteTxRx(portHandler1, DXL_ID1, ADDR_MX_TORQUE_ENABLE, TORQUE_DISABLE, &dxl_error);
-if (dxl_comm_result != COMM_SUCCESS)
-{
-printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-}
-else if (dxl_error != 0)
-{
-printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-}
-// Disable Dynamixel Torqueof DXL2
-dxl_comm_result = packetHandler->write1ByteTxRx(portHandler2, DXL_ID2, ADDR_MX_TORQUE_ENABLE, TORQUE_DISABLE, &dxl_error);
-if (dxl_comm_result != COMM_SUCCESS)
-{
-printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
-}
-else if (dxl_error != 0)
-{
-printf("%s\n", packetHandler->getRxPacketError(dxl_error));
-}
-
-// Close port DXL1
-portHandler1->closePort();
-// Close port DXL2
-portHandler2->closePort();
-
-return 0;
-}
-// End of C style code
-*/
-
+
+using namespace std;
+
+/*******************************************************************************
+* Copyright 2017 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/*///////////////////////////////////////////////////////////////////////////////
+Created by: Sayyed Omar Kamal
+Date: 8 June 2018
+
+For Dynamixel MX-64 and Pro M42 servos specifically. Control tables for MX and Pro servos in header file. Code allows use of either servo by setting servoType variable when creating DXLServo object.
+Most Register addresses added as required by project. Unused ones may be added in future. 
+Most basic functionalities added; 
+- Position control via direct integer value or angle. 
+- Velocity and Acceleration changes via direct integer or velocity/acceleration. 
+- Current or Torque (depending on servo type) changes via direct integer or current. 
+- Read/Write of most used Parameters (Position, Velocity, Acceleration, Current/Torque, Present values, Limits, Gains, internal states, etc). 
+- Conversion between high level (angle, velocity, acceleration) and low level integers
+
+Code built in Linux Ubuntu environment. Cross platform functionality not fully implemented yet. Focus on Ubuntu for now.
+
+Requires Dynamixel SDK:
+https://github.com/ROBOTIS-GIT/DynamixelSDK
+eManual for environment Setup
+http://emanual.robotis.com/docs/en/software/dynamixel/dynamixel_sdk/overview/
+
+///////////////////////////////////////////////////////////////////////////////*/
+
+#include "DXLProServo.h"
+#include "DXLMotionProfile.h"
+#include "DXLWriteBatch.h"
+#include "DXLTrajectoryValidator.h"
+
+#include <chrono>
+#include <thread>
+
+/*
+// If getch() needed. getch call for Windows is _getch(), for non-Windows, need to use below code
+int getch(void)
+{
+//#if defined(__linux__) || defined(__APPLE__)
+    struct termios oldt, newt;
+    int ch;
+    tcgetattr(STDIN_FILENO, &oldt);
+    newt = oldt;
+    newt.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
+    ch = getchar();
+    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
+    return ch;
+//#elif defined(_WIN32) || defined(_WIN64)
+//    return _getch();
+//#endif
+}
+*/
+
+// if kbhit() needed
+/*
+int kbhit(void)
+{
+#if defined(__linux__) || defined(__APPLE__)
+    struct termios oldt, newt;
+    int ch;
+    int oldf;
+
+    tcgetattr(STDIN_FILENO, &oldt);
+    newt = oldt;
+    newt.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
+    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
+    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
+
+    ch = getchar();
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
+    fcntl(STDIN_FILENO, F_SETFL, oldf);
+
+    if (ch != EOF)
+    {
+        ungetc(ch, stdin);
+        return 1;
+    }
+
+    return 0;
+#elif defined(_WIN32) || defined(_WIN64)
+    return _kbhit();
+#endif
+}
+*/
+
+void crossSleep(int time) {			// Cross platform sleep() func. Linux/Unix: time in seconds. Windows: time in milliseconds. May be busy sleep. Change to non-busy sleep.
+#if defined(__linux__) || defined(__APPLE__)
+    if (time >= 10) {
+        DXL_LOG_WARN(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Sleeping for more than 10 seconds. System will not respond in that time. Are you sure?");
+    }
+    sleep(time);		// Change to ms sleep later
+#elif defined(_WIN32) || defined(_WIN64)
+    _sleep(time);
+#endif
+}
+
+////////////////////////////////////////////////////   DXLServo class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLServo::DXLServo() {							// Constructor
+    identity = 1;								// default ID 1
+    protocolVersion = 2.0;						// default Protocol 2.0
+    baudRate = 57600;							// default 57,600 baud
+
+    goalPositionVector.clear();					// Initialize empty vectors at start
+	goalAngleVector.clear();
+    goalSource = 0, goalSourceCount = 0, goalSourceMin = 0, goalSourceMax = 0;
+    present_position = 0, present_current = 0.0, present_temperature = 25;				// Basic starting values, change with read later
+    limitAccel = 1, limitVel = 1, limitCurrent = 0, limitPosMin = 0, limitPosMax = 4095, homeOffset = 0;
+    limitAccelKnown = false, limitVelKnown = false;
+    profileAccel = 1, profileVel = 1;
+    profileKnown = false, settleMarginSec = DXL_MOVE_SETTLE_INITIAL_SEC, lastMoveChecks = 0;
+
+    for (int i = 0; i < 4; i++) {			// Initialize all External Port Modes to 0;
+        externalPort[i] = 0;
+    }
+
+
+    dxl_comm_result = COMM_TX_FAIL;				// Initial comm result
+    dxl_error = 0;								// Dynamixel error
+
+    retryPolicy[DXL_OP_TELEMETRY] = DXLRetryPolicy(2, 0, 2.0, 30.0);       // Stale telemetry is worse than a skipped sample, retry once quickly
+    retryPolicy[DXL_OP_CONTROL] = DXLRetryPolicy(2, 0, 2.0, 30.0);
+    retryPolicy[DXL_OP_CONFIG] = DXLRetryPolicy(3, 1000, 5.0, 100.0);      // EEPROM writes are slow and rare, be patient
+    timeoutPort = 0;
+    portBackend = DXL_PORT_SDK;
+    packetBackend = DXL_PACKET_SDK;
+    busScheduler = 0;
+    lastAttempts = 0;
+
+    DXLServoState initial = DXLServoState();
+    initial.tick = -1;
+    stateSlot.write(initial);
+    estimatorEnabled = false;
+    readTiming = false;
+}
+
+DXLServo::~DXLServo() {							// Destructor
+
+}
+
+// Packet call wrappers. Disabled stats/trace and no learned timeout cost two relaxed loads and no clock reads per attempt.
+void DXLServo::recordTxRx(uint8_t instruction, uint16_t address, uint16_t length, uint64_t startUs, uint64_t endUs, int result, uint8_t error) {
+    DXLBusStats &stats = DXLBusStats::instance();
+    if (stats.isEnabled()) {
+        stats.record(identity, instruction, address, uint32_t(endUs - startUs), result, error);
+    }
+    DXLTrace &trace = DXLTrace::instance();
+    if (trace.isEnabled()) {
+        DXLTraceEvent event;
+        event.startUs = startUs;
+        event.endUs = endUs;
+        event.bus = DXLTimeoutPort::underlying(this->prtHandler);     // Same track whether or not the servo learns timeouts
+        event.result = result;
+        event.address = address;
+        event.length = length;
+        event.id = uint8_t(identity);
+        event.instruction = instruction;
+        event.error = error;
+        trace.record(event, deviceName.c_str());
+    }
+}
+
+DXLOpClass DXLServo::opClassFor(uint16_t address) {            // Register ranges from control tables in header
+    if (servoType == DXL_PRO_M42) {
+        if (address == ADDR_PRO_HARDWARE_ERROR_STATUS)  return DXL_OP_TELEMETRY;
+        if (address < ADDR_PRO_TORQUE_ENABLE)   return DXL_OP_CONFIG;       // EEPROM
+        if (address < ADDR_PRO_MOVING)          return DXL_OP_CONTROL;      // Torque enable - Goal Acceleration
+        return DXL_OP_TELEMETRY;
+    }
+    if (address == ADDR_MX_HARDWARE_ERROR_STATUS)   return DXL_OP_TELEMETRY;
+    if (address < ADDR_MX_TORQUE_ENABLE)    return DXL_OP_CONFIG;           // EEPROM
+    if (address < ADDR_MX_REALTIME_TICK)    return DXL_OP_CONTROL;          // Torque enable - Goal Position
+    return DXL_OP_TELEMETRY;
+}
+
+int DXLServo::txRxOnce(uint8_t instruction, uint16_t address, uint16_t length, void *data, uint32_t value, uint8_t &error) {
+    if (instruction == INST_READ) {
+        if (length == 1)        return this->pktHandler->read1ByteTxRx(this->prtHandler, identity, address, static_cast<uint8_t *>(data), &error);
+        else if (length == 2)   return this->pktHandler->read2ByteTxRx(this->prtHandler, identity, address, static_cast<uint16_t *>(data), &error);
+        else if (length == 4)   return this->pktHandler->read4ByteTxRx(this->prtHandler, identity, address, static_cast<uint32_t *>(data), &error);
+        return this->pktHandler->readTxRx(this->prtHandler, identity, address, length, static_cast<uint8_t *>(data), &error);
+    }
+    else if (instruction == INST_WRITE) {
+        if (length == 1 && data == 0)       return this->pktHandler->write1ByteTxRx(this->prtHandler, identity, address, uint8_t(value), &error);
+        else if (length == 2 && data == 0)  return this->pktHandler->write2ByteTxRx(this->prtHandler, identity, address, uint16_t(value), &error);
+        else if (length == 4 && data == 0)  return this->pktHandler->write4ByteTxRx(this->prtHandler, identity, address, value, &error);
+        return this->pktHandler->writeTxRx(this->prtHandler, identity, address, length, static_cast<uint8_t *>(data), &error);
+    }
+    return this->pktHandler->reboot(this->prtHandler, identity, &error);
+}
+
+int DXLServo::busPriorityFor(uint8_t instruction, uint16_t address) {
+    if (instruction == INST_REBOOT)     return DXL_PRIO_CONFIG;
+    switch (opClassFor(address)) {
+    case DXL_OP_TELEMETRY:  return DXL_PRIO_TELEMETRY;
+    case DXL_OP_CONTROL:    return (instruction == INST_WRITE) ? DXL_PRIO_CONTROL : DXL_PRIO_CONFIG;      // RAM setting read back is diagnostics
+    default:                return DXL_PRIO_CONFIG;
+    }
+}
+
+DXLError DXLServo::runTxRx(uint8_t instruction, uint16_t address, uint16_t length, void *data, uint32_t value, int priority) {
+    if (busScheduler == 0 || busScheduler->onWorkerThread())    return executeTxRx(instruction, address, length, data, value);
+
+    uint32_t estimate = 0;                          // Unknown latency, scheduler uses class average
+    if (rttEstimator.sampleCount() > 0)     estimate = uint32_t(dxlWireTimeUs(baudRate, instruction, length) + rttEstimator.smoothedUs());
+    if (priority < 0)   priority = busPriorityFor(instruction, address);
+    DXLError status;                                // Outcome travels back with the job, other threads' calls to this servo cannot overwrite it
+    busScheduler->runSync(priority, [&]() { status = executeTxRx(instruction, address, length, data, value); return status.comm; }, estimate);
+    return status;
+}
+
+int DXLServo::keepResult(const DXLError &status) {
+    dxl_comm_result = status.comm;
+    dxl_error = status.packetError;
+    lastAttempts = status.attempts;
+    return dxl_comm_result;
+}
+
+void DXLServo::emergencyStop() {                // As disableTorque(), priority passed with the call so other threads' calls keep theirs
+    int address = (servoType == DXL_PRO_M42) ? ADDR_PRO_TORQUE_ENABLE : ADDR_MX_TORQUE_ENABLE;
+    keepResult(runTxRx(INST_WRITE, address, 1, 0, TORQUE_DISABLE, DXL_PRIO_EMERGENCY));
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+}
+
+DXLError DXLServo::executeTxRx(uint8_t instruction, uint16_t address, uint16_t length, void *data, uint32_t value) {
+    const DXLRetryPolicy &policy = retryPolicy[(instruction == INST_REBOOT) ? DXL_OP_CONFIG : opClassFor(address)];
+    int result = COMM_SUCCESS, attempts = 0;
+    uint8_t error = 0;
+
+    if (!breaker.isClosed() && !breaker.allow(DXLBusStats::nowUs()))   return DXLError(DXL_COMM_CIRCUIT_OPEN, 0, uint8_t(identity), address, 0);     // ID marked dead, do not spend a timeout on it
+
+    bool learn = (timeoutPort != 0) && policy.adaptiveTimeout;
+    double wireUs = learn ? dxlWireTimeUs(baudRate, instruction, length) : 0.0;
+    int backoff = policy.backoffUs;
+    for (;;) {
+        attempts++;
+        if (timeoutPort != 0)   timeoutPort->setOverrideTimeout(learn ? rttEstimator.timeoutMs(wireUs, attempts, policy) : 0.0);
+
+        bool timed = learn || busInstrumented();
+        bool stamped = timed || readTiming || estimatorEnabled;       // Reads for clock sync and sample times, goal writes for the estimator
+        uint64_t start = stamped ? DXLBusStats::nowUs() : 0;
+        error = 0;
+        DXLTimeoutPort *wrapper = dynamic_cast<DXLTimeoutPort *>(this->prtHandler);    // Also set on servos that copied a wrapped port
+        bool claim = (wrapper != 0) && dynamic_cast<DXLPacketHandler *>(this->pktHandler) == 0;      // Native codec claims the real port itself
+        if (!claim)     result = txRxOnce(instruction, address, length, data, value, error);
+        else if ((result = wrapper->claimBus()) == COMM_SUCCESS) {
+            result = txRxOnce(instruction, address, length, data, value, error);
+            wrapper->releaseBus();
+        }
+        uint64_t end = stamped ? DXLBusStats::nowUs() : 0;
+        if (timed)  recordTxRx(instruction, address, length, start, end, result, error);
+
+        bool retry;
+        if (result == COMM_SUCCESS) {
+            breaker.onSuccess();
+            if (learn)  rttEstimator.observe(double(end - start) - wireUs);
+            retry = policy.retryCorrupt && (error & 0x7F) == 3;        // Status packet CRC error, instruction may not have been applied
+        }
+        else if (result == COMM_RX_TIMEOUT || result == COMM_RX_FAIL) {
+            breaker.onNoResponse(end != 0 ? end : DXLBusStats::nowUs());
+            retry = !breaker.isOpen();
+        }
+        else if (result == COMM_RX_CORRUPT) {
+            breaker.onSuccess();                        // Something answered, the ID is alive
+            retry = policy.retryCorrupt;
+        }
+        else {
+            breaker.onInconclusive(end != 0 ? end : DXLBusStats::nowUs());
+            retry = (result == COMM_PORT_BUSY || result == COMM_TX_FAIL) && !breaker.isOpen();
+        }
+
+        if (!retry || attempts >= policy.maxAttempts) {
+            if (instruction == INST_READ && result == COMM_SUCCESS && (error & 0x7F) == 0)   publishState(address, length, static_cast<const uint8_t *>(data), start, end);
+            if (instruction == INST_WRITE && result == COMM_SUCCESS && (error & 0x7F) == 0) {
+                double byteUs = (baudRate > 0) ? 10.0e6 / double(baudRate) : 0.0;      // Servo acts on the goal once the instruction is in
+                noteWrite(address, length, static_cast<const uint8_t *>(data), value, start + uint64_t(byteUs * (12 + length)));
+            }
+            return DXLError(result, error, uint8_t(identity), address, attempts);
+        }
+        DXL_LOG_DEBUG(identity, address, result, "Retrying, attempt %d of %d", attempts + 1, policy.maxAttempts);
+        if (backoff > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(backoff));
+            backoff *= 2;
+        }
+    }
+}
+
+struct DXLStateField {
+    uint16_t mxAddress, proAddress;
+    uint8_t length;
+};
+
+static const DXLStateField stateFields[] = {                    // Order matches publishState() switch
+    { ADDR_MX_PRESENT_POSITION, ADDR_PRO_PRESENT_POSITION, 4 },
+    { ADDR_MX_PRESENT_VELOCITY, ADDR_PRO_PRESENT_VELOCITY, 4 },
+    { ADDR_MX_PRESENT_CURRENT, ADDR_PRO_PRESENT_CURRENT, 2 },
+    { ADDR_MX_PRESENT_TEMPERATURE, ADDR_PRO_PRESENT_TEMPERATURE, 1 },
+    { ADDR_MX_MOVING, ADDR_PRO_MOVING, 1 },
+    { ADDR_MX_HARDWARE_ERROR_STATUS, ADDR_PRO_HARDWARE_ERROR_STATUS, 1 },
+};
+
+void DXLServo::publishState(uint16_t address, uint16_t length, const uint8_t *data, uint64_t txUs, uint64_t rxUs) {      // Reads of other registers cost two compares per field
+    bool pro = (servoType == DXL_PRO_M42);
+    int covered[6];
+    int count = 0;
+    for (int f = 0; f < 6; f++) {
+        uint16_t field = pro ? stateFields[f].proAddress : stateFields[f].mxAddress;
+        if (field >= address && field + stateFields[f].length <= address + length)    covered[count++] = f;
+    }
+    bool hasTick = !pro && address <= ADDR_MX_REALTIME_TICK && ADDR_MX_REALTIME_TICK + 2 <= address + length;
+    if ((count == 0 && !hasTick) || data == 0)  return;
+
+    uint64_t now = DXLBusStats::nowUs();
+    if (rxUs == 0)                      rxUs = now;
+    if (txUs == 0 || txUs > rxUs)       txUs = rxUs;
+    // Servo sampled after the whole instruction arrived and before its status started: narrow the window by both wire times
+    double byteUs = (baudRate > 0) ? 10.0e6 / double(baudRate) : 0.0;
+    bool v1 = (protocolVersion == 1.0);
+    uint64_t lowUs = txUs + uint64_t(byteUs * (v1 ? 8 : 14));
+    uint64_t statusUs = uint64_t(byteUs * ((v1 ? 6 : 11) + length));
+    uint64_t highUs = (rxUs > statusUs) ? rxUs - statusUs : 0;
+
+    int32_t tick = -1;
+    uint64_t sampleUs;
+    if (hasTick) {
+        const uint8_t *p = data + (ADDR_MX_REALTIME_TICK - address);
+        tick = DXL_MAKEWORD(p[0], p[1]);
+    }
+    if (tick >= 0 && txUs < rxUs) {                   // Unstamped reads (tx = rx) would only widen the offset bounds
+        sampleUs = clockSync.observe(uint16_t(tick), lowUs, highUs, rxUs);
+    }
+    else {
+        sampleUs = clockSync.sampleTimeUs(lowUs, highUs, rxUs);
+    }
+
+    stateSlot.update([&](DXLServoState &state) {
+        for (int i = 0; i < count; i++) {
+            int f = covered[i];
+            const uint8_t *p = data + ((pro ? stateFields[f].proAddress : stateFields[f].mxAddress) - address);
+            switch (f) {
+            case 0: state.position = int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(p[0], p[1]), DXL_MAKEWORD(p[2], p[3]))), state.positionUs = now, state.positionSampleUs = sampleUs; break;
+            case 1: state.velocity = int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(p[0], p[1]), DXL_MAKEWORD(p[2], p[3]))), state.velocityUs = now; break;
+            case 2: state.current = int16_t(DXL_MAKEWORD(p[0], p[1])), state.currentUs = now; break;
+            case 3: state.temperature = p[0], state.temperatureUs = now; break;
+            case 4: state.moving = p[0], state.movingUs = now; break;
+            default: state.hardwareError = p[0], state.hardwareErrorUs = now; break;
+            }
+        }
+        if (tick >= 0)  state.tick = tick;
+        state.txUs = txUs, state.rxUs = rxUs, state.sampleUs = sampleUs;
+        state.timeUs = now;
+        state.updates++;
+    });
+
+    if (!estimatorEnabled)  return;
+    bool updated = false;
+    for (int i = 0; i < count; i++) {
+        if (covered[i] > 1)     continue;
+        const uint8_t *p = data + ((pro ? stateFields[covered[i]].proAddress : stateFields[covered[i]].mxAddress) - address);
+        int32_t raw = int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(p[0], p[1]), DXL_MAKEWORD(p[2], p[3])));
+        if (covered[i] == 0)    estimator.updatePosition(double(raw), sampleUs);
+        else                    estimator.updateVelocity(double(raw) * countsPerSecPerUnit(), sampleUs);    // Position covered first when both are, see stateFields
+        updated = true;
+    }
+    if (updated)    estimatorSlot.write(estimator);
+}
+
+double DXLServo::countsPerSecPerUnit() const {
+    if (servoType == DXL_PRO_M42)   return 0.00389076 * 263187.0 / 60.0;    // 0.00389076 rpm, 263187 counts/rev
+    return 0.229 * 4096.0 / 60.0;                                           // 0.229 rpm, 4096 counts/rev
+}
+
+double DXLServo::countsPerSec2PerUnit() const {                             // rpm2 to counts/s2, as convertValtoAcc()
+    if (servoType == DXL_PRO_M42)   return (58000.0 / 288.5) * 263187.0 / 3600.0;
+    return 214.577 * 4096.0 / 3600.0;
+}
+
+void DXLServo::noteWrite(uint16_t address, uint16_t length, const uint8_t *data, uint32_t value, uint64_t atUs) {
+    bool pro = (servoType == DXL_PRO_M42);
+    uint16_t goalAddress = pro ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION;
+    uint16_t velAddress = pro ? ADDR_PRO_GOAL_VELOCITY : ADDR_MX_PROFILE_VELOCITY;
+    uint16_t accAddress = pro ? ADDR_PRO_GOAL_ACCELERATION : ADDR_MX_PROFILE_ACCELERATION;
+    auto field = [&](uint16_t at, int32_t &out) {      // 4 byte register inside the write, data 0 for write4ByteTxRx()
+        if (at < address || at + 4 > address + length)    return false;
+        if (data == 0)  out = int32_t(value);
+        else            out = int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(data[at - address], data[at - address + 1]), DXL_MAKEWORD(data[at - address + 2], data[at - address + 3])));
+        return true;
+    };
+    int32_t vel = 0, acc = 0, goal = 0;
+    bool hasVel = field(velAddress, vel), hasAcc = field(accAddress, acc);
+    if (hasVel && hasAcc)   profileKnown = true;    // Both in one block, e.g. a profile + goal write
+    if (hasVel)     profileVel = vel;
+    if (hasAcc)     profileAccel = acc;
+    if (field(goalAddress, goal) && estimatorEnabled)   noteGoal(goal, profileKnown ? profileVel : 0, profileKnown ? profileAccel : 0, atUs);
+}
+
+void DXLServo::noteGoal(int goalPosition, int velocityValue, int accelValue, uint64_t atUs) {
+    if (velocityValue > 0 && accelValue >= 0) {
+        profileVel = velocityValue, profileAccel = accelValue;
+        profileKnown = true;
+    }
+    if (!estimatorEnabled)  return;
+    estimator.setGoal(double(goalPosition), double(velocityValue) * countsPerSecPerUnit(), double(accelValue) * countsPerSec2PerUnit(), atUs);
+    estimatorSlot.write(estimator);
+}
+
+void DXLServo::enableStateEstimator(const DXLEstimatorNoise &noise) {
+    estimator.reset();
+    estimator.setNoise(noise);
+    estimatorSlot.write(estimator);
+    estimatorEnabled = true;
+}
+
+DXLExpected<DXLTimedSample> DXLServo::readTimedPosition() {
+    bool pro = (servoType == DXL_PRO_M42);
+    uint16_t start = pro ? ADDR_PRO_PRESENT_POSITION : ADDR_MX_REALTIME_TICK;
+    uint16_t length = pro ? 8 : uint16_t(ADDR_MX_PRESENT_POSITION + 4 - ADDR_MX_REALTIME_TICK);
+    uint8_t block[16];
+    readTiming = true;                          // This read and every one after stamped, the clock sync needs a series of pairs
+    DXLError status = runTxRx(INST_READ, start, length, block, 0);     // Published, and with it stamped and paired, by executeTxRx()
+    if (status.comm != COMM_SUCCESS || (status.packetError & 0x7F) != 0)    return DXLExpected<DXLTimedSample>(status);
+
+    const uint8_t *pos = block + ((pro ? ADDR_PRO_PRESENT_POSITION : ADDR_MX_PRESENT_POSITION) - start);
+    const uint8_t *vel = block + ((pro ? ADDR_PRO_PRESENT_VELOCITY : ADDR_MX_PRESENT_VELOCITY) - start);
+    DXLServoState state = stateSlot.read();     // Written by this thread just now
+    DXLTimedSample sample;
+    sample.position = int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(pos[0], pos[1]), DXL_MAKEWORD(pos[2], pos[3])));
+    sample.velocity = int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(vel[0], vel[1]), DXL_MAKEWORD(vel[2], vel[3])));
+    sample.tick = pro ? -1 : int32_t(DXL_MAKEWORD(block[0], block[1]));
+    sample.txUs = state.txUs, sample.rxUs = state.rxUs, sample.sampleUs = state.sampleUs;
+    present_position = sample.position;
+    return DXLExpected<DXLTimedSample>(sample);
+}
+
+double DXLServo::predictPosition(uint64_t atUs) const {        // Constant velocity from the sample on: exact for the cruise phase of a profile, a good guess across a 1 - 2 ms gap
+    DXLServoState state = stateSlot.read();
+    if (state.positionSampleUs == 0)    return double(state.position);
+    double dtUs = (atUs > state.positionSampleUs) ? double(atUs - state.positionSampleUs) : -double(state.positionSampleUs - atUs);
+    dtUs = std::min(dtUs, double(DXL_PREDICT_HORIZON_US));
+    double countsPerUs = countsPerSecPerUnit() / 1.0e6;
+    return double(state.position) + double(state.velocity) * countsPerUs * dtUs;
+}
+
+double DXLServo::predictAngle(uint64_t atUs) const {
+    double degreesPerCount = (servoType == DXL_PRO_M42) ? (180.0 / 131593.0) : (360.0 / 4095.0);     // As convertValtoPos()
+    return (predictPosition(atUs) + double(homeOffset)) * degreesPerCount;
+}
+
+int DXLServo::read1ByteTxRx(uint16_t address, uint8_t *data) {
+    return keepResult(runTxRx(INST_READ, address, 1, data, 0));
+}
+
+int DXLServo::read2ByteTxRx(uint16_t address, uint16_t *data) {
+    return keepResult(runTxRx(INST_READ, address, 2, data, 0));
+}
+
+int DXLServo::read4ByteTxRx(uint16_t address, uint32_t *data) {
+    return keepResult(runTxRx(INST_READ, address, 4, data, 0));
+}
+
+int DXLServo::readBlockTxRx(uint16_t address, uint16_t length, uint8_t *data) {
+    return keepResult(runTxRx(INST_READ, address, length, data, 0));
+}
+
+int DXLServo::write1ByteTxRx(uint16_t address, uint8_t data) {
+    return keepResult(runTxRx(INST_WRITE, address, 1, 0, data));
+}
+
+int DXLServo::write2ByteTxRx(uint16_t address, uint16_t data) {
+    return keepResult(runTxRx(INST_WRITE, address, 2, 0, data));
+}
+
+int DXLServo::write4ByteTxRx(uint16_t address, uint32_t data) {
+    return keepResult(runTxRx(INST_WRITE, address, 4, 0, data));
+}
+
+int DXLServo::writeBlockTxRx(uint16_t address, uint16_t length, const uint8_t *data) {
+    return keepResult(runTxRx(INST_WRITE, address, length, const_cast<uint8_t *>(data), 0));       // SDK takes non-const, only reads it
+}
+
+int DXLServo::rebootTxRx() {
+    return keepResult(runTxRx(INST_REBOOT, 0, 0, 0, 0));
+}
+
+void DXLServo::setRetryPolicy(DXLOpClass opClass, const DXLRetryPolicy &policy) {
+    if (opClass < 0 || opClass >= DXL_OP_CLASSES)   return;
+    retryPolicy[opClass] = policy;
+    if (retryPolicy[opClass].maxAttempts < 1)   retryPolicy[opClass].maxAttempts = 1;
+}
+
+void DXLServo::enableAdaptiveTimeout() {       // Wrap port once so SDK packet timeouts can be replaced by learned ones
+    if (timeoutPort != 0 || this->prtHandler == 0)  return;
+    timeoutPort = DXLTimeoutPort::wrap(this->prtHandler);       // One per real port, shared with other servos on it
+    this->prtHandler = timeoutPort;
+}
+
+void DXLServo::configureCircuitBreaker(int failures, int openMs, int maxOpenMs) {
+    breaker.configure(failures, uint64_t(openMs) * 1000, uint64_t(maxOpenMs) * 1000);
+}
+
+DXLError DXLServo::lastError(uint16_t address) const {
+    return DXLError(dxl_comm_result, dxl_error, uint8_t(identity), address, lastAttempts);
+}
+
+DXLError DXLServo::readValue(uint16_t address, uint16_t length, uint32_t &value) {
+    value = 0;
+    if (length == 1) {
+        uint8_t data = 0;
+        DXLError status = runTxRx(INST_READ, address, 1, &data, 0);
+        value = data;
+        return status;
+    }
+    else if (length == 2) {
+        uint16_t data = 0;
+        DXLError status = runTxRx(INST_READ, address, 2, &data, 0);
+        value = data;
+        return status;
+    }
+    else if (length == 4) {
+        return runTxRx(INST_READ, address, 4, &value, 0);
+    }
+    return DXLError(COMM_TX_ERROR, 0, uint8_t(identity), address, 0);
+}
+
+DXLExpected<uint32_t> DXLServo::tryRead(uint16_t address, uint16_t length) {     // Alert bit alone does not fail the read, data is valid; getState().hardwareError or checkShutdown() for it
+    uint32_t value;
+    DXLError status = readValue(address, length, value);
+    if (status.comm != COMM_SUCCESS || (status.packetError & 0x7F) != 0)    return DXLExpected<uint32_t>(status);
+    return DXLExpected<uint32_t>(value);
+}
+
+DXLExpected<void> DXLServo::tryWrite(uint16_t address, uint16_t length, uint32_t value) {
+    if (length != 1 && length != 2 && length != 4)  return DXLExpected<void>(DXLError(COMM_TX_ERROR, 0, uint8_t(identity), address, 0));
+    DXLError status = runTxRx(INST_WRITE, address, length, 0, value);
+    if (status.comm != COMM_SUCCESS || (status.packetError & 0x7F) != 0)    return DXLExpected<void>(status);
+    return DXLExpected<void>();
+}
+
+DXLExpected<int> DXLServo::tryReadCurrentPosition() {          // Signed position, Pro positions below 0 are valid
+    uint16_t address = (servoType == DXL_PRO_M42) ? ADDR_PRO_PRESENT_POSITION : ADDR_MX_PRESENT_POSITION;
+    DXLExpected<uint32_t> raw = tryRead(address, 4);
+    if (!raw)   return DXLExpected<int>(raw.error());
+    present_position = int(int32_t(raw.value()));
+    return DXLExpected<int>(present_position);
+}
+
+DXLExpected<double> DXLServo::tryGetPresentCurrent() {          // Signed current in amps, negative for reverse torque
+    uint16_t address = (servoType == DXL_PRO_M42) ? ADDR_PRO_PRESENT_CURRENT : ADDR_MX_PRESENT_CURRENT;
+    DXLExpected<uint32_t> raw = tryRead(address, 2);
+    if (!raw)   return DXLExpected<double>(raw.error());
+    present_current = convertValtoCurr(int(int16_t(raw.value())));
+    return DXLExpected<double>(present_current);
+}
+
+DXLExpected<int> DXLServo::tryGetPresentTemperature() {
+    uint16_t address = (servoType == DXL_PRO_M42) ? ADDR_PRO_PRESENT_TEMPERATURE : ADDR_MX_PRESENT_TEMPERATURE;
+    uint32_t raw;
+    DXLError status = readValue(address, 1, raw);
+    if (status.comm != COMM_SUCCESS || (status.packetError & 0x7F) != 0)    return DXLExpected<int>(status);
+    if (raw > 100)  return DXLExpected<int>(DXLError(DXL_COMM_INVALID_VALUE, 0, uint8_t(identity), address, status.attempts));     // Valid range 0 - 100
+    present_temperature = int(raw);
+    return DXLExpected<int>(present_temperature);
+}
+
+DXLExpected<bool> DXLServo::tryIsMoving() {
+    uint16_t address = (servoType == DXL_PRO_M42) ? ADDR_PRO_MOVING : ADDR_MX_MOVING;
+    DXLExpected<uint32_t> raw = tryRead(address, 1);
+    if (!raw)   return DXLExpected<bool>(raw.error());
+    return DXLExpected<bool>(raw.value() > 0);
+}
+
+DXLExpected<void> DXLServo::tryWriteGoalPosition(int position) {       // Direct goal write, returns without waiting for motion
+    uint16_t address = (servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION;
+    return tryWrite(address, 4, uint32_t(position));
+}
+
+void DXLServo::enableTorque() {			// Enable Dynamixel Torque
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_TORQUE_ENABLE;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_TORQUE_ENABLE;
+
+    dxl_comm_result = write1ByteTxRx(address, TORQUE_ENABLE);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+    else
+    {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Dynamixel#%d has been successfully connected ", identity);
+    }
+}
+
+void DXLServo::disableTorque() {			// Disable Dynamixel Torque
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_TORQUE_ENABLE;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_TORQUE_ENABLE;
+
+    dxl_comm_result = write1ByteTxRx(address, TORQUE_DISABLE);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+}
+
+void DXLServo::addToGoalPosVector(const std::vector<int> &posVector) {			// Store a vector of preselected Goal Positions into internal vector
+    if (goalSource) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Goal positions come from an external source, reset first!");
+        return;
+    }
+    for (int i = 0; i < posVector.size(); i++) {
+        goalPositionVector.push_back(posVector[i]);
+    }
+}
+
+void DXLServo::useGoalPositions(const int32_t *positions, size_t count, int minPosition, int maxPosition) {     // Goal positions read in place from caller's memory
+    goalPositionVector.clear();
+    goalSource = positions;
+    goalSourceCount = positions ? count : 0;
+    goalSourceMin = minPosition, goalSourceMax = maxPosition;
+}
+
+static int reportGoalViolations(int id, const std::vector<DXLViolation> &violations, size_t found, const char *unit) {   // Log what the validator found, 1 if nothing
+    for (size_t i = 0; i < violations.size() && i < DXL_VALIDATE_LOG_MAX; i++) {
+        DXL_LOG_ERROR(id, DXL_LOG_NONE, DXL_LOG_NONE, "Error! %s %d at index %d outside position limit %d by %d!", unit,
+            int(violations[i].value), int(violations[i].index), int(violations[i].limit), int(-violations[i].margin));
+    }
+    if (found > DXL_VALIDATE_LOG_MAX)   DXL_LOG_ERROR(id, DXL_LOG_NONE, DXL_LOG_NONE, "Error! %d more invalid values!", int(found - DXL_VALIDATE_LOG_MAX));
+    if (found > 0) {
+        DXL_LOG_ERROR(id, DXL_LOG_NONE, DXL_LOG_NONE, "!!! Modify or reinitialize Position Vector !!!");
+        return 0;
+    }
+    return 1;
+}
+
+int DXLServo::checkGoalPosVector() {			// Check internal vector against position limits, every invalid value reported
+    if (goalPositionCount() == 0) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Goal Position Vector is empty!");
+        return -1;
+    }
+    else {
+        if (goalSource) {                       // External source: range given with it, not scanned (pages would all be read in)
+            if (goalSourceMin < limitPosMin || goalSourceMax > limitPosMax) {
+                DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! External goal positions range %d - %d outside position limits %d - %d!", goalSourceMin, goalSourceMax, limitPosMin, limitPosMax);
+                return 0;
+            }
+            return 1;
+        }
+        std::vector<DXLViolation> violations;
+        size_t found = dxlValidateColumn(goalPositionVector.data(), goalPositionVector.size(), DXLAxisBounds(limitPosMin, limitPosMax), 0.0, 0, violations, DXL_VALIDATE_LOG_MAX);
+        return reportGoalViolations(identity, violations, found, "Position");
+    }
+}
+
+void DXLServo::writeGoalPosition(int vectorPosition) {						// Write DXL position from internal stored vector. Input: vectorPosition = index of positon stored in internal vector
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_GOAL_POSITION;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_GOAL_POSITION;
+
+    if (goalPositionCount() == 0) {				// If array is empty
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Goal Position Vector is empty!");
+    }
+    else {
+        dxl_comm_result = write4ByteTxRx(address, goalPositionAt(vectorPosition));
+        if (dxl_comm_result != COMM_SUCCESS)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        }
+        else if (dxl_error != 0)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        }
+        waitForMove(goalPositionAt(vectorPosition));		// Predicted arrival instead of polling Moving back to back. Comment out if changing to external Moving check
+    }
+    //return;
+}
+
+void DXLServo::writeGoalPosition(int select, int vectorPosition) {			// Write DXL position from either internal Position or direct integer entry. Inputs: select: 0 = Internal vector, 1 = direct entry. vectorPosition: Index of stored position in internal vector or direct integer value of desired position
+    int address, limit;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_GOAL_POSITION;
+        limit = 4096;		// Max integer value for position of MX servo
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_GOAL_POSITION;
+        limit = pow(2, 31);		// Max integer value for position of Pro servo
+    }
+    int valPos = 0;
+    bool written = false;
+    if (select == 0) {			// Internal Position Vector
+        if (vectorPosition >= int(goalPositionCount()) || vectorPosition < 0) {
+            DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid vector reference!");
+            return;
+        }
+        valPos = goalPositionAt(vectorPosition);
+        dxl_comm_result = write4ByteTxRx(address, valPos);
+        written = (dxl_comm_result == COMM_SUCCESS && dxl_error == 0);     // Nothing to wait for after a timeout or error status
+        if (dxl_comm_result != COMM_SUCCESS)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        }
+        else if (dxl_error != 0)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        }
+    }
+    else if (select == 1) {		// Direct entry
+        if (abs(vectorPosition) >= 0 && abs(vectorPosition) < limit) {
+            valPos = vectorPosition;
+            dxl_comm_result = write4ByteTxRx(address, valPos);
+            written = (dxl_comm_result == COMM_SUCCESS && dxl_error == 0);
+            if (dxl_comm_result != COMM_SUCCESS)
+            {
+                DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+            }
+            else if (dxl_error != 0)
+            {
+                DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+            }
+        }
+        else {
+            DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value of desired Goal Position; Values between 0 - %i only, from -180 to +180 degrees in units of 0.088 degrees!", limit);
+        }
+    }
+    else {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid Select value; 0 for internal reference or 1 for direct entry!");
+    }
+    if (written)    waitForMove(valPos);		// Predicted arrival instead of polling Moving back to back. Comment out if changing to external Moving check
+}
+
+int DXLServo::readCurrentPosition() {			// Read servo's position, returns integer value. For angle, use readCurrentAngle(). Sample time in getState().positionSampleUs.
+    bool success = true;
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_PRESENT_POSITION;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_PRESENT_POSITION;
+
+    DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading Present Position");
+    int position = -1;
+    dxl_comm_result = read4ByteTxRx(address, (uint32_t*)&position);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Present Position read");
+        if (position < 0) {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Position value is negative! Unexpected Error");
+            return -1;
+        }
+        present_position = position;
+    }
+    return position;
+}
+
+double DXLServo::readCurrentAngle() {			// Read servo's position, returns in angle (degrees).
+    bool success = true;
+    int address, temp;
+    double angle;
+
+    if (servoType == DXL_MX_64)  address = ADDR_MX_PRESENT_POSITION;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_PRESENT_POSITION;
+
+    DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading Present Angle");
+    int position = -1;
+    dxl_comm_result = read4ByteTxRx(address, (uint32_t*)&position);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Present Angle read");
+//        if (position < 0 && servoType == DXL_MX_64) {
+//            printf("Error! Position value is negative! Unexpected Error\n");
+//            return -1.0;
+//        }
+//        else if (position < 0 && servoType == DXL_PRO_M42) {
+//            temp = -(position);
+//        }
+//        else{
+        temp = position;
+        //}
+        angle = convertValtoPos( (temp + homeOffset) );		// Current angle including homing offset
+        present_position = temp;
+    }
+    return angle;
+}
+
+void DXLServo::addToGoalAngleVect(const std::vector<double> &angVector) {		// Store a vector of preselected Goal Positions into internal vector
+    for (int i = 0; i < angVector.size(); i++) {
+        goalAngleVector.push_back(angVector[i]);
+    }
+}
+
+int DXLServo::checkGoalAngleVect() {			// Check internal vector against position limits after conversion, every invalid value reported
+    if (goalAngleVector.size() == 0) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Goal Angle Vector is empty!");
+        return -1;
+    }
+    else {
+        std::vector<int32_t> positions(goalAngleVector.size());
+        for (size_t i = 0; i < goalAngleVector.size(); i++)     positions[i] = convertPostoVal(goalAngleVector[i]) - homeOffset;    // As writeGoalAngle() sends them
+        std::vector<DXLViolation> violations;
+        size_t found = dxlValidateColumn(positions.data(), positions.size(), DXLAxisBounds(limitPosMin, limitPosMax), 0.0, 0, violations, DXL_VALIDATE_LOG_MAX);
+        return reportGoalViolations(identity, violations, found, "Angle as position");
+    }
+}
+
+void DXLServo::writeGoalAngle(int vectorAngle) {			// Write DXL position from internal stored vector. Input: vectorAngle = index of positon stored in internal vector
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_GOAL_POSITION;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_GOAL_POSITION;
+
+    if (goalAngleVector.size() == 0) {				// If array is empty
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Goal Position Vector is empty!");
+        return;
+    }
+    else if (vectorAngle > goalAngleVector.size() || vectorAngle < 0) {		// if reference to vector is negative or exceeds vector size
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid vector reference!");
+        return;
+    }
+    else {
+        int valPos = convertPostoVal(goalAngleVector[vectorAngle]);
+        valPos = valPos - homeOffset;
+        dxl_comm_result = write4ByteTxRx(address, valPos);
+        if (dxl_comm_result != COMM_SUCCESS)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        }
+        else if (dxl_error != 0)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        }
+        waitForMove(valPos);			// Predicted arrival instead of polling Moving back to back. Comment out if changing to external Moving check
+        //printf("Goal angle write done\n");
+    }
+}
+
+void DXLServo::writeGoalAngle(int select, double vectorAngle) {			// Write DXL position from either internal Angle or direct integer entry. Inputs: select: 0 = Internal vector, 1 = direct entry. vectorPosition: Index of stored position in internal vector or direct integer value of desired position
+    int address, limit;
+    double unit;
+    int valPos = 0;
+    bool written = false;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_GOAL_POSITION;
+        limit = 4096;
+        unit = 0.088;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_GOAL_POSITION;
+        limit = pow(2, 31);
+        unit = 0.00137;
+    }
+
+    if (select == 0) {			// Internal Position Vector
+        if (vectorAngle > goalAngleVector.size() || vectorAngle < 0) {
+            DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid vector reference!");
+            return;
+        }
+        valPos = convertPostoVal(goalAngleVector[vectorAngle]);
+        valPos = valPos - homeOffset;
+        dxl_comm_result = write4ByteTxRx(address, valPos);
+        written = (dxl_comm_result == COMM_SUCCESS && dxl_error == 0);     // Nothing to wait for after a timeout or error status
+        if (dxl_comm_result != COMM_SUCCESS)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        }
+        else if (dxl_error != 0)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        }
+    }
+    else if (select == 1) {		// Direct entry
+        valPos = convertPostoVal(vectorAngle);
+        valPos = valPos - homeOffset;
+        if (abs(valPos) < limit) {
+            dxl_comm_result = write4ByteTxRx(address, valPos);
+            written = (dxl_comm_result == COMM_SUCCESS && dxl_error == 0);
+            if (dxl_comm_result != COMM_SUCCESS)
+            {
+                DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+            }
+            else if (dxl_error != 0)
+            {
+                DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+            }
+        }
+        else {
+            DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value of desired Goal Position; Values between 0 - %i only, from 0 to 360 degrees in units of %f degrees!", limit, unit);
+        }
+    }
+    else {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid Select value; 0 for internal reference or 1 for direct entry!");
+    }
+    if (written)    waitForMove(valPos);		// Predicted arrival instead of polling Moving back to back. Comment out if changing to external Moving check
+}
+
+int DXLServo::checkOperating() {			// Returns status of Operate Mode register
+    //bool success = true;
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_OPERATING_MODE;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_OPERATING_MODE;
+
+    DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading Operate Mode");
+    uint8_t *set_operate_mode = new uint8_t;
+    dxl_comm_result = read1ByteTxRx(address, set_operate_mode);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        //success = false;
+    }
+
+    DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Operate Mode read");
+    int opMode = 0;
+    opMode = (opMode << 8) + set_operate_mode[0];
+
+    if (opMode < 0) {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Operate Mode value is negative!");
+        return -1;
+    }
+    else return opMode;
+}
+
+int DXLServo::checkPositionMode() {				// Checks if Operate Mode is set to Position Control Mode, warning if not.
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_OPERATING_MODE;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_OPERATING_MODE;
+
+    uint8_t *set_operate_mode = new uint8_t;
+    dxl_comm_result = read1ByteTxRx(address, set_operate_mode);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    int opMode = 0;
+    opMode = (opMode << 8) + set_operate_mode[0];
+
+    if (opMode < 0) {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Operate Mode value is negative! Unexpected error!");
+        return -1;
+    }
+    else if (opMode != 3) {
+        DXL_LOG_WARN(identity, address, dxl_comm_result, "Warning! Operate Mode not set to Position Control!");
+        return 0;
+    }
+    else return 1;
+}
+
+void DXLServo::setOperatingMode(int mode) {				// Change Operate Mode. Input: mode: 0 = Current Control, 1 = Velocity Control, 2 = Position (Single turn) Control (default), 3 = Extended Position (Multi turn) Control, 4 = Current based Position Control, 5 = PWM Control
+    bool success = true;
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_OPERATING_MODE;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_OPERATING_MODE;
+
+    uint8_t opMode = 3;									// Default Operating Mode: 3, Position Control
+    std::string modeSet;
+    // add MX or PRO check
+    switch (mode) {
+    case 0:
+        opMode = DXL_MX_CURRENT_CONTROL_MODE;
+        modeSet = "Current";
+        break;
+    case 1:
+        opMode = DXL_VELOCITY_CONTROL_MODE;
+        modeSet = "Velocity";
+        break;
+    case 2:
+        opMode = DXL_POSITION_CONTROL_MODE;
+        modeSet = "Position";
+        break;
+    case 3:
+        opMode = DXL_EXTENDED_CONTROL_MODE;
+        modeSet = "Extended Position";
+        break;
+    case 4:
+        opMode = DXL_MX_CURRENT_POSITION_CONTROL_MODE;
+        modeSet = "Current Position";
+        break;
+    case 5:
+        opMode = DXL_MX_PWM_CONTROL_MODE;
+        modeSet = "PWM";
+        break;
+    }
+
+    if (servoType == DXL_PRO_M42 && (opMode == 4 || opMode == 5)) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "ERROR! Pro servo does not implement Current based Position or PWM Control!");
+        return;
+    }
+
+    dxl_comm_result = write1ByteTxRx(address, opMode);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        //printf("Operating Mode set to: %s Control Mode\n", modeSet);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Operating Mode set to: %s Control Mode.", modeSet.c_str());
+    }
+}
+
+void DXLServo::setMaxCurrentLimit() {       // Sets Current limit to the max value before stall torque occurs
+    bool success = true;
+    int address, limit;
+    //double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_CURRENT_LIMIT;
+        limit = DXL_MX_CURRENT_LIMIT_MAX;
+        //mult = 0.00336;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_TORQUE_LIMIT;
+        limit = DXL_PRO_M42_TORQUE_LIMIT_MAX;
+        //mult = 0.004028;
+    }
+
+    dxl_comm_result = write2ByteTxRx(address, limit);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        //double set = limit * mult;
+        double set = convertValtoCurr(limit);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Current limit set to max %.2f amps", set);
+        limitCurrent = limit;
+    }
+}
+
+void DXLServo::setCurrentLimit(double amps) {		// Sets Current limit to desired current value. Limited by precalculated max current before stall torque occurs.
+    bool success = true;
+    int address;
+    double currLimit;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_CURRENT_LIMIT;
+        currLimit = 4.0;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_TORQUE_LIMIT;
+        currLimit = 2.1;
+    }
+
+    if (amps > currLimit || amps < 0.0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value of current limit! Select between 0.0 and %f!", currLimit);
+        return;
+    }
+
+    if (amps < (0.2 * currLimit)) {
+        DXL_LOG_WARN(identity, address, DXL_LOG_NONE, "Warning! Setting value to less than 0.2 of limit, \nServo may not function properly under load!");
+    }
+
+    int limit;
+    limit = convertCurrtoVal(amps);
+    //if (servoType == DXL_MX_64) {
+    //	limit = int(int((amps / 0.00336) + 0.5));								// Rounding number trick; int(float value + 0.5)
+    //}
+    //else {
+    //	limit = int(int((amps / 0.004028) + 0.5));
+    //}
+
+    dxl_comm_result = write2ByteTxRx(address, limit);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        //success = false;
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Current Limit set to %.2f amps", amps);
+        limitCurrent = limit;
+    }
+}
+
+void DXLServo::setCurrentLimit(int limit) {				// Sets Current limit via direct integer value. Limited by MX value limit or Pro M42 servo corresponding max current before stall torque occurs
+    bool success = true;
+    int address, currLimit;
+    //double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_CURRENT_LIMIT;
+        currLimit = 1941;
+        //mult = 0.00336;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_TORQUE_LIMIT;
+        currLimit = 521;
+        //mult = 0.004028;
+    }
+
+    if (limit > currLimit || limit < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value of current limit! Select between 0 and %d!", currLimit);
+        return;
+    }
+
+    if (limit < (currLimit / 5)) {
+        DXL_LOG_WARN(identity, address, DXL_LOG_NONE, "Warning! Setting value to less than 0.2 of limit, \nservo may not function properly under load!");
+    }
+
+    dxl_comm_result = write2ByteTxRx(address, limit);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        //double set = double(limit)* mult;
+        double set = convertValtoCurr(limit);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Current Limit set to %.2f", set);
+        limitCurrent = limit;
+    }
+}
+
+void DXLServo::set80rpmVelLimit() {			// Sets Velocity Limit to 80rpm
+    bool success = true;
+    int address, velLimit;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_VELOCITY_LIMIT;
+        velLimit = DXL_MX_VELOCITY_LIMIT_80;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_VELOCITY_LIMIT;
+        velLimit = DXL_PRO_M42_VELOCITY_LIMIT_80;
+    }
+
+    dxl_comm_result = write4ByteTxRx(address, velLimit);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = true;
+    }
+
+    if (success) {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Velocity Limit set to 80rpm");
+        limitVel = velLimit, limitVelKnown = true;
+    }
+}
+
+void DXLServo::setVelocityLimit(int limit) {			// Sets Velocity limit via direct integer value
+    bool success = true;
+    int address, velLimit;
+    //double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_VELOCITY_LIMIT;
+        velLimit = 1023;
+        //mult = 0.229;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_VELOCITY_LIMIT;
+        velLimit = 25710;       // Actual limit for Pro servo is 2^31, but unlikely to use such high speed, severely limited for position application
+        //mult = 0.00389076;
+    }
+
+    if (limit > velLimit || limit < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value of velocity limit! Select between 0 and %d!", velLimit);
+        return;
+    }
+    dxl_comm_result = write4ByteTxRx(address, limit);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        //int set = int(limit * mult);
+        int set = convertValtoVel(limit);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Velocity Limit set to %i rpm", set);
+        limitVel = limit, limitVelKnown = true;
+    }
+}
+
+void DXLServo::setVelocityLimit(double limit) {			// Set velocity limit to desired velocity (rpm)
+    bool success = true;
+    int address;
+    double velLimit = 235.0;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_VELOCITY_LIMIT;
+        //velLimit = 1023;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_VELOCITY_LIMIT;
+        //velLimit = 60400;       // Actual limit for Pro servo is 2^31 * 0.00389076, but unlikely to use such high speed, severely limited for position application
+    }
+
+    if (limit > velLimit || limit < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value of velocity limit! Select between 0 and 235.0!");
+        return;
+    }
+
+    int pass = convertVeltoVal(limit);
+
+    dxl_comm_result = write4ByteTxRx(address, pass);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Velocity Limit set to %.3f rpm", limit);
+        limitVel = pass, limitVelKnown = true;
+    }
+}
+
+int DXLServo::getVelocityLimit() {				// Read value of Velocity Limit set in servo. Returns integer value, conversion available. Change func to return double instead of int?
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_VELOCITY_LIMIT;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_VELOCITY_LIMIT;
+
+    int velocLim = 0;
+    dxl_comm_result = read4ByteTxRx(address, (uint32_t*)&velocLim);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    double velocity = convertValtoVel(velocLim);
+    DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Velocity Limit at %f rpm", velocity);
+    //return velocity;
+    return velocLim;
+}
+
+void DXLServo::setlowAccelLimit() {				// Sets Acceleration to low precalculated value. DXL servo acceleration far too high for position application, causes following error and shutdown.
+    bool success = true;
+    int address, limit;
+    //double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_ACCELERATION_LIMIT;
+        limit = DXL_MX_ACCELERATION_LIMIT_LOW;
+        //mult = 214.577;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_ACCELERATION_LIMIT;
+        limit = DXL_PRO_M42_ACCEL_LIMIT_LOW;
+        //mult = 201.039;
+    }
+
+    dxl_comm_result = write4ByteTxRx(address, limit);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        //double set = limit * mult;
+        double set = convertValtoAcc(limit);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Acceleration set to %.3f rev/min2", set);
+        limitAccel = DXL_MX_ACCELERATION_LIMIT_LOW, limitAccelKnown = true;
+    }
+}
+
+void DXLServo::setAccelLimit(int limit) {				// Sets Acceleration limit, limited to 100 * unit. Modifiable.
+    bool success = true;
+    int address;
+    //double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_ACCELERATION_LIMIT;
+        //mult = 214.577;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_ACCELERATION_LIMIT;
+        //mult = 201.039;
+    }
+
+    if (limit > 100 || limit < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value of acceleration limit! Select between 0 and 100!/n100 value limit for safe operation!");
+        return;
+    }
+    dxl_comm_result = write4ByteTxRx(address, limit);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        //double set = limit * mult;
+        double set = convertValtoAcc(limit);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Acceleration set to %.3f rev/min2", set);
+        limitAccel = limit, limitAccelKnown = true;
+    }
+}
+
+void DXLServo::setAccelLimit(double limit) {			// Sets Acceleration limit, limited to 100 * unit.
+    bool success = true;
+    int address;
+    double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_ACCELERATION_LIMIT;
+        mult = 214.577;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_ACCELERATION_LIMIT;
+        mult = 201.039;
+    }
+
+    if (limit > (100 * mult) || limit < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value of acceleration limit! Select between 0 and 100 * %.3f!/n100 value limit for safe operation!", mult);
+        return;
+    }
+
+    int pass = convertAcctoVal(limit);
+
+    dxl_comm_result = write4ByteTxRx(address, pass);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Acceleration set to %.3f rev/min2", limit);
+        limitAccel = pass, limitAccelKnown = true;
+    }
+}
+
+int DXLServo::getAccelLimit() {				// Read value of Acceleration limit, return in integer. Conversion available.
+    bool success = true;
+    int address;
+    //double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_ACCELERATION_LIMIT;
+        //mult = 214.577;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_ACCELERATION_LIMIT;
+        //mult = 201.039;
+    }
+
+    DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading acceleration limit");
+
+    int accelLim = 0;
+    dxl_comm_result = read4ByteTxRx(address, (uint32_t*)&accelLim);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Acceleration limit read");
+    //double accel = accelLim * mult;
+    double accel = convertValtoAcc(accelLim);
+    DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Acceleration Limit at  %.3f rev/min2", accel);
+    return accelLim;
+}
+
+void DXLServo::setPositionLimit(bool minMax, int position) {		// Sets Position limits of servo. Inputs: minMax false for Min, true for Max; Position int for direct transmission
+    bool success = true;
+    int address, limitMin, limitMax;
+    std::string set;
+    if (!minMax) {									// minMax == false, Min Position Limit
+        if (servoType == DXL_MX_64) {
+            address = ADDR_MX_MIN_POSITION_LIMIT;
+            limitMin = 0;
+        }
+        else if (servoType == DXL_PRO_M42) {
+            address = ADDR_PRO_MIN_POSITION_LIMIT;
+            limitMin = int( -(pow(2.0,31.0)) );
+        }
+        set = "Minimum";
+    }
+    else {
+        if (servoType == DXL_MX_64) {
+            address = ADDR_MX_MAX_POSITION_LIMIT;			// minMax == true, Max Position Limit
+            limitMax = 4096;
+        }
+        else if (servoType == DXL_PRO_M42) {
+            address = ADDR_PRO_MAX_POSITION_LIMIT;
+            limitMax = int( pow(2.0, 31.0) );
+        }
+        set = "Maximum";
+    }
+
+    if (position < limitMin || position > limitMax) {		// check that position does not exceed limits
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "ERROR! Value exceeds limits!\nSelect between %i and %i!", limitMin, limitMax);
+        return;
+    }
+
+    dxl_comm_result = write4ByteTxRx(address, position);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        double angle = convertValtoPos(position);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "%s Position limit set to %g degrees", set.c_str(), angle);
+        if (!minMax)	limitPosMin = position;
+        else			limitPosMax = position;
+    }
+}
+
+void DXLServo::setPositionLimit(bool minMax, double angle) {		// Sets Position limits of servo. Inputs: minMax false for Min, true for Max; angle in degrees
+    bool success = true;
+    int address;
+    double limitMin, limitMax;
+    std::string set;
+    if (!minMax) {									// minMax == false, Min Position Limit
+        if (servoType == DXL_MX_64) {
+            address = ADDR_MX_MIN_POSITION_LIMIT;
+            limitMin = 0.0;
+        }
+        else if (servoType == DXL_PRO_M42) {
+            address = ADDR_PRO_MIN_POSITION_LIMIT;
+            limitMin = -( pow(2.0, 31.0) );
+        }
+        set = "Minimum";
+    }
+    else {
+        if (servoType == DXL_MX_64) {
+            address = ADDR_MX_MAX_POSITION_LIMIT;			// minMax == true, Max Position Limit
+            limitMax = 360.0;
+        }
+        else if (servoType == DXL_PRO_M42) {
+            address = ADDR_PRO_MAX_POSITION_LIMIT;
+            limitMax = int( pow(2.0, 31.0) );
+        }
+        set = "Maximum";
+    }
+
+    if (angle < limitMin || angle > limitMax) {		// check that angle does not exceed limits
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "ERROR! Value exceeds limits!\nSelect between %f and %f!", limitMin, limitMax);
+        return;
+    }
+
+    int position = convertPostoVal(angle);
+
+    dxl_comm_result = write4ByteTxRx(address, position);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "%s Position limit set to %g degrees", set.c_str(), angle);
+        if (!minMax)	limitPosMin = position;
+        else			limitPosMax = position;
+    }
+}
+
+void DXLServo::setProfileAcceleration(int accel) {			// Sets Acceleration value for move while servo torque is enabled. Input: accel: direct integer value for transmission.
+    bool success = true;
+    int address;
+    //double mult;
+    if (servoType == DXL_MX_64){
+        address = ADDR_MX_PROFILE_ACCELERATION;
+        //mult = 214.577;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        //// Can edit to use Goal Var if Pro servo used to distinguish between speed control and Positioning Move Profile.
+        //printf("Error! Profile Variable only for MX servos!\nUse Goal Acceleration for Pro servo!\n");
+        //return;
+        address = ADDR_PRO_GOAL_ACCELERATION;
+        //mult = 201.039;
+    }
+
+    if (accel == 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Value of 0 will give infinite acceleration! Disallowed for safe operation!");
+        return;
+    }
+    // Assumes Acceleration limit has been set/read in code before
+    else if (accel > limitAccel || accel < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value! Select value between 1 - %d!", limitAccel);
+        return;
+    }
+
+    dxl_comm_result = write4ByteTxRx(address, accel);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        //double set = double(accel) * 214.577;
+        double set = convertValtoAcc(accel);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Profile acceleration set to %.3f rev/min2", set);
+        profileAccel = accel;
+    }
+}
+
+void DXLServo::setProfileAcceleration(double accel) {			// Sets Acceleration value for move while servo torque is enabled. Input: accel: acceleration (rpm2)
+    bool success = true;
+    int address;
+    //double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_PROFILE_ACCELERATION;
+        //mult = 214.577;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        //// Can edit to use Goal Var if Pro servo used to distinguish between speed control and Positioning Move Profile.
+        //printf("Error! Profile Variable only for MX servos!\nUse Goal Acceleration for Pro servo!\n");
+        //return;
+        address = ADDR_PRO_GOAL_ACCELERATION;
+        //mult = 201.039;
+    }
+    // Assumes Acceleration limit has been set/read in code before
+    double limit = convertValtoAcc(limitAccel);
+
+    if (accel == 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Value of 0 will give infinite acceleration! Disallowed for safe operation!");
+        return;
+    }
+    else if (accel > limit || accel < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value! Select value between 1 - %f!", limit);
+        return;
+    }
+
+    // Convert to integer for transmission
+    int pass = convertAcctoVal(accel);
+
+    dxl_comm_result = write4ByteTxRx(address, accel);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Profile acceleration set to %.3f rev/min2", accel);
+        profileAccel = pass;
+    }
+}
+
+int DXLServo::checkProfileAcceleration() {				// Read value of Profile Acceleration register, returns direct integer value. Conversion available.
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_PROFILE_ACCELERATION;
+    else if (servoType == DXL_PRO_M42) {
+        //printf("Error! Profile Variable only for MX servos!\nUse Goal Acceleration for Pro servo!\n");
+        //return -1;
+        address = ADDR_PRO_GOAL_ACCELERATION;
+    }
+    DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading Profile Acceleration");
+    int accel = -1;
+    dxl_comm_result = read4ByteTxRx(address, (uint32_t*)&accel);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Profile Acceleration read");
+    double trueAccel = convertValtoAcc(accel);
+
+    if (accel < 0) {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Value is negative! Unexpected error!");
+        return -1;
+    }
+    else return accel;
+}
+
+void DXLServo::setProfileVelocity(int vel) {			// Sets Velocity value for move while servo torque is enabled. Input: vel: direct integer value for transmission
+    bool success = true;
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_PROFILE_VELOCITY;
+    else if (servoType == DXL_PRO_M42) {
+        //printf("Error! Profile Variable only for MX servos!\nUse Goal Velocity for Pro servo!\n");
+        //return;
+        address = ADDR_PRO_GOAL_VELOCITY;
+    }
+
+    if (vel == 0) {
+        DXL_LOG_WARN(identity, address, DXL_LOG_NONE, "Warning! Value of 0 will give infinite velocity! Disallowed for safe operation!");
+        return;
+    }
+    // Assumes Velocity limit has been set/read in code before
+    else if (vel > limitVel || vel < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value! Select value between 1 - %d!", limitVel);
+        return;
+    }
+
+    dxl_comm_result = write4ByteTxRx(address, vel);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        double set = convertValtoVel(vel);
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Profile Velocity set to %.3f rpm", set);
+        profileVel = vel;
+    }
+}
+
+void DXLServo::setProfileVelocity(double vel) {			// Sets Velocity value for move while servo torque is enabled. Input: vel: velocity (rpm)
+    bool success = true;
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_PROFILE_VELOCITY;
+    else if (servoType == DXL_PRO_M42) {
+        //printf("Error! Profile Variable only for MX servos!\nUse Goal Velocity for Pro servo!\n");
+        //return;
+        address = ADDR_PRO_GOAL_VELOCITY;
+    }
+
+    double limit = convertValtoVel(limitVel);
+
+    if (vel == 0) {
+        DXL_LOG_WARN(identity, address, DXL_LOG_NONE, "Warning! Value of 0 will give infinite velocity! Disallowed for safe operation!");
+        return;
+    }
+    // Assumes Velocity limit has been set/read in code before
+    else if (vel > limit || vel < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid value! Select value between 1 - %d!", limitVel);
+        return;
+    }
+
+    int pass = convertVeltoVal(vel);
+
+    dxl_comm_result = write4ByteTxRx(address, pass);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Profile Velocity set to %.3f rpm", vel);
+        profileVel = pass;
+    }
+}
+
+int DXLServo::checkProfileVelocity() {				// Reads value of register in servo, returns direct integer value. Conversion available.
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_PROFILE_VELOCITY;
+    else if (servoType == DXL_PRO_M42) {
+        //printf("Error! Profile Variable only for MX servos!\nUse Goal Velocity for Pro servo!\n");
+        //return -1;
+        address = ADDR_PRO_GOAL_VELOCITY;
+    }
+
+    int vel = -1;
+    dxl_comm_result = read4ByteTxRx(address, (uint32_t*)&vel);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    double trueVel = convertValtoVel(vel);		// convert to rpm, for future use
+
+    if (vel < 0) {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Value is negative! Unexpected error!");
+        return -1;
+    }
+    else return vel;
+}
+
+int DXLServo::checkPresentTemperature() {			// Checks temperature of servo, issues warnings for close to limit and exceeded limit. ADD: shutdown check if exceed.
+    int addressLim, addressTemp;
+    if (servoType == DXL_MX_64) {
+        addressLim = ADDR_MX_TEMPERATURE_LIMIT;
+        addressTemp = ADDR_MX_PRESENT_TEMPERATURE;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        addressLim = ADDR_PRO_TEMPERATURE_LIMIT;
+        addressTemp = ADDR_PRO_PRESENT_TEMPERATURE;
+    }
+
+    uint8_t *limitTemp = new uint8_t;
+    dxl_comm_result = read1ByteTxRx(addressLim, limitTemp);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, addressLim, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, addressLim, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    int limTemp = 0;
+    limTemp = (limTemp << 8) + limitTemp[0];
+
+    if (limTemp < 0) {					// Error in comm function return, unexpected error
+        DXL_LOG_ERROR(identity, addressLim, dxl_comm_result, "Error! Value (EEPROM Limit) is negative! Unexpected error!");
+        return -1;
+    }
+    else {									// Return value should be 80 with Temp Limit EEPROM value unchanged
+        uint8_t *presTemp = new uint8_t;
+        dxl_comm_result = read1ByteTxRx(addressTemp, presTemp);
+        if (dxl_comm_result != COMM_SUCCESS)
+        {
+            DXL_LOG_ERROR(identity, addressTemp, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        }
+        else if (dxl_error != 0)
+        {
+            DXL_LOG_ERROR(identity, addressTemp, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        }
+
+        int valTemp = 0;
+        valTemp = (valTemp << 8) + presTemp[0];
+
+        if (valTemp < 0) {
+            DXL_LOG_ERROR(identity, addressTemp, dxl_comm_result, "Error! Value (Presnt Temperature) is negative! Unexpected error!");
+            return -1;
+        }
+        else if (valTemp >= (0.9 * limTemp) && valTemp < limTemp) {			// If Present Temperature is around 90% of limit or higher but lower than limit
+            DXL_LOG_WARN(identity, addressTemp, dxl_comm_result, "Warning! Temperature has reached 90 percent of limit!");
+            return 1;
+        }
+        else if (valTemp >= limTemp) {					// If Present Temperature is at or exceeds limit ( 80 - 100 C )
+            DXL_LOG_ERROR(identity, addressTemp, dxl_comm_result, "Error! Temperature has exceeded limit! Shutdown triggering!");
+			//ADD checkShutdown()
+            return 2;
+        }
+    }
+    return 0;
+}
+
+int DXLServo::getPresentTemperature() {				// Reads Present Temperature register, returns integer value, actual temperature value equal (1:1). Warning: For MX servo, temperature sensor on PCB, not motor. Actual motor temperature may be higher than reported.
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_PRESENT_TEMPERATURE;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_PRESENT_TEMPERATURE;
+    DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading Present Temperature");
+    uint8_t *presTemp = new uint8_t;
+    dxl_comm_result = read1ByteTxRx(address, presTemp);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Present Temperature read");
+    int valTemp = 0;
+    valTemp = (valTemp << 8) + presTemp[0];
+
+    if (valTemp < 0 || valTemp > 100) {							// Present Temperature valid range: 0 - 100, outside range -> Error
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Value is outside valid range! Unexpected error!");
+        return -1;
+    }
+    return valTemp;			// Temperature value ~= Actual Temperature, 1:1 relation
+}
+
+int DXLServo::checkPresentCurrent() {
+    int address;
+    if (servoType == DXL_MX_64)  address = ADDR_MX_PRESENT_CURRENT;
+    else if (servoType == DXL_PRO_M42)   address = ADDR_PRO_PRESENT_CURRENT;
+
+    if (limitCurrent <= 0) {													// Limit should not be 0 or negative
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Limit has not been set or unexpected error has occurred!");
+        return -1;
+    }
+    else {
+        DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading Present Current");
+        uint16_t *presCur = new uint16_t;
+        dxl_comm_result = read2ByteTxRx(address, presCur);
+        if (dxl_comm_result != COMM_SUCCESS)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        }
+        else if (dxl_error != 0)
+        {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        }
+
+        DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Present Current read");
+        int current = 0;
+        current = ((current << 16) + presCur[0]) | ((current << 8) + presCur[1]);
+
+        if (current < 0) {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Value is negative! Unexpected Error!");
+            return -1;
+        }
+        else if (current >= (0.9*limitCurrent) && current < limitCurrent) {
+            DXL_LOG_WARN(identity, address, dxl_comm_result, "Warning! Current is close to limit!");
+            return 1;
+        }
+        else if (current >= limitCurrent) {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Current has exceeded limit!");
+            return 2;
+        }
+    }
+    return 0;
+}
+
+double DXLServo::getPresentCurrent() {
+    bool success = true;
+    int address, limit;
+    //double mult;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_PRESENT_CURRENT;
+        limit = 1941;
+        //mult = 0.00336;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_PRESENT_CURRENT;
+        limit = 32767;
+        //mult = 0.004028;
+    }
+
+    DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading Present Current");
+    uint16_t *presCur = new uint16_t;
+    dxl_comm_result = read2ByteTxRx(address, presCur);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Present Current read");
+        int current = 0;
+        current = ((current << 16) + presCur[0]) | ((current << 8) + presCur[1]);
+
+        if (current < 0 || current > limit) {
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "Error! Value is outside valid range! Unexpected Error!");
+            return -1;
+        }
+
+        double actCurr = static_cast<double>(current);
+        actCurr = convertValtoCurr(current);
+        //actCurr = actCurr * mult;   // Actual Current in amps
+        return actCurr;
+    }
+    return 0.0; //if problem
+}
+
+int DXLServo::getHomingOffset() {			// Read value of Homing Offset set in servo, returns direct integer value.
+    bool success = true;
+    int address;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_HOMING_OFFSET;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_HOMING_OFFSET;
+    }
+
+    DXL_LOG_DEBUG(identity, address, DXL_LOG_NONE, "Reading Homing Offset");
+    int homingOffset = 0;
+    dxl_comm_result = read4ByteTxRx(address, (uint32_t*)&homingOffset);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_DEBUG(identity, address, dxl_comm_result, "Homing Offset read");
+        homeOffset = homingOffset;
+    }
+    return homingOffset;
+}
+
+bool DXLServo::isMoving() {				// Moving check for servo, for use with write position functions to ensure subsequent write does not occur while servo still in motion.
+    int address;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_MOVING;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_MOVING;
+    }
+
+    uint8_t *move = new uint8_t;
+    dxl_comm_result = read1ByteTxRx(address, move);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    int valMove = 0;
+    valMove = (valMove << 8) + move[0];
+
+    if (valMove > 0)    return true;
+    else    return false;
+}
+
+double DXLServo::predictMoveTime(int fromPosition, int toPosition) {
+    if (!profileKnown) {                                // Once, then kept current by setProfile*()
+        uint16_t velAddress = (servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_VELOCITY : ADDR_MX_PROFILE_VELOCITY;
+        uint16_t accAddress = (servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_ACCELERATION : ADDR_MX_PROFILE_ACCELERATION;
+        DXLExpected<uint32_t> vel = tryRead(velAddress, 4);
+        DXLExpected<uint32_t> acc = tryRead(accAddress, 4);
+        if (!vel || !acc)   return 0.0;                 // Unknown profile: no prediction, check straight away
+        profileVel = int(vel.value());
+        profileAccel = int(acc.value());
+        profileKnown = true;
+    }
+    return dxlProfileTimeSec(servoType, toPosition - fromPosition, profileVel, profileAccel) + settleMarginSec;
+}
+
+void DXLServo::waitForMove(int goalPosition) {			// Replaces polling Moving back to back: one position read, a sleep, and usually a single Moving check
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    lastMoveChecks = 0;
+    double predicted = 0.0;
+    DXLExpected<int> from = tryReadCurrentPosition();  // Servo has only just started, close enough to the start of the move
+    if (from)   predicted = predictMoveTime(from.value(), goalPosition);
+
+    double sleepSec = predicted - DXL_MOVE_WAKE_LEAD_SEC;
+    if (sleepSec > 0.0)     std::this_thread::sleep_until(start + std::chrono::microseconds(int64_t(sleepSec * 1.0e6)));
+
+    bool firstCheckMoving = false;
+    for (;;) {
+        lastMoveChecks++;
+        bool moving = isMoving();
+        if (dxl_comm_result != COMM_SUCCESS)    return;  // Already logged by isMoving(), do not spin on a dead bus
+        if (!moving)    break;
+        if (lastMoveChecks == 1)    firstCheckMoving = true;
+        if ((lastMoveChecks % 30) == 0)     DXL_LOG_DEBUG(identity, DXL_LOG_NONE, dxl_comm_result, "Servo still moving...");
+        std::this_thread::sleep_for(std::chrono::milliseconds(DXL_MOVE_POLL_MS));
+    }
+
+    if (predicted <= 0.0)   return;
+    double actual = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double observedMargin = actual - (predicted - settleMarginSec);
+    if (firstCheckMoving)   settleMarginSec += 0.5 * (observedMargin - settleMarginSec);   // Woke too early, move margin towards what it took
+    else                    settleMarginSec *= 0.9;                                         // Already stopped, creep earlier to find the edge
+    settleMarginSec = std::min(std::max(settleMarginSec, 0.0), 1.0);
+}
+
+int DXLServo::convertPostoVal(double angle) {			// Convert position in degrees to integer value for transmission
+    //int factor,
+    int valuePos;
+    if (servoType == DXL_MX_64) {
+        //factor = 4096;
+        valuePos = int( (angle * (4095.0/360.0)) + 0.5);   // 0 - 360 degrees
+    }
+    else if (servoType == DXL_PRO_M42) {
+        //factor = 131593;
+        valuePos = int( (angle * (131593.0/180.0)) +0.5); // -180 - +180 degrees
+    }
+
+    return valuePos;
+}
+
+double DXLServo::convertValtoPos(int position) {		// Convert integer value from transmission to position in degrees
+    double angle;
+    if (servoType == DXL_MX_64) {
+        angle = double(position) * (360.0/4095.0);   // 0 - 4095
+    }
+    else if (servoType == DXL_PRO_M42) {
+        angle = double(position) * (180.0/131593.0); // -131,593 - +131,593
+    }
+
+    return angle;
+}
+
+int DXLServo::convertCurrtoVal(double current) {			// Convert current in amps to integer value for transmission
+    int valueCurr;
+    if (servoType == DXL_MX_64) {
+        valueCurr = int( (current/0.00336) + 0.5);   // 3.36mA units, 0 - 1941
+    }
+    else if (servoType == DXL_PRO_M42) {
+        //valueCurr = int( (current / 0.004028) + 0.5);	 // 4.028mA units, 0 - 32767, should be limited by Torque Limit
+        valueCurr = int( (current / (8250.0/2048.0)) + 0.5);	 // 4.028mA units, 0 - 32767, should be limited by Torque Limit
+    }
+
+    if (valueCurr > limitCurrent) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "ERROR! Current limit exceeded!");
+        return limitCurrent;
+    }
+    return valueCurr;
+}
+
+double DXLServo::convertValtoCurr(int value) {		// Convert integer value from transmission to current in amps
+    double current;
+    if (servoType == DXL_MX_64) {
+        current = double(value) * 0.00336;   // 3.36mA units, 0 - ~ 4 amps
+    }
+    else if (servoType == DXL_PRO_M42) {
+        //current = double(value) * 0.004028;	 // 4.028mA units, 0 - ~ 2.1 amps
+        current = double(value) * (8250.0/2048.0);	 // 4.028mA units, 0 - ~ 2.1 amps
+    }
+
+    return current;
+}
+
+int DXLServo::convertVeltoVal(double velocity) {			// Convert velocity in rpm to integer value for transmission
+    int valueVel;
+    if (servoType == DXL_MX_64) {
+        valueVel = int((velocity / 0.229) + 0.5);   // 0.229rpm units, 0 - 1023
+    }
+    else if (servoType == DXL_PRO_M42) {
+        valueVel = int((velocity / 0.00389076) + 0.5);	 // 0.00389076rpm units, 0 - 2^32, should be limited by Velocity Limit
+    }
+
+    if (valueVel > limitVel) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "ERROR! Velocity limit exceeded!");
+        return limitVel;
+    }
+    return valueVel;
+}
+
+double DXLServo::convertValtoVel(int value) {				// Convert integer value from transmission to velocity in rpm
+    double velocity;
+    if (servoType == DXL_MX_64) {
+        velocity = double(value) * 0.229;   // 0.229rpm units
+    }
+    else if (servoType == DXL_PRO_M42) {
+        velocity = double(value) * 0.00389076;	 // 0.00389076rpm units
+    }
+
+    return velocity;
+}
+
+int DXLServo::convertAcctoVal(double accel) {				// Convert acceleration in rpm2 to integer value for transmission
+    int valueAcc;
+    if (servoType == DXL_MX_64) {
+        valueAcc = int((accel / 214.577) + 0.5);   // 214.577rpm2 units, 0 - 32767
+    }
+    else if (servoType == DXL_PRO_M42) {
+        //valueAcc = int((accel / 201.039) + 0.5);	 // 201.039rpm2 units, 0 - 2^32, should be limited by Acceleration Limit
+        valueAcc = int((accel / (58000.0/288.5)) + 0.5);	 // 201.039rpm2 units, 0 - 2^32, should be limited by Acceleration Limit
+    }
+
+    if (valueAcc > limitAccel) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "ERROR! Velocity limit exceeded!");
+        return limitAccel;
+    }
+    return valueAcc;
+}
+
+double DXLServo::convertValtoAcc(int value) {			// Convert integer value from transmission to acceleration in rpm2
+    double accel;
+    if (servoType == DXL_MX_64) {
+        accel = double(value) * 214.577;   // 214.577rpm2 units
+    }
+    else if (servoType == DXL_PRO_M42) {
+        //accel = double(value) * 201.039;	 // 201.039rpm2 units
+        accel = double(value) * (58000.0/288.5);	 // 201.039rpm2 units
+    }
+
+    return accel;
+}
+
+void DXLServo::servoReboot() {
+    // Try reboot. Only for servos on Protocol 2.0.
+    // Dynamixel LED will flicker while it reboots
+    if (protocolVersion != 2.0) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Reboot only available for Protocol 2.0!\nPower down servo to reboot in Protocol 1.0!");
+        return;
+    }
+
+    dxl_comm_result = rebootTxRx();
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+}
+
+void DXLServo::selectExtPortMode(int port, int mode) {			// Inputs: port: 1 - 4, select port number; mode: 0 - 3, select port function: 0 - Analog Input mode, 1 - Output mode, 2 - Pull-up Input mode, 3 - Pull-up Output mode
+    if (servoType == DXL_MX_64) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! External Port function not available on MX servos!");
+        return;
+    }
+
+    int address;
+    switch (port) {
+    case 1: {
+        address = ADDR_PRO_EXT_PORT_MODE_1;
+        break;
+    }
+    case 2: {
+        address = ADDR_PRO_EXT_PORT_MODE_2;
+        break;
+    }
+    case 3: {
+        address = ADDR_PRO_EXT_PORT_MODE_3;
+        break;
+    }
+    case 4: {
+        address = ADDR_PRO_EXT_PORT_MODE_4;
+        break;
+    }
+    default:
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Invalid Port number selected! Choose between 1 - 4!");
+        return;
+    }
+
+    uint8_t extmode = uint8_t(mode);
+    string function;
+    switch (mode) {
+    case 0: {
+        function = "Analog Input";
+        break;
+    }
+    case 1: {
+        function = "Output";
+        break;
+    }
+    case 2: {
+        function = "Pull-up Input";
+        break;
+    }
+    case 3: {
+        function = "Pull-up Output";
+        break;
+    }
+    default:
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Invalid Mode number selected! Choose between 0 - 3!");
+        return;
+    }
+
+    dxl_comm_result = write1ByteTxRx(address, extmode);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    DXL_LOG_INFO(identity, address, dxl_comm_result, "External Port %d set to %s mode.", port, function.c_str());
+    externalPort[port - 1] = mode;
+}
+
+void DXLServo::selectExtPortModes(int mode1, int mode2, int mode3, int mode4) {		// All four External Port modes (44 - 47) in one write, modes as selectExtPortMode()
+    if (servoType == DXL_MX_64) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! External Port function not available on MX servos!");
+        return;
+    }
+
+    int mode[4] = { mode1, mode2, mode3, mode4 };
+    DXLWriteBatch batch;
+    for (int i = 0; i < 4; i++) {
+        if (mode[i] < 0 || mode[i] > 3) {
+            DXL_LOG_ERROR(identity, ADDR_PRO_EXT_PORT_MODE_1 + i, DXL_LOG_NONE, "Error! Invalid Mode number selected! Choose between 0 - 3!");
+            return;
+        }
+        batch.write(*this, uint16_t(ADDR_PRO_EXT_PORT_MODE_1 + i), 1, uint32_t(mode[i]));
+    }
+
+    if (batch.flush()) {
+        for (int i = 0; i < 4; i++)     externalPort[i] = mode[i];
+        DXL_LOG_INFO(identity, ADDR_PRO_EXT_PORT_MODE_1, dxl_comm_result, "External Ports set to modes (%d, %d, %d, %d).", mode1, mode2, mode3, mode4);
+    }
+}
+
+void DXLServo::setExtPortData(int port, int data) {				// Inputs: port: 1 - 4, select port number; data: 0 or 1, for Output and Pull-up Output Modes only, 0 for 0V, 1 for 3.3V
+    if (servoType == DXL_MX_64) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! External Port function not available on MX servos!");
+        return;
+    }
+
+    if (externalPort[port] == 0 || externalPort[port] == 3) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! External Port is in Input Mode! Read only!");
+        return;
+    }
+
+    bool success = true;
+    int address;
+    switch (port) {
+    case 1: {
+        address = ADDR_PRO_EXT_PORT_DATA_1;
+        break;
+    }
+    case 2: {
+        address = ADDR_PRO_EXT_PORT_DATA_2;
+        break;
+    }
+    case 3: {
+        address = ADDR_PRO_EXT_PORT_DATA_3;
+        break;
+    }
+    case 4: {
+        address = ADDR_PRO_EXT_PORT_DATA_4;
+        break;
+    }
+    default:
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Invalid Port number selected! Choose between 1 - 4!");
+        return;
+    }
+
+    dxl_comm_result = write2ByteTxRx(address, data);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if (success) {
+        DXL_LOG_INFO(identity, address, dxl_comm_result, "Port %i Data set to %i.", port, data);
+    }
+}
+
+int DXLServo::readExtPortData(int port) {				// Input: port: External Port select number, 1 - 4
+    if (servoType == DXL_MX_64) {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! External Port function not available on MX servos!");
+        return -1;
+    }
+
+    bool success = true;
+    int address;
+    switch (port) {
+    case 1: {
+        address = ADDR_PRO_EXT_PORT_DATA_1;
+        break;
+    }
+    case 2: {
+        address = ADDR_PRO_EXT_PORT_DATA_2;
+        break;
+    }
+    case 3: {
+        address = ADDR_PRO_EXT_PORT_DATA_3;
+        break;
+    }
+    case 4: {
+        address = ADDR_PRO_EXT_PORT_DATA_4;
+        break;
+    }
+    default:
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Invalid Port number selected! Choose between 1 - 4!");
+        return -1;
+    }
+
+    uint16_t *pass = new uint16_t;
+    dxl_comm_result = read2ByteTxRx(address, pass);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        success = false;
+    }
+
+    if(success){
+        DXL_LOG_DEBUG(identity, address, dxl_comm_result, "External Data %i read", port);
+        int extData = 0;
+        extData = ((extData << 16) + pass[0]) | ((extData << 8) + pass[1]);
+        return extData;
+    }
+
+    return 0;
+}
+
+void  DXLServo::setLED(int color, int light) {
+    int address, limit;
+    string select;
+    switch (color) {
+    case 0: {
+        address = ADDR_MX_LED;
+        limit = 1;
+        select = "Single";
+        break;
+    }
+    case 1: {
+        address = ADDR_PRO_LED_RED;
+        limit = 255;
+        select = "Red";
+        break;
+    }
+    case 2: {
+        address = ADDR_PRO_LED_GREEN;
+        limit = 255;
+        select = "Green";
+        break;
+    }
+    case 3: {
+        address = ADDR_PRO_LED_BLUE;
+        limit = 255;
+        select = "Blue";
+        break;
+    }
+    default:
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Invalid Port number selected! Choose between 1 - 4!");
+        return;
+    }
+
+    if (light > limit)		light = limit;
+    if (light < 0) {
+        DXL_LOG_ERROR(identity, address, DXL_LOG_NONE, "Error! Negative numbers not allowed!");
+        return;
+    }
+
+    uint8_t pass = uint8_t(light);
+    dxl_comm_result = write1ByteTxRx(address, pass);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    DXL_LOG_INFO(identity, address, dxl_comm_result, "%s LED set to %d", select.c_str(), light);
+}
+
+void DXLServo::setLEDColor(int red, int green, int blue) {			// Pro: all three LEDs in one write. MX: single LED on if any colour is non-zero.
+    if (servoType == DXL_MX_64) {
+        setLED(0, (red > 0 || green > 0 || blue > 0) ? 1 : 0);
+        return;
+    }
+
+    int light[3] = { red, green, blue };
+    DXLWriteBatch batch;
+    for (int i = 0; i < 3; i++) {
+        if (light[i] < 0) {
+            DXL_LOG_ERROR(identity, ADDR_PRO_LED_RED + i, DXL_LOG_NONE, "Error! Negative numbers not allowed!");
+            return;
+        }
+        if (light[i] > 255)     light[i] = 255;
+        batch.write(*this, uint16_t(ADDR_PRO_LED_RED + i), 1, uint32_t(light[i]));
+    }
+
+    if (batch.flush()) {
+        DXL_LOG_INFO(identity, ADDR_PRO_LED_RED, dxl_comm_result, "LEDs set to (%d, %d, %d)", light[0], light[1], light[2]);
+    }
+}
+
+void DXLServo::setPositionGain(int gainP, int gainI, int gainD, int gainF1, int gainF2) {			// gainI, gainD, gainF1, gainF2 default to 0, gainP required in code.
+    bool success = true;
+    if (servoType == DXL_PRO_M42) {
+        DXL_LOG_DEBUG(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Setting Position P Gain");
+        dxl_comm_result = write2ByteTxRx(ADDR_PRO_POSITION_P_GAIN, gainP);
+        if (dxl_comm_result != COMM_SUCCESS)
+        {
+            DXL_LOG_ERROR(identity, ADDR_PRO_POSITION_P_GAIN, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        }
+        else if (dxl_error != 0)
+        {
+            DXL_LOG_ERROR(identity, ADDR_PRO_POSITION_P_GAIN, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+            success = false;
+        }
+
+        if (success) {
+            DXL_LOG_INFO(identity, ADDR_PRO_POSITION_P_GAIN, dxl_comm_result, "Position P Gain set to %i", gainP);
+        }
+    }
+    else if (servoType == DXL_MX_64) {
+        int address[5] = { ADDR_MX_POSITION_P_GAIN, ADDR_MX_POSITION_I_GAIN, ADDR_MX_POSITION_D_GAIN, ADDR_MX_POSITION_FF1_GAIN, ADDR_MX_POSITION_FF2_GAIN };
+        int gain[5] = { gainP, gainI, gainD, gainF1, gainF2 };
+        //char out[5] = { 'P', 'I', 'D', 'FF1', 'FF2' };
+        char out[5] = { 'P', 'I', 'D', '1', '2' };
+
+        DXL_LOG_DEBUG(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Setting Position Gains for P, I, D, FF1st, FF2nd");
+        DXLWriteBatch batch;                    // D, I, P (80 - 85) in one packet, FF2, FF1 (88 - 91) in another, failures logged by flush()
+        for (int i = 0; i < 5; i++)     batch.write(*this, address[i], 2, uint32_t(gain[i]));
+        batch.flush();
+        for (int i = 0; i < 5; i++) {
+            if (batch.written(*this, address[i])) {
+                DXL_LOG_INFO(identity, address[i], dxl_comm_result, "Position %c Gain set to %i", out[i], gain[i]);
+            }
+        }
+    }
+    else {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Servo type undefined!");
+    }
+}
+
+void DXLServo::readPositionGain(vector<int> &setGains) {			// Input: setGains: vector of ints for the gain values read. MX will return vector of 5 ints, Pro will return vector of single int. Change to overload, if int return int, if vector return vector?
+    bool success = true;
+    //uint16_t *presGain = new uint16_t;
+    if (servoType == DXL_PRO_M42) {			// Only 1 gain value, read and store into vector once
+        DXL_LOG_DEBUG(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Setting Position P Gain");
+        uint16_t *presGain = new uint16_t;
+        dxl_comm_result = read2ByteTxRx(ADDR_PRO_POSITION_P_GAIN, presGain);
+        if (dxl_comm_result != COMM_SUCCESS)
+        {
+            DXL_LOG_ERROR(identity, ADDR_PRO_POSITION_P_GAIN, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+        }
+        else if (dxl_error != 0)
+        {
+            DXL_LOG_ERROR(identity, ADDR_PRO_POSITION_P_GAIN, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+        }
+
+        DXL_LOG_DEBUG(identity, ADDR_PRO_POSITION_P_GAIN, dxl_comm_result, "Present Current read");
+        int gainP = 0;
+        gainP = ((gainP << 16) + presGain[0]) | ((gainP << 8) + presGain[1]);
+
+        if (success) {
+            DXL_LOG_INFO(identity, ADDR_PRO_POSITION_P_GAIN, dxl_comm_result, "Position P Gain set to %i", gainP);
+            setGains.push_back(gainP);
+        }
+    }
+    else if (servoType == DXL_MX_64) {			// 5 gain values to read and store into vector
+        int address[5] = { ADDR_MX_POSITION_P_GAIN, ADDR_MX_POSITION_I_GAIN, ADDR_MX_POSITION_D_GAIN, ADDR_MX_POSITION_FF1_GAIN, ADDR_MX_POSITION_FF2_GAIN };
+        //int gain[5] = { 0, 0, 0, 0, 0 };
+        //char out[5] = { 'P', 'I', 'D', 'FF1', 'FF2' };
+        char out[5] = { 'P', 'I', 'D', '1', '2' };
+
+        DXL_LOG_DEBUG(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Setting Position Gains for P, I, D, FF1st, FF2nd");
+        for (int i = 0; i < 5; i++) {
+            uint16_t *presGain = new uint16_t;
+            dxl_comm_result = read2ByteTxRx(address[i], presGain);
+            if (dxl_comm_result != COMM_SUCCESS)
+            {
+                DXL_LOG_ERROR(identity, address[i], dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+            }
+            else if (dxl_error != 0)
+            {
+                DXL_LOG_ERROR(identity, address[i], dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+            }
+
+            //printf("Present Current read\n");
+            int gain = 0;
+            gain = ((gain << 16) + presGain[0]) | ((gain << 8) + presGain[1]);
+
+            if (success) {
+                DXL_LOG_INFO(identity, address[i], dxl_comm_result, "Position %c Gain set to %i", out[i], gain);
+                setGains.push_back(gain);
+            }
+            //presGain = 0;		// reset uint for next loop
+        }
+    }
+    else {
+        DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Servo type undefined!");
+    }
+}
+
+int DXLServo::checkShutdown(int statusBits) {
+    int address;
+    bool hardErr = false;
+    if (servoType == DXL_MX_64) {
+        address = ADDR_MX_HARDWARE_ERROR_STATUS;
+    }
+    else if (servoType == DXL_PRO_M42) {
+        address = ADDR_PRO_HARDWARE_ERROR_STATUS;
+    }
+
+    uint8_t *status = new uint8_t;
+    dxl_comm_result = read1ByteTxRx(address, status);
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getTxRxResult(dxl_comm_result));
+    }
+    else if (dxl_error != 0)
+    {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "%s", this->pktHandler->getRxPacketError(dxl_error));
+    }
+
+    int valStatus = 0;
+    valStatus = (valStatus << 8) + status[0];
+    statusBits = valStatus;
+
+    if (valStatus > 0) {
+        DXL_LOG_ERROR(identity, address, dxl_comm_result, "Hardware Error detected! Servo in Shutdown! Checking error...");
+        hardErr = true;
+    }
+    else {
+        DXL_LOG_DEBUG(identity, address, dxl_comm_result, "No error detetcted, continue.");
+        return 0;
+    }
+
+    //unsigned int statusBits = (unsigned int)status;
+    if (hardErr) {
+        if ( ( valStatus & 0x04) == 1 ) {		// bit 2 set means Overheating Error. Typical procedure is to power off and let cool. However, forums describe MX servos temperature sensor to be on pcb instead of motor so by the time the error is detected, motor is likely to have burnt out.
+            DXL_LOG_ERROR(identity, address, dxl_comm_result, "Overheating Error Detected! Do NOT reboot servo!\nDisconnect power from servo and leave for at least half hour!");
+            if(servoType == DXL_MX_64)	DXL_LOG_ERROR(identity, address, dxl_comm_result, "MX Overheat Error may mean that motor has burnt out. Replacement may be necessary.");
+            // TOADD: disable servoReboot() command for half hour. Just put thread to sleep for 30 mins?
+            return -1;
+        }
+        else {		// If not Overheat Error, can try reboot. TOADD: Identify individual errors and suggest remedies.
+            servoReboot();
+            return 1;
+        }
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////   End of DXLServo class   /////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+////////////////////
+//		29 Mar 2018 changes not yet implemented in example.
+//      21 May: Linux test
+//      7 June: MX and Pro functionality. Pro functions untested (awaiting Pro servo).
+////////////////////
+
+////////////////////////////////////////////////////    Example Code Using DXLServo functions    ///////////////////////////////////////////////////////////////////////////
+int main() {
+    // Initialize Servo objects and parameters
+
+    DXLServo panServo;								// DXLServo object 1
+    if (panServo.getDXLID() != 1) {				// Ensure Pan set to ID 1
+        panServo.setDXLID(1);
+    }
+    panServo.setDeviceName(0);						// USB port ttyUSB0
+    panServo.setDXLServo(0);                        // MX-64 servo in use
+
+    DXLServo tiltServo;								// DXLServo object 2
+    if (tiltServo.getDXLID() != 2) {				// Ensure Tilt set to ID 2
+        tiltServo.setDXLID(2);
+    }
+    tiltServo.setDeviceName(0);						// USB port ttyUSB0
+    tiltServo.setDXLServo(0);                        // MX-64 servo in use
+
+    // Open USB Port in Linux. ADD: Windows version if necessary
+    int fd = 0;
+    fd = open(panServo.deviceName.c_str(), O_CREAT | O_RDWR | O_NOCTTY | O_NDELAY);
+    //fd = open(panServo.deviceName.c_str(), O_RDWR | O_NOCTTY);
+    if (fd == -1)    cout << "unable to open USB" << endl;
+    else    cout << "USB Port Opened" << endl;
+
+    //initialize Port and Packet handlers, open port, set baudrate
+    panServo.initPortHandler();
+    panServo.initPacketHandler();
+    panServo.openPort();
+    panServo.setPortBaudRate();
+
+    // TOCHANGE: Merge all port and packet handler calls into one class as only one instance needed per U2D2, not per servo.
+    tiltServo.initPortHandler();
+    tiltServo.initPacketHandler();
+    tiltServo.openPort();
+    tiltServo.setPortBaudRate();
+
+    cout << "Ports Opened" << endl;
+
+
+    //EEPROM Write, do before enabling Torque
+    tiltServo.setOperatingMode(2);  //Set operating mode to Position Mode, internal = 3
+    tiltServo.setMaxCurrentLimit();  //Set Current Limit to internally defined max limit for each servo type; 4A for MX, 2.1A for Pro M42
+    tiltServo.set80rpmVelLimit();   // Set velocity limit to 80 rpm via internal defined value
+    int velLimit = tiltServo.getVelocityLimit();
+    cout << "Velocity Limit: " << velLimit << " rpm." << endl;
+    tiltServo.setVelocityLimit(80.0);   // Set velocity limit to 80 rpm using double conversion function
+    velLimit = tiltServo.getVelocityLimit();
+    cout << "Velocity Limit: " << velLimit << " rpm." << endl;
+    tiltServo.setlowAccelLimit();   // Set accel limit to internally defined value
+    int accLimit = tiltServo.getAccelLimit();
+    cout << "Accel Limit: " << accLimit << " rev/min2." << endl;
+    tiltServo.setAccelLimit(6400.0);    // Set accel limit to 6400 rpm2 via double conversion
+    accLimit = tiltServo.getAccelLimit();
+    cout << "Accel Limit: " << accLimit << " rev/min2." << endl;
+    //tiltServo.setCurrentLimit(3.5);    //Set current limit to 3.5A, val = 1042
+    //tiltServo.setCurrentLimit(1200);    //Set current Limit to val = 1200, 4.032A
+
+
+    // Enable Torque outputs
+    panServo.enableTorque();
+    tiltServo.enableTorque();
+    cout << "Torque Enabled" << endl;
+
+    //int pan = 0, tilt = 0;
+    int currentPanPos = 0, currentTiltPos = 0, currentPanTemp = 0, currentTiltTemp = 0, homePanOffset = 0, homeTiltOffset = 0;
+    double currentPanI = 0, currentTiltI = 0;
+    int cycle = 3;
+
+    while (cycle > 0) {
+        //printf("Press any key to continue! (or press ESC to quit!)\n");
+        //if (getch() == ESC_ASCII_VALUE) break;
+
+        // std::cout << "Hello.\nPress enter to continue." << std::endl;
+        //std::cin.get();
+        //sleep(2);
+        crossSleep(1);		// Linux, sleep 1s
+
+        // Read current Pan position and offset
+        currentPanPos = panServo.readCurrentPosition();
+        homePanOffset = panServo.getHomingOffset();
+        cout << "Pan Offset: " << homePanOffset << "." << endl;
+        double anglePan = double(currentPanPos + homePanOffset) * 0.088;
+        //double anglePan = ( (double)currentPanPos * 0.088 ) - 180 - (homePanOffset * 0.088);
+        cout << "Pan Position: " << anglePan << " degrees." << endl;
+        double angleP = panServo.readCurrentAngle();
+        cout << "Pan Angle = " << angleP << " degrees" << endl;
+
+        // Read current Tilt position and offset
+        currentTiltPos = tiltServo.readCurrentPosition();
+        homeTiltOffset = tiltServo.getHomingOffset();
+        cout << "Tilt Offset: " << homeTiltOffset << "." << endl;
+        cout << "Tilt Pos Val: " << currentTiltPos << "." << endl;
+        double angleTilt = double(currentTiltPos + homeTiltOffset) * 0.088;
+        //double angleTilt = ( (double)currentTiltPos * 0.088 ) - 180 - (homeTiltOffset * 0.088);
+        cout << "Tilt Position: " << angleTilt << " degrees." << endl;
+        double angleT = tiltServo.readCurrentAngle();
+        cout << "Tilt Angle = " << angleT << " degrees" << endl;
+
+        // Read present temperature of servo
+        currentPanTemp = panServo.getPresentTemperature();
+        cout << "Pan Temp: " << currentPanTemp << "C." << endl;
+        currentTiltTemp = tiltServo.getPresentTemperature();
+        cout << "Tilt Temp: " << currentTiltTemp << "C." << endl;
+
+        // Read present current through servo. Undefined before 1st move
+        currentPanI = panServo.getPresentCurrent();
+        cout << "Pan Current: " << std::fixed << std::setprecision(2) << currentPanI << "A." << endl;
+        currentTiltI = tiltServo.getPresentCurrent();
+        cout << "Tilt Current: " << std::fixed << std::setprecision(2) << currentTiltI << "A." << endl;
+
+        // Set Profile Acceleration and Velocity then read their respective registers
+        tiltServo.setProfileAcceleration(5);
+        int profileAccel = tiltServo.checkProfileAcceleration();
+        cout << "Profile Acc Val: " << profileAccel << " ." << endl;
+        tiltServo.setProfileVelocity(10);
+        int profileVel = tiltServo.checkProfileVelocity();
+        cout << "Profile Vel Val: " << profileVel << " ." << endl;
+
+        // Read the internal gains of the servo
+        vector<int> gains;
+        gains.clear();
+        tiltServo.readPositionGain(gains);
+        cout << "Position Gains are: P = " << gains[0] << ", I = " << gains[1] << ", D = " << gains[2] << ", FF1 = " << gains[3] << ", FF2 = " << gains[4] << "." << endl;;
+        gains.clear();
+
+        // GoalPosition function test
+        tiltServo.writeGoalPosition(1);
+        std::vector<int> tiltGoals;
+        tiltGoals.clear();
+//        tiltGoals.push_back(1830);
+//        tiltGoals.push_back(1900);
+//        tiltGoals.push_back(1700);
+        int start = 1603;
+        for(int i = 0; i < 10; i++){
+            tiltGoals.push_back(start);
+            start += 45;
+        }
+        tiltServo.addToGoalPosVector(tiltGoals);
+        int checkGPV = tiltServo.checkGoalPosVector();
+//        tiltServo.writeGoalPosition(1);
+//        //sleep(2);
+//        crossSleep(1);		// Linux, sleep 1s
+//        angleT = tiltServo.readCurrentAngle();
+//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
+//        tiltServo.writeGoalPosition(1, 2000);
+//        //sleep(2);
+//        crossSleep(1);		// Linux, sleep 1s
+//        angleT = tiltServo.readCurrentAngle();
+//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
+//        tiltServo.writeGoalPosition(0, 2);
+//        //sleep(2);
+//        crossSleep(1);		// Linux, sleep 1s
+//        angleT = tiltServo.readCurrentAngle();
+//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
+        for(int x = 0; x < 10; x++){
+            tiltServo.writeGoalPosition(x);
+            crossSleep(1);		// Linux, sleep 1s
+            angleT = tiltServo.readCurrentAngle();
+            cout << "Tilt Angle = " << angleT << " degrees" << endl;
+        }
+
+        tiltGoals.clear();
+        tiltServo.resetGoalPosVector();
+
+        //GoalAngle function test
+        vector<double> goalAngles;
+        goalAngles.clear();
+//        goalAngles.push_back(0.0);
+//        goalAngles.push_back(6.15);
+//        goalAngles.push_back(-11.43);
+        double start1 = -20.0;
+        for(int i = 0; i < 10; i++){
+            goalAngles.push_back(start1);
+            start1 += 4.0;
+        }
+        tiltServo.addToGoalAngleVect(goalAngles);
+        int checkGAV = tiltServo.checkGoalAngleVect();
+//        tiltServo.writeGoalAngle(1);
+//        crossSleep(1);
+//        angleT = tiltServo.readCurrentAngle();
+//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
+//        tiltServo.writeGoalAngle(1, 14.95);
+//        crossSleep(1);
+//        angleT = tiltServo.readCurrentAngle();
+//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
+//        tiltServo.writeGoalAngle(0, 2);
+//        crossSleep(1);
+//        angleT = tiltServo.readCurrentAngle();
+//        cout << "Tilt Angle = " << angleT << " degrees" << endl;
+        for(int x = 0; x < 10; x++){
+            tiltServo.writeGoalAngle(x);
+            crossSleep(1);		// Linux, sleep 1s
+            angleT = tiltServo.readCurrentAngle();
+            cout << "Tilt Angle = " << angleT << " degrees" << endl;
+        }
+
+        goalAngles.clear();
+        tiltServo.resetGoalAngleVect();
+
+        cycle -= 1;
+        cout << "Next Cycle" << endl << endl;
+    }
+
+    // Close DXLServo
+
+    // Clear internal position vectors
+    panServo.resetGoalPosVector();
+    tiltServo.resetGoalPosVector();
+
+    // Disable DXLs Torque outputs
+    panServo.disableTorque();
+    tiltServo.disableTorque();
+    cout << "Torque Disabled" << endl;
+
+    // Close Comms port
+    panServo.closePort();
+    tiltServo.closePort();
+    close(fd);
+    cout << "Ports Closed" << endl;
+
+    return 0;
+}
+// End of C++ Example Code using DXLServo functions
+*/
+
+// C Style code of SDK functions
+/*int main()
+{
+// Initialize PortHandler instance
+// Set the port path
+// Get methods and members of PortHandlerLinux or PortHandlerWindows
+dynamixel::PortHandler *portHandler1 = dynamixel::PortHandler::getPortHandler(DEVICENAME1);
+dynamixel::PortHandler *portHandler2 = dynamixel::PortHandler::getPortHandler(DEVICENAME2);
+
+// Initialize PacketHandler instance
+// Set the protocol version
+// Get methods and members of Protocol1PacketHandler or Protocol2PacketHandler
+dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(PROTOCOL_VERSION);
+
+int index1 = 0, index2 = 0;
+int dxl_comm_result = COMM_TX_FAIL;             // Communication result
+
+
+//CHANGE THIS WHEN TESTING ON QUICABOT!
+//int dxl_goal_position[2] = { DXL_MINIMUM_POSITION_VALUE, DXL_MAXIMUM_POSITION_VALUE };         // Goal position
+int dxl1_goal_position[5] = { 1024, 1536, 2048, 2560, 3072 };         // Goal position for Pan
+int dxl2_goal_position[6] = { 1536, 1875, 2216, 2560, 2898, 3072 };         // Goal position for Tilt
+//CHANGE THIS WHEN TESTING ON QUICABOT!
+
+uint8_t dxl_error = 0;                          // Dynamixel error
+int32_t dxl1_present_position = 0;               // Present position: Pan
+int32_t dxl2_present_position = 0;               // Present position: Tilt
+int32_t dxl1_present_current = 0;               // Present current: Pan
+int32_t dxl2_present_current = 0;               // Present current: Tilt
+int32_t dxl1_present_temperature = 0;               // Present temperature: Pan
+int32_t dxl2_present_temperature = 0;               // Present temperature: Tilt
+
+
+// Open port 1
+if (portHandler1->openPort())
+{
+printf("Succeeded to open the port!\n");
+}
+else
+{
+printf("Failed to open the port!\n");
+printf("Press any key to terminate...\n");
+_getch();
+return 0;
+}
+// Open port 2
+if (portHandler2->openPort())
+{
+printf("Succeeded to open the port!\n");
+}
+else
+{
+printf("Failed to open the port!\n");
+printf("Press any key to terminate...\n");
+_getch();
+return 0;
+}
+
+// Set port baudrate for motor 1
+if (portHandler1->setBaudRate(BAUDRATE))
+{
+printf("Succeeded to change the baudrate!\n");
+}
+else
+{
+printf("Failed to change the baudrate!\n");
+printf("Press any key to terminate...\n");
+_getch();
+return 0;
+}
+// Set port baudrate for motor 2
+if (portHandler2->setBaudRate(BAUDRATE))
+{
+printf("Succeeded to change the baudrate!\n");
+}
+else
+{
+printf("Failed to change the baudrate!\n");
+printf("Press any key to terminate...\n");
+_getch();
+return 0;
+}
+
+// Enable Dynamixel Torque for DXL 1
+dxl_comm_result = packetHandler->write1ByteTxRx(portHandler1, DXL_ID1, ADDR_MX_TORQUE_ENABLE, TORQUE_ENABLE, &dxl_error);
+if (dxl_comm_result != COMM_SUCCESS)
+{
+// printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+}
+else if (dxl_error != 0)
+{
+// printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+}
+else
+{
+printf("Dynamixel#%d has been successfully connected \n", DXL_ID1);
+}
+// Enable Dynamixel Torque for DXL 2
+dxl_comm_result = packetHandler->write1ByteTxRx(portHandler2, DXL_ID2, ADDR_MX_TORQUE_ENABLE, TORQUE_ENABLE, &dxl_error);
+if (dxl_comm_result != COMM_SUCCESS)
+{
+// printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+}
+else if (dxl_error != 0)
+{
+// printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+}
+else
+{
+printf("Dynamixel#%d has been successfully connected \n", DXL_ID2);
+}
+
+while (1)
+{
+printf("Press any key to continue! (or press ESC to quit!)\n");
+if (_getch() == ESC_ASCII_VALUE)
+break;
+
+// Write goal position to DXL1
+dxl_comm_result = packetHandler->write4ByteTxRx(portHandler1, DXL_ID1, ADDR_MX_GOAL_POSITION, dxl1_goal_position[index1], &dxl_error);
+if (dxl_comm_result != COMM_SUCCESS)
+{
+printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+}
+else if (dxl_error != 0)
+{
+printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+}
+// Write goal position to DXL2
+dxl_comm_result = packetHandler->write4ByteTxRx(portHandler2, DXL_ID2, ADDR_MX_GOAL_POSITION, dxl2_goal_position[index2], &dxl_error);
+if (dxl_comm_result != COMM_SUCCESS)
+{
+printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+}
+else if (dxl_error != 0)
+{
+printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+}
+
+do
+{
+// Read present position of DXL1
+dxl_comm_result = packetHandler->read4ByteTxRx(portHandler1, DXL_ID1, ADDR_MX_PRESENT_POSITION, (uint32_t*)&dxl1_present_position, &dxl_error);
+if (dxl_comm_result != COMM_SUCCESS)
+{
+printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+}
+else if (dxl_error != 0)
+{
+printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+}
+// Read present position of DXL2
+dxl_comm_result = packetHandler->read4ByteTxRx(portHandler2, DXL_ID2, ADDR_MX_PRESENT_POSITION, (uint32_t*)&dxl2_present_position, &dxl_error);
+if (dxl_comm_result != COMM_SUCCESS)
+{
+printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+}
+else if (dxl_error != 0)
+{
+printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+}
+
+printf("[ID:%03d] GoalPos:%03d  PresPos:%03d\t[ID:%03d] GoalPos:%03d  PresPos:%03d\n", DXL_ID1, dxl1_goal_position[index1], dxl1_present_position, DXL_ID2, dxl2_goal_position[index2], dxl2_present_position);
+
+} while ((abs(dxl1_goal_position[index1] - dxl1_present_position) > DXL_MX_MOVING_STATUS_THRESHOLD) || (abs(dxl2_goal_position[index2] - dxl2_present_position) > DXL_MX_MOVING_STATUS_THRESHOLD));
+
+// Change goal position: Pan
+if ( index1 >= 0 && index1 < ( sizeof dxl1_goal_position / sizeof *dxl1_goal_position ) )
+{
+index1 += 1;
+}
+else
+{
+index1 = 0;
+}
+// Change goal position: Tilt
+if ( index2 >= 0 && index2 < (sizeof dxl2_goal_position / sizeof *dxl2_goal_position))
+{
+index2 += 1;
+}
+else
+{
+index2 = 0;
+}
+}
+
+// Disable Dynamixel Torqueof DXL1
+dxl_comm_result = packetHandler->write1ByteTxRx(portHandler1, DXL_ID1, ADDR_MX_TORQUE_ENABLE, TORQUE_DISABLE, &dxl_error);
+if (dxl_comm_result != COMM_SUCCESS)
+{
+printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+}
+else if (dxl_error != 0)
+{
+printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+}
+// Disable Dynamixel Torqueof DXL2
+dxl_comm_result = packetHandler->write1ByteTxRx(portHandler2, DXL_ID2, ADDR_MX_TORQUE_ENABLE, TORQUE_DISABLE, &dxl_error);
+if (dxl_comm_result != COMM_SUCCESS)
+{
+printf("%s\n", packetHandler->getTxRxResult(dxl_comm_result));
+}
+else if (dxl_error != 0)
+{
+printf("%s\n", packetHandler->getRxPacketError(dxl_error));
+}
+
+// Close port DXL1
+portHandler1->closePort();
+// Close port DXL2
+portHandler2->closePort();
+
+return 0;
+}
+// End of C style code
+*/
+
@@ -1,420 +1,627 @@
-#pragma once
-
-/*///////////////////////////////////////////////////////////////////////////////
-Created by: Sayyed Omar Kamal
-Date: 8 June 2018
-
-For Dynamixel Pro servos, based on MX-64 servo control. Basic C++ function calls working properly in Linux. 
-*////////////////////////////////////////////////////////////////////////////////
-
-#if defined(__linux__) || defined(__APPLE__)
-#include <fcntl.h>
-#include <termios.h>
-#include <unistd.h>
-#include <errno.h>
-#define STDIN_FILENO 0
-#elif defined(_WIN32) || defined(_WIN64)
-#include <conio.h>
-#endif
-
-#include <algorithm>
-#include <vector>
-#include <string>
-#include <iostream>
-#include <iomanip>
-#include <sstream>
-#include <cmath>
-
-#include <stdlib.h>
-#include <stdio.h>
-#include <cstdio>
-//#include <time.h>
-//#include <chrono>
-//#include <thread>
-
-#include "dynamixel_sdk/dynamixel_sdk.h"                                // Uses Dynamixel SDK library
-
-// Control table address
-//EEPROM
-
-#define ADDR_MX_ID						7
-#define ADDR_PRO_ID                         7
-
-#define ADDR_MX_BAUD_RATE				8
-#define ADDR_PRO_BAUD_RATE                  8
-
-#define ADDR_MX_OPERATING_MODE			11
-#define ADDR_PRO_OPERATING_MODE             11
-
-#define ADDR_MX_PROTOCOL_VERSION		13
-// Pro servos fixed at Protocol 2.0
-
-#define ADDR_MX_HOMING_OFFSET   		20
-#define ADDR_PRO_HOMING_OFFSET              13
-
-#define ADDR_MX_MOVING_THRESHOLD   		24
-#define ADDR_PRO_MOVING_THRESHOLD           17
-
-#define ADDR_MX_TEMPERATURE_LIMIT		31
-#define ADDR_PRO_TEMPERATURE_LIMIT          21
-
-// Voltage supplied with fixed dc-dc converter, no need to alter voltage limits
-// MX only: PWM not in use for now, not adding
-
-#define ADDR_MX_CURRENT_LIMIT			38
-#define ADDR_PRO_TORQUE_LIMIT               30  //Pro uses Torque as current limit
-
-#define ADDR_MX_ACCELERATION_LIMIT		40
-#define ADDR_PRO_ACCELERATION_LIMIT         26
-
-#define ADDR_MX_VELOCITY_LIMIT			44
-#define ADDR_PRO_VELOCITY_LIMIT             32
-
-#define ADDR_MX_MAX_POSITION_LIMIT		48
-#define ADDR_MX_MIN_POSITION_LIMIT		52
-#define ADDR_PRO_MAX_POSITION_LIMIT         36
-#define ADDR_PRO_MIN_POSITION_LIMIT         40
-
-// Pro only
-#define ADDR_PRO_EXT_PORT_MODE_1            44
-#define ADDR_PRO_EXT_PORT_MODE_2            45
-#define ADDR_PRO_EXT_PORT_MODE_3            46
-#define ADDR_PRO_EXT_PORT_MODE_4            47
-
-#define ADDR_MX_SHUTDOWN    			63
-#define ADDR_PRO_SHUTDOWN                   48
-
-// Pro Indirect Address would be here, not in use at moment so not added
-
-//RAM
-#define ADDR_MX_TORQUE_ENABLE			64
-#define ADDR_PRO_TORQUE_ENABLE              562
-
-#define ADDR_MX_LED         			65
-#define ADDR_PRO_LED_RED                    563
-#define ADDR_PRO_LED_GREEN                  564
-#define ADDR_PRO_LED_BLUE                   565
-
-#define ADDR_MX_STATUS_RETURN_LEVEL		65
-#define ADDR_PRO_STATUS_RETURN_LEVEL		891
-
-// Read only
-#define ADDR_MX_REGISTERED_INSTRUCTION  69
-#define ADDR_PRO_REGISTERED_INSTRUCTION		890
-
-// Read only
-#define ADDR_MX_HARDWARE_ERROR_STATUS	70
-#define ADDR_PRO_HARDWARE_ERROR_STATUS      892
-
-// Velocity (I,P) Gains not implemented yet
-// Position Gains (MX:D,I,P,FF2,FF1; Pro:P)
-#define ADDR_MX_POSITION_D_GAIN			80
-#define ADDR_MX_POSITION_I_GAIN			82
-#define ADDR_MX_POSITION_P_GAIN			84
-#define ADDR_MX_POSITION_FF2_GAIN		88
-#define ADDR_MX_POSITION_FF1_GAIN		90
-#define ADDR_PRO_POSITION_P_GAIN		    594
-
-// MX only: Bus Watchdog not in use currently
-// MX only: Goal PWM not in use currently
-
-#define ADDR_MX_GOAL_CURRENT   			102
-#define ADDR_PRO_GOAL_TORQUE                604
-
-#define ADDR_MX_GOAL_VELOCITY  			104
-#define ADDR_PRO_GOAL_VELOCITY              600
-
-// Profile vars for MX only
-#define ADDR_MX_PROFILE_ACCELERATION	108
-#define ADDR_MX_PROFILE_VELOCITY		112
-
-#define ADDR_MX_GOAL_POSITION			116
-#define ADDR_PRO_GOAL_POSITION              596
-
-// MX only: Realtime Tick not in use currently
-
-#define ADDR_PRO_GOAL_ACCELERATION          606
-
-// Read only
-#define ADDR_MX_MOVING					122
-#define ADDR_PRO_MOVING                     610
-
-// MX only
-#define ADDR_MX_MOVING_STATUS			123
-
-// All Present Registers are read-only
-#define ADDR_MX_PRESENT_CURRENT			126
-#define ADDR_PRO_PRESENT_CURRENT			621
-
-#define ADDR_MX_PRESENT_VELOCITY		128
-#define ADDR_PRO_PRESENT_VELOCITY			615
-
-#define ADDR_MX_PRESENT_POSITION		132
-#define ADDR_PRO_PRESENT_POSITION			611
-
-// MX only: Velocity and Position Trajectory not in use currently
-// Present Input Voltage not in use currently
-
-#define ADDR_MX_PRESENT_TEMPERATURE		146
-#define ADDR_PRO_PRESENT_TEMPERATURE		625
-
-// Pro only
-#define ADDR_PRO_EXT_PORT_DATA_1            626
-#define ADDR_PRO_EXT_PORT_DATA_2            628
-#define ADDR_PRO_EXT_PORT_DATA_3            630
-#define ADDR_PRO_EXT_PORT_DATA_4            632
-
-// Indirect Data not in use currently
-
-// Default settings
-// Protocol version
-#define PROTOCOL_VERSION                2.0                 // Using Protocol 2.0
-//Servo specific values
-#define DXL_ID1                                 1                   // Dynamixel1 ID, Pan Servo
-#define DXL_ID2                                 2                   // Dynamixel2 ID, Tilt Servo
-#define DXL_BAUDRATE_57600                      1                   // Baudrate set value for 57600 baud, default baudrate
-
-// Operating Mode Values
-#define DXL_MX_CURRENT_CONTROL_MODE             0                   // Operating Mode set value for Current Control Mode for MX
-#define DXL_PRO_TORQUE_CONTROL_MODE             0                   // Operating Mode set value for Torque Control Mode for Pro
-#define DXL_VELOCITY_CONTROL_MODE               1					// Operating Mode set value for Velocity Control Mode
-#define DXL_POSITION_CONTROL_MODE               3					// Operating Mode set value for Position Control (Single turn) Mode
-#define DXL_EXTENDED_CONTROL_MODE               4					// Operating Mode set value for Extended Position Control (Multi turn) Mode
-#define DXL_MX_CURRENT_POSITION_CONTROL_MODE	5					// Operating Mode set value for Current-based Position Control Mode for MX only
-#define DXL_MX_PWM_CONTROL_MODE                 16					// Operating Mode set value for PWM Control Mode for MX only
-
-//Parameter Limits precalculated values
-#define DXL_MX_CURRENT_LIMIT_MAX                 1190				// Current Limit set value for 4 Amps maximum, MX-64R stall current: 4.1A at 12V
-#define DXL_MX_ACCELERATION_LIMIT_LOW			30					// Acceleration Limit set value for 6437 rev/min2 maximum, MX
-#define DXL_MX_VELOCITY_LIMIT_80				350					// Velocity Limit set value for 80.15 rpm maximum, MX
-#define DXL_PRO_M42_TORQUE_LIMIT_MAX                    521             // Torque limit for Pro M42, using current, absolute max at ~5.7Nm = 2.16A, use 2.1A
-#define DXL_PRO_M42_VELOCITY_LIMIT_80                  20562            // Velocity limit for Pro M42, 80 rpm
-#define DXL_PRO_M42_ACCEL_LIMIT_LOW                     30              // Acceleration limit for Pro M42, 6031 rpm2
-
-//General servo data values
-#define TORQUE_ENABLE                       1                   // Value for enabling the torque
-#define TORQUE_DISABLE                      0                   // Value for disabling the torque
-#define PROFILE_ACCELERATION_MAX            15					// Limiting value to ensure DXL does not accelerate too quickly, causing following error
-#define PROFILE_MX_VELOCITY_MAX             200					// Limiting value to ensure DXL does not turn too quickly, causing following error
-#define PROFILE_PRO_VELOCITY_MAX                2570
-#define DXL_MX_MOVING_STATUS_THRESHOLD      10                  // Dynamixel moving status threshold
-#define DXL_PRO_MOVING_STATUS_THRESHOLD         50
-
-//Values for system commands
-#define BAUDRATE                        57600				//For use in code, not to set DXL Baudrate
-#if defined(__linux__) || defined(__APPLE__)
-#define DEVICENAME1                      "/dev/ttyUSB1"
-#elif defined(_WIN32) || defined(_WIN64)
-#define DEVICENAME1                      "COM1"				// Check which port is being used on each servo
-// ex) Windows: "COM1"   Linux: "/dev/ttyUSB0" Mac: "/dev/tty.usbserial-*"
-#endif
-#define ESC_ASCII_VALUE                 0x1b
-
-//DXL Servo type defines
-#define DXL_MX_64                 0
-#define DXL_PRO_M42               1
-
-class DXLServo {
-private:
-    std::vector<int> goalPositionVector;
-    std::vector<double> goalAngleVector;
-    int   limitAccel, limitVel, profileAccel, profileVel, limitCurrent, limitPosMin, limitPosMax, homeOffset;
-    int externalPort[4];		// External Port Mode indicator. Ports 1 - 4, modes 0 - 3. E.g. externalPort[0] = 1; -> extrenal port 1 set to output mode.
-
-protected:
-
-public:
-    DXLServo();
-    ~DXLServo();
-
-    double protocolVersion;
-    uint8_t dxl_error;
-    int dxl_comm_result, baudRate, identity, servoType;
-    int present_position, present_temperature;
-    double present_current;
-
-    dynamixel::PortHandler *prtHandler;
-    dynamixel::PacketHandler *pktHandler;
-
-    //std::string deviceName = std::string( "/dev/ttyUSB" );
-#if defined(__linux__) || defined(__APPLE__)
-    std::string deviceName = std::string("/dev/ttyUSB");
-#elif defined(_WIN32) || defined(_WIN64)
-    std::string deviceName = std::string("COM");
-#endif
-
-    void setDXLServo(int servoModel) {
-        if (servoModel == 0)		servoType = DXL_MX_64;
-        else if (servoModel == 1)   servoType = DXL_PRO_M42;
-        else    printf("Error! Invalid Servo selected! Select '0' for MX-64 or '1' for Pro M42!");
-    }
-
-    void setDXLID(int dxlNum) {
-        identity = dxlNum;
-    }
-
-    int getDXLID() {								// get DXL ID set in code memory
-        return identity;
-    }
-
-    void setDeviceName() {							// If default ID used, COM1 or /dev/ttyUSB1
-        std::stringstream sstm;
-        sstm << deviceName << 1;
-        deviceName = sstm.str();
-    }
-
-    void setDeviceName(int deviceNum) {				// For multi DXL ID
-        std::stringstream sstm;
-        sstm << deviceName << deviceNum;
-        deviceName = sstm.str();
-    }
-
-    void initPortHandler() {
-        this->prtHandler = dynamixel::PortHandler::getPortHandler(deviceName.c_str());
-    }
-
-    void setProtocolVersion(double protocolNum) {				// Set Protocol 1.0 or 2.0
-        protocolVersion = protocolNum;
-    }
-
-    void initPacketHandler() {
-        this->pktHandler = dynamixel::PacketHandler::getPacketHandler(protocolVersion);
-    }
-
-    void openPort() {			// Open comms port to DXL
-        if (this->prtHandler->openPort())
-        {
-            printf("Succeeded to open the port!\n");
-        }
-        else
-        {
-            printf("Failed to open the port!\n");
-            //printf("Press any key to terminate...\n");
-            //_getch();
-        }
-    }
-
-    void setDeviceBaudRate(int desiredRate) {
-        baudRate = desiredRate;
-    }
-
-    void closePort() {
-        this->prtHandler->closePort();
-    }
-
-    void setPortBaudRate() {
-        if (this->prtHandler->setBaudRate(baudRate))
-        {
-            printf("Succeeded to change the baudrate!\n");
-        }
-        else
-        {
-            printf("Failed to change the baudrate!\n");
-            //printf("Press any key to terminate...\n");
-            //_getch();
-            //return 0;
-        }
-    }
-    void enableTorque();													// Enable servo motion. Must be set for servo to operate. Changes to EEPROM registers must be applied before calling this.
-    void disableTorque();													// Disable servo motion. Call at end of use.
-
-    // GoalPos functions use Position values for direct transmission
-    void addToGoalPosVector(const std::vector<int> &posVector);					// Add Position values into internal vector. Uses std::vector<int> as input. CHANGE to int[], more common?
-    //void addToGoalPosVector(int posVector[]);
-    void addToGoalPosVector(int posVector) {									// Add 1 Position value to internal vector. Use in for loop with int array data.
-        goalPositionVector.push_back(posVector);
-    }
-    int checkGoalPosVector();												// Check internal Position Vector for empty vector or invalid values
-    void resetGoalPosVector() {												// Reset internal Position Vector for new values if needed
-        goalPositionVector.clear();
-    }
-    void writeGoalPosition(int vectorPosition);							// Write Goal Position to DXL from internal GoalPos Vector
-    void writeGoalPosition(int select, int vectorPosition);				// Write Goal Position to DXL directly or from internal Goal Position Vector; int select = {0 -> from internal vector, 1 -> direct}
-    int readCurrentPosition();											// Read Position value from servo, position value does not include homing offset
-    int getCurrentGoalPos(int index) {										// Read value of position in internal Goal Position vector, assumes user already knows size of vector
-        return goalPositionVector[index];
-    }
-
-    // GoalAngle functions use angle as inputs, require conversion to Position values for transmission
-    double readCurrentAngle();											// Read Position value and convert to angle, angle value includes homing offset, assumes initial read acquired
-    void addToGoalAngleVect(const std::vector<double> &angVector);				// Add angle values into internal vector. Angle values depend on servo used (e.g. MX-64: 0-360 deg, Pro: -180 to 180).
-    //void addToGoalAngleVect(double angVector[]);
-    void addToGoalAngleVect(double angVector) {							// Add 1 Angle into internal vector. Use in for loop with double array data.
-        goalAngleVector.push_back(angVector);
-    }
-    int checkGoalAngleVect();											// Check internal vector for empty vector
-    void resetGoalAngleVect() {											// Reset internal Angle Vector for new values if needed
-        goalAngleVector.clear();
-    }
-    void writeGoalAngle(int vectorAngle);								// Write Goal Angle to DXL from internal GoalAngle Vector
-    void writeGoalAngle(int select, double vectorAngle);					// Write Goal Angle to DXL directly or from internal Goal Angle Vector; int select = {0 -> from internal vector, 1 -> direct}, conversion to Position value handled, includes home offset
-    int getCurrentGoalAngle(int index) {								// Read value of angle in internal Goal Angle vector, assumes user already knows size of vector
-        return goalAngleVector[index];
-    }
-
-    int checkOperating();									// Return value of Operating Mode; 0 = Current control, 1 = Velocity control, 3 = Position control (single turn), 4 = Extended Position control (Multi-turn), 5 = Current-based Position control, 16 = PWN control
-    int checkPositionMode();								// Check if Operating Mode is set to Position Control (Single Turn). Returns 1 if yes, 0 if other control modes, -1 if error.
-    void setOperatingMode(int mode);						// Change DXL Operating Mode; mode selection values 0-5, 0 = Current, 1 = Velocity, 2 = Position (single turn), 3 = Extended Position(Multi turn), 4 = Current based Position, 5 = PWM
-
-    void setMaxCurrentLimit();								// Set current limit to max Amps before stall torque occurs, value predefined in header
-    void setCurrentLimit(double amps);                      // Set current limit between 0 - servo limit. MX-64: 4.0 A, Pro M42: 0 - 2.1 A
-    void setCurrentLimit(int limit);                        // Set current limit between 0 - 1941, current = limit * 3.36mA {externally calculated}
-
-    void set80rpmVelLimit();								// Set Velocity limit to 80.15 rpm, value predefined in header
-    void setVelocityLimit(int limit);						// Set Velocity limit between 0 - 1023, velocity = limit * 0.229rpm {externally calculated}
-    void setVelocityLimit(double limit);					// Set Velocity limit between 0 - 235.0 rpm
-    int getVelocityLimit();                                 // Return Velocity Limit set in DXL
-
-    void setlowAccelLimit();								// Set Acceleration limit to 30 * 214.577 = 6437 rev/min2, value predefined in header
-    void setAccelLimit(int limit);							// Set Acceleration limit between 0 - 100, limited to 100 as actual limit is far too large for safe operation.
-    void setAccelLimit(double limit);						// Set Acceleration limit between 0 - (100 * unit), limited to 100 times for safe operation
-    int getAccelLimit();                                    // Return Acceleration Limit set in DXL. Value multiply 214.517rev/mim2.
-
-    void setPositionLimit(bool minMax, int position);		// Set Position Limit; minMax: false for Min (Lower) limit, true for Max (Upper) limit; Position between 0 and limit
-    void setPositionLimit(bool minMax, double angle);		// Set Position Limit; minMax: false for Min (Lower) limit, true for Max (Upper) limit; angle between 0 to 360 or -180 and +180 degrees, see servo type
-
-    void setProfileAcceleration(int accel);					// Set Profile Acceleration, accel must be between 1 and limit set in EEPROM, 0 not allowed so no infinite acceleration. Accel value in integer for direct transmission.
-    void setProfileAcceleration(double accel);				// Set Profile Acceleration, accel must be between 1.0 and limit, 0 not allowed so no infinite acceleration. Acceleration in rev/min2 to be converted for transmission.
-    int checkProfileAcceleration();							// Check value of Profile Acceleration in DXL RAM, return int, conversion available.
-    void setProfileVelocity(int vel);						// Set Profile Velocity, vel must be between 1 and limit set in EEPROM, 0 not allowed so no infinite velocity, Velocity value in integer for direct transmission.
-    void setProfileVelocity(double vel);					// Set Profile Velocity, vel must be between 1.0 and (limit * unit) set in EEPROM, 0 not allowed so no infinite velocity, Velocity in rpm to be converted for transmission
-    int checkProfileVelocity();								// Check value of Profile Velocity in DXL RAM. Value multiply 0.229rpm
-
-    int checkPresentTemperature();							// Check Present Temperature, compare against limit, issues warning at 10% from limit and at or above limit. Returns: -1 if negative error, 0 if no problem, 1 if close to limit, 2 if exceed limit.
-    int getPresentTemperature();							// Return Present Temperature value, for displaying value externally
-
-    int checkPresentCurrent();								// Check Present Current, compare against limit, warning at 10% from limit, error at/beyond limit. Returns: -1 if negative error, 0 if no problem, 1 if close to limit, 2 if exceed limit.
-    double getPresentCurrent();								// Return Present Current value, for displaying externally
-
-    int getHomingOffset();                                  // Return Homing Offset value
-
-    bool isMoving();                                        // Check if servo is moving after write command
-
-    int convertPostoVal(double angle);                      // Convert input angle (desired position) into Position value for transmission
-    double convertValtoPos(int position);                   // Convert Position value from transmission into output angle
-
-    int convertCurrtoVal(double current);					// Convert input current (amps) into Current value for transmission
-    double convertValtoCurr(int value);						// Convert Current value from transmission into output current
-
-    int convertVeltoVal(double velocity);					// Convert input velocity (rpm) into Velocity value for transmission
-    double convertValtoVel(int value);						// Convert Velocity value from transmission into output velocity
-
-    int convertAcctoVal(double accel);						// Convert input acceleration (rev/min2) into Acceleration value for transmission
-    double convertValtoAcc(int value);						// Convert Acceleration value from transmission into output acceleration
-
-    void servoReboot();										// Call when servo shuts down due to error to reactivate. Reactivates servo and prints error message with details of last occurred error.
-
-    // Pro servos only
-    void selectExtPortMode(int port, int mode);				// Select mode for External Ports 1-4, "port" to select port number, "mode" to select function. port: 1 - 4, mode: 0 - 3.
-    void setExtPortData(int port, int data);				// For External Port output modes (1,3), set output to 0V or 3.3V.
-    int readExtPortData(int port);							// Read value of External Port Datas.
-
-    void  setLED(int color, int light);						// Activate or deactivate LED/s. MX servos, single LED. Pro servos, (r,g,b) LEDs. "color": 0 for MX single LED, (1,2,3) for Pro (Red, Green, Blue) LED. "light": MX: 0 off, 1 on; Pro: 0 - 255 intensity.
-
-    void setPositionGain(int gainP, int gainI = 0, int gainD = 0, int gainF1 = 0, int gainF2 = 0);						// Set Position Gains for servo motors. Pro servos only have variable P gain, MX servos have (P,I,D,FF1,FF2)
-    void readPositionGain(vector<int> &setGains);			// Read Position Gains currently set in registers, store in vector<int>. MX: 5 gain values. Pro: 1 gain value.
-
-    int checkShutdown(int statusBits);				// Check Hardware Error Status register for Shutdown condition. If Shutdown detected and not Overheating Error, try reboot. If Overheating Error, disable servo, warn user to disconnect motor for at least half hour.
-
-};
-
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Created by: Sayyed Omar Kamal
+Date: 8 June 2018
+
+For Dynamixel Pro servos, based on MX-64 servo control. Basic C++ function calls working properly in Linux. 
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <errno.h>
+#define STDIN_FILENO 0
+#elif defined(_WIN32) || defined(_WIN64)
+#include <conio.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <cstdio>
+//#include <time.h>
+//#include <chrono>
+//#include <thread>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"                                // Uses Dynamixel SDK library
+#include "DXLBusStats.h"                                                // Latency histograms and result counters for packet calls
+#include "DXLTrace.h"                                                   // Chrome trace-event recording of packet calls
+#include "DXLLog.h"                                                     // Leveled async logging, all DXLServo output goes through this
+#include "DXLResult.h"                                                  // DXLExpected/DXLError results for try*() calls
+#include "DXLRetryPolicy.h"                                             // Retry, learned timeout and circuit breaker for packet calls
+#include "DXLPortHandlerLinux.h"                                        // Low latency serial port (Linux only)
+#include "DXLPortHandlerUring.h"                                        // io_uring serial port (Linux only)
+#include "DXLPacket.h"                                                  // Native Protocol 2.0 packet codec and PacketHandler
+#include "DXLBusScheduler.h"                                            // Priority arbitration of packet calls between threads
+#include "DXLSeqlock.h"                                                 // Lock-free publishing of latest servo state to reader threads
+#include "DXLClockSync.h"                                               // Servo Realtime Tick to host clock mapping
+#include "DXLStateEstimator.h"                                          // Kalman position/velocity/acceleration estimate between reads
+
+// Control table address
+//EEPROM
+
+#define ADDR_MX_ID						7
+#define ADDR_PRO_ID                         7
+
+#define ADDR_MX_BAUD_RATE				8
+#define ADDR_PRO_BAUD_RATE                  8
+
+#define ADDR_MX_OPERATING_MODE			11
+#define ADDR_PRO_OPERATING_MODE             11
+
+#define ADDR_MX_PROTOCOL_VERSION		13
+// Pro servos fixed at Protocol 2.0
+
+#define ADDR_MX_HOMING_OFFSET   		20
+#define ADDR_PRO_HOMING_OFFSET              13
+
+#define ADDR_MX_MOVING_THRESHOLD   		24
+#define ADDR_PRO_MOVING_THRESHOLD           17
+
+#define ADDR_MX_TEMPERATURE_LIMIT		31
+#define ADDR_PRO_TEMPERATURE_LIMIT          21
+
+// Voltage supplied with fixed dc-dc converter, no need to alter voltage limits
+// MX only: PWM not in use for now, not adding
+
+#define ADDR_MX_CURRENT_LIMIT			38
+#define ADDR_PRO_TORQUE_LIMIT               30  //Pro uses Torque as current limit
+
+#define ADDR_MX_ACCELERATION_LIMIT		40
+#define ADDR_PRO_ACCELERATION_LIMIT         26
+
+#define ADDR_MX_VELOCITY_LIMIT			44
+#define ADDR_PRO_VELOCITY_LIMIT             32
+
+#define ADDR_MX_MAX_POSITION_LIMIT		48
+#define ADDR_MX_MIN_POSITION_LIMIT		52
+#define ADDR_PRO_MAX_POSITION_LIMIT         36
+#define ADDR_PRO_MIN_POSITION_LIMIT         40
+
+// Pro only
+#define ADDR_PRO_EXT_PORT_MODE_1            44
+#define ADDR_PRO_EXT_PORT_MODE_2            45
+#define ADDR_PRO_EXT_PORT_MODE_3            46
+#define ADDR_PRO_EXT_PORT_MODE_4            47
+
+#define ADDR_MX_SHUTDOWN    			63
+#define ADDR_PRO_SHUTDOWN                   48
+
+// Pro Indirect Address would be here, not in use at moment so not added
+
+//RAM
+#define ADDR_MX_TORQUE_ENABLE			64
+#define ADDR_PRO_TORQUE_ENABLE              562
+
+#define ADDR_MX_LED         			65
+#define ADDR_PRO_LED_RED                    563
+#define ADDR_PRO_LED_GREEN                  564
+#define ADDR_PRO_LED_BLUE                   565
+
+#define ADDR_MX_STATUS_RETURN_LEVEL		68
+#define ADDR_PRO_STATUS_RETURN_LEVEL		891
+
+// Read only
+#define ADDR_MX_REGISTERED_INSTRUCTION  69
+#define ADDR_PRO_REGISTERED_INSTRUCTION		890
+
+// Read only
+#define ADDR_MX_HARDWARE_ERROR_STATUS	70
+#define ADDR_PRO_HARDWARE_ERROR_STATUS      892
+
+// Velocity (I,P) Gains not implemented yet
+// Position Gains (MX:D,I,P,FF2,FF1; Pro:P)
+#define ADDR_MX_POSITION_D_GAIN			80
+#define ADDR_MX_POSITION_I_GAIN			82
+#define ADDR_MX_POSITION_P_GAIN			84
+#define ADDR_MX_POSITION_FF2_GAIN		88
+#define ADDR_MX_POSITION_FF1_GAIN		90
+#define ADDR_PRO_POSITION_P_GAIN		    594
+
+// MX only: Bus Watchdog not in use currently
+// MX only: Goal PWM not in use currently
+
+#define ADDR_MX_GOAL_CURRENT   			102
+#define ADDR_PRO_GOAL_TORQUE                604
+
+#define ADDR_MX_GOAL_VELOCITY  			104
+#define ADDR_PRO_GOAL_VELOCITY              600
+
+// Profile vars for MX only
+#define ADDR_MX_PROFILE_ACCELERATION	108
+#define ADDR_MX_PROFILE_VELOCITY		112
+
+#define ADDR_MX_GOAL_POSITION			116
+#define ADDR_PRO_GOAL_POSITION              596
+
+// MX only: Realtime Tick, 1ms per count, wraps after 32767. Read with present values for clock sync, see readTimedPosition()
+#define ADDR_MX_REALTIME_TICK			120
+
+#define ADDR_PRO_GOAL_ACCELERATION          606
+
+// Read only
+#define ADDR_MX_MOVING					122
+#define ADDR_PRO_MOVING                     610
+
+// MX only
+#define ADDR_MX_MOVING_STATUS			123
+
+// All Present Registers are read-only
+#define ADDR_MX_PRESENT_CURRENT			126
+#define ADDR_PRO_PRESENT_CURRENT			621
+
+#define ADDR_MX_PRESENT_VELOCITY		128
+#define ADDR_PRO_PRESENT_VELOCITY			615
+
+#define ADDR_MX_PRESENT_POSITION		132
+#define ADDR_PRO_PRESENT_POSITION			611
+
+// MX only: Velocity and Position Trajectory not in use currently
+// Present Input Voltage not in use currently
+
+#define ADDR_MX_PRESENT_TEMPERATURE		146
+#define ADDR_PRO_PRESENT_TEMPERATURE		625
+
+// Pro only
+#define ADDR_PRO_EXT_PORT_DATA_1            626
+#define ADDR_PRO_EXT_PORT_DATA_2            628
+#define ADDR_PRO_EXT_PORT_DATA_3            630
+#define ADDR_PRO_EXT_PORT_DATA_4            632
+
+// Indirect Data not in use currently
+
+// Default settings
+// Protocol version
+#define PROTOCOL_VERSION                2.0                 // Using Protocol 2.0
+//Servo specific values
+#define DXL_ID1                                 1                   // Dynamixel1 ID, Pan Servo
+#define DXL_ID2                                 2                   // Dynamixel2 ID, Tilt Servo
+#define DXL_BAUDRATE_57600                      1                   // Baudrate set value for 57600 baud, default baudrate
+
+// Operating Mode Values
+#define DXL_MX_CURRENT_CONTROL_MODE             0                   // Operating Mode set value for Current Control Mode for MX
+#define DXL_PRO_TORQUE_CONTROL_MODE             0                   // Operating Mode set value for Torque Control Mode for Pro
+#define DXL_VELOCITY_CONTROL_MODE               1					// Operating Mode set value for Velocity Control Mode
+#define DXL_POSITION_CONTROL_MODE               3					// Operating Mode set value for Position Control (Single turn) Mode
+#define DXL_EXTENDED_CONTROL_MODE               4					// Operating Mode set value for Extended Position Control (Multi turn) Mode
+#define DXL_MX_CURRENT_POSITION_CONTROL_MODE	5					// Operating Mode set value for Current-based Position Control Mode for MX only
+#define DXL_MX_PWM_CONTROL_MODE                 16					// Operating Mode set value for PWM Control Mode for MX only
+
+//Parameter Limits precalculated values
+#define DXL_MX_CURRENT_LIMIT_MAX                 1190				// Current Limit set value for 4 Amps maximum, MX-64R stall current: 4.1A at 12V
+#define DXL_MX_ACCELERATION_LIMIT_LOW			30					// Acceleration Limit set value for 6437 rev/min2 maximum, MX
+#define DXL_MX_VELOCITY_LIMIT_80				350					// Velocity Limit set value for 80.15 rpm maximum, MX
+#define DXL_PRO_M42_TORQUE_LIMIT_MAX                    521             // Torque limit for Pro M42, using current, absolute max at ~5.7Nm = 2.16A, use 2.1A
+#define DXL_PRO_M42_VELOCITY_LIMIT_80                  20562            // Velocity limit for Pro M42, 80 rpm
+#define DXL_PRO_M42_ACCEL_LIMIT_LOW                     30              // Acceleration limit for Pro M42, 6031 rpm2
+
+//General servo data values
+#define TORQUE_ENABLE                       1                   // Value for enabling the torque
+#define TORQUE_DISABLE                      0                   // Value for disabling the torque
+#define PROFILE_ACCELERATION_MAX            15					// Limiting value to ensure DXL does not accelerate too quickly, causing following error
+#define PROFILE_MX_VELOCITY_MAX             200					// Limiting value to ensure DXL does not turn too quickly, causing following error
+#define PROFILE_PRO_VELOCITY_MAX                2570
+#define DXL_MX_MOVING_STATUS_THRESHOLD      10                  // Dynamixel moving status threshold
+#define DXL_PRO_MOVING_STATUS_THRESHOLD         50
+#define DXL_MOVE_SETTLE_INITIAL_SEC         0.02                // Starting guess, profile end to Moving clear. Learned per servo afterwards.
+#define DXL_MOVE_WAKE_LEAD_SEC              0.005               // Wake this long before predicted arrival for first Moving check
+#define DXL_MOVE_POLL_MS                    5                   // Moving check interval once predicted arrival has passed
+#define DXL_PREDICT_HORIZON_US              100000              // predictPosition() extrapolates at most this far past the sample
+
+//Values for system commands
+#define BAUDRATE                        57600				//For use in code, not to set DXL Baudrate
+#if defined(__linux__) || defined(__APPLE__)
+#define DEVICENAME1                      "/dev/ttyUSB1"
+#elif defined(_WIN32) || defined(_WIN64)
+#define DEVICENAME1                      "COM1"				// Check which port is being used on each servo
+// ex) Windows: "COM1"   Linux: "/dev/ttyUSB0" Mac: "/dev/tty.usbserial-*"
+#endif
+#define ESC_ASCII_VALUE                 0x1b
+
+//DXL Servo type defines
+#define DXL_MX_64                 0
+#define DXL_PRO_M42               1
+
+//Port backend defines
+#define DXL_PORT_SDK              0                 // SDK PortHandler
+#define DXL_PORT_LOW_LATENCY      1                 // DXLPortHandlerLinux, falls back to SDK off Linux
+#define DXL_PORT_IO_URING         2                 // DXLPortHandlerUring, falls back to read/write without io_uring, to SDK off Linux
+
+//Packet backend defines
+#define DXL_PACKET_SDK            0                 // SDK PacketHandler
+#define DXL_PACKET_NATIVE         1                 // DXLPacketHandler, Protocol 2.0 only, SDK used for 1.0
+
+struct DXLServoState {                                                          // Latest present values, published by every successful read that covers them
+    int32_t position, velocity, current;                                        // Raw register values, signed
+    uint8_t temperature, moving, hardwareError;
+    uint64_t positionUs, velocityUs, currentUs, temperatureUs, movingUs, hardwareErrorUs;   // DXLBusStats::nowUs() of the read each came from, 0 never read
+    uint64_t timeUs;                                                            // Newest of the above
+    uint64_t updates;                                                           // Reads published so far
+    uint64_t txUs, rxUs;                                                        // Latest read: before its instruction went out, after its status arrived
+    uint64_t sampleUs;                                                          // Latest read: estimated host time the servo took the values, see DXLClockSync
+    uint64_t positionSampleUs;                                                  // sampleUs of the read position came from
+    int32_t tick;                                                               // MX Realtime Tick of the latest read covering it, -1 never read
+};
+
+struct DXLTimedSample {                                                         // readTimedPosition() result
+    int32_t position, velocity;                                                 // Raw register values
+    int32_t tick;                                                               // Realtime Tick, -1 on Pro
+    uint64_t txUs, rxUs, sampleUs;                                              // As DXLServoState
+};
+
+class DXLServo {
+private:
+    std::vector<int> goalPositionVector;
+    std::vector<double> goalAngleVector;
+    const int32_t *goalSource;                  // External goal positions (mapped trajectory column) used instead of goalPositionVector, 0 if none
+    size_t goalSourceCount;
+    int goalSourceMin, goalSourceMax;           // Range of goalSource, known by its owner
+    int   limitAccel, limitVel, profileAccel, profileVel, limitCurrent, limitPosMin, limitPosMax, homeOffset;
+    bool  limitAccelKnown, limitVelKnown;                                           // Limit written through this object, getters report 0 until then
+    int externalPort[4];		// External Port Mode indicator. Ports 1 - 4, modes 0 - 3. E.g. externalPort[0] = 1; -> extrenal port 1 set to output mode.
+
+    bool busInstrumented() const {                                                  // True if stats or trace want packet calls timed
+        return DXLBusStats::instance().isEnabled() || DXLTrace::instance().isEnabled();
+    }
+    void recordTxRx(uint8_t instruction, uint16_t address, uint16_t length, uint64_t startUs, uint64_t endUs, int result, uint8_t error);     // Hand finished packet call to DXLBusStats and DXLTrace
+
+    DXLRetryPolicy retryPolicy[DXL_OP_CLASSES];                                     // Per operation class, see opClassFor()
+    DXLRttEstimator rttEstimator;                                                   // Learned latency beyond wire time, used once adaptive timeout enabled
+    DXLCircuitBreaker breaker;                                                      // Fails calls fast while this ID does not respond
+    DXLTimeoutPort *timeoutPort;                                                    // Wrapper around prtHandler set by enableAdaptiveTimeout(), 0 if not used
+    int lastAttempts;                                                               // Packets sent by last call
+
+    int portBackend;                                                                // DXL_PORT_SDK, DXL_PORT_LOW_LATENCY or DXL_PORT_IO_URING
+    int packetBackend;                                                              // DXL_PACKET_SDK or DXL_PACKET_NATIVE
+#if defined(__linux__)
+    DXLPortOptions portOptions;
+#endif
+
+    int txRxOnce(uint8_t instruction, uint16_t address, uint16_t length, void *data, uint32_t value, uint8_t &error);     // Single SDK call, no retry
+    DXLError executeTxRx(uint8_t instruction, uint16_t address, uint16_t length, void *data, uint32_t value);  // Breaker check, retries, learned timeout and instrumentation around txRxOnce()
+    DXLError runTxRx(uint8_t instruction, uint16_t address, uint16_t length, void *data, uint32_t value, int priority = -1);   // executeTxRx() directly, or as bus scheduler job if one is set. priority: DXL_PRIO_*, -1 busPriorityFor()
+    int keepResult(const DXLError &status);                                         // Outcome into dxl_comm_result/dxl_error/lastAttempts for the legacy calls, returns comm
+    DXLError readValue(uint16_t address, uint16_t length, uint32_t &value);         // length 1, 2 or 4, members untouched
+
+    DXLBusScheduler *busScheduler;                                                  // 0: packet calls run on calling thread
+    DXLError lastError(uint16_t address) const;
+
+    bool profileKnown;                                                              // profileVel/profileAccel match the servo's registers
+    double settleMarginSec;                                                         // Learned time from predicted profile end to Moving clear
+    int lastMoveChecks;                                                             // Moving reads spent by last waitForMove()
+
+    DXLSeqlock<DXLServoState> stateSlot;                                            // See getState()
+    DXLClockSync clockSync;                                                         // Fed by publishState() from reads covering Realtime Tick
+    DXLStateEstimator estimator;                                                    // Fed by publishState() and goal writes while enabled, bus thread only
+    DXLSeqlock<DXLStateEstimator> estimatorSlot;                                    // Copy published after every update, see estimateState()
+    bool estimatorEnabled;
+    bool readTiming;                                                                // Stamp every read for clock sync and sample times, see enableReadTiming()
+    void noteWrite(uint16_t address, uint16_t length, const uint8_t *data, uint32_t value, uint64_t atUs);    // Goal/profile registers written, keeps profile and estimator current
+    void waitForMove(int goalPosition);                                             // Sleep until shortly before predicted arrival, then confirm with isMoving()
+    size_t goalPositionCount() const { return goalSource ? goalSourceCount : goalPositionVector.size(); }
+    int goalPositionAt(size_t index) const { return goalSource ? int(goalSource[index]) : goalPositionVector[index]; }
+
+protected:
+
+public:
+    DXLServo();
+    ~DXLServo();
+
+    double protocolVersion;
+    uint8_t dxl_error;
+    int dxl_comm_result, baudRate, identity, servoType;
+    int present_position, present_temperature;
+    double present_current;
+
+    dynamixel::PortHandler *prtHandler;
+    dynamixel::PacketHandler *pktHandler;
+
+    // Instrumented packet calls. All reads/writes to this servo go through these, set dxl_comm_result and dxl_error, return dxl_comm_result. Timed into DXLBusStats/DXLTrace when enabled.
+    // These members, and every call that reports through them, belong to one thread per servo. Threads sharing a servo through a bus
+    // scheduler use the try*() calls, whose results come back with their own job.
+    int read1ByteTxRx(uint16_t address, uint8_t *data);
+    int read2ByteTxRx(uint16_t address, uint16_t *data);
+    int read4ByteTxRx(uint16_t address, uint32_t *data);
+    int readBlockTxRx(uint16_t address, uint16_t length, uint8_t *data);        // Consecutive registers in one packet, little endian as on the servo
+    int write1ByteTxRx(uint16_t address, uint8_t data);
+    int write2ByteTxRx(uint16_t address, uint16_t data);
+    int write4ByteTxRx(uint16_t address, uint32_t data);
+    int writeBlockTxRx(uint16_t address, uint16_t length, const uint8_t *data);  // Consecutive registers in one packet, see DXLWriteBatch for coalescing
+    int rebootTxRx();
+
+    // Published state. Every successful read covering Present Position/Velocity/Current/Temperature, Moving or Hardware Error Status
+    // (single register getters, block reads, publishState() from group reads) updates one seqlock slot. Any thread can take a
+    // consistent, timestamped copy without locking or bus traffic. present_position/present_current/present_temperature are kept
+    // for old code but are plain members, unsafe to read while another thread polls.
+    DXLServoState getState() const { return stateSlot.read(); }
+    bool tryGetState(DXLServoState &state) const { return stateSlot.tryRead(state); }      // Wait-free single attempt, false if a write overlapped
+    uint32_t stateWrites() const { return stateSlot.writes(); }                             // Changes whenever new values are published
+    void publishState(uint16_t address, uint16_t length, const uint8_t *data, uint64_t txUs = 0, uint64_t rxUs = 0);   // Registers from address, little endian as on the servo. For group reads done outside DXLServo, times around the read (0: now).
+
+    // Latency compensation. Once read timing is on (enableReadTiming(), readTimedPosition() or the state estimator), every read is stamped
+    // with host tx/rx times; on MX, reads covering Realtime Tick also sync the servo clock to the host's, which pins down when within that
+    // window the values were taken. predictPosition() carries the last sample forward with its velocity, so a controller acting on it does
+    // not lag by the bus round trip. Times are DXLBusStats::nowUs(). Off, reads cost no clock reads beyond the one publishing takes.
+    void enableReadTiming(bool enable = true) { readTiming = enable; }
+    DXLExpected<DXLTimedSample> readTimedPosition();                                // One read: MX Realtime Tick to Present Position (16 bytes), Pro Present Position and Velocity. Turns read timing on.
+    double predictPosition(uint64_t atUs) const;                                    // Raw position at atUs from published state, up to DXL_PREDICT_HORIZON_US past the sample
+    double predictAngle(uint64_t atUs) const;                                       // Degrees including homing offset, as readCurrentAngle()
+    const DXLClockSync &getClockSync() const { return clockSync; }
+
+    // State estimation. Once enabled, every published position/velocity read and every goal written (with the profile known,
+    // see setProfileVelocity()/setProfileAcceleration()) goes into a Kalman filter. estimateState() gives smooth position, velocity
+    // and acceleration at any time from any thread, so a controller can run at its own rate on sparse position-only reads.
+    void enableStateEstimator(const DXLEstimatorNoise &noise = DXLEstimatorNoise());
+    void disableStateEstimator() { estimatorEnabled = false; }
+    DXLStateEstimate estimateState(uint64_t atUs) const { return estimatorSlot.read().estimate(atUs); }     // Raw units: counts, counts/s, counts/s2
+    void noteGoal(int goalPosition, int velocityValue, int accelValue, uint64_t atUs);  // Goal and profile written outside DXLServo (group writes)
+
+    // Retry and timeout policy. Defaults: telemetry/control 2 attempts, config 3 attempts with backoff; breaker opens after 3 timeouts for 0.5s, doubling to 8s.
+    DXLOpClass opClassFor(uint16_t address);                                        // Operation class of register for this servo type
+    void setRetryPolicy(DXLOpClass opClass, const DXLRetryPolicy &policy);
+    DXLRetryPolicy getRetryPolicy(DXLOpClass opClass) const { return retryPolicy[opClass]; }
+    void enableAdaptiveTimeout();                                                   // Call after initPortHandler(). Replaces SDK packet timeout with one learned from round trips.
+    void configureCircuitBreaker(int failures, int openMs, int maxOpenMs);          // Consecutive timeouts before ID marked dead, first open period, longest open period
+    bool isServoDead() const { return breaker.isOpen(); }                           // true while calls to this ID fail fast with DXL_COMM_CIRCUIT_OPEN
+    void resetCircuitBreaker() { breaker.reset(); }
+    int getLastAttempts() const { return lastAttempts; }                            // Of the last call reporting through dxl_comm_result
+    double getSmoothedLatencyUs() const { return rttEstimator.smoothedUs(); }       // Learned latency beyond wire time
+
+    // Result-returning calls. Fail with DXLError instead of printing and returning sentinel values. The result, error byte and attempts
+    // are those of this call's own packets; dxl_comm_result/dxl_error/getLastAttempts() are left alone, so any thread may use them.
+    DXLExpected<uint32_t> tryRead(uint16_t address, uint16_t length);              // length 1, 2 or 4
+    DXLExpected<void> tryWrite(uint16_t address, uint16_t length, uint32_t value);
+    DXLExpected<int> tryReadCurrentPosition();
+    DXLExpected<double> tryGetPresentCurrent();
+    DXLExpected<int> tryGetPresentTemperature();
+    DXLExpected<bool> tryIsMoving();
+    DXLExpected<void> tryWriteGoalPosition(int position);
+
+    // Bus arbitration. With a scheduler set, packet calls queue by priority: goal/setpoint writes are control, present values telemetry,
+    // EEPROM and RAM setting reads (gains, limits) configuration. Calls still block the caller until done.
+    void setBusScheduler(DXLBusScheduler *scheduler) { busScheduler = scheduler; }
+    DXLBusScheduler *getBusScheduler() const { return busScheduler; }
+    int busPriorityFor(uint8_t instruction, uint16_t address);                      // DXL_PRIO_* used for a packet call to this register
+    void emergencyStop();                                                           // Torque off at emergency priority, ahead of every queued call
+
+    //std::string deviceName = std::string( "/dev/ttyUSB" );
+#if defined(__linux__) || defined(__APPLE__)
+    std::string deviceName = std::string("/dev/ttyUSB");
+#elif defined(_WIN32) || defined(_WIN64)
+    std::string deviceName = std::string("COM");
+#endif
+
+    void setDXLServo(int servoModel) {
+        if (servoModel == 0)		servoType = DXL_MX_64;
+        else if (servoModel == 1)   servoType = DXL_PRO_M42;
+        if (servoModel == 0)        limitPosMin = 0, limitPosMax = 4095;            // Full range of the model until setPositionLimit()
+        else if (servoModel == 1)   limitPosMin = -131593, limitPosMax = 131593;
+        else    DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Invalid Servo selected! Select '0' for MX-64 or '1' for Pro M42!");
+    }
+
+    void setDXLID(int dxlNum) {
+        identity = dxlNum;
+    }
+
+    int getDXLID() {								// get DXL ID set in code memory
+        return identity;
+    }
+
+    void setDeviceName() {							// If default ID used, COM1 or /dev/ttyUSB1
+        std::stringstream sstm;
+        sstm << deviceName << 1;
+        deviceName = sstm.str();
+    }
+
+    void setDeviceName(int deviceNum) {				// For multi DXL ID
+        std::stringstream sstm;
+        sstm << deviceName << deviceNum;
+        deviceName = sstm.str();
+    }
+
+    void setPortBackend(int backend) {              // DXL_PORT_SDK, DXL_PORT_LOW_LATENCY or DXL_PORT_IO_URING, call before initPortHandler()
+        portBackend = backend;
+    }
+
+#if defined(__linux__)
+    void setPortOptions(const DXLPortOptions &options) {     // Low latency backend settings, call before initPortHandler()
+        portOptions = options;
+    }
+#endif
+
+    void initPortHandler() {
+#if defined(__linux__)
+        if (portBackend == DXL_PORT_LOW_LATENCY) {
+            this->prtHandler = new DXLPortHandlerLinux(deviceName.c_str(), portOptions);
+            return;
+        }
+        if (portBackend == DXL_PORT_IO_URING) {
+            this->prtHandler = new DXLPortHandlerUring(deviceName.c_str(), portOptions);
+            return;
+        }
+#endif
+        this->prtHandler = dynamixel::PortHandler::getPortHandler(deviceName.c_str());      // SDK handler, also fallback off Linux
+    }
+
+    void setProtocolVersion(double protocolNum) {				// Set Protocol 1.0 or 2.0
+        protocolVersion = protocolNum;
+    }
+
+    void setPacketBackend(int backend) {            // DXL_PACKET_SDK or DXL_PACKET_NATIVE, call before initPacketHandler()
+        packetBackend = backend;
+    }
+
+    void initPacketHandler() {
+        if (packetBackend == DXL_PACKET_NATIVE && protocolVersion == 2.0) {
+            static DXLPacketHandler nativeHandler;  // Shared like the SDK's handler, keeps a receive ring per port
+            this->pktHandler = &nativeHandler;
+            return;
+        }
+        this->pktHandler = dynamixel::PacketHandler::getPacketHandler(protocolVersion);
+    }
+
+    void openPort() {			// Open comms port to DXL
+        if (this->prtHandler->openPort())
+        {
+            DXL_LOG_INFO(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Succeeded to open the port %s!", deviceName.c_str());
+        }
+        else
+        {
+            DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Failed to open the port %s!", deviceName.c_str());
+            //printf("Press any key to terminate...\n");
+            //_getch();
+        }
+    }
+
+    void setDeviceBaudRate(int desiredRate) {
+        baudRate = desiredRate;
+    }
+
+    void closePort() {
+        this->prtHandler->closePort();
+    }
+
+    void setPortBaudRate() {
+        if (this->prtHandler->setBaudRate(baudRate))
+        {
+            DXL_LOG_INFO(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Succeeded to change the baudrate!");
+        }
+        else
+        {
+            DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Failed to change the baudrate!");
+            //printf("Press any key to terminate...\n");
+            //_getch();
+            //return 0;
+        }
+    }
+    void enableTorque();													// Enable servo motion. Must be set for servo to operate. Changes to EEPROM registers must be applied before calling this.
+    void disableTorque();													// Disable servo motion. Call at end of use.
+
+    // GoalPos functions use Position values for direct transmission
+    void addToGoalPosVector(const std::vector<int> &posVector);					// Add Position values into internal vector. Uses std::vector<int> as input. CHANGE to int[], more common?
+    //void addToGoalPosVector(int posVector[]);
+    void addToGoalPosVector(int posVector) {									// Add 1 Position value to internal vector. Use in for loop with int array data.
+        if (goalSource) {
+            DXL_LOG_ERROR(identity, DXL_LOG_NONE, DXL_LOG_NONE, "Error! Goal positions come from an external source, reset first!");
+            return;
+        }
+        goalPositionVector.push_back(posVector);
+    }
+    int checkGoalPosVector();												// Check internal Position Vector for empty vector or values outside position limits, all of them logged
+    void resetGoalPosVector() {												// Reset internal Position Vector for new values if needed, drops an external source too
+        goalPositionVector.clear();
+        goalSource = 0, goalSourceCount = 0;
+    }
+    // Use count positions owned by the caller (e.g. a mapped DXLTrajectoryFile column) in place of the internal vector, no copy.
+    // Must outlive their use; min/maxPosition is their range, checked by checkGoalPosVector() instead of scanning them.
+    void useGoalPositions(const int32_t *positions, size_t count, int minPosition, int maxPosition);
+    void writeGoalPosition(int vectorPosition);							// Write Goal Position to DXL from internal GoalPos Vector
+    void writeGoalPosition(int select, int vectorPosition);				// Write Goal Position to DXL directly or from internal Goal Position Vector; int select = {0 -> from internal vector, 1 -> direct}
+    int readCurrentPosition();											// Read Position value from servo, position value does not include homing offset
+    int getCurrentGoalPos(int index) {										// Read value of position in internal Goal Position vector, assumes user already knows size of vector
+        return goalPositionAt(index);
+    }
+
+    // GoalAngle functions use angle as inputs, require conversion to Position values for transmission
+    double readCurrentAngle();											// Read Position value and convert to angle, angle value includes homing offset, assumes initial read acquired
+    void addToGoalAngleVect(const std::vector<double> &angVector);				// Add angle values into internal vector. Angle values depend on servo used (e.g. MX-64: 0-360 deg, Pro: -180 to 180).
+    //void addToGoalAngleVect(double angVector[]);
+    void addToGoalAngleVect(double angVector) {							// Add 1 Angle into internal vector. Use in for loop with double array data.
+        goalAngleVector.push_back(angVector);
+    }
+    int checkGoalAngleVect();											// Check internal vector for empty vector or angles outside position limits once converted, all of them logged
+    void resetGoalAngleVect() {											// Reset internal Angle Vector for new values if needed
+        goalAngleVector.clear();
+    }
+    void writeGoalAngle(int vectorAngle);								// Write Goal Angle to DXL from internal GoalAngle Vector
+    void writeGoalAngle(int select, double vectorAngle);					// Write Goal Angle to DXL directly or from internal Goal Angle Vector; int select = {0 -> from internal vector, 1 -> direct}, conversion to Position value handled, includes home offset
+    int getCurrentGoalAngle(int index) {								// Read value of angle in internal Goal Angle vector, assumes user already knows size of vector
+        return goalAngleVector[index];
+    }
+
+    int checkOperating();									// Return value of Operating Mode; 0 = Current control, 1 = Velocity control, 3 = Position control (single turn), 4 = Extended Position control (Multi-turn), 5 = Current-based Position control, 16 = PWN control
+    int checkPositionMode();								// Check if Operating Mode is set to Position Control (Single Turn). Returns 1 if yes, 0 if other control modes, -1 if error.
+    void setOperatingMode(int mode);						// Change DXL Operating Mode; mode selection values 0-5, 0 = Current, 1 = Velocity, 2 = Position (single turn), 3 = Extended Position(Multi turn), 4 = Current based Position, 5 = PWM
+
+    void setMaxCurrentLimit();								// Set current limit to max Amps before stall torque occurs, value predefined in header
+    void setCurrentLimit(double amps);                      // Set current limit between 0 - servo limit. MX-64: 4.0 A, Pro M42: 0 - 2.1 A
+    void setCurrentLimit(int limit);                        // Set current limit between 0 - 1941, current = limit * 3.36mA {externally calculated}
+
+    void set80rpmVelLimit();								// Set Velocity limit to 80.15 rpm, value predefined in header
+    void setVelocityLimit(int limit);						// Set Velocity limit between 0 - 1023, velocity = limit * 0.229rpm {externally calculated}
+    void setVelocityLimit(double limit);					// Set Velocity limit between 0 - 235.0 rpm
+    int getVelocityLimit();                                 // Return Velocity Limit set in DXL
+
+    void setlowAccelLimit();								// Set Acceleration limit to 30 * 214.577 = 6437 rev/min2, value predefined in header
+    void setAccelLimit(int limit);							// Set Acceleration limit between 0 - 100, limited to 100 as actual limit is far too large for safe operation.
+    void setAccelLimit(double limit);						// Set Acceleration limit between 0 - (100 * unit), limited to 100 times for safe operation
+    int getAccelLimit();                                    // Return Acceleration Limit set in DXL. Value multiply 214.517rev/mim2.
+
+    void setPositionLimit(bool minMax, int position);		// Set Position Limit; minMax: false for Min (Lower) limit, true for Max (Upper) limit; Position between 0 and limit
+    void setPositionLimit(bool minMax, double angle);		// Set Position Limit; minMax: false for Min (Lower) limit, true for Max (Upper) limit; angle between 0 to 360 or -180 and +180 degrees, see servo type
+
+    void setProfileAcceleration(int accel);					// Set Profile Acceleration, accel must be between 1 and limit set in EEPROM, 0 not allowed so no infinite acceleration. Accel value in integer for direct transmission.
+    void setProfileAcceleration(double accel);				// Set Profile Acceleration, accel must be between 1.0 and limit, 0 not allowed so no infinite acceleration. Acceleration in rev/min2 to be converted for transmission.
+    int checkProfileAcceleration();							// Check value of Profile Acceleration in DXL RAM, return int, conversion available.
+    void setProfileVelocity(int vel);						// Set Profile Velocity, vel must be between 1 and limit set in EEPROM, 0 not allowed so no infinite velocity, Velocity value in integer for direct transmission.
+    void setProfileVelocity(double vel);					// Set Profile Velocity, vel must be between 1.0 and (limit * unit) set in EEPROM, 0 not allowed so no infinite velocity, Velocity in rpm to be converted for transmission
+    int checkProfileVelocity();								// Check value of Profile Velocity in DXL RAM. Value multiply 0.229rpm
+
+    int checkPresentTemperature();							// Check Present Temperature, compare against limit, issues warning at 10% from limit and at or above limit. Returns: -1 if negative error, 0 if no problem, 1 if close to limit, 2 if exceed limit.
+    int getPresentTemperature();							// Return Present Temperature value, for displaying value externally
+
+    int checkPresentCurrent();								// Check Present Current, compare against limit, warning at 10% from limit, error at/beyond limit. Returns: -1 if negative error, 0 if no problem, 1 if close to limit, 2 if exceed limit.
+    double getPresentCurrent();								// Return Present Current value, for displaying externally
+
+    int getHomingOffset();                                  // Return Homing Offset value
+    int getCurrentLimitSetting() const { return limitCurrent; }     // Current/Torque limit last set through this object, 0 if never set. No bus access.
+    int getPositionLimitSetting(bool minMax) const { return minMax ? limitPosMax : limitPosMin; }   // Position limit last set through this object (default full range of the model). No bus access.
+    int getVelocityLimitSetting() const { return limitVelKnown ? limitVel : 0; }        // Velocity Limit value last set through this object, 0 if never set. No bus access.
+    int getAccelLimitSetting() const { return limitAccelKnown ? limitAccel : 0; }       // Acceleration Limit value last set through this object, 0 if never set. No bus access.
+    double countsPerSecPerUnit() const;                             // Velocity register unit (limit, profile, present) in position values per second
+    double countsPerSec2PerUnit() const;                            // Acceleration register unit in position values per second2
+
+    bool isMoving();                                        // Check if servo is moving after write command
+    double predictMoveTime(int fromPosition, int toPosition);   // Seconds from goal write to Moving clear, from profile registers and learned settle margin
+    void invalidateProfileCache() { profileKnown = false; }     // Profile registers written outside setProfile*(), e.g. by group writes
+    int getLastMoveChecks() const { return lastMoveChecks; }
+
+    int convertPostoVal(double angle);                      // Convert input angle (desired position) into Position value for transmission
+    double convertValtoPos(int position);                   // Convert Position value from transmission into output angle
+
+    int convertCurrtoVal(double current);					// Convert input current (amps) into Current value for transmission
+    double convertValtoCurr(int value);						// Convert Current value from transmission into output current
+
+    int convertVeltoVal(double velocity);					// Convert input velocity (rpm) into Velocity value for transmission
+    double convertValtoVel(int value);						// Convert Velocity value from transmission into output velocity
+
+    int convertAcctoVal(double accel);						// Convert input acceleration (rev/min2) into Acceleration value for transmission
+    double convertValtoAcc(int value);						// Convert Acceleration value from transmission into output acceleration
+
+    void servoReboot();										// Call when servo shuts down due to error to reactivate. Reactivates servo and prints error message with details of last occurred error.
+
+    // Pro servos only
+    void selectExtPortMode(int port, int mode);				// Select mode for External Ports 1-4, "port" to select port number, "mode" to select function. port: 1 - 4, mode: 0 - 3.
+    void selectExtPortModes(int mode1, int mode2, int mode3, int mode4);	// Select modes for all four External Ports in one write. mode: 0 - 3 as selectExtPortMode().
+    void setExtPortData(int port, int data);				// For External Port output modes (1,3), set output to 0V or 3.3V.
+    int readExtPortData(int port);							// Read value of External Port Datas.
+
+    void  setLED(int color, int light);						// Activate or deactivate LED/s. MX servos, single LED. Pro servos, (r,g,b) LEDs. "color": 0 for MX single LED, (1,2,3) for Pro (Red, Green, Blue) LED. "light": MX: 0 off, 1 on; Pro: 0 - 255 intensity.
+    void setLEDColor(int red, int green, int blue);			// Set Pro (r,g,b) LEDs in one write, 0 - 255 each. MX: single LED on if any colour non-zero.
+
+    void setPositionGain(int gainP, int gainI = 0, int gainD = 0, int gainF1 = 0, int gainF2 = 0);						// Set Position Gains for servo motors. Pro servos only have variable P gain, MX servos have (P,I,D,FF1,FF2)
+    void readPositionGain(std::vector<int> &setGains);			// Read Position Gains currently set in registers, store in vector<int>. MX: 5 gain values. Pro: 1 gain value.
+
+    int checkShutdown(int statusBits);				// Check Hardware Error Status register for Shutdown condition. If Shutdown detected and not Overheating Error, try reboot. If Overheating Error, disable servo, warn user to disconnect motor for at least half hour.
+
+};
+
@@ -0,0 +1,74 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Result types for DXLServo calls that can fail on the bus.
+
+DXLExpected<T> holds either a value or a DXLError, similar to std::expected<T, DXLError> (C++23) without needing it.
+Use with DXLServo::try*() functions instead of the sentinel returns (-1, 0.0) of the older getters.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+
+#define DXL_COMM_CIRCUIT_OPEN           -9100           // Not sent: ID marked dead by circuit breaker, call failed fast. Outside SDK COMM_* range.
+#define DXL_COMM_INVALID_VALUE          -9101           // Not sent: value read back was outside valid range for the register
+#define DXL_COMM_MOTION_TIMEOUT         -9102           // Bus fine, servo still moving when wait for completion gave up
+#define DXL_COMM_OUT_OF_RANGE           -9103           // Target outside the servo's position limits: not sent, or sent clamped where the call says so
+
+struct DXLError {
+    int comm;                                           // COMM_* result of last attempt, or DXL_COMM_* above. COMM_SUCCESS if failure came from status packet error byte.
+    uint8_t packetError;                                // Status packet error byte of last attempt, 0 if none
+    uint8_t id;                                         // Servo ID addressed
+    uint16_t address;                                   // First register of the failed call
+    int attempts;                                       // Packets sent before giving up, 0 if circuit breaker refused
+
+    DXLError() : comm(0), packetError(0), id(0), address(0), attempts(0) {}
+    DXLError(int commResult, uint8_t error, uint8_t servoId, uint16_t addr, int tries)
+        : comm(commResult), packetError(error), id(servoId), address(addr), attempts(tries) {}
+
+    bool isTimeout() const          { return comm == COMM_RX_TIMEOUT; }
+    bool isCircuitOpen() const      { return comm == DXL_COMM_CIRCUIT_OPEN; }
+    bool isHardwareAlert() const    { return (packetError & 0x80) != 0; }   // Servo reports Hardware Error Status set, check checkShutdown()
+    std::string describe() const {                                          // One line summary for logs
+        char text[128];
+        snprintf(text, sizeof(text), "[ID:%03d] addr %d: comm %d, error 0x%02X after %d attempt(s)", int(id), int(address), comm, int(packetError), attempts);
+        return std::string(text);
+    }
+};
+
+template <typename T>
+class DXLExpected {
+private:
+    bool ok;
+    T val;
+    DXLError err;
+
+public:
+    DXLExpected(const T &value) : ok(true), val(value), err() {}
+    DXLExpected(const DXLError &error) : ok(false), val(), err(error) {}
+
+    bool hasValue() const           { return ok; }
+    explicit operator bool() const  { return ok; }
+    const T &value() const          { return val; }                         // Only meaningful if hasValue()
+    const T &operator*() const      { return val; }
+    T valueOr(const T &fallback) const { return ok ? val : fallback; }
+    const DXLError &error() const   { return err; }                         // Only meaningful if !hasValue()
+};
+
+template <>
+class DXLExpected<void> {
+private:
+    bool ok;
+    DXLError err;
+
+public:
+    DXLExpected() : ok(true), err() {}
+    DXLExpected(const DXLError &error) : ok(false), err(error) {}
+
+    bool hasValue() const           { return ok; }
+    explicit operator bool() const  { return ok; }
+    const DXLError &error() const   { return err; }
+};
@@ -0,0 +1,135 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Retry, adaptive timeout and circuit breaking for DXLServo packet calls. See DXLRetryPolicy.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLRetryPolicy.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+
+////////////////////////////////////////////////////   DXLRttEstimator   /////////////////////////////////////////////////////////////////////////////////////////
+
+void DXLRttEstimator::observe(double excessUs) {
+    if (excessUs < 0.0)     excessUs = 0.0;
+    if (samples == 0) {
+        srttUs = excessUs;
+        rttvarUs = excessUs / 2.0;
+    }
+    else {
+        rttvarUs = 0.75 * rttvarUs + 0.25 * fabs(srttUs - excessUs);
+        srttUs = 0.875 * srttUs + 0.125 * excessUs;
+    }
+    samples++;
+}
+
+double DXLRttEstimator::timeoutMs(double wireUs, int attempt, const DXLRetryPolicy &policy) const {
+    if (!policy.adaptiveTimeout || samples < 4)     return 0.0;     // Too few samples, let SDK choose
+
+    double timeout = (wireUs + srttUs + 4.0 * rttvarUs) / 1000.0;
+    for (int i = 1; i < attempt; i++)   timeout *= policy.timeoutGrowth;
+    if (timeout < policy.minTimeoutMs)  timeout = policy.minTimeoutMs;
+    if (timeout > policy.maxTimeoutMs)  timeout = policy.maxTimeoutMs;
+    return timeout;
+}
+
+////////////////////////////////////////////////////   DXLCircuitBreaker   /////////////////////////////////////////////////////////////////////////////////////////
+
+void DXLCircuitBreaker::configure(int threshold, uint64_t openUs, uint64_t maxOpenUs) {
+    failureThreshold = (threshold > 0) ? threshold : 1;
+    baseOpenPeriodUs = openUs;
+    maxOpenPeriodUs = (maxOpenUs > openUs) ? maxOpenUs : openUs;
+    openPeriodUs = baseOpenPeriodUs;
+}
+
+bool DXLCircuitBreaker::allow(uint64_t nowUs) {
+    if (state == 0)     return true;
+    if (state == 1 && nowUs >= openUntilUs) {           // Open period over, let one probe through
+        state = 2;
+        return true;
+    }
+    return false;                                       // Open, or half open with probe already in flight
+}
+
+void DXLCircuitBreaker::onSuccess() {
+    state = 0;
+    consecutiveFailures = 0;
+    openPeriodUs = baseOpenPeriodUs;
+}
+
+void DXLCircuitBreaker::onNoResponse(uint64_t nowUs) {
+    consecutiveFailures++;
+    if (state == 2) {                                   // Probe failed, stay dead longer
+        openPeriodUs = (openPeriodUs * 2 < maxOpenPeriodUs) ? openPeriodUs * 2 : maxOpenPeriodUs;
+        state = 1;
+        openUntilUs = nowUs + openPeriodUs;
+    }
+    else if (consecutiveFailures >= failureThreshold) {
+        state = 1;
+        openUntilUs = nowUs + openPeriodUs;
+    }
+}
+
+void DXLCircuitBreaker::onInconclusive(uint64_t nowUs) {
+    if (state != 2)     return;
+    state = 1;                                          // Probe never reached the ID, try again after a normal period
+    openUntilUs = nowUs + openPeriodUs;
+}
+
+void DXLCircuitBreaker::reset() {
+    state = 0;
+    consecutiveFailures = 0;
+    openUntilUs = 0;
+    openPeriodUs = baseOpenPeriodUs;
+}
+
+////////////////////////////////////////////////////   DXLTimeoutPort   /////////////////////////////////////////////////////////////////////////////////////////
+
+thread_local double DXLTimeoutPort::overrideMs = 0.0;  // Per thread: servos sharing a wrapper set it right before their own TxRx
+
+static std::mutex timeoutPortsLock;
+static std::map<dynamixel::PortHandler *, std::unique_ptr<DXLTimeoutPort> > timeoutPorts;     // Keyed by inner port
+
+DXLTimeoutPort *DXLTimeoutPort::wrap(dynamixel::PortHandler *port) {
+    if (port == 0)  return 0;
+    DXLTimeoutPort *wrapped = dynamic_cast<DXLTimeoutPort *>(port);
+    if (wrapped != 0)   return wrapped;
+    std::lock_guard<std::mutex> guard(timeoutPortsLock);
+    std::unique_ptr<DXLTimeoutPort> &slot = timeoutPorts[port];
+    if (!slot)  slot.reset(new DXLTimeoutPort(port));
+    return slot.get();
+}
+
+dynamixel::PortHandler *DXLTimeoutPort::underlying(dynamixel::PortHandler *port) {
+    DXLTimeoutPort *wrapped = dynamic_cast<DXLTimeoutPort *>(port);
+    return (wrapped != 0) ? wrapped->inner : port;
+}
+
+void DXLTimeoutPort::release(dynamixel::PortHandler *port) {
+    std::lock_guard<std::mutex> guard(timeoutPortsLock);
+    timeoutPorts.erase(underlying(port));
+}
+
+////////////////////////////////////////////////////   Wire time   /////////////////////////////////////////////////////////////////////////////////////////
+
+double dxlWireTimeUs(int baudRate, uint8_t instruction, uint16_t length) {
+    if (baudRate <= 0)  return 0.0;
+    // Protocol 2.0: instruction packet 10 bytes + params, status packet 11 bytes + data. 10 bits per byte (8N1).
+    int txBytes, rxBytes;
+    switch (instruction) {
+    case INST_READ:
+        txBytes = 10 + 4;
+        rxBytes = 11 + length;
+        break;
+    case INST_WRITE:
+        txBytes = 10 + 2 + length;
+        rxBytes = 11;
+        break;
+    default:
+        txBytes = 10;
+        rxBytes = 11;
+        break;
+    }
+    return double(txBytes + rxBytes) * 10.0 * 1000000.0 / double(baudRate);
+}
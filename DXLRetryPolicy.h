@@ -0,0 +1,123 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Retry, adaptive timeout and circuit breaking for DXLServo packet calls.
+
+- DXLRetryPolicy: bounded attempts and backoff, one policy per operation class (telemetry, control, config).
+- DXLRttEstimator: learns round trip latency beyond wire time (Jacobson/Karels, as TCP RTO), gives per-attempt packet timeout.
+- DXLCircuitBreaker: after repeated timeouts an ID is marked dead and calls fail fast until a probe succeeds,
+  so one unplugged servo costs one timeout per open period instead of one per call.
+- DXLTimeoutPort: forwarding PortHandler. The SDK sets its own length-based packet timeout inside every TxRx,
+  this wrapper swaps it for the learned one while leaving everything else to the real port. One wrapper per real port,
+  shared by every servo on it (wrap()), and underlying() gives the real port for bus identity, streams and port claims.
+  The busy flag is the real port's is_using_. DXLPacketHandler claims it there directly. SDK PacketHandler calls through
+  the wrapper only touch the wrapper's own is_using_, so they go between claimBus() and releaseBus() (DXLServo does this
+  for every call), and group reads and writes are built on underlying().
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+
+enum DXLOpClass {
+    DXL_OP_TELEMETRY = 0,                               // Present values, Moving, Hardware Error Status
+    DXL_OP_CONTROL,                                     // RAM setpoints: torque enable, goals, profile, LED, gains
+    DXL_OP_CONFIG,                                      // EEPROM registers, reboot
+    DXL_OP_CLASSES
+};
+
+struct DXLRetryPolicy {
+    int maxAttempts;                                    // Total packets per call including first, >= 1
+    int backoffUs;                                      // Wait before each retry, doubles per retry
+    bool retryCorrupt;                                  // Retry on COMM_RX_CORRUPT and status packet CRC error (error number 3)
+    bool adaptiveTimeout;                               // Use learned timeout, false keeps SDK length-based timeout
+    double minTimeoutMs, maxTimeoutMs;                  // Clamp on learned timeout
+    double timeoutGrowth;                               // Timeout multiplier per retry
+
+    DXLRetryPolicy() : maxAttempts(2), backoffUs(0), retryCorrupt(true), adaptiveTimeout(true), minTimeoutMs(2.0), maxTimeoutMs(50.0), timeoutGrowth(2.0) {}
+    DXLRetryPolicy(int attempts, int backoff, double minMs, double maxMs)
+        : maxAttempts(attempts), backoffUs(backoff), retryCorrupt(true), adaptiveTimeout(true), minTimeoutMs(minMs), maxTimeoutMs(maxMs), timeoutGrowth(2.0) {}
+};
+
+class DXLRttEstimator {
+private:
+    double srttUs, rttvarUs;                            // Smoothed excess latency and mean deviation
+    int samples;
+
+public:
+    DXLRttEstimator() : srttUs(0.0), rttvarUs(0.0), samples(0) {}
+
+    void observe(double excessUs);                      // Add one successful round trip: measured time minus wire time
+    double timeoutMs(double wireUs, int attempt, const DXLRetryPolicy &policy) const;     // Packet timeout for attempt (1 = first), 0 if nothing learned yet (use SDK default)
+    double smoothedUs() const   { return srttUs; }
+    int sampleCount() const     { return samples; }
+    void reset()                { srttUs = 0.0, rttvarUs = 0.0, samples = 0; }
+};
+
+class DXLCircuitBreaker {
+private:
+    int state;                                          // 0 closed, 1 open, 2 half open (one probe allowed)
+    int consecutiveFailures;
+    int failureThreshold;                               // Consecutive no-response failures before opening
+    uint64_t openUntilUs;
+    uint64_t openPeriodUs, baseOpenPeriodUs, maxOpenPeriodUs;      // Open period doubles on failed probe, up to max
+
+public:
+    DXLCircuitBreaker() : state(0), consecutiveFailures(0), failureThreshold(3), openUntilUs(0), openPeriodUs(500000), baseOpenPeriodUs(500000), maxOpenPeriodUs(8000000) {}
+
+    void configure(int threshold, uint64_t openUs, uint64_t maxOpenUs);
+    bool allow(uint64_t nowUs);                         // false if call must fail fast
+    void onSuccess();                                   // Any status packet received, even corrupt or with error byte set
+    void onNoResponse(uint64_t nowUs);                  // Timeout or port failure
+    void onInconclusive(uint64_t nowUs);                // Port busy, TX failure: nothing learned about the ID, a probe goes back to open
+    bool isOpen() const         { return state == 1; }
+    bool isClosed() const       { return state == 0; }
+    void reset();
+};
+
+class DXLTimeoutPort : public dynamixel::PortHandler {
+private:
+    dynamixel::PortHandler *inner;
+    static thread_local double overrideMs;              // Packet timeout for the calling thread's next TxRx, 0 to use inner port's length-based timeout
+
+    explicit DXLTimeoutPort(dynamixel::PortHandler *port) : inner(port) { is_using_ = false; }
+
+public:
+    virtual ~DXLTimeoutPort() {}                        // Does not own inner port
+
+    static DXLTimeoutPort *wrap(dynamixel::PortHandler *port);              // Shared wrapper of port, made on first call. port itself if already wrapped.
+    static dynamixel::PortHandler *underlying(dynamixel::PortHandler *port);    // Real port behind a wrapper, port itself otherwise
+    static void release(dynamixel::PortHandler *port);  // Deletes port's wrapper, once no servo uses it (before deleting the port)
+
+    dynamixel::PortHandler *innerPort() const { return inner; }
+    void setOverrideTimeout(double msec) { overrideMs = msec; }
+
+    int claimBus() {                                    // Before a TxRx through the wrapper: COMM_PORT_BUSY if the real port is in use
+        if (inner->is_using_)   return COMM_PORT_BUSY;
+        inner->is_using_ = true;
+        return COMM_SUCCESS;
+    }
+    void releaseBus() {                                 // After it: real port free, override not left for the thread's next TxRx
+        inner->is_using_ = false;
+        overrideMs = 0.0;
+    }
+
+    virtual bool openPort()                             { return inner->openPort(); }
+    virtual void closePort()                            { inner->closePort(); }
+    virtual void clearPort()                            { inner->clearPort(); }
+    virtual void setPortName(const char *port_name)     { inner->setPortName(port_name); }
+    virtual char *getPortName()                         { return inner->getPortName(); }
+    virtual bool setBaudRate(const int baudrate)        { return inner->setBaudRate(baudrate); }
+    virtual int getBaudRate()                           { return inner->getBaudRate(); }
+    virtual int getBytesAvailable()                     { return inner->getBytesAvailable(); }
+    virtual int readPort(uint8_t *packet, int length)   { return inner->readPort(packet, length); }
+    virtual int writePort(uint8_t *packet, int length)  { return inner->writePort(packet, length); }
+    virtual void setPacketTimeout(uint16_t packet_length) {        // Called by SDK before each status wait
+        if (overrideMs > 0.0)   inner->setPacketTimeout(overrideMs);
+        else                    inner->setPacketTimeout(packet_length);
+    }
+    virtual void setPacketTimeout(double msec)          { inner->setPacketTimeout(msec); }
+    virtual bool isPacketTimeout()                      { return inner->isPacketTimeout(); }
+};
+
+double dxlWireTimeUs(int baudRate, uint8_t instruction, uint16_t length);     // Time on the wire for instruction + status packet (Protocol 2.0, no stuffing)
@@ -0,0 +1,104 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Seqlock slot for publishing small plain structs from one thread to many.
+
+The sequence counter is odd while a write is in progress. Readers copy the value and check the counter did not move, so
+they never block the writer and never take a lock; tryRead() is a single attempt (wait-free), read() retries until a
+write-free window (a few hundred ns at worst). Writers exclude each other through the counter itself, so any number of
+threads may publish, e.g. whichever thread made the last read of a servo.
+
+The value is held as relaxed atomic words, so concurrent copy in and out is race free by the C++ memory model (and under
+ThreadSanitizer), not just in practice. T must be trivially copyable. All-zero memory is a valid empty slot, so a slot
+can live in shared memory without construction.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <type_traits>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DXL_SEQLOCK_PAUSE()     _mm_pause()
+#else
+#define DXL_SEQLOCK_PAUSE()     ((void)0)
+#endif
+
+template <typename T>
+class DXLSeqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "DXLSeqlock value must be trivially copyable");
+
+private:
+    static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence;                     // Even: stable, odd: write in progress. Writes so far = sequence / 2.
+    std::atomic<uint64_t> words[WORDS];
+
+    void storeWords(const T &value) {
+        uint64_t buffer[WORDS] = {};
+        memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; i++)  words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    void loadWords(T &value) const {
+        uint64_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; i++)  buffer[i] = words[i].load(std::memory_order_relaxed);
+        memcpy(&value, buffer, sizeof(T));
+    }
+
+    uint32_t beginWrite() {                             // Spins only while another thread is writing
+        uint32_t current = sequence.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((current & 1) == 0 && sequence.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed))    break;
+            DXL_SEQLOCK_PAUSE();
+            current = sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);    // Odd count visible before any word changes
+        return current;
+    }
+
+    void endWrite(uint32_t start) {
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+public:
+    DXLSeqlock() : sequence(0) { storeWords(T()); }
+    DXLSeqlock(const DXLSeqlock &other) : sequence(0) { storeWords(other.read()); }
+    DXLSeqlock &operator=(const DXLSeqlock &other) {
+        if (this != &other)     write(other.read());
+        return *this;
+    }
+
+    void write(const T &value) {
+        uint32_t start = beginWrite();
+        storeWords(value);
+        endWrite(start);
+    }
+
+    template <typename F>
+    void update(F modify) {                             // Read-modify-write under the writer lock, modify(T &) must not block
+        uint32_t start = beginWrite();
+        T value;
+        loadWords(value);
+        modify(value);
+        storeWords(value);
+        endWrite(start);
+    }
+
+    bool tryRead(T &out) const {                        // Single attempt, false if a write overlapped (out then unspecified)
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1)     return false;
+        loadWords(out);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    T read() const {
+        T out;
+        while (!tryRead(out))   DXL_SEQLOCK_PAUSE();
+        return out;
+    }
+
+    uint32_t writes() const { return sequence.load(std::memory_order_acquire) >> 1; }     // Changes when a new value is published
+};
@@ -0,0 +1,251 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Per-servo position/velocity/acceleration estimator. See DXLStateEstimator.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLStateEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+////////////////////////////////////////////////////   DXLStateEstimator definition   ////////////////////////////////////////////////////////////////////////////////////////
+
+void DXLStateEstimator::reset() {
+    memset(x, 0, sizeof(x));
+    memset(P, 0, sizeof(P));
+    memset(&plan, 0, sizeof(plan));
+    timeUs = 0;
+    initialized = false;
+    positionUpdates = 0, velocityUpdates = 0;
+}
+
+void DXLStateEstimator::planState(uint64_t atUs, double s[3]) const {
+    s[0] = s[1] = s[2] = 0.0;
+    if (!plan.active)   return;
+    double pos = plan.startPosition, vel = plan.startVelocity;
+    double t = (atUs > plan.startUs) ? double(atUs - plan.startUs) * 1.0e-6 : 0.0;
+    if (t >= plan.totalSec) {                           // Arrived and holding
+        s[0] = plan.goalPosition;
+        return;
+    }
+    for (int i = 0; i < plan.segments; i++) {
+        double a = plan.segmentAccel[i];
+        double dt = std::min(t, plan.segmentSec[i]);
+        pos += vel * dt + 0.5 * a * dt * dt;
+        vel += a * dt;
+        t -= dt;
+        if (t <= 0.0) {
+            s[2] = a;
+            break;
+        }
+    }
+    s[0] = pos, s[1] = vel;
+}
+
+void DXLStateEstimator::addSegment(double sec, double accel) {
+    if (sec <= 0.0 || plan.segments >= DXL_ESTIMATOR_PLAN_SEGMENTS)    return;
+    plan.segmentSec[plan.segments] = sec;
+    plan.segmentAccel[plan.segments] = accel;
+    plan.segments++;
+    plan.totalSec += sec;
+}
+
+void DXLStateEstimator::addRestToRest(double distance, double direction, double velocity, double accel) {
+    if (distance <= 0.0)    return;
+    double peak = std::min(velocity, sqrt(distance * accel));   // Triangle if profile velocity is out of reach
+    double rampSec = peak / accel;
+    addSegment(rampSec, direction * accel);
+    addSegment(distance / peak - rampSec, 0.0);
+    addSegment(rampSec, -direction * accel);
+}
+
+void DXLStateEstimator::propagate(double dt, double state[3], double cov[3][3]) const {
+    double F[3][3] = { { 1.0, dt, 0.5 * dt * dt }, { 0.0, 1.0, dt }, { 0.0, 0.0, 1.0 } };
+    double next[3];
+    for (int i = 0; i < 3; i++)     next[i] = F[i][0] * state[0] + F[i][1] * state[1] + F[i][2] * state[2];
+    memcpy(state, next, sizeof(next));
+    if (cov == 0)   return;
+
+    double FP[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)     FP[i][j] = F[i][0] * cov[0][j] + F[i][1] * cov[1][j] + F[i][2] * cov[2][j];
+    double q = noise.jerkDensity;                       // White jerk, continuous time Q
+    double dt2 = dt * dt, dt3 = dt2 * dt;
+    double Q[3][3] = { { q * dt3 * dt2 / 20.0, q * dt2 * dt2 / 8.0, q * dt3 / 6.0 },
+                       { q * dt2 * dt2 / 8.0,  q * dt3 / 3.0,       q * dt2 / 2.0 },
+                       { q * dt3 / 6.0,        q * dt2 / 2.0,       q * dt } };
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)     cov[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2] + Q[i][j];
+}
+
+void DXLStateEstimator::predictTo(uint64_t atUs) {     // x = plan(t1) + F (x - plan(t0)): only the deviation from plan is extrapolated
+    if (atUs <= timeUs)     return;
+    double s0[3], s1[3];
+    planState(timeUs, s0);
+    planState(atUs, s1);
+    double deviation[3] = { x[0] - s0[0], x[1] - s0[1], x[2] - s0[2] };
+    propagate(double(atUs - timeUs) * 1.0e-6, deviation, P);
+    for (int i = 0; i < 3; i++)     x[i] = s1[i] + deviation[i];
+    timeUs = atUs;
+}
+
+void DXLStateEstimator::update(const double H[3], double z, double predicted, double variance) {
+    double PH[3];
+    for (int i = 0; i < 3; i++)     PH[i] = P[i][0] * H[0] + P[i][1] * H[1] + P[i][2] * H[2];
+    double S = H[0] * PH[0] + H[1] * PH[1] + H[2] * PH[2] + variance;
+    if (S <= 0.0)   return;
+    double innovation = z - predicted;
+    double K[3] = { PH[0] / S, PH[1] / S, PH[2] / S };
+    for (int i = 0; i < 3; i++)     x[i] += K[i] * innovation;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)     P[i][j] -= K[i] * PH[j];
+    for (int i = 0; i < 3; i++)                         // Keep symmetric against rounding
+        for (int j = i + 1; j < 3; j++)     P[i][j] = P[j][i] = 0.5 * (P[i][j] + P[j][i]);
+}
+
+void DXLStateEstimator::updatePosition(double position, uint64_t sampleUs) {
+    positionUpdates++;
+    if (!initialized) {
+        double s[3];
+        planState(sampleUs, s);
+        x[0] = position, x[1] = s[1], x[2] = s[2];
+        memset(P, 0, sizeof(P));
+        P[0][0] = noise.positionSigma * noise.positionSigma;
+        P[1][1] = noise.initialVelocitySigma * noise.initialVelocitySigma;
+        P[2][2] = noise.initialAccelSigma * noise.initialAccelSigma;
+        timeUs = sampleUs;
+        initialized = true;
+        return;
+    }
+    predictTo(sampleUs);
+    double dt = double(timeUs - std::min(sampleUs, timeUs)) * 1.0e-6;     // > 0: sample older than the filter
+    double H[3] = { 1.0, -dt, 0.5 * dt * dt };
+    double s0[3], s1[3];
+    planState(timeUs, s0);
+    planState(sampleUs, s1);
+    double predicted = s1[0] + H[0] * (x[0] - s0[0]) + H[1] * (x[1] - s0[1]) + H[2] * (x[2] - s0[2]);
+    update(H, position, predicted, noise.positionSigma * noise.positionSigma);
+}
+
+void DXLStateEstimator::updateVelocity(double velocity, uint64_t sampleUs) {
+    if (!initialized)   return;                         // Position first, velocity alone does not place the servo
+    velocityUpdates++;
+    predictTo(sampleUs);
+    double dt = double(timeUs - std::min(sampleUs, timeUs)) * 1.0e-6;
+    double H[3] = { 0.0, 1.0, -dt };
+    double s0[3], s1[3];
+    planState(timeUs, s0);
+    planState(sampleUs, s1);
+    double predicted = s1[1] + (x[1] - s0[1]) - dt * (x[2] - s0[2]);
+    update(H, velocity, predicted, noise.velocitySigma * noise.velocitySigma);
+}
+
+void DXLStateEstimator::setGoal(double goalPosition, double velocity, double accel, uint64_t atUs) {
+    if (initialized)    predictTo(atUs);            // x is absolute, it becomes deviation from whichever plan follows
+    plan.active = false;
+
+    double distance = fabs(goalPosition - x[0]);
+    if (!initialized || velocity <= 0.0 || (distance == 0.0 && x[1] == 0.0)) {
+        if (initialized && velocity <= 0.0 && distance > 0.0)     P[1][1] += noise.initialVelocitySigma * noise.initialVelocitySigma;     // Step of unknown speed
+        return;
+    }
+    if (accel <= 0.0)   accel = 1.0e9;                  // Unlimited acceleration: velocity steps within a microsecond
+
+    // Profile from the present velocity, in the goal's direction: brake if moving away or too fast, overshoot and come back
+    // if too close to stop, else accelerate / cruise / decelerate
+    plan.startUs = atUs;
+    plan.startPosition = x[0], plan.startVelocity = x[1], plan.goalPosition = goalPosition;
+    plan.segments = 0, plan.totalSec = 0.0;
+    double direction = (goalPosition > x[0] || (goalPosition == x[0] && x[1] < 0.0)) ? 1.0 : -1.0;
+    double speed = x[1] * direction;                    // Towards goal
+    if (speed < 0.0) {                                  // Moving away: stop first, goal is then further
+        addSegment(-speed / accel, direction * accel);
+        distance += speed * speed / (2.0 * accel);
+        speed = 0.0;
+    }
+    else if (speed > velocity) {                        // Above profile velocity: slow down to it
+        addSegment((speed - velocity) / accel, -direction * accel);
+        distance -= (speed * speed - velocity * velocity) / (2.0 * accel);
+        speed = velocity;
+    }
+    double stopping = speed * speed / (2.0 * accel);
+    if (distance < stopping) {                          // Cannot stop in time: stop past the goal, come back from rest
+        addSegment(speed / accel, -direction * accel);
+        addRestToRest(stopping - distance, -direction, velocity, accel);
+    }
+    else if (speed > 0.0) {                             // Under way towards goal: speed up from present speed
+        double peak = std::min(velocity, sqrt(accel * distance + 0.5 * speed * speed));
+        addSegment((peak - speed) / accel, direction * accel);
+        addSegment((distance - (peak * peak - speed * speed) / (2.0 * accel) - peak * peak / (2.0 * accel)) / peak, 0.0);     // Cruise, none for a triangle
+        addSegment(peak / accel, -direction * accel);
+    }
+    else {
+        addRestToRest(distance, direction, velocity, accel);
+    }
+    plan.active = (plan.segments > 0);
+    if (plan.active) {
+        double s[3];
+        planState(atUs, s);
+        x[2] = s[2];                                    // Acceleration follows the new profile at once
+    }
+    timeUs = std::max(timeUs, atUs);
+}
+
+bool DXLStateEstimator::isFollowingPlan(uint64_t atUs) const {
+    return plan.active && atUs < plan.startUs + uint64_t(plan.totalSec * 1.0e6);
+}
+
+DXLStateEstimate DXLStateEstimator::estimate(uint64_t atUs) const {
+    DXLStateEstimate out;
+    memset(&out, 0, sizeof(out));
+    out.atUs = atUs;
+    out.valid = initialized;
+    if (!initialized)   return out;
+
+    double s0[3], s1[3];
+    planState(timeUs, s0);
+    planState(atUs, s1);
+    double deviation[3] = { x[0] - s0[0], x[1] - s0[1], x[2] - s0[2] };
+    double cov[3][3];
+    memcpy(cov, P, sizeof(cov));
+    double dtUs = (atUs > timeUs) ? double(std::min<uint64_t>(atUs - timeUs, DXL_ESTIMATOR_HORIZON_US)) : 0.0;
+    if (atUs < timeUs)  memcpy(s1, s0, sizeof(s1));     // Asked for the past: latest state, not rewound
+    propagate(dtUs * 1.0e-6, deviation, cov);
+
+    out.position = s1[0] + deviation[0];
+    out.velocity = s1[1] + deviation[1];
+    out.acceleration = s1[2] + deviation[2];
+    out.positionSigma = sqrt(std::max(cov[0][0], 0.0));
+    out.velocitySigma = sqrt(std::max(cov[1][1], 0.0));
+    return out;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLStateEstimator    ///////////////////////////////////////////////////////////////////////////
+#include "DXLProServo.h"
+
+int main() {
+    DXLServo tilt;
+    tilt.setDXLServo(0);
+    tilt.identity = 2;
+    tilt.initPortHandler();
+    tilt.initPacketHandler();
+    tilt.openPort();
+    tilt.setPortBaudRate();
+    tilt.enableStateEstimator();
+    tilt.setProfileAcceleration(20);                    // Known profile: goals become planned motion for the estimator
+    tilt.setProfileVelocity(60);
+    tilt.tryReadCurrentPosition();
+    tilt.tryWriteGoalPosition(3000);
+
+    // Controller at 1 kHz, position read every 20th cycle, velocity never read
+    for (int cycle = 0; cycle < 3000; cycle++) {
+        if (cycle % 20 == 0)    tilt.tryReadCurrentPosition();
+        DXLStateEstimate state = tilt.estimateState(DXLBusStats::nowUs());
+        if (cycle % 100 == 0)   printf("%.1f counts, %.1f counts/s, %.0f counts/s2 (+- %.2f, %.1f)\n", state.position, state.velocity, state.acceleration, state.positionSigma, state.velocitySigma);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return 0;
+}
+// End of Example Code
+*/
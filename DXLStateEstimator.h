@@ -0,0 +1,84 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Per-servo position/velocity/acceleration estimator.
+
+Constant acceleration Kalman filter over raw position units (counts, counts/s, counts/s2), driven by white jerk. It fuses:
+    position reads      sparse is fine, each taken at its sample time (DXLServoState::positionSampleUs). A sample older than
+                        the filter is applied through H = [1, -dt, dt2/2] instead of rewinding it.
+    velocity reads      optional, noisy (one LSB is 15.6 counts/s on MX), weighted accordingly.
+    commanded goals     the servo's own trapezoid profile to the goal (Profile Velocity/Acceleration) is a known input: the
+                        filter tracks the deviation from the planned motion, so acceleration and cruise need no reads to be
+                        followed, and position reads only correct start time and following error. The plan starts from the
+                        estimated velocity, so goals changed mid move (retargeting) brake, reverse or overshoot as the servo does.
+Between reads estimate() carries the state to any time at controller rate, without bus traffic. Goals written with no
+known profile (velocity 0 = unlimited) only widen the velocity uncertainty.
+
+Plain data, trivially copyable, so DXLServo publishes it through a DXLSeqlock for readers on other threads.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#define DXL_ESTIMATOR_HORIZON_US        100000          // Deviation from plan extrapolated at most this far past the last update
+#define DXL_ESTIMATOR_PLAN_SEGMENTS     6               // Brake/reverse, overshoot, accelerate, cruise, decelerate
+
+struct DXLEstimatorNoise {
+    double positionSigma;                               // Counts. Quantization alone is 0.29.
+    double velocitySigma;                               // Counts/s
+    double jerkDensity;                                 // Counts2/s5, how fast acceleration may change unannounced
+    double initialVelocitySigma, initialAccelSigma;     // At first position read
+
+    DXLEstimatorNoise() : positionSigma(0.5), velocitySigma(30.0), jerkDensity(1.0e7), initialVelocitySigma(2000.0), initialAccelSigma(20000.0) {}
+};
+
+struct DXLStateEstimate {
+    double position, velocity, acceleration;            // Counts, counts/s, counts/s2
+    double positionSigma, velocitySigma;                // One standard deviation
+    uint64_t atUs;                                      // DXLBusStats::nowUs() this is for
+    bool valid;                                         // false until the first position read
+};
+
+struct DXLEstimatorPlan {                               // Profile to goal as constant acceleration segments, counts, counts/s, counts/s2
+    bool active;
+    uint64_t startUs;
+    double startPosition, startVelocity, goalPosition;
+    double segmentSec[DXL_ESTIMATOR_PLAN_SEGMENTS], segmentAccel[DXL_ESTIMATOR_PLAN_SEGMENTS];
+    int segments;
+    double totalSec;
+};
+
+class DXLStateEstimator {
+private:
+    double x[3];                                        // Position, velocity, acceleration at timeUs
+    double P[3][3];
+    uint64_t timeUs;
+    bool initialized;
+    DXLEstimatorNoise noise;
+    DXLEstimatorPlan plan;
+    uint32_t positionUpdates, velocityUpdates;
+
+    void planState(uint64_t atUs, double s[3]) const;   // Planned position/velocity/acceleration, zero without a plan
+    void addSegment(double sec, double accel);
+    void addRestToRest(double distance, double direction, double velocity, double accel);     // Trapezoid or triangle
+    void propagate(double dtSec, double state[3], double cov[3][3]) const;     // Deviation from plan under F, covariance with Q
+    void predictTo(uint64_t atUs);
+    void update(const double H[3], double z, double predicted, double variance);
+
+public:
+    DXLStateEstimator() { reset(); }
+
+    void reset();
+    void setNoise(const DXLEstimatorNoise &values) { noise = values; }
+    const DXLEstimatorNoise &getNoise() const { return noise; }
+
+    void updatePosition(double position, uint64_t sampleUs);
+    void updateVelocity(double velocity, uint64_t sampleUs);       // Counts/s
+    // Goal written at atUs. velocity/accel: profile limits in counts/s, counts/s2, velocity <= 0 if unknown or unlimited.
+    void setGoal(double goalPosition, double velocity, double accel, uint64_t atUs);
+
+    DXLStateEstimate estimate(uint64_t atUs) const;     // Any thread, const
+    bool isInitialized() const          { return initialized; }
+    bool isFollowingPlan(uint64_t atUs) const;          // Goal known and move not finished by plan at atUs
+    uint32_t positionCount() const      { return positionUpdates; }
+    uint32_t velocityCount() const      { return velocityUpdates; }
+};
@@ -0,0 +1,231 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Host-side torque (current) control loop. See DXLTorqueController.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLTorqueController.h"
+
+#include <chrono>
+#include <cmath>
+#include <string.h>
+
+#define MX_CURRENT_UNIT_AMPS            0.00336         // 3.36mA, as convertValtoCurr()
+#define PRO_CURRENT_UNIT_AMPS           0.004028        // 4.028mA
+
+#define MX_TORQUE_BLOCK_START           ADDR_MX_PRESENT_CURRENT      // 126: current(2) velocity(4) position(4)
+#define MX_TORQUE_BLOCK_LENGTH          10
+#define PRO_TORQUE_BLOCK_START          ADDR_PRO_PRESENT_POSITION    // 611: position(4) velocity(4) reserved(2) current(2)
+#define PRO_TORQUE_BLOCK_LENGTH         12
+#define TORQUE_BLOCK_MAX                12
+
+#define TORQUE_MAX_STEP_SEC             0.1             // Integrator time step cap, first cycle and after stalls
+
+static int32_t blockInt32(const uint8_t *data) {
+    return int32_t(DXL_MAKEDWORD(DXL_MAKEWORD(data[0], data[1]), DXL_MAKEWORD(data[2], data[3])));
+}
+
+static int16_t blockInt16(const uint8_t *data) {
+    return int16_t(DXL_MAKEWORD(data[0], data[1]));
+}
+
+////////////////////////////////////////////////////   DXLTorqueController class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLTorqueController::DXLTorqueController(DXLServo *controlled) : running(false) {
+    servo = controlled;
+    ampsPerUnit = (servo->servoType == DXL_PRO_M42) ? PRO_CURRENT_UNIT_AMPS : MX_CURRENT_UNIT_AMPS;
+    kp = 0.0, ki = 0.0, kd = 0.0;
+    targetDeg = 0.0, targetRpm = 0.0, feedforwardAmps = 0.0;
+    integral = 0.0;
+    memset(&state, 0, sizeof(state));
+    memset(&stats, 0, sizeof(stats));
+    lastStepUs = 0;
+    maxMisses = 5;
+    updateLimit();
+}
+
+DXLTorqueController::~DXLTorqueController() {
+    if (running.load() || worker.joinable())    stop();
+}
+
+void DXLTorqueController::updateLimit() {
+    int limit = servo->getCurrentLimitSetting();
+    if (limit <= 0)     limit = (servo->servoType == DXL_PRO_M42) ? DXL_PRO_M42_TORQUE_LIMIT_MAX : DXL_MX_CURRENT_LIMIT_MAX;
+    std::lock_guard<std::mutex> guard(lock);
+    limitValue = limit;
+}
+
+void DXLTorqueController::setPID(double kpAmpsPerDeg, double kiAmpsPerDegSec, double kdAmpsPerRpm) {
+    std::lock_guard<std::mutex> guard(lock);
+    kp = kpAmpsPerDeg;
+    ki = kiAmpsPerDegSec;
+    kd = kdAmpsPerRpm;
+    if (ki == 0.0)  integral = 0.0;
+}
+
+void DXLTorqueController::setImpedance(double stiffnessAmpsPerDeg, double dampingAmpsPerRpm) {
+    setPID(stiffnessAmpsPerDeg, 0.0, dampingAmpsPerRpm);
+}
+
+void DXLTorqueController::setTarget(double angleDeg, double velocityRpm, double feedforward) {
+    std::lock_guard<std::mutex> guard(lock);
+    targetDeg = angleDeg;
+    targetRpm = velocityRpm;
+    feedforwardAmps = feedforward;
+}
+
+bool DXLTorqueController::enterTorqueMode() {
+    servo->disableTorque();
+    if (servo->dxl_comm_result != COMM_SUCCESS)     return false;
+    servo->setOperatingMode(0);                         // Current Control (MX), Torque Control (Pro)
+    if (servo->dxl_comm_result != COMM_SUCCESS)     return false;
+    uint16_t goalAddress = (servo->servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_TORQUE : ADDR_MX_GOAL_CURRENT;
+    if (servo->write2ByteTxRx(goalAddress, 0) != COMM_SUCCESS)  return false;     // No jump when torque comes on
+    servo->enableTorque();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        integral = 0.0;
+        lastStepUs = 0;
+    }
+    return servo->dxl_comm_result == COMM_SUCCESS;
+}
+
+bool DXLTorqueController::cycle() {
+    bool pro = (servo->servoType == DXL_PRO_M42);
+    uint8_t block[TORQUE_BLOCK_MAX];
+    uint64_t startUs = DXLBusStats::nowUs();
+    if (servo->readBlockTxRx(pro ? PRO_TORQUE_BLOCK_START : MX_TORQUE_BLOCK_START, pro ? PRO_TORQUE_BLOCK_LENGTH : MX_TORQUE_BLOCK_LENGTH, block) != COMM_SUCCESS) {
+        std::lock_guard<std::mutex> guard(lock);
+        stats.commFailures++;
+        return false;
+    }
+    uint64_t readUs = DXLBusStats::nowUs();
+
+    DXLTorqueState now;
+    if (pro) {
+        now.position = blockInt32(block);
+        now.velocity = blockInt32(block + 4);
+        now.current = blockInt16(block + 10);
+    }
+    else {
+        now.current = blockInt16(block);
+        now.velocity = blockInt32(block + 2);
+        now.position = blockInt32(block + 6);
+    }
+    now.angleDeg = servo->convertValtoPos(now.position);
+    now.velocityRpm = servo->convertValtoVel(now.velocity);
+    now.currentAmps = double(now.current) * ampsPerUnit;
+    now.timeUs = readUs;
+
+    int output;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        double dt = (lastStepUs != 0) ? std::min(double(readUs - lastStepUs) * 1.0e-6, TORQUE_MAX_STEP_SEC) : 0.0;
+        lastStepUs = readUs;
+
+        double error = targetDeg - now.angleDeg;
+        double limitAmps = double(limitValue) * ampsPerUnit;
+        double pd = kp * error + kd * (targetRpm - now.velocityRpm) + feedforwardAmps;
+        double u = pd + ki * (integral + error * dt);
+        now.saturated = (fabs(u) > limitAmps);
+        if (!now.saturated || (u > 0.0) != (error > 0.0))  integral += error * dt;     // Conditional integration, no windup
+        u = pd + ki * integral;
+
+        output = int(lround(u / ampsPerUnit));
+        output = std::min(std::max(output, -limitValue), limitValue);
+        now.commandAmps = double(output) * ampsPerUnit;
+        state = now;
+    }
+
+    int result = servo->write2ByteTxRx(pro ? ADDR_PRO_GOAL_TORQUE : ADDR_MX_GOAL_CURRENT, uint16_t(int16_t(output)));
+    uint32_t cycleUs = uint32_t(DXLBusStats::nowUs() - startUs);
+    std::lock_guard<std::mutex> guard(lock);
+    stats.cycles++;
+    stats.maxCycleUs = std::max(stats.maxCycleUs, cycleUs);
+    if (result != COMM_SUCCESS)     stats.commFailures++;
+    return result == COMM_SUCCESS;
+}
+
+bool DXLTorqueController::step() {
+    DXLBusScheduler *bus = servo->getBusScheduler();
+    if (bus != 0)   return bus->runSync(DXL_PRIO_CONTROL, [this]() { return cycle() ? COMM_SUCCESS : COMM_RX_FAIL; }) == COMM_SUCCESS;
+    return cycle();
+}
+
+void DXLTorqueController::loop(double rateHz) {
+    const std::chrono::microseconds period(int64_t(1.0e6 / rateHz));
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now() + period;
+    int misses = 0;
+
+    while (running.load()) {
+        std::this_thread::sleep_until(next);
+        std::chrono::steady_clock::time_point woke = std::chrono::steady_clock::now();
+        uint32_t lateUs = uint32_t(std::chrono::duration_cast<std::chrono::microseconds>(woke - next).count());
+
+        misses = step() ? 0 : misses + 1;
+        if (misses >= maxMisses) {
+            DXL_LOG_ERROR(servo->identity, DXL_LOG_NONE, servo->dxl_comm_result, "Torque loop stopped after %d failed cycles", misses);
+            running.store(false);
+            break;
+        }
+
+        std::chrono::steady_clock::time_point done = std::chrono::steady_clock::now();
+        next += period;
+        std::lock_guard<std::mutex> guard(lock);
+        stats.maxLatenessUs = std::max(stats.maxLatenessUs, lateUs);
+        if (done > next) {                              // Missed a slot, re-anchor instead of bursting to catch up
+            stats.overruns++;
+            next = done + period;
+        }
+    }
+}
+
+bool DXLTorqueController::start(double rateHz) {
+    if (rateHz <= 0.0 || running.load())    return false;
+    if (worker.joinable())  worker.join();             // Loop that stopped itself
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        lastStepUs = 0;
+    }
+    running.store(true);
+    worker = std::thread(&DXLTorqueController::loop, this, rateHz);
+    return true;
+}
+
+void DXLTorqueController::stop() {
+    running.store(false);
+    if (worker.joinable())  worker.join();
+    uint16_t goalAddress = (servo->servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_TORQUE : ADDR_MX_GOAL_CURRENT;
+    if (servo->write2ByteTxRx(goalAddress, 0) != COMM_SUCCESS) {
+        DXL_LOG_ERROR(servo->identity, goalAddress, servo->dxl_comm_result, "%s", servo->pktHandler->getTxRxResult(servo->dxl_comm_result));
+    }
+}
+
+DXLTorqueState DXLTorqueController::getState() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return state;
+}
+
+DXLTorqueLoopStats DXLTorqueController::getStats() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLTorqueController    ///////////////////////////////////////////////////////////////////////////
+    proServo.setCurrentLimit(1.0);                      // Saturation for the host loop, amps
+    DXLTorqueController controller(&proServo);
+    controller.setImpedance(0.02, 0.004);               // 0.02A per degree spring, 0.004A per rpm damper
+    controller.setTarget(proServo.convertValtoPos(proServo.readCurrentPosition()));     // Hold where it is
+    if (!controller.enterTorqueMode())  return 1;
+    controller.start(500.0);                            // 500Hz, needs low latency port at 1Mbps or faster
+
+    for (int x = 0; x < 10; x++) {                      // Arm can be pushed away and springs back
+        crossSleep(1);
+        DXLTorqueState s = controller.getState();
+        DXLTorqueLoopStats st = controller.getStats();
+        printf("Angle %.2f deg, command %.3f A%s, %llu cycles, %llu overruns\n", s.angleDeg, s.commandAmps, s.saturated ? " (saturated)" : "",
+            (unsigned long long)st.cycles, (unsigned long long)st.overruns);
+    }
+    controller.stop();
+    proServo.disableTorque();
+// End of Example Code
+*/
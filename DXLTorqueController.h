@@ -0,0 +1,78 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Host-side torque (current) control loop.
+
+The servo runs in Current (MX) / Torque (Pro) Control Mode and the host closes the position loop at a fixed rate:
+    u = kp * (angle error) + ki * integral(angle error) + kd * (velocity error) + feedforward
+kd acts on the servo's Present Velocity, so no numerical differentiation. setImpedance() is the same law without the
+integrator: a virtual spring/damper around the target, for compliant behaviour the on-board Pro P-only gain cannot give.
+Output saturates at the current limit last set with setCurrentLimit() (servo maximum if never set), integrator stops
+winding up while saturated.
+
+One cycle is one read of Present Current/Velocity/Position and one Goal Torque/Current write:
+    MX:  read 126 - 135 (10 bytes), write 102
+    Pro: read 611 - 622 (12 bytes), write 604
+With a bus scheduler set, each cycle is one control priority job.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+struct DXLTorqueState {
+    int position, velocity, current;                    // Raw register values
+    double angleDeg, velocityRpm, currentAmps;
+    double commandAmps;                                 // Last output after saturation
+    bool saturated;
+    uint64_t timeUs;                                    // DXLBusStats::nowUs() of the read
+};
+
+struct DXLTorqueLoopStats {
+    uint64_t cycles, commFailures, overruns;            // overruns: cycle finished after next cycle was due
+    uint32_t maxCycleUs, maxLatenessUs;                 // Longest read/compute/write, latest wake up after due time
+};
+
+class DXLTorqueController {
+private:
+    DXLServo *servo;
+    double ampsPerUnit;                                 // Goal/Present current unit
+    int limitValue;                                     // Output saturation, raw
+
+    mutable std::mutex lock;                            // Gains, target and state, shared with the loop thread
+    double kp, ki, kd;
+    double targetDeg, targetRpm, feedforwardAmps;
+    double integral;                                    // degree-seconds
+    DXLTorqueState state;
+    DXLTorqueLoopStats stats;
+    uint64_t lastStepUs;
+
+    std::thread worker;
+    std::atomic<bool> running;
+    int maxMisses;                                      // Consecutive failed cycles before the loop gives up
+
+    bool cycle();                                       // Read, compute, write. Runs on bus worker thread when scheduler set.
+    void loop(double rateHz);
+
+public:
+    DXLTorqueController(DXLServo *controlled);
+    ~DXLTorqueController();
+
+    void setPID(double kpAmpsPerDeg, double kiAmpsPerDegSec, double kdAmpsPerRpm);
+    void setImpedance(double stiffnessAmpsPerDeg, double dampingAmpsPerRpm);     // PD, integrator cleared
+    void setTarget(double angleDeg, double velocityRpm = 0.0, double feedforward = 0.0);     // Angle as convertValtoPos(), feedforward in amps
+    void setMaxMisses(int misses) { maxMisses = misses; }
+    void updateLimit();                                 // Pick up a new setCurrentLimit() value
+
+    bool enterTorqueMode();                             // Torque off, Current/Torque Control Mode, torque on. false on comm failure.
+    bool step();                                        // One cycle on calling thread, for user driven loops. false on comm failure.
+    bool start(double rateHz);                          // Run step() at fixed rate on own thread. Call enterTorqueMode() first.
+    void stop();                                        // Stop thread, command zero torque. Servo stays in torque mode.
+    bool isRunning() const { return running.load(); }
+
+    DXLTorqueState getState() const;
+    DXLTorqueLoopStats getStats() const;
+};
@@ -0,0 +1,225 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Transaction tracing for DXLServo packet calls. See DXLTrace.h.
+
+Chrome trace-event format reference: "Trace Event Format" document, complete events ("ph":"X") with ts/dur in microseconds.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLTrace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+#include "DXLBusStats.h"
+
+static thread_local void *localBuffer = 0;               // This thread's DXLTrace::ThreadBuffer
+static thread_local uint64_t localGeneration = 0;
+
+////////////////////////////////////////////////////   DXLTrace class definition   /////////////////////////////////////////////////////////////////////////////////////////
+
+DXLTrace::DXLTrace() {
+    enabled.store(false, std::memory_order_relaxed);
+    capacity.store(DXL_TRACE_DEFAULT_CAPACITY, std::memory_order_relaxed);
+    generation.store(1, std::memory_order_relaxed);
+    epochUs = 0;
+}
+
+DXLTrace::~DXLTrace() {
+    for (size_t i = 0; i < buffers.size(); i++)     delete buffers[i];
+}
+
+DXLTrace &DXLTrace::instance() {
+    static DXLTrace trace;
+    return trace;
+}
+
+void DXLTrace::enable(bool on) {
+    if (on) {
+        std::lock_guard<std::mutex> lock(registryLock);
+        if (epochUs == 0)   epochUs = DXLBusStats::nowUs();
+    }
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+void DXLTrace::setCapacity(size_t events) {
+    if (events == 0)    events = 1;
+    capacity.store(events, std::memory_order_relaxed);
+}
+
+void DXLTrace::clear() {
+    std::lock_guard<std::mutex> lock(registryLock);
+    for (size_t i = 0; i < buffers.size(); i++)     delete buffers[i];
+    buffers.clear();
+    busNames.clear();
+    epochUs = enabled.load(std::memory_order_relaxed) ? DXLBusStats::nowUs() : 0;
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+DXLTrace::ThreadBuffer *DXLTrace::threadBuffer() {
+    uint64_t current = generation.load(std::memory_order_acquire);
+    if (localBuffer != 0 && localGeneration == current)     return static_cast<ThreadBuffer *>(localBuffer);
+
+    ThreadBuffer *buffer = new ThreadBuffer;
+    buffer->events.resize(capacity.load(std::memory_order_relaxed));      // Allocate up front, recording never reallocates
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+    buffer->lastBus = 0;
+
+    std::lock_guard<std::mutex> lock(registryLock);
+    buffer->tid = int(buffers.size()) + 1;
+    buffers.push_back(buffer);
+    localBuffer = buffer;
+    localGeneration = generation.load(std::memory_order_relaxed);
+    return buffer;
+}
+
+void DXLTrace::nameBus(const void *bus, const char *name) {
+    std::lock_guard<std::mutex> lock(registryLock);
+    for (size_t i = 0; i < busNames.size(); i++) {
+        if (busNames[i].first == bus)   return;
+    }
+    busNames.push_back(std::make_pair(bus, std::string(name != 0 ? name : "bus")));
+}
+
+void DXLTrace::record(const DXLTraceEvent &event, const char *busName) {
+    ThreadBuffer *buffer = threadBuffer();
+    if (buffer->lastBus != event.bus) {
+        nameBus(event.bus, busName);
+        buffer->lastBus = event.bus;
+    }
+
+    size_t index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= buffer->events.size()) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = event;
+    buffer->count.store(index + 1, std::memory_order_release);        // Publish after event fully written
+}
+
+size_t DXLTrace::eventCount() const {
+    std::lock_guard<std::mutex> lock(registryLock);
+    size_t total = 0;
+    for (size_t i = 0; i < buffers.size(); i++)     total += buffers[i]->count.load(std::memory_order_acquire);
+    return total;
+}
+
+uint64_t DXLTrace::droppedCount() const {
+    std::lock_guard<std::mutex> lock(registryLock);
+    uint64_t total = 0;
+    for (size_t i = 0; i < buffers.size(); i++)     total += buffers[i]->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+const char *DXLTrace::instructionName(uint8_t instruction) {
+    switch (instruction) {
+    case INST_PING:         return "Ping";
+    case INST_READ:         return "Read";
+    case INST_WRITE:        return "Write";
+    case INST_REG_WRITE:    return "RegWrite";
+    case INST_ACTION:       return "Action";
+    case INST_REBOOT:       return "Reboot";
+    case INST_SYNC_READ:    return "SyncRead";
+    case INST_SYNC_WRITE:   return "SyncWrite";
+    case INST_BULK_READ:    return "BulkRead";
+    case INST_BULK_WRITE:   return "BulkWrite";
+    default:                return "Inst";
+    }
+}
+
+static const char *resultName(int result) {
+    switch (result) {
+    case COMM_SUCCESS:          return "COMM_SUCCESS";
+    case COMM_PORT_BUSY:        return "COMM_PORT_BUSY";
+    case COMM_TX_FAIL:          return "COMM_TX_FAIL";
+    case COMM_RX_FAIL:          return "COMM_RX_FAIL";
+    case COMM_TX_ERROR:         return "COMM_TX_ERROR";
+    case COMM_RX_WAITING:       return "COMM_RX_WAITING";
+    case COMM_RX_TIMEOUT:       return "COMM_RX_TIMEOUT";
+    case COMM_RX_CORRUPT:       return "COMM_RX_CORRUPT";
+    case COMM_NOT_AVAILABLE:    return "COMM_NOT_AVAILABLE";
+    default:                    return "COMM_UNKNOWN";
+    }
+}
+
+static void jsonString(std::ostringstream &out, const std::string &text) {      // Port names are the only free text, escape quotes and backslashes
+    out << '"';
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '"' || text[i] == '\\')  out << '\\';
+        out << text[i];
+    }
+    out << '"';
+}
+
+static void writeEvent(std::ostringstream &out, const DXLTraceEvent &event, uint64_t epochUs, int pid, int tid) {
+    uint64_t start = (event.startUs > epochUs) ? event.startUs - epochUs : 0;
+    uint64_t duration = (event.endUs > event.startUs) ? event.endUs - event.startUs : 0;
+    out << "{\"name\":\"" << DXLTrace::instructionName(event.instruction) << ' ' << int(event.id) << '@' << event.address << "\","
+        << "\"cat\":\"" << (event.result == COMM_SUCCESS ? "dxl" : "dxl,fail") << "\",\"ph\":\"X\","
+        << "\"ts\":" << start << ",\"dur\":" << duration << ",\"pid\":" << pid << ",\"tid\":" << tid << ","
+        << "\"args\":{\"id\":" << int(event.id) << ",\"instruction\":" << int(event.instruction) << ",\"address\":" << event.address
+        << ",\"length\":" << event.length << ",\"result\":\"" << resultName(event.result) << "\",\"error\":" << int(event.error) << "}}";
+}
+
+std::string DXLTrace::chromeJson() const {
+    std::lock_guard<std::mutex> lock(registryLock);
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    // Process 1: one track per recording thread. Process 2: one track per bus.
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"DXL threads\"}},\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"DXL buses\"}}";
+    for (size_t i = 0; i < buffers.size(); i++) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffers[i]->tid << ",\"args\":{\"name\":\"thread " << buffers[i]->tid << "\"}}";
+    }
+    for (size_t i = 0; i < busNames.size(); i++) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":" << (i + 1) << ",\"args\":{\"name\":";
+        jsonString(out, busNames[i].second);
+        out << "}}";
+    }
+
+    for (size_t i = 0; i < buffers.size(); i++) {
+        size_t count = buffers[i]->count.load(std::memory_order_acquire);
+        for (size_t e = 0; e < count; e++) {
+            const DXLTraceEvent &event = buffers[i]->events[e];
+            int busTid = 0;
+            for (size_t b = 0; b < busNames.size(); b++) {
+                if (busNames[b].first == event.bus) {
+                    busTid = int(b) + 1;
+                    break;
+                }
+            }
+            out << ",\n";
+            writeEvent(out, event, epochUs, 1, buffers[i]->tid);
+            out << ",\n";
+            writeEvent(out, event, epochUs, 2, busTid);
+        }
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+bool DXLTrace::exportChromeJson(const std::string &path) const {
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!file.is_open())    return false;
+    file << chromeJson();
+    return file.good();
+}
+
+/*
+////////////////////////////////////////////////////    Example Code Using DXLTrace    ///////////////////////////////////////////////////////////////////////////
+    DXLTrace::instance().enable(true);
+
+    for (int x = 0; x < 10; x++) {
+        tiltServo.writeGoalPosition(x);                 // Goal write followed by isMoving() polling
+    }
+
+    DXLTrace::instance().enable(false);
+    if (!DXLTrace::instance().exportChromeJson("dxl_trace.json")) {
+        printf("Failed to write trace file!\n");
+    }
+    printf("%zu events, %llu dropped\n", DXLTrace::instance().eventCount(), (unsigned long long)DXLTrace::instance().droppedCount());
+    // Open dxl_trace.json in https://ui.perfetto.dev
+// End of Example Code
+*/
@@ -0,0 +1,72 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Transaction tracing for DXLServo packet calls, exported as Chrome trace-event JSON (open in Perfetto or chrome://tracing).
+
+Each thread records into its own preallocated buffer, no locks on the recording path after the first event of a thread.
+Buffers stop recording when full (dropped count kept) instead of wrapping, so export never reads a half written event.
+Export shows one track per thread and one track per bus (serial port), overlapping slices on a bus track are collisions between threads.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define DXL_TRACE_DEFAULT_CAPACITY      65536               // Events per thread buffer, ~2MB per tracing thread
+
+struct DXLTraceEvent {
+    uint64_t startUs, endUs;                                // DXLBusStats::nowUs() time base
+    const void *bus;                                        // PortHandler used, identifies bus track
+    int result;                                             // COMM_* result
+    uint16_t address, length;                               // First register and byte count, 0 for reboot/ping
+    uint8_t id, instruction, error;                         // Servo ID, INST_*, status packet error byte
+};
+
+class DXLTrace {
+private:
+    struct ThreadBuffer {
+        std::vector<DXLTraceEvent> events;                  // Preallocated, written only by owner thread
+        std::atomic<size_t> count;                          // Events published, release store after each write
+        std::atomic<uint64_t> dropped;                      // Events lost to full buffer
+        const void *lastBus;                                // Last bus named by this thread, avoids registry lock per event
+        int tid;                                            // Track number in export
+    };
+
+    std::atomic<bool> enabled;
+    std::atomic<size_t> capacity;
+    std::atomic<uint64_t> generation;                       // Bumped by clear(), threads re-register on mismatch
+    uint64_t epochUs;                                       // Trace start, subtracted from exported timestamps
+
+    mutable std::mutex registryLock;                        // Guards buffers and busNames, never taken on recording path once thread registered
+    std::vector<ThreadBuffer *> buffers;
+    std::vector<std::pair<const void *, std::string> > busNames;
+
+    DXLTrace();
+    ~DXLTrace();
+    DXLTrace(const DXLTrace &) = delete;
+    DXLTrace &operator=(const DXLTrace &) = delete;
+
+    ThreadBuffer *threadBuffer();
+    void nameBus(const void *bus, const char *name);
+
+public:
+    static DXLTrace &instance();                            // Single trace per process, shared by all DXLServo objects
+
+    void enable(bool on);                                   // Start/stop recording. First enable sets trace time origin.
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    void setCapacity(size_t events);                        // Events per thread buffer, applies to buffers created after call (use before enable or after clear)
+    void clear();                                           // Drop all recorded events and buffers. Call while no thread is recording.
+
+    void record(const DXLTraceEvent &event, const char *busName);       // Record one transaction in calling thread's buffer. busName only read when thread sees a new bus.
+
+    size_t eventCount() const;                              // Events recorded across all threads
+    uint64_t droppedCount() const;                          // Events lost to full buffers
+    std::string chromeJson() const;                         // Chrome trace-event JSON of all recorded events
+    bool exportChromeJson(const std::string &path) const;   // Write chromeJson() to file. Returns false if file cannot be written.
+
+    static const char *instructionName(uint8_t instruction);
+};
@@ -0,0 +1,406 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Precompiled binary trajectory files, memory mapped. See DXLTrajectoryFile.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLTrajectoryFile.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool hostLittleEndian() {
+    uint16_t probe = 1;
+    return *reinterpret_cast<uint8_t *>(&probe) == 1;
+}
+
+static size_t pageSize() {
+    static size_t size = size_t(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+////////////////////////////////////////////////////   DXLTrajectoryFile definition   ////////////////////////////////////////////////////////////////////////////////////////
+
+DXLTrajectoryFile::DXLTrajectoryFile() : fd(-1), base(0), length(0), header(0), axisTable(0) {}
+
+DXLTrajectoryFile::~DXLTrajectoryFile() {
+    close();
+}
+
+bool DXLTrajectoryFile::open(const std::string &path) {
+    close();
+    if (!hostLittleEndian()) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory files are little endian, not supported on this host");
+        return false;
+    }
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot open trajectory %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(DXLTrajectoryHeader)) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory %s too short", path.c_str());
+        close();
+        return false;
+    }
+    length = size_t(info.st_size);
+    void *mapped = mmap(0, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot map trajectory %s: %s", path.c_str(), strerror(errno));
+        base = 0;
+        close();
+        return false;
+    }
+    base = static_cast<uint8_t *>(mapped);
+    header = reinterpret_cast<const DXLTrajectoryHeader *>(base);
+    axisTable = reinterpret_cast<const DXLTrajectoryAxisHeader *>(base + sizeof(DXLTrajectoryHeader));
+
+    const char *problem = 0;                            // Everything the accessors rely on is checked here, once
+    if (memcmp(header->magic, DXL_TRAJECTORY_MAGIC, 8) != 0)    problem = "not a trajectory file";
+    else if (header->version != DXL_TRAJECTORY_VERSION || header->headerSize != sizeof(DXLTrajectoryHeader))    problem = "unsupported version";
+    else if (header->units != DXL_TRAJECTORY_UNITS_POSITION)    problem = "unsupported units";
+    else if (header->axisCount == 0 || header->axisCount > DXL_TRAJECTORY_MAX_AXES)    problem = "bad axis count";
+    else if (!(header->rateHz > 0.0))   problem = "bad rate";
+    else if (header->fileSize != length)    problem = "truncated";
+    else if (sizeof(DXLTrajectoryHeader) + header->axisCount * sizeof(DXLTrajectoryAxisHeader) > length)   problem = "truncated axis table";
+    else if (header->sampleCount > (length / sizeof(int32_t)))  problem = "bad sample count";
+    else {
+        for (uint32_t a = 0; a < header->axisCount && problem == 0; a++) {
+            const DXLTrajectoryAxisHeader &entry = axisTable[a];
+            if (entry.columnOffset % sizeof(int32_t) != 0 || entry.columnOffset > length || header->sampleCount * sizeof(int32_t) > length - entry.columnOffset)     problem = "column outside file";
+            else if (entry.model != DXL_MX_64 && entry.model != DXL_PRO_M42)    problem = "unknown servo model";
+        }
+    }
+    if (problem != 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory %s: %s", path.c_str(), problem);
+        close();
+        return false;
+    }
+
+    madvise(base, length, MADV_SEQUENTIAL);             // Read ahead aggressively, pages behind are first to go
+    released.assign(header->axisCount, 0);
+    DXL_LOG_INFO(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory %s: %u axes, %llu samples at %.1f Hz", path.c_str(),
+        header->axisCount, (unsigned long long)header->sampleCount, header->rateHz);
+    return true;
+}
+
+void DXLTrajectoryFile::close() {
+    if (base != 0)  munmap(base, length);
+    if (fd >= 0)    ::close(fd);
+    fd = -1;
+    base = 0;
+    length = 0;
+    header = 0;
+    axisTable = 0;
+    released.clear();
+}
+
+bool DXLTrajectoryFile::checkServo(size_t index, DXLServo &servo) const {
+    if (!isOpen() || index >= axisCount())  return false;
+    const DXLTrajectoryAxisHeader &entry = axisTable[index];
+    if (entry.model != servo.servoType) {
+        DXL_LOG_ERROR(servo.identity, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory axis %d is for a different servo model", int(index));
+        return false;
+    }
+    if (entry.id != 0 && entry.id != servo.identity) {
+        DXL_LOG_ERROR(servo.identity, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory axis %d compiled for ID %d", int(index), entry.id);
+        return false;
+    }
+    int homing = servo.getHomingOffset();
+    if (servo.dxl_comm_result != COMM_SUCCESS)  return false;     // Logged by getHomingOffset()
+    if (homing != entry.homingOffset) {
+        DXL_LOG_ERROR(servo.identity, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory axis %d compiled with homing offset %d, servo has %d", int(index), entry.homingOffset, homing);
+        return false;
+    }
+    if (header->sampleCount > 0 && (entry.minPosition < servo.getPositionLimitSetting(false) || entry.maxPosition > servo.getPositionLimitSetting(true))) {
+        DXL_LOG_ERROR(servo.identity, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory axis %d range %d - %d outside position limits", int(index), entry.minPosition, entry.maxPosition);
+        return false;
+    }
+    return true;
+}
+
+bool DXLTrajectoryFile::bindServo(size_t index, DXLServo &servo) const {
+    if (!checkServo(index, servo))  return false;
+    servo.useGoalPositions(column(index), size_t(header->sampleCount), axisTable[index].minPosition, axisTable[index].maxPosition);
+    return true;
+}
+
+void DXLTrajectoryFile::prefetch(uint64_t from, uint64_t count) const {
+    if (!isOpen() || from >= header->sampleCount)   return;
+    count = std::min(count, header->sampleCount - from);
+    for (uint32_t a = 0; a < header->axisCount; a++) {
+        uint64_t start = axisTable[a].columnOffset + from * sizeof(int32_t);
+        uint64_t pageStart = start / pageSize() * pageSize();
+        madvise(base + pageStart, size_t(start + count * sizeof(int32_t) - pageStart), MADV_WILLNEED);
+    }
+}
+
+void DXLTrajectoryFile::release(uint64_t before) {
+    if (!isOpen())  return;
+    before = std::min(before, header->sampleCount);
+    for (uint32_t a = 0; a < header->axisCount; a++) {
+        uint64_t from = axisTable[a].columnOffset + released[a] * sizeof(int32_t);
+        uint64_t to = axisTable[a].columnOffset + before * sizeof(int32_t);
+        uint64_t pageFrom = alignUp(from, pageSize());  // Whole pages only, neighbours may still be playing
+        uint64_t pageTo = to / pageSize() * pageSize();
+        if (pageTo <= pageFrom)     continue;
+        madvise(base + pageFrom, size_t(pageTo - pageFrom), MADV_DONTNEED);
+#if defined(__linux__)
+        posix_fadvise(fd, off_t(pageFrom), off_t(pageTo - pageFrom), POSIX_FADV_DONTNEED);     // Out of the page cache too
+#endif
+        released[a] = (pageTo - axisTable[a].columnOffset) / sizeof(int32_t);
+    }
+}
+
+////////////////////////////////////////////////////   DXLTrajectoryWriter definition   ////////////////////////////////////////////////////////////////////////////////////////
+
+DXLTrajectoryWriter::DXLTrajectoryWriter() : fd(-1), base(0), length(0), header(0), axisTable(0) {}
+
+DXLTrajectoryWriter::~DXLTrajectoryWriter() {
+    if (base != 0)  munmap(base, length);
+    if (fd >= 0)    ::close(fd);
+}
+
+bool DXLTrajectoryWriter::create(const std::string &path, const std::vector<DXLTrajectoryAxis> &axes, uint64_t samples, double rateHz) {
+    if (base != 0 || axes.empty() || axes.size() > DXL_TRAJECTORY_MAX_AXES || !(rateHz > 0.0) || !hostLittleEndian())    return false;
+    uint64_t columnBytes = alignUp(samples * sizeof(int32_t), DXL_TRAJECTORY_ALIGN);
+    uint64_t dataOffset = alignUp(sizeof(DXLTrajectoryHeader) + axes.size() * sizeof(DXLTrajectoryAxisHeader), DXL_TRAJECTORY_ALIGN);
+    length = size_t(dataOffset + columnBytes * axes.size());
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || ftruncate(fd, off_t(length)) != 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot create trajectory %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    void *mapped = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot map trajectory %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    base = static_cast<uint8_t *>(mapped);
+    header = reinterpret_cast<DXLTrajectoryHeader *>(base);
+    axisTable = reinterpret_cast<DXLTrajectoryAxisHeader *>(base + sizeof(DXLTrajectoryHeader));
+
+    memcpy(header->magic, DXL_TRAJECTORY_MAGIC, 8);
+    header->version = DXL_TRAJECTORY_VERSION;
+    header->headerSize = sizeof(DXLTrajectoryHeader);
+    header->axisCount = uint32_t(axes.size());
+    header->units = DXL_TRAJECTORY_UNITS_POSITION;
+    header->sampleCount = samples;
+    header->rateHz = rateHz;
+    header->fileSize = length;
+    for (size_t a = 0; a < axes.size(); a++) {
+        axisTable[a].model = axes[a].model;
+        axisTable[a].id = axes[a].id;
+        axisTable[a].homingOffset = axes[a].homingOffset;
+        axisTable[a].columnOffset = dataOffset + columnBytes * a;
+    }
+    return true;
+}
+
+int32_t *DXLTrajectoryWriter::column(size_t index) {
+    return reinterpret_cast<int32_t *>(base + axisTable[index].columnOffset);
+}
+
+void DXLTrajectoryWriter::setSample(uint64_t index, const int32_t *values) {
+    for (uint32_t a = 0; a < header->axisCount; a++)    column(a)[index] = values[a];
+}
+
+bool DXLTrajectoryWriter::finish() {
+    if (base == 0)  return false;
+    for (uint32_t a = 0; a < header->axisCount; a++) {
+        const int32_t *values = column(a);
+        int32_t low = 0, high = 0;
+        if (header->sampleCount > 0) {
+            std::pair<const int32_t *, const int32_t *> range = std::minmax_element(values, values + header->sampleCount);
+            low = *range.first, high = *range.second;
+        }
+        axisTable[a].minPosition = low, axisTable[a].maxPosition = high;
+    }
+    bool ok = (msync(base, length, MS_SYNC) == 0);
+    munmap(base, length);
+    ok = (::close(fd) == 0) && ok;
+    base = 0, fd = -1;
+    header = 0, axisTable = 0;
+    return ok;
+}
+
+static int angleToPosition(int model, double angle, int homingOffset) {     // As convertPostoVal(), then homing offset off as writeGoalAngle()
+    int value = (model == DXL_PRO_M42) ? int(angle * (131593.0 / 180.0) + 0.5) : int(angle * (4095.0 / 360.0) + 0.5);
+    return value - homingOffset;
+}
+
+bool dxlCompileTrajectory(const std::string &textPath, const std::string &outPath, const std::vector<DXLTrajectoryAxis> &axes, double rateHz, bool angles) {
+    FILE *in = fopen(textPath.c_str(), "r");
+    if (in == 0) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Cannot open %s: %s", textPath.c_str(), strerror(errno));
+        return false;
+    }
+    char line[1024];
+    uint64_t samples = 0;                               // First pass counts samples so the file is sized once
+    while (fgets(line, sizeof(line), in) != 0) {
+        char *p = line + strspn(line, " \t\r\n,");
+        if (*p != 0 && *p != '#')   samples++;
+    }
+
+    DXLTrajectoryWriter writer;
+    if (!writer.create(outPath, axes, samples, rateHz)) {
+        fclose(in);
+        return false;
+    }
+    rewind(in);
+    std::vector<int32_t> row(axes.size());
+    uint64_t index = 0;
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), in) != 0) {
+        lineNumber++;
+        char *p = line + strspn(line, " \t\r\n,");
+        if (*p == 0 || *p == '#')   continue;
+        for (size_t a = 0; a < axes.size(); a++) {
+            p += strspn(p, " \t,");
+            char *end;
+            double value = strtod(p, &end);
+            if (end == p) {
+                DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "%s:%d: expected %d values", textPath.c_str(), lineNumber, int(axes.size()));
+                ok = false;
+                break;
+            }
+            row[a] = angles ? angleToPosition(axes[a].model, value, axes[a].homingOffset) : int32_t(value);
+            p = end;
+        }
+        if (ok)     writer.setSample(index++, row.data());
+    }
+    fclose(in);
+    ok = writer.finish() && ok;
+    if (!ok)    unlink(outPath.c_str());
+    return ok;
+}
+
+////////////////////////////////////////////////////   DXLTrajectoryStreamer definition   ////////////////////////////////////////////////////////////////////////////////////////
+
+DXLTrajectoryStreamer::DXLTrajectoryStreamer(DXLTrajectoryFile *trajectory) : file(trajectory), stopRequested(false), played(0) {
+    servos.assign(file->axisCount(), 0);
+}
+
+bool DXLTrajectoryStreamer::attach(size_t axis, DXLServo *servo) {
+    if (axis >= servos.size() || !file->checkServo(axis, *servo))   return false;
+    servos[axis] = servo;
+    param.reserve(servos.size() * 9);                   // Bulk Write entry: ID, address (2), length (2), data (4)
+    return true;
+}
+
+int DXLTrajectoryStreamer::sendSample(uint64_t index) {     // Goal bytes go from the mapping into the packet, little endian as on the servo
+    DXLServo *first = 0;
+    bool mixed = false;
+    for (size_t a = 0; a < servos.size(); a++) {
+        if (servos[a] == 0)     continue;
+        if (first == 0)     first = servos[a];
+        else if (servos[a]->servoType != first->servoType)  mixed = true;
+    }
+    if (first == 0)     return COMM_NOT_AVAILABLE;
+
+    param.clear();
+    for (size_t a = 0; a < servos.size(); a++) {
+        if (servos[a] == 0)     continue;
+        const uint8_t *goal = reinterpret_cast<const uint8_t *>(file->column(a) + index);
+        param.push_back(uint8_t(servos[a]->identity));
+        if (mixed) {
+            uint16_t address = (servos[a]->servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION;
+            param.push_back(DXL_LOBYTE(address));
+            param.push_back(DXL_HIBYTE(address));
+            param.push_back(4);
+            param.push_back(0);
+        }
+        param.insert(param.end(), goal, goal + 4);
+    }
+    if (mixed)  return first->pktHandler->bulkWriteTxOnly(first->prtHandler, param.data(), uint16_t(param.size()));
+    uint16_t address = (first->servoType == DXL_PRO_M42) ? ADDR_PRO_GOAL_POSITION : ADDR_MX_GOAL_POSITION;
+    return first->pktHandler->syncWriteTxOnly(first->prtHandler, address, 4, param.data(), uint16_t(param.size()));
+}
+
+int DXLTrajectoryStreamer::writeSample(uint64_t index) {
+    if (index >= file->sampleCount())   return COMM_NOT_AVAILABLE;
+    DXLServo *first = 0;
+    for (size_t a = 0; a < servos.size() && first == 0; a++)    first = servos[a];
+    if (first == 0)     return COMM_NOT_AVAILABLE;
+
+    int result;
+    if (first->getBusScheduler() != 0)  result = first->getBusScheduler()->runSync(DXL_PRIO_CONTROL, [&]() { return sendSample(index); });
+    else                                result = sendSample(index);
+    first->dxl_comm_result = result;
+    if (result != COMM_SUCCESS)     DXL_LOG_ERROR(first->identity, DXL_LOG_NONE, result, "%s", first->pktHandler->getTxRxResult(result));
+    return result;
+}
+
+int DXLTrajectoryStreamer::play(uint64_t from, uint64_t count) {
+    stopRequested.store(false);
+    played = 0;
+    uint64_t end = (count > file->sampleCount() - std::min(from, file->sampleCount())) ? file->sampleCount() : from + count;
+    uint64_t window = std::max<uint64_t>(1, uint64_t(file->rateHz() * DXL_TRAJECTORY_WINDOW_SEC));
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double periodUs = 1.0e6 / file->rateHz();
+
+    int result = COMM_SUCCESS;
+    for (uint64_t i = from; i < end && !stopRequested.load(std::memory_order_relaxed); i++) {
+        if ((i - from) % window == 0) {                 // Next window in, played ones out: resident set stays at about two windows
+            file->prefetch(i + window, window);
+            if (i >= from + window)     file->release(i - window);
+            if (i == from)  file->prefetch(i, window);
+        }
+        std::this_thread::sleep_until(start + std::chrono::microseconds(int64_t(double(i - from) * periodUs)));
+        result = writeSample(i);
+        if (result != COMM_SUCCESS)     break;
+        played++;
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////    Example Code Using DXLTrajectoryFile    ///////////////////////////////////////////////////////////////////////////
+/*
+int main() {
+    DXLServo pan, tilt;
+    pan.setDXLServo(0), tilt.setDXLServo(0);
+    pan.identity = 1, tilt.identity = 2;
+    pan.initPortHandler(), pan.initPacketHandler();
+    tilt.prtHandler = pan.prtHandler, tilt.pktHandler = pan.pktHandler;
+
+    // Once, offline: scan.txt holds "pan tilt" angles per line, 100 samples per second
+    std::vector<DXLTrajectoryAxis> axes;
+    axes.push_back(DXLTrajectoryAxis(DXL_MX_64, 1, pan.getHomingOffset()));
+    axes.push_back(DXLTrajectoryAxis(DXL_MX_64, 2, tilt.getHomingOffset()));
+    if (!dxlCompileTrajectory("scan.txt", "scan.traj", axes, 100.0, true))     return 1;
+
+    DXLTrajectoryFile scan;
+    if (!scan.open("scan.traj"))    return 1;           // One mmap(), however long the pattern
+
+    DXLTrajectoryStreamer streamer(&scan);
+    if (!streamer.attach(0, &pan) || !streamer.attach(1, &tilt))    return 1;
+    pan.enableTorque(), tilt.enableTorque();
+    int result = streamer.play();                       // Both goals per sample in one Sync Write, paced at 100 Hz
+    printf("played %llu of %llu samples, result %d\n", (unsigned long long)streamer.samplesPlayed(), (unsigned long long)scan.sampleCount(), result);
+
+    // Or point by point through the servo's own goal writer, no copy into goalPositionVector
+    if (scan.bindServo(0, pan)) {
+        for (int i = 0; i < 10; i++)    pan.writeGoalPosition(i);
+    }
+    return 0;
+}
+*/
+// End of Example Code
+
+#endif
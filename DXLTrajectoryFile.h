@@ -0,0 +1,144 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Precompiled binary trajectory files, memory mapped.
+
+Long scan patterns are compiled once (from text, or written directly with DXLTrajectoryWriter) into goal position values
+ready for the Goal Position register, and played from the mapping: open() is one mmap() whatever the length, nothing is
+parsed or converted at load, and only the pages being played are resident.
+
+Layout, little endian:
+    DXLTrajectoryHeader         64 bytes: magic "DXLTRAJ", version, axis count, units, samples per axis, rate
+    DXLTrajectoryAxisHeader     32 bytes per axis: servo model, ID, homing offset compiled with, value range, column offset
+    columns                     one packed int32 column per axis, samples values each, 64 byte aligned
+Goal values already have the homing offset taken off, as writeGoalAngle() does, so a file is only valid with the homing
+offset it was compiled for; attaching a servo checks model, ID, homing offset and position limits against the header.
+
+Playback:
+    DXLServo::useGoalPositions()    writeGoalPosition(index) reads the mapped column directly, see bindServo()
+    DXLTrajectoryStreamer           all axes of a sample in one Sync Write (Bulk Write for mixed MX/Pro) straight from the
+                                    columns, paced at the file rate, pages behind the play position dropped as it goes
+Linux and macOS.
+*////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__linux__) || defined(__APPLE__)
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+#define DXL_TRAJECTORY_MAGIC            "DXLTRAJ"       // 8 bytes with terminator
+#define DXL_TRAJECTORY_VERSION          1
+#define DXL_TRAJECTORY_MAX_AXES         64
+#define DXL_TRAJECTORY_ALIGN            64              // Column alignment, bytes
+#define DXL_TRAJECTORY_UNITS_POSITION   0               // Goal Position register values
+#define DXL_TRAJECTORY_WINDOW_SEC       1.0             // Streamer prefetches this far ahead and drops pages this far behind
+
+struct DXLTrajectoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;                                // sizeof(DXLTrajectoryHeader), axis table follows
+    uint32_t axisCount;
+    uint32_t units;                                     // DXL_TRAJECTORY_UNITS_*
+    uint64_t sampleCount;                               // Per axis
+    double rateHz;                                      // Samples per second
+    uint64_t fileSize;
+    uint8_t reserved[16];
+};
+
+struct DXLTrajectoryAxisHeader {
+    int32_t model;                                      // DXL_MX_64 or DXL_PRO_M42
+    int32_t id;                                         // Servo ID compiled for, 0 any
+    int32_t homingOffset;                               // Taken off angles at compile time
+    int32_t minPosition, maxPosition;                   // Range of the column
+    uint32_t reserved;
+    uint64_t columnOffset;                              // File offset of the int32 column
+};
+
+struct DXLTrajectoryAxis {                              // Axis description for DXLTrajectoryWriter and dxlCompileTrajectory()
+    int model, id, homingOffset;
+
+    DXLTrajectoryAxis(int servoModel = DXL_MX_64, int servoId = 0, int homing = 0) : model(servoModel), id(servoId), homingOffset(homing) {}
+};
+
+class DXLTrajectoryFile {
+private:
+    int fd;
+    uint8_t *base;
+    size_t length;
+    const DXLTrajectoryHeader *header;
+    const DXLTrajectoryAxisHeader *axisTable;
+    std::vector<uint64_t> released;                     // Per axis, samples before this already dropped
+
+public:
+    DXLTrajectoryFile();
+    ~DXLTrajectoryFile();
+    DXLTrajectoryFile(const DXLTrajectoryFile &) = delete;
+    DXLTrajectoryFile &operator=(const DXLTrajectoryFile &) = delete;
+
+    bool open(const std::string &path);                 // Maps and checks the file, logs and returns false if invalid
+    void close();
+    bool isOpen() const { return base != 0; }
+
+    size_t axisCount() const { return header ? header->axisCount : 0; }
+    uint64_t sampleCount() const { return header ? header->sampleCount : 0; }
+    double rateHz() const { return header ? header->rateHz : 0.0; }
+    const DXLTrajectoryAxisHeader &axis(size_t index) const { return axisTable[index]; }
+    const int32_t *column(size_t index) const { return reinterpret_cast<const int32_t *>(base + axisTable[index].columnOffset); }
+
+    bool checkServo(size_t index, DXLServo &servo) const;   // Model, ID, homing offset (one read) and limits match the axis
+    bool bindServo(size_t index, DXLServo &servo) const;    // checkServo(), then servo.useGoalPositions() on the mapped column
+
+    void prefetch(uint64_t from, uint64_t count) const;     // Ask for the pages of these samples ahead of use
+    void release(uint64_t before);                      // Drop pages of samples before this from memory, they are read again if needed
+};
+
+class DXLTrajectoryWriter {
+private:
+    int fd;
+    uint8_t *base;
+    size_t length;
+    DXLTrajectoryHeader *header;
+    DXLTrajectoryAxisHeader *axisTable;
+
+public:
+    DXLTrajectoryWriter();
+    ~DXLTrajectoryWriter();
+    DXLTrajectoryWriter(const DXLTrajectoryWriter &) = delete;
+    DXLTrajectoryWriter &operator=(const DXLTrajectoryWriter &) = delete;
+
+    bool create(const std::string &path, const std::vector<DXLTrajectoryAxis> &axes, uint64_t samples, double rateHz);
+    int32_t *column(size_t index);                      // Fill directly, or with setSample()
+    void setSample(uint64_t index, const int32_t *values);     // One value per axis
+    bool finish();                                      // Value ranges into the header, written out and closed
+};
+
+// Text to binary: one line per sample, one value per axis separated by spaces, tabs or commas, '#' starts a comment.
+// angles: values are degrees, converted as writeGoalAngle() does (convertPostoVal() minus homing offset), else position values.
+bool dxlCompileTrajectory(const std::string &textPath, const std::string &outPath, const std::vector<DXLTrajectoryAxis> &axes, double rateHz, bool angles);
+
+class DXLTrajectoryStreamer {
+private:
+    DXLTrajectoryFile *file;
+    std::vector<DXLServo *> servos;                     // By axis, 0 for axes not played
+    std::vector<uint8_t> param;                         // Sync/Bulk Write parameters, sized once
+    std::atomic<bool> stopRequested;
+    uint64_t played;
+
+    int sendSample(uint64_t index);
+
+public:
+    explicit DXLTrajectoryStreamer(DXLTrajectoryFile *trajectory);
+
+    bool attach(size_t axis, DXLServo *servo);          // checkServo() first, false if it does not match
+    int writeSample(uint64_t index);                    // One packet with every attached axis' goal, through the bus scheduler if set. COMM_* result.
+    int play(uint64_t from = 0, uint64_t count = UINT64_MAX);   // Paced at the file rate until done, stop() or a failed write
+    void stop() { stopRequested.store(true); }          // From another thread, play() returns after the current sample
+    uint64_t samplesPlayed() const { return played; }
+};
+
+#endif
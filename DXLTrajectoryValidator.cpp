@@ -0,0 +1,291 @@
+/*///////////////////////////////////////////////////////////////////////////////
+Batch limit checks over whole multi-axis trajectories, every violation reported. See DXLTrajectoryValidator.h.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include "DXLTrajectoryValidator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define ROUNDING_SHARE                  0.25            // Rounding band's largest share of a windowed bound
+#define MAX_WINDOW                      256             // Samples, longest difference window
+
+struct ColumnLimits {                                   // Integer thresholds per window, violation when strictly beyond
+    int32_t minPosition, maxPosition;
+    int32_t velocity, accel;
+    uint32_t velocityWindow, accelWindow;               // Samples the first and second differences span
+};
+
+// Unrounded bound over a window plus what the rounding band adds to it, in whole position values
+static int32_t windowThreshold(double bound, double rounding) {
+    if (!(bound > 0.0) || bound + rounding >= double(INT32_MAX))  return INT32_MAX;
+    return int32_t(floor(bound + rounding));            // |difference| > floor(x) exactly when > x, differences being whole
+}
+
+// Fewest samples k for which the band's share of growth * k^power stays within ROUNDING_SHARE
+static uint32_t windowFor(double growth, double rounding, int power) {
+    if (!(growth > 0.0))    return 1;
+    double k = ceil(pow(rounding / (ROUNDING_SHARE * growth), 1.0 / power));
+    return (k <= 1.0) ? 1 : uint32_t(std::min(k, double(MAX_WINDOW)));
+}
+
+////////////////////////////////////////////////////   Block kernels   /////////////////////////////////////////////////////////////////////////////////////////
+
+// First i from start, in steps of DXL_VALIDATE_LANES, whose block i .. i + lanes - 1 holds a violation, or end if none does.
+// Velocity at i is q[i] - q[i - velocityWindow], acceleration q[i + k] - 2q[i] + q[i - k] with k = accelWindow, so start >= both
+// windows and end + lanes - 1 + accelWindow <= samples - 1. A lane whose int32 difference wraps is marked dirty, the scalar
+// pass after works in 64 bits and decides.
+static uint64_t nextDirtyBlock(const int32_t *q, uint64_t start, uint64_t end, const ColumnLimits &limits) {
+    const size_t kv = limits.velocityWindow, ka = limits.accelWindow;
+#if defined(__AVX2__)
+    const __m256i below = _mm256_set1_epi32(limits.minPosition), above = _mm256_set1_epi32(limits.maxPosition);
+    const __m256i velocity = _mm256_set1_epi32(limits.velocity), velocityNeg = _mm256_set1_epi32(-limits.velocity);
+    const __m256i accel = _mm256_set1_epi32(limits.accel), accelNeg = _mm256_set1_epi32(-limits.accel);
+    for (uint64_t i = start; i < end; i += 8) {
+        __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(q + i));
+        __m256i back = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(q + i - kv));
+        __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(q + i - ka));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(q + i + ka));
+        __m256i vel = _mm256_sub_epi32(cur, back);
+        __m256i rise = _mm256_sub_epi32(next, cur), fall = _mm256_sub_epi32(cur, prev);
+        __m256i acc = _mm256_sub_epi32(rise, fall);
+        __m256i wrap = _mm256_and_si256(_mm256_xor_si256(cur, back), _mm256_xor_si256(cur, vel));     // a - b wraps when a, b and a, a - b differ in sign
+        wrap = _mm256_or_si256(wrap, _mm256_and_si256(_mm256_xor_si256(next, cur), _mm256_xor_si256(next, rise)));
+        wrap = _mm256_or_si256(wrap, _mm256_and_si256(_mm256_xor_si256(cur, prev), _mm256_xor_si256(cur, fall)));
+        wrap = _mm256_or_si256(wrap, _mm256_and_si256(_mm256_xor_si256(rise, fall), _mm256_xor_si256(rise, acc)));
+        __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi32(below, cur), _mm256_cmpgt_epi32(cur, above));
+        bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi32(vel, velocity), _mm256_cmpgt_epi32(velocityNeg, vel)));
+        bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi32(acc, accel), _mm256_cmpgt_epi32(accelNeg, acc)));
+        bad = _mm256_or_si256(bad, _mm256_srai_epi32(wrap, 31));
+        if (!_mm256_testz_si256(bad, bad))  return i;
+    }
+#elif defined(__SSE2__)
+    const __m128i below = _mm_set1_epi32(limits.minPosition), above = _mm_set1_epi32(limits.maxPosition);
+    const __m128i velocity = _mm_set1_epi32(limits.velocity), velocityNeg = _mm_set1_epi32(-limits.velocity);
+    const __m128i accel = _mm_set1_epi32(limits.accel), accelNeg = _mm_set1_epi32(-limits.accel);
+    for (uint64_t i = start; i < end; i += 4) {
+        __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q + i));
+        __m128i back = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q + i - kv));
+        __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q + i - ka));
+        __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q + i + ka));
+        __m128i vel = _mm_sub_epi32(cur, back);
+        __m128i rise = _mm_sub_epi32(next, cur), fall = _mm_sub_epi32(cur, prev);
+        __m128i acc = _mm_sub_epi32(rise, fall);
+        __m128i wrap = _mm_and_si128(_mm_xor_si128(cur, back), _mm_xor_si128(cur, vel));
+        wrap = _mm_or_si128(wrap, _mm_and_si128(_mm_xor_si128(next, cur), _mm_xor_si128(next, rise)));
+        wrap = _mm_or_si128(wrap, _mm_and_si128(_mm_xor_si128(cur, prev), _mm_xor_si128(cur, fall)));
+        wrap = _mm_or_si128(wrap, _mm_and_si128(_mm_xor_si128(rise, fall), _mm_xor_si128(rise, acc)));
+        __m128i bad = _mm_or_si128(_mm_cmplt_epi32(cur, below), _mm_cmpgt_epi32(cur, above));
+        bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmpgt_epi32(vel, velocity), _mm_cmplt_epi32(vel, velocityNeg)));
+        bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmpgt_epi32(acc, accel), _mm_cmplt_epi32(acc, accelNeg)));
+        bad = _mm_or_si128(bad, _mm_srai_epi32(wrap, 31));
+        if (_mm_movemask_epi8(bad) != 0)    return i;
+    }
+#elif defined(__ARM_NEON)
+    const int32x4_t below = vdupq_n_s32(limits.minPosition), above = vdupq_n_s32(limits.maxPosition);
+    const int32x4_t velocity = vdupq_n_s32(limits.velocity), velocityNeg = vdupq_n_s32(-limits.velocity);
+    const int32x4_t accel = vdupq_n_s32(limits.accel), accelNeg = vdupq_n_s32(-limits.accel);
+    for (uint64_t i = start; i < end; i += 4) {
+        int32x4_t cur = vld1q_s32(q + i), back = vld1q_s32(q + i - kv), prev = vld1q_s32(q + i - ka), next = vld1q_s32(q + i + ka);
+        int32x4_t vel = vsubq_s32(cur, back);
+        int32x4_t rise = vsubq_s32(next, cur), fall = vsubq_s32(cur, prev);
+        int32x4_t acc = vsubq_s32(rise, fall);
+        int32x4_t wrap = vandq_s32(veorq_s32(cur, back), veorq_s32(cur, vel));
+        wrap = vorrq_s32(wrap, vandq_s32(veorq_s32(next, cur), veorq_s32(next, rise)));
+        wrap = vorrq_s32(wrap, vandq_s32(veorq_s32(cur, prev), veorq_s32(cur, fall)));
+        wrap = vorrq_s32(wrap, vandq_s32(veorq_s32(rise, fall), veorq_s32(rise, acc)));
+        uint32x4_t bad = vorrq_u32(vcltq_s32(cur, below), vcgtq_s32(cur, above));
+        bad = vorrq_u32(bad, vorrq_u32(vcgtq_s32(vel, velocity), vcltq_s32(vel, velocityNeg)));
+        bad = vorrq_u32(bad, vorrq_u32(vcgtq_s32(acc, accel), vcltq_s32(acc, accelNeg)));
+        bad = vorrq_u32(bad, vreinterpretq_u32_s32(vshrq_n_s32(wrap, 31)));
+#if defined(__aarch64__)
+        if (vmaxvq_u32(bad) != 0)   return i;
+#else
+        uint32x2_t folded = vorr_u32(vget_low_u32(bad), vget_high_u32(bad));
+        if ((vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0)     return i;
+#endif
+    }
+#else
+    (void)q, (void)start, (void)limits, (void)kv, (void)ka;
+#endif
+    return end;
+}
+
+////////////////////////////////////////////////////   Column validation   /////////////////////////////////////////////////////////////////////////////////////////
+
+struct ColumnCheck {                                    // Scalar check of one sample, records what it finds
+    const int32_t *q;
+    uint64_t samples;
+    const DXLAxisBounds *bounds;
+    ColumnLimits limits;
+    double rateHz;
+    uint32_t axis;
+    std::vector<DXLViolation> *violations;
+    size_t maxViolations, found;
+
+    void record(uint64_t index, int kind, double value, double limit, double margin) {
+        found++;
+        if (found > maxViolations)  return;
+        DXLViolation violation;
+        violation.index = index, violation.axis = axis, violation.kind = kind;
+        violation.value = value, violation.limit = limit, violation.margin = margin;
+        violations->push_back(violation);
+    }
+
+    void sample(uint64_t i) {                           // Windows shortened near the ends, same test as the kernel otherwise
+        int64_t position = q[i];
+        if (position < limits.minPosition)  record(i, DXL_VIOLATION_POSITION, double(position), double(bounds->minPosition), double(position - limits.minPosition));
+        if (position > limits.maxPosition)  record(i, DXL_VIOLATION_POSITION, double(position), double(bounds->maxPosition), double(limits.maxPosition - position));
+        if (i == 0 || !(rateHz > 0.0))  return;
+        if (bounds->velocity > 0.0) {
+            uint64_t k = std::min(uint64_t(limits.velocityWindow), i);
+            int64_t velocity = position - int64_t(q[i - k]);
+            double span = double(k) / rateHz;
+            if (double(std::abs(velocity)) > bounds->velocity * span + 2.0 * DXL_VALIDATE_ROUNDING) {
+                double value = double(velocity) / span;
+                record(i, DXL_VIOLATION_VELOCITY, value, bounds->velocity, bounds->velocity - fabs(value));
+            }
+        }
+        if (i + 1 >= samples || !(bounds->accel > 0.0))    return;
+        uint64_t k = std::min(uint64_t(limits.accelWindow), std::min(i, samples - 1 - i));
+        int64_t accel = int64_t(q[i + k]) - 2 * position + int64_t(q[i - k]);
+        double span = double(k) / rateHz;
+        if (double(std::abs(accel)) > bounds->accel * span * span + 4.0 * DXL_VALIDATE_ROUNDING) {
+            double value = double(accel) / (span * span);
+            record(i, DXL_VIOLATION_ACCEL, value, bounds->accel, bounds->accel - fabs(value));
+        }
+    }
+};
+
+size_t dxlValidateColumn(const int32_t *column, uint64_t samples, const DXLAxisBounds &bounds, double rateHz, uint32_t axis,
+    std::vector<DXLViolation> &violations, size_t maxViolations) {
+    ColumnCheck check;
+    check.q = column, check.samples = samples;
+    check.bounds = &bounds;
+    check.limits.minPosition = bounds.minPosition, check.limits.maxPosition = bounds.maxPosition;
+    check.limits.velocity = check.limits.accel = INT32_MAX;
+    check.limits.velocityWindow = check.limits.accelWindow = 1;
+    if (rateHz > 0.0) {                                 // Windows long enough that the band is a small share of the bound
+        const double velocityBand = 2.0 * DXL_VALIDATE_ROUNDING, accelBand = 4.0 * DXL_VALIDATE_ROUNDING;
+        check.limits.velocityWindow = windowFor(bounds.velocity / rateHz, velocityBand, 1);
+        check.limits.accelWindow = windowFor(bounds.accel / (rateHz * rateHz), accelBand, 2);
+        double velocitySpan = double(check.limits.velocityWindow) / rateHz, accelSpan = double(check.limits.accelWindow) / rateHz;
+        check.limits.velocity = windowThreshold(bounds.velocity * velocitySpan, velocityBand);
+        check.limits.accel = windowThreshold(bounds.accel * accelSpan * accelSpan, accelBand);
+    }
+    check.rateHz = rateHz, check.axis = axis;
+    check.violations = &violations;
+    check.maxViolations = maxViolations, check.found = 0;
+    if (samples == 0)   return 0;
+
+    uint64_t head = std::max(check.limits.velocityWindow, check.limits.accelWindow), tail = check.limits.accelWindow;
+    uint64_t i = 0;
+    if (DXL_VALIDATE_LANES > 1 && samples >= head + tail + DXL_VALIDATE_LANES) {
+        for (; i < head; i++)   check.sample(i);
+        uint64_t end = head + (samples - head - tail) / DXL_VALIDATE_LANES * DXL_VALIDATE_LANES;     // Blocks up to here keep q[i + lanes - 1 + tail] in range
+        while (i < end) {
+            i = nextDirtyBlock(column, i, end, check.limits);
+            if (i >= end)   break;
+            for (uint64_t k = i; k < i + DXL_VALIDATE_LANES; k++)   check.sample(k);
+            i += DXL_VALIDATE_LANES;
+        }
+        i = end;
+    }
+    for (; i < samples; i++)    check.sample(i);
+    return check.found;
+}
+
+////////////////////////////////////////////////////   DXLTrajectoryValidator definition   ////////////////////////////////////////////////////////////////////////////////////////
+
+int DXLTrajectoryValidator::addAxis(const DXLAxisBounds &axisBounds) {
+    bounds.push_back(axisBounds);
+    return int(bounds.size()) - 1;
+}
+
+int DXLTrajectoryValidator::addAxis(const DXLServo &servo, double velocity, double accel) {
+    return addAxis(DXLAxisBounds(servo.getPositionLimitSetting(false), servo.getPositionLimitSetting(true), velocity, accel));
+}
+
+size_t DXLTrajectoryValidator::validate(const int32_t *const *columns, uint64_t samples, std::vector<DXLViolation> &violations) const {
+    size_t found = 0;
+    for (size_t a = 0; a < bounds.size(); a++) {
+        size_t room = SIZE_MAX;                         // Cap shared by all axes
+        if (maxViolations != 0)     room = (found < maxViolations) ? maxViolations - found : 0;
+        found += dxlValidateColumn(columns[a], samples, bounds[a], rateHz, uint32_t(a), violations, room);
+    }
+    return found;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+
+size_t DXLTrajectoryValidator::validate(const DXLTrajectoryFile &file, std::vector<DXLViolation> &violations) const {
+    if (!file.isOpen() || file.axisCount() != bounds.size()) {
+        DXL_LOG_ERROR(DXL_LOG_NONE, DXL_LOG_NONE, DXL_LOG_NONE, "Trajectory has %d axes, validator %d", int(file.axisCount()), int(bounds.size()));
+        return 0;
+    }
+    std::vector<const int32_t *> columns(bounds.size());
+    for (size_t a = 0; a < bounds.size(); a++)  columns[a] = file.column(a);
+    if (rateHz > 0.0)   return validate(columns.data(), file.sampleCount(), violations);
+    DXLTrajectoryValidator atFileRate(*this);
+    atFileRate.setRate(file.rateHz());
+    return atFileRate.validate(columns.data(), file.sampleCount(), violations);
+}
+
+#endif
+
+////////////////////////////////////////////////////    Example Code Using DXLTrajectoryValidator    ///////////////////////////////////////////////////////////////////////////
+/*
+// Rounding check: a trapezoid at the limits, rounded to position values, passes; the same at twice the acceleration fails
+static size_t checkTrapezoid(double accel, double rateHz) {
+    const double velocity = 1000.0, limitAccel = 2000.0, distance = 20000.0;
+    double rampTime = velocity / accel, ramp = 0.5 * accel * rampTime * rampTime, total = 2.0 * rampTime + (distance - 2.0 * ramp) / velocity;
+    std::vector<int32_t> column;
+    for (uint64_t k = 0; double(k) / rateHz <= total; k++) {
+        double t = double(k) / rateHz, position;
+        if (t < rampTime)   position = 0.5 * accel * t * t;
+        else if (t < total - rampTime)  position = ramp + velocity * (t - rampTime);
+        else    position = distance - 0.5 * accel * (total - t) * (total - t);
+        column.push_back(int32_t(llround(position)));
+    }
+    std::vector<DXLViolation> violations;
+    return dxlValidateColumn(column.data(), column.size(), DXLAxisBounds(0, 20000, velocity, limitAccel), rateHz, 0, violations);
+}
+
+int main() {
+    printf("200 Hz: feasible %zu violations, 2x acceleration %zu\n", checkTrapezoid(2000.0, 200.0), checkTrapezoid(4000.0, 200.0));   // 0, > 0
+
+    DXLServo pan, tilt;
+    pan.setDXLServo(0), tilt.setDXLServo(0);
+    pan.identity = 1, tilt.identity = 2;
+    pan.initPortHandler(), pan.initPacketHandler();
+    tilt.prtHandler = pan.prtHandler, tilt.pktHandler = pan.pktHandler;
+    pan.setPositionLimit(false, 1024), pan.setPositionLimit(true, 3072);
+
+    DXLTrajectoryFile scan;
+    if (!scan.open("scan.traj"))    return 1;
+
+    DXLTrajectoryValidator validator;                   // Rate taken from the file
+    validator.addAxis(pan, 3000.0, 7000.0);             // Position limits as set above, velocity/accel in position values per s, s2
+    validator.addAxis(tilt, 3000.0, 7000.0);
+    std::vector<DXLViolation> violations;
+    size_t found = validator.validate(scan, violations);
+    for (size_t i = 0; i < violations.size(); i++) {
+        const DXLViolation &v = violations[i];
+        printf("axis %u sample %llu: %s %.1f, limit %.1f, margin %.1f\n", v.axis, (unsigned long long)v.index,
+            v.kind == DXL_VIOLATION_POSITION ? "position" : (v.kind == DXL_VIOLATION_VELOCITY ? "velocity" : "accel"), v.value, v.limit, v.margin);
+    }
+    if (found > 0)  return 1;                           // Never streamed
+
+    DXLTrajectoryStreamer streamer(&scan);
+    streamer.attach(0, &pan), streamer.attach(1, &tilt);
+    streamer.play();
+    return 0;
+}
+*/
+// End of Example Code
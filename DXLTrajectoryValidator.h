@@ -0,0 +1,87 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Batch limit checks over whole multi-axis trajectories, every violation reported.
+
+Trajectories are int32 goal position columns, one per axis, as DXLTrajectoryFile stores them. One pass over each column
+checks, per sample i:
+    position        minPosition <= q[i] <= maxPosition
+    velocity        |q[i] - q[i-k]| <= velocity * k/rate + 2 band                          (k = velocity window)
+    acceleration    |q[i+k] - 2q[i] + q[i-k]| <= accel * (k/rate)2 + 4 band                (k = acceleration window)
+Samples are whole position values, each up to band (DXL_VALIDATE_ROUNDING) off the exact trajectory, so differences are held
+to the unrounded bound plus what the band can add. Over one sample that would swamp the bound (2000 per s2 at 200 Hz is 0.05
+position values), so the windows are sized per column from the bounds and rate, the band at most a quarter of the windowed
+bound: a rounded copy of a feasible trajectory passes, one that needs twice the acceleration over a window fails. Windows
+shorten near the column ends. Blocks of samples are tested at once (AVX2 8 lanes, SSE2 or NEON 4 lanes, whichever the
+build targets); only blocks holding a violation, or a difference beyond int32, are gone through sample by sample in 64 bits
+to record them. Each violation carries sample index, axis, value (mean over its window), limit and margin (limit - |value|,
+negative), in position values, per second, per second2.
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+#include "DXLTrajectoryFile.h"
+
+#if defined(__AVX2__)
+#define DXL_VALIDATE_LANES          8
+#elif defined(__SSE2__) || defined(__ARM_NEON)
+#define DXL_VALIDATE_LANES          4
+#else
+#define DXL_VALIDATE_LANES          1                   // Scalar only
+#endif
+
+#define DXL_VIOLATION_POSITION      0
+#define DXL_VIOLATION_VELOCITY      1
+#define DXL_VIOLATION_ACCEL         2
+
+#define DXL_VALIDATE_ROUNDING       1.0                 // Position values a sample may sit off the exact trajectory
+#define DXL_VALIDATE_LOG_MAX        10                  // Violations logged one by one by DXLServo checks, the rest counted
+
+struct DXLAxisBounds {
+    int32_t minPosition, maxPosition;                   // Position values
+    double velocity;                                    // Position values per second, <= 0 not checked
+    double accel;                                       // Position values per second2, <= 0 not checked
+
+    DXLAxisBounds(int32_t minimum = INT32_MIN, int32_t maximum = INT32_MAX, double maxVelocity = 0.0, double maxAccel = 0.0)
+        : minPosition(minimum), maxPosition(maximum), velocity(maxVelocity), accel(maxAccel) {}
+};
+
+struct DXLViolation {
+    uint64_t index;                                     // Sample
+    uint32_t axis;
+    int kind;                                           // DXL_VIOLATION_*
+    double value;                                       // Position, velocity or acceleration found (mean over the window)
+    double limit;                                       // Bound broken (for position, the nearer one)
+    double margin;                                      // limit - |value| (position: distance outside the range), negative
+};
+
+// One column against one axis' bounds, rateHz <= 0 checks positions only. Violations appended in index order, at most
+// maxViolations of them. Returns the number found, including any past the cap.
+size_t dxlValidateColumn(const int32_t *column, uint64_t samples, const DXLAxisBounds &bounds, double rateHz, uint32_t axis,
+    std::vector<DXLViolation> &violations, size_t maxViolations = SIZE_MAX);
+
+class DXLTrajectoryValidator {
+private:
+    std::vector<DXLAxisBounds> bounds;
+    double rateHz;
+    size_t maxViolations;
+
+public:
+    explicit DXLTrajectoryValidator(double rate = 0.0) : rateHz(rate), maxViolations(0) {}
+
+    int addAxis(const DXLAxisBounds &axisBounds);       // Returns axis index
+    int addAxis(const DXLServo &servo, double velocity = 0.0, double accel = 0.0);   // Position limits last set through servo, no bus access
+    void clear() { bounds.clear(); }
+    size_t axisCount() const { return bounds.size(); }
+    void setRate(double rate) { rateHz = rate; }        // Samples per second, 0 positions only
+    void setMaxViolations(size_t count) { maxViolations = count; }     // Stop recording after this many, 0 no cap (default)
+
+    // columns[a] holds samples values for axis a. Violations grouped by axis, index order within. Returns the number found.
+    size_t validate(const int32_t *const *columns, uint64_t samples, std::vector<DXLViolation> &violations) const;
+#if defined(__linux__) || defined(__APPLE__)
+    size_t validate(const DXLTrajectoryFile &file, std::vector<DXLViolation> &violations) const;     // At the file's rate if none set
+#endif
+};
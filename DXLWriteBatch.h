@@ -0,0 +1,76 @@
+#pragma once
+
+/*///////////////////////////////////////////////////////////////////////////////
+Register write coalescing.
+
+Writes are queued per servo and sent at flush(). Queued registers that sit next to each other go out as one block
+write instead of one packet each:
+    Pro LED R, G, B (563 - 565):            3 writes -> 1
+    Pro External Port Mode 1 - 4 (44 - 47): 4 writes -> 1
+    MX Position D, I, P, FF2, FF1 (80 - 91): 5 writes -> 2, or 1 with bytes 86 - 87 known
+Ranges up to maxGap bytes apart are also joined if every byte in the gap is known, either queued or given with setKnown()
+(e.g. from a DXLControlTable snapshot). Unknown bytes are never written. A range is not joined across the EEPROM/RAM
+boundary, where one locked byte would fail the whole packet, or beyond maxLength bytes.
+
+Later writes to the same byte replace earlier ones. A failed packet fails every register it carried, see written().
+*////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "DXLProServo.h"
+
+#define DXL_BATCH_MAX_GAP               8               // Bytes, a gap costs less wire time than a second instruction and status packet
+#define DXL_BATCH_MAX_LENGTH            128             // Bytes per block write
+
+struct DXLBatchWrite {
+    DXLServo *servo;
+    uint16_t address, length;
+    size_t registers;                                   // Queued writes carried by this packet
+    int commResult;                                     // COMM_* of the packet, COMM_NOT_AVAILABLE until flushed
+    uint8_t error;                                      // Status packet error byte
+};
+
+struct DXLWriteBatchStats {
+    uint64_t registerWrites;                            // Writes queued and flushed
+    uint64_t packets;                                   // Block writes sent for them
+    uint64_t gapBytes;                                  // Known bytes rewritten to join ranges
+};
+
+class DXLWriteBatch {
+private:
+    struct Pending {
+        DXLServo *servo;
+        std::map<uint16_t, uint8_t> bytes;              // Queued, by address
+        std::map<uint16_t, uint16_t> registers;         // Queued register start -> length, for counting and written()
+        std::map<uint16_t, uint8_t> known;              // Present register contents usable as gap filler
+    };
+
+    std::vector<Pending> pending;
+    std::vector<DXLBatchWrite> results;
+    DXLWriteBatchStats stats;
+    int maxGap, maxLength;
+
+    Pending &entryFor(DXLServo &servo);
+    bool gapKnown(const Pending &entry, uint16_t from, uint16_t to) const;  // Every byte in [from, to) queued or known
+    void planServo(const Pending &entry, std::vector<DXLBatchWrite> &out) const;
+    void fillBlock(const Pending &entry, const DXLBatchWrite &write, std::vector<uint8_t> &block) const;
+
+public:
+    DXLWriteBatch(int maxGapBytes = DXL_BATCH_MAX_GAP, int maxLengthBytes = DXL_BATCH_MAX_LENGTH);
+
+    void write(DXLServo &servo, uint16_t address, uint16_t length, uint32_t value);     // length 1, 2 or 4, little endian as on the servo
+    void writeBytes(DXLServo &servo, uint16_t address, uint16_t length, const uint8_t *data);
+    void setKnown(DXLServo &servo, uint16_t address, uint16_t length, const uint8_t *data);   // Current contents, only sent to fill a gap
+
+    size_t pendingWrites() const;
+    std::vector<DXLBatchWrite> plan() const;            // Packets flush() would send, no bus traffic
+    DXLExpected<void> flush();                          // Send and clear queue, first failure returned, every packet still tried
+    void clear();                                       // Drop queued writes and known bytes
+
+    const std::vector<DXLBatchWrite> &getResults() const { return results; }   // Packets of last flush()
+    bool written(const DXLServo &servo, uint16_t address) const;               // Register at address was in a packet that succeeded in last flush()
+    DXLWriteBatchStats getStats() const { return stats; }
+    void resetStats();
+};